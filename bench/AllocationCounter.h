@@ -0,0 +1,56 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+// Replaces the global allocation functions with ones that track live heap
+// bytes. Include from exactly one translation unit of a benchmark binary.
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+
+inline std::size_t &liveBytes() {
+  static std::size_t bytes = 0;
+  return bytes;
+}
+
+inline std::size_t &allocationCount() {
+  static std::size_t count = 0;
+  return count;
+}
+
+} // namespace bench
+
+namespace {
+constexpr std::size_t kAllocationHeader = alignof(std::max_align_t);
+}
+
+void *operator new(std::size_t size) {
+  void *raw = std::malloc(size + kAllocationHeader);
+  if (!raw) {
+    throw std::bad_alloc();
+  }
+  *static_cast<std::size_t *>(raw) = size;
+  bench::liveBytes() += size;
+  ++bench::allocationCount();
+  return static_cast<char *>(raw) + kAllocationHeader;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  void *raw = static_cast<char *>(ptr) - kAllocationHeader;
+  bench::liveBytes() -= *static_cast<std::size_t *>(raw);
+  std::free(raw);
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept {
+  operator delete(ptr);
+}
+
+#endif // ALLOCATION_COUNTER_H
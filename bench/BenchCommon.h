@@ -0,0 +1,56 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+class Stopwatch {
+private:
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  void reset() { start_ = std::chrono::steady_clock::now(); }
+
+  double elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start_)
+        .count();
+  }
+};
+
+template <typename T> inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+// First positional argument overrides the default problem size, so the same
+// binary can be run at full scale or quickly on a small machine.
+inline std::size_t sizeArg(int argc, char **argv, std::size_t fallback) {
+  if (argc > 1) {
+    return static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+  }
+  return fallback;
+}
+
+inline void report(const std::string &label, double value,
+                   const std::string &unit) {
+  std::cout << "  " << std::left << std::setw(44) << label << std::right
+            << std::setw(14) << std::fixed << std::setprecision(2) << value
+            << " " << unit << std::endl;
+}
+
+} // namespace bench
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,115 @@
+// Filtered counts over task state and type: a scan through the virtual
+// accessors compared with popcounts over the bitmap indexes.
+//
+// Usage: bitmap_index_bench [tasks]   (default: 10000000)
+
+#include "BenchCommon.h"
+
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskBitmapIndex.h"
+#include "../include/TaskState.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 1000;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 10000000);
+  auto deadline = std::chrono::system_clock::now();
+
+  LabFactory labFactory;
+  ProjectFactory projectFactory;
+  ExamFactory examFactory;
+  TaskFactory *factories[] = {&labFactory, &projectFactory, &examFactory};
+
+  std::vector<std::shared_ptr<Subject>> subjects;
+  std::vector<std::shared_ptr<Task>> batch;
+  for (std::size_t first = 0; first < taskCount; first += kTasksPerSubject) {
+    auto subject = std::make_shared<Subject>(
+        "S", "S" + std::to_string(subjects.size()));
+    batch.clear();
+    for (std::size_t i = first; i < taskCount && i < first + kTasksPerSubject;
+         ++i) {
+      // Titles stay within the small-string buffer to keep 10M tasks in RAM.
+      auto task = factories[(i * 7) % 3]->createTask(std::to_string(i),
+                                                     deadline);
+      if (i % 5 == 0) {
+        task->completeTask();
+      } else if (i % 5 == 1) {
+        task->startTask();
+      }
+      batch.push_back(std::move(task));
+    }
+    subject->addTasks(batch);
+    subjects.push_back(std::move(subject));
+  }
+
+  std::cout << "Bitmap index benchmark, " << taskCount << " tasks"
+            << std::endl;
+
+  TaskBitmapIndex index;
+  bench::Stopwatch watch;
+  for (const auto &subject : subjects) {
+    index.attach(*subject);
+  }
+  bench::report("build index", watch.elapsedSeconds() * 1e3, "ms");
+  bench::report("index memory",
+                static_cast<double>(index.memoryUsage()) / (1 << 20), "MiB");
+
+  watch.reset();
+  std::size_t scanCompleted = 0;
+  std::size_t scanInProgressLabs = 0;
+  for (const auto &subject : subjects) {
+    for (const auto &task : subject->taskView()) {
+      if (task->isCompleted()) {
+        ++scanCompleted;
+      }
+      if (task->getStateName() == "In Progress" && task->getType() == "Lab") {
+        ++scanInProgressLabs;
+      }
+    }
+  }
+  bench::report("scan: completed + in-progress labs",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  watch.reset();
+  std::uint64_t completed = index.count({TaskStateKind::Completed});
+  std::uint64_t inProgressLabs =
+      index.count({TaskStateKind::InProgress, TaskType::Lab});
+  bench::report("bitmap: completed + in-progress labs",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  const Subject *one = subjects[subjects.size() / 2].get();
+  watch.reset();
+  std::size_t scanSubject = 0;
+  for (const auto &task : one->taskView()) {
+    if (task->isCompleted() && task->getType() == "Exam") {
+      ++scanSubject;
+    }
+  }
+  double scanSubjectUs = watch.elapsedSeconds() * 1e6;
+
+  watch.reset();
+  std::uint64_t bitmapSubject =
+      index.count({TaskStateKind::Completed, TaskType::Exam, one});
+  double bitmapSubjectUs = watch.elapsedSeconds() * 1e6;
+  bench::report("scan: completed exams in one subject", scanSubjectUs, "us");
+  bench::report("bitmap: completed exams in one subject", bitmapSubjectUs,
+                "us");
+
+  bool agree = scanCompleted == completed &&
+               scanInProgressLabs == inProgressLabs &&
+               scanSubject == bitmapSubject;
+  if (!agree) {
+    std::cout << "  counts differ between scan and index" << std::endl;
+  }
+  return agree ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+// Bulk import of generated cohorts from CSV and JSON Lines, compared with
+// the per-row path the UI uses: iso_date::parse, then Registry::createTask
+// for every row.
+//
+// Usage: bulk_import_bench [tasks] [threads]   (default: 2000000, all cores)
+
+#include "BenchCommon.h"
+
+#include "../include/BulkImporter.h"
+#include "../include/CommandManager.h"
+#include "../include/IsoDate.h"
+#include "../include/Registry.h"
+
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 1000;
+constexpr std::size_t kBaselineTasks = 20000;
+const char *const kTypes[] = {"Lab", "Project", "Exam"};
+const char *const kStates[] = {"Pending", "InProgress", "Completed"};
+
+std::string deadlineFor(std::size_t i) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "2030-%02zu-%02zuT%02zu:00:00",
+                1 + i % 12, 1 + i % 28, i % 24);
+  return buffer;
+}
+
+std::string makeCsv(std::size_t taskCount) {
+  std::string csv = "kind,code,name,description\n";
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    if (i % kTasksPerSubject == 0) {
+      std::string code = "S" + std::to_string(i / kTasksPerSubject);
+      csv += "S," + code + ",Subject " + code + ",\"Cohort, autumn\"\n";
+    }
+    csv += "T,S" + std::to_string(i / kTasksPerSubject) + ",Task " +
+           std::to_string(i) + ",Imported task," + deadlineFor(i) + "," +
+           kTypes[i % 3] + "," + kStates[i % 3] + "\n";
+  }
+  return csv;
+}
+
+std::string makeJsonLines(std::size_t taskCount) {
+  std::string jsonl;
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    std::string code = "S" + std::to_string(i / kTasksPerSubject);
+    if (i % kTasksPerSubject == 0) {
+      jsonl += "{\"kind\":\"subject\",\"code\":\"" + code +
+               "\",\"name\":\"Subject " + code +
+               "\",\"description\":\"Cohort, autumn\"}\n";
+    }
+    jsonl += "{\"kind\":\"task\",\"subject\":\"" + code +
+             "\",\"title\":\"Task " + std::to_string(i) +
+             "\",\"description\":\"Imported task\",\"deadline\":\"" +
+             deadlineFor(i) + "\",\"type\":\"" + kTypes[i % 3] +
+             "\",\"state\":\"" + kStates[i % 3] + "\"}\n";
+  }
+  return jsonl;
+}
+
+void clearRegistry() {
+  Registry::instance().subjects.clear();
+  Registry::instance().publish();
+  CommandManager::instance().clearHistory();
+}
+
+double importRate(const std::string &label, const std::string &data,
+                  BulkImporter::Format format, std::size_t threads,
+                  std::size_t expected) {
+  BulkImporter::Options options;
+  options.format = format;
+  options.threads = threads;
+
+  bench::Stopwatch watch;
+  ImportStats stats = BulkImporter(Registry::instance(), options)
+                          .importBuffer(data);
+  double seconds = watch.elapsedSeconds();
+  if (stats.tasks != expected || stats.malformed != 0) {
+    std::cout << "  " << label << ": imported " << stats.tasks << " of "
+              << expected << " tasks" << std::endl;
+  }
+  double rate = static_cast<double>(stats.tasks) / seconds;
+  bench::report(label + " (" +
+                    std::to_string(data.size() >> 20) + " MiB)",
+                rate / 1e6, "M tasks/s");
+  clearRegistry();
+  return rate;
+}
+
+// What bindings.cpp does for every task the UI creates.
+double perRowRate(std::size_t taskCount) {
+  std::cout.setstate(std::ios::failbit);
+  auto &registry = Registry::instance();
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    if (i % kTasksPerSubject == 0) {
+      std::string code = "S" + std::to_string(i / kTasksPerSubject);
+      registry.createSubject("Subject " + code, code, "Cohort, autumn");
+    }
+    DateTime deadline;
+    iso_date::parse(deadlineFor(i), deadline);
+    registry.createTask("S" + std::to_string(i / kTasksPerSubject),
+                        "Task " + std::to_string(i), "Imported task",
+                        deadline, static_cast<int>(i % 3) + 1);
+  }
+  double seconds = watch.elapsedSeconds();
+  std::cout.clear();
+  clearRegistry();
+  return static_cast<double>(taskCount) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 2000000);
+  std::size_t threads =
+      argc > 2 ? static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10))
+               : std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "Bulk import benchmark, " << taskCount << " tasks, "
+            << threads << " parser threads" << std::endl;
+
+  std::string csv = makeCsv(taskCount);
+  importRate("CSV import", csv, BulkImporter::Format::Csv, threads,
+             taskCount);
+  csv = std::string();
+
+  std::string jsonl = makeJsonLines(taskCount);
+  importRate("JSON Lines import", jsonl, BulkImporter::Format::JsonLines,
+             threads, taskCount);
+  jsonl = std::string();
+
+  double baseline = perRowRate(std::min(taskCount, kBaselineTasks));
+  bench::report("per-row createTask (" +
+                    std::to_string(std::min(taskCount, kBaselineTasks)) +
+                    " tasks)",
+                baseline / 1e6, "M tasks/s");
+  return 0;
+}
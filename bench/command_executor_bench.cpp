@@ -0,0 +1,104 @@
+// Producers changing task states through one CommandManager: each takes a
+// mutex around executeCommand, against submitting to a CommandExecutor and
+// moving on. Reports how long producers are held up and the total time
+// until every command is in the history.
+//
+// Usage: command_executor_bench [commands]   (default: 400000)
+
+#include "BenchCommon.h"
+
+#include "../include/CommandExecutor.h"
+#include "../include/CommandManager.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kProducers = 4;
+const TaskStateKind kTargets[] = {TaskStateKind::InProgress,
+                                  TaskStateKind::Completed,
+                                  TaskStateKind::Pending};
+
+// Runs submit(producer, i) for commandCount commands split over the
+// producers; finish() waits for the commands to take effect.
+template <typename Submit, typename Finish>
+void run(const std::string &label, std::size_t commandCount, Submit &&submit,
+         Finish &&finish) {
+  std::cout.setstate(std::ios::failbit);
+  bench::Stopwatch watch;
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (std::size_t i = p; i < commandCount; i += kProducers) {
+        submit(p, i);
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  double producerSeconds = watch.elapsedSeconds();
+  finish();
+  double totalSeconds = watch.elapsedSeconds();
+  std::cout.clear();
+
+  bench::report(label + ": producer time per command",
+                producerSeconds * 1e9 / commandCount, "ns");
+  bench::report(label + ": total time per command",
+                totalSeconds * 1e9 / commandCount, "ns");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t commandCount = bench::sizeArg(argc, argv, 400000);
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    tasks.push_back(factory.createTask("Task " + std::to_string(p), deadline));
+  }
+
+  std::cout << "Command executor benchmark, " << commandCount << " commands, "
+            << kProducers << " producers, "
+            << std::thread::hardware_concurrency() << " hardware threads"
+            << std::endl;
+
+  {
+    CommandManager history;
+    std::mutex mutex;
+    run(
+        "mutex", commandCount,
+        [&](std::size_t p, std::size_t i) {
+          auto command =
+              std::make_shared<SetTaskStateCommand>(*tasks[p], kTargets[i % 3]);
+          std::lock_guard<std::mutex> lock(mutex);
+          history.executeCommand(std::move(command));
+        },
+        [] {});
+  }
+  {
+    CommandManager history;
+    CommandExecutor executor(history);
+    run(
+        "executor", commandCount,
+        [&](std::size_t p, std::size_t i) {
+          executor.submit(
+              std::make_shared<SetTaskStateCommand>(*tasks[p], kTargets[i % 3]),
+              nullptr);
+        },
+        [&] { executor.flush().get(); });
+    bench::report("executor: commands per batch",
+                  static_cast<double>(executor.applied()) /
+                      static_cast<double>(executor.batches()),
+                  "");
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// State changes through CommandManager over a long session: the compact
+// record path Registry uses against a SetTaskStateCommand object per
+// change, counting heap allocations once the history ring is full.
+//
+// Usage: command_history_bench [commands]   (default: 2000000)
+
+#include "AllocationCounter.h"
+#include "BenchCommon.h"
+
+#include "../include/CommandManager.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasks = 1000;
+const TaskStateKind kTargets[] = {TaskStateKind::InProgress,
+                                  TaskStateKind::Completed,
+                                  TaskStateKind::Pending};
+
+template <typename Execute>
+void run(const std::string &label, std::size_t commandCount,
+         const std::vector<std::shared_ptr<Task>> &tasks, Execute &&execute) {
+  std::cout.setstate(std::ios::failbit);
+  CommandManager history;
+  // Fill the ring first so the measurement sees the steady state.
+  for (std::size_t i = 0; i < history.depth(); ++i) {
+    execute(history, *tasks[i % tasks.size()], kTargets[i % 3]);
+  }
+
+  std::size_t allocations = bench::allocationCount();
+  std::size_t bytes = bench::liveBytes();
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < commandCount; ++i) {
+    execute(history, *tasks[i % tasks.size()], kTargets[(i / 7) % 3]);
+    if (i % 16 == 15) {
+      history.undoLastCommand();
+      history.redoLastCommand();
+    }
+  }
+  double seconds = watch.elapsedSeconds();
+  std::cout.clear();
+  bench::report(label + ": per command", seconds * 1e9 / commandCount, "ns");
+  bench::report(label + ": heap allocations per command",
+                static_cast<double>(bench::allocationCount() - allocations) /
+                    static_cast<double>(commandCount),
+                "");
+  bench::report(label + ": history growth",
+                static_cast<double>(bench::liveBytes() - bytes) / 1024.0,
+                "KiB");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t commandCount = bench::sizeArg(argc, argv, 2000000);
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  for (std::size_t i = 0; i < kTasks; ++i) {
+    tasks.push_back(factory.createTask("Task " + std::to_string(i), deadline));
+  }
+
+  std::cout << "Command history benchmark, " << commandCount
+            << " commands, depth " << CommandManager::kDefaultDepth << " ("
+            << CommandManager::kDefaultDepth * sizeof(CommandRecord) / 1024.0
+            << " KiB of records)" << std::endl;
+
+  run("records", commandCount, tasks,
+      [](CommandManager &history, Task &task, TaskStateKind target) {
+        history.executeStateChange(task, target);
+      });
+  run("command objects", commandCount, tasks,
+      [](CommandManager &history, Task &task, TaskStateKind target) {
+        history.executeCommand(
+            std::make_shared<SetTaskStateCommand>(task, target));
+      });
+  return 0;
+}
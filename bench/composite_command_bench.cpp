@@ -0,0 +1,81 @@
+// A 10k-task state change through Registry: one changeTaskStates()
+// transaction against one changeTaskState() call per task, reporting time,
+// undo history entries and versions published. The per-task path keeps only
+// the newest CommandManager::kDefaultDepth entries.
+//
+// Usage: composite_command_bench [tasks]   (default: 10000)
+
+#include "BenchCommon.h"
+
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename Change>
+void run(const std::string &label, Change &&change) {
+  auto &registry = Registry::instance();
+  registry.commands().clearHistory();
+  std::cout.setstate(std::ios::failbit);
+  const std::uint64_t version = registry.snapshot()->version;
+  bench::Stopwatch watch;
+  change(registry, 2);
+  double applySeconds = watch.elapsedSeconds();
+  std::size_t entries = 0;
+  while (registry.commands().canUndo()) {
+    registry.commands().undoLastCommand();
+    ++entries;
+  }
+  registry.publish();
+  double totalSeconds = watch.elapsedSeconds();
+  std::uint64_t versions = registry.snapshot()->version - version - 1;
+  std::cout.clear();
+
+  bench::report(label + ": apply", applySeconds * 1e3, "ms");
+  bench::report(label + ": apply and undo", totalSeconds * 1e3, "ms");
+  bench::report(label + ": history entries", static_cast<double>(entries), "");
+  bench::report(label + ": versions published",
+                static_cast<double>(versions), "");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 10000);
+  auto &registry = Registry::instance();
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+  registry.createSubject("Benchmark", "BENCH", "");
+  std::vector<TaskId> tasks;
+  std::cout.setstate(std::ios::failbit);
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    tasks.push_back(registry
+                        .createTask("BENCH", "Task " + std::to_string(i), "",
+                                    deadline, 1)
+                        ->getHandle());
+  }
+  std::cout.clear();
+
+  std::cout << "Composite command benchmark, " << taskCount << " tasks"
+            << std::endl;
+
+  run("per task", [&](Registry &r, int target) {
+    for (TaskId id : tasks) {
+      r.changeTaskState(id, target);
+    }
+  });
+  run("transaction", [&](Registry &r, int target) {
+    std::vector<std::pair<TaskId, int>> changes;
+    changes.reserve(tasks.size());
+    for (TaskId id : tasks) {
+      changes.emplace_back(id, target);
+    }
+    r.changeTaskStates(changes);
+  });
+  return 0;
+}
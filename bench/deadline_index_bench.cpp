@@ -0,0 +1,79 @@
+// Window queries on task deadlines: scanning every subject's task list
+// compared with the registry-wide deadline index.
+//
+// Usage: deadline_index_bench [tasks]   (default: 200000)
+
+#include "BenchCommon.h"
+
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 100;
+constexpr int kQueries = 1000;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 200000);
+  auto &registry = Registry::instance();
+  auto now = std::chrono::system_clock::now();
+
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    std::string code = "SUBJ" + std::to_string(i / kTasksPerSubject);
+    if (i % kTasksPerSubject == 0) {
+      registry.createSubject("Subject " + code, code, "");
+    }
+    registry.createTask(code, "Task " + std::to_string(i), "",
+                        now + std::chrono::minutes((i * 7919) % 525600),
+                        1 + static_cast<int>(i % 3));
+  }
+
+  std::cout << "Deadline index benchmark, " << taskCount << " tasks, "
+            << kQueries << " one-day windows" << std::endl;
+
+  bench::Stopwatch watch;
+  std::size_t scanned = 0;
+  for (int q = 0; q < kQueries; ++q) {
+    DateTime from = now + std::chrono::hours(24 * (q % 365));
+    DateTime to = from + std::chrono::hours(24);
+    for (const auto &[code, subject] : registry.subjects) {
+      for (const auto &task : subject->taskView()) {
+        if (task->getDeadline() >= from && task->getDeadline() < to) {
+          ++scanned;
+        }
+      }
+    }
+  }
+  bench::report("scan every subject (per query)",
+                watch.elapsedSeconds() * 1e6 / kQueries, "us");
+
+  watch.reset();
+  std::size_t indexed = 0;
+  for (int q = 0; q < kQueries; ++q) {
+    DateTime from = now + std::chrono::hours(24 * (q % 365));
+    indexed +=
+        registry.tasksDueBetween(from, from + std::chrono::hours(24)).size();
+  }
+  bench::report("tasksDueBetween (per query)",
+                watch.elapsedSeconds() * 1e6 / kQueries, "us");
+
+  watch.reset();
+  std::size_t next = 0;
+  for (int q = 0; q < kQueries; ++q) {
+    next += registry.nextDue(10, now + std::chrono::hours(q)).size();
+  }
+  bench::report("nextDue(10) (per query)",
+                watch.elapsedSeconds() * 1e6 / kQueries, "us");
+
+  bench::report("tasks per window", static_cast<double>(indexed) / kQueries,
+                "tasks");
+  bench::doNotOptimize(scanned);
+  bench::doNotOptimize(next);
+  return scanned == indexed ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Deadline formatting and parsing through iso_date against the C library
+// path the UI used before: localtime + put_time into a stringstream, and
+// get_time + mktime.
+//
+// Usage: iso_date_bench [dates]   (default: 1000000)
+
+#include "BenchCommon.h"
+
+#include "../include/IsoDate.h"
+
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string putTimeFormat(const DateTime &dt) {
+  auto time = std::chrono::system_clock::to_time_t(dt);
+  std::tm tm_local = {};
+  localtime_r(&time, &tm_local);
+  std::stringstream ss;
+  ss << std::put_time(&tm_local, "%Y-%m-%d %H:%M");
+  return ss.str();
+}
+
+DateTime getTimeParse(const std::string &text) {
+  std::tm timeinfo = {};
+  std::istringstream ss(text);
+  ss >> std::get_time(&timeinfo, "%Y-%m-%dT%H:%M:%S");
+  timeinfo.tm_isdst = -1;
+  return std::chrono::system_clock::from_time_t(std::mktime(&timeinfo));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t count = bench::sizeArg(argc, argv, 1000000);
+
+  // Deadlines over a term: a few months of hourly slots.
+  std::vector<DateTime> deadlines;
+  deadlines.reserve(count);
+  auto start = std::chrono::system_clock::from_time_t(1767225600);
+  for (std::size_t i = 0; i < count; ++i) {
+    deadlines.push_back(start + std::chrono::hours(i % 3000) +
+                        std::chrono::minutes(i % 60));
+  }
+  std::vector<std::string> texts;
+  texts.reserve(count);
+  for (const DateTime &deadline : deadlines) {
+    texts.push_back(
+        iso_date::format(deadline, iso_date::DateStyle::Seconds).str());
+  }
+
+  std::cout << "ISO date benchmark, " << count << " dates" << std::endl;
+
+  bench::Stopwatch watch;
+  std::size_t bytes = 0;
+  for (const DateTime &deadline : deadlines) {
+    bytes += putTimeFormat(deadline).size();
+  }
+  bench::report("format: localtime + put_time",
+                watch.elapsedSeconds() * 1e9 / count, "ns/date");
+
+  watch.reset();
+  for (const DateTime &deadline : deadlines) {
+    iso_date::FormattedDate text = iso_date::format(deadline);
+    bench::doNotOptimize(text);
+    bytes += text.view().size();
+  }
+  bench::report("format: iso_date", watch.elapsedSeconds() * 1e9 / count,
+                "ns/date");
+
+  watch.reset();
+  std::int64_t sum = 0;
+  for (const std::string &text : texts) {
+    sum += getTimeParse(text).time_since_epoch().count();
+  }
+  bench::report("parse: get_time + mktime",
+                watch.elapsedSeconds() * 1e9 / count, "ns/date");
+
+  watch.reset();
+  for (const std::string &text : texts) {
+    DateTime parsed;
+    iso_date::parse(text, parsed);
+    sum -= parsed.time_since_epoch().count();
+  }
+  bench::report("parse: iso_date", watch.elapsedSeconds() * 1e9 / count,
+                "ns/date");
+  bench::doNotOptimize(bytes);
+  bench::doNotOptimize(sum);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Polling NotificationManager for due reminders: the heap poll against the
+// old full scan calling shouldTrigger on every notification, plus cancel
+// and reschedule by handle.
+//
+// Usage: notification_queue_bench [notifications]   (default: 200000)
+
+#include "BenchCommon.h"
+
+#include "../include/Notification.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kDuePerPoll = 10;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t count = bench::sizeArg(argc, argv, 200000);
+  auto &manager = NotificationManager::getInstance();
+  const DateTime start = std::chrono::system_clock::now();
+
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  std::vector<NotificationId> ids;
+  tasks.reserve(count);
+  ids.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    // One reminder a minute, two days before each deadline.
+    tasks.push_back(factory.createTask(
+        "Task " + std::to_string(i),
+        start + std::chrono::hours(48) + std::chrono::minutes(i)));
+    ids.push_back(manager.addNotification(
+        std::make_shared<DeadlineNotification>("Reminder", tasks.back(), 2)));
+  }
+
+  std::cout << "Notification queue benchmark, " << count
+            << " deadline reminders, " << kDuePerPoll << " due per poll"
+            << std::endl;
+
+  const std::size_t polls = count / kDuePerPoll / 2;
+
+  // The old checkNotifications: every notification asked at every poll.
+  std::size_t scanPolls = polls < 200 ? polls : 200;
+  std::size_t scanned = 0;
+  bench::Stopwatch watch;
+  for (std::size_t p = 0; p < scanPolls; ++p) {
+    DateTime now = start + std::chrono::minutes(kDuePerPoll * (p + 1));
+    for (const auto &notification : manager.getNotifications()) {
+      scanned += notification->shouldTrigger(now);
+    }
+  }
+  bench::doNotOptimize(scanned);
+  bench::report("full scan per poll", watch.elapsedSeconds() * 1e6 / scanPolls,
+                "us");
+
+  std::size_t fired = 0;
+  watch.reset();
+  for (std::size_t p = 0; p < polls; ++p) {
+    DateTime now = start + std::chrono::minutes(kDuePerPoll * (p + 1)) +
+                   std::chrono::seconds(1);
+    fired += manager.pollDue(now).size();
+  }
+  bench::report("heap poll per poll", watch.elapsedSeconds() * 1e6 / polls,
+                "us");
+  bench::report("fired per poll",
+                static_cast<double>(fired) / static_cast<double>(polls), "");
+
+  watch.reset();
+  for (std::size_t i = 0; i < count; ++i) {
+    manager.reschedule(ids[i], start + std::chrono::minutes((i * 7919) % count));
+  }
+  bench::report("reschedule", watch.elapsedSeconds() * 1e9 / count, "ns");
+
+  watch.reset();
+  for (std::size_t i = 0; i < count; ++i) {
+    manager.cancel(ids[(i * 7919) % count]);
+  }
+  bench::report("cancel", watch.elapsedSeconds() * 1e9 / count, "ns");
+  return 0;
+}
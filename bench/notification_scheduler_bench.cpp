@@ -0,0 +1,131 @@
+// NotificationScheduler firing timers: a million in virtual time, driven as
+// fast as the scheduler thread keeps up, then a few hundred on the system
+// clock to see how late the thread wakes.
+//
+// Usage: notification_scheduler_bench [timers]   (default: 1000000)
+
+#include "BenchCommon.h"
+
+#include "../include/Clock.h"
+#include "../include/Notification.h"
+#include "../include/NotificationScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kStepSeconds = 1000;
+constexpr std::size_t kWallTimers = 200;
+
+double micros(DateTime::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t count = bench::sizeArg(argc, argv, 1000000);
+  auto &manager = NotificationManager::getInstance();
+
+  std::cout << "Notification scheduler benchmark, " << count
+            << " timers in virtual time" << std::endl;
+
+  // One timer per simulated second, armed out of order.
+  const DateTime start;
+  std::vector<NotificationId> ids;
+  ids.reserve(count);
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < count; ++i) {
+    ids.push_back(manager.addNotification(std::make_shared<Notification>(
+        "Timer", start + std::chrono::seconds(1 + (i * 7919) % count),
+        nullptr)));
+  }
+  bench::report("arm", watch.elapsedSeconds() * 1e9 / count, "ns/timer");
+
+  {
+    VirtualClock clock(start);
+    std::atomic<std::int64_t> stepStarted{0};
+    std::atomic<std::int64_t> firstFiring{0};
+    std::uint64_t simulatedLate = 0;
+    NotificationScheduler scheduler(
+        {[&](const NotificationFiring &firing) {
+          simulatedLate += static_cast<std::uint64_t>(
+              (firing.fired - firing.due).count());
+          if (firstFiring.load(std::memory_order_relaxed) == 0) {
+            firstFiring.store(
+                std::chrono::steady_clock::now().time_since_epoch().count(),
+                std::memory_order_relaxed);
+          }
+        }},
+        clock);
+    scheduler.sync();
+
+    std::vector<double> wakeLatency;
+    watch.reset();
+    for (std::size_t second = 0; second < count; second += kStepSeconds) {
+      firstFiring.store(0);
+      stepStarted.store(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+      clock.advance(std::chrono::seconds(kStepSeconds));
+      scheduler.sync();
+      if (std::int64_t fired = firstFiring.load()) {
+        wakeLatency.push_back(
+            micros(std::chrono::steady_clock::duration(fired - stepStarted)));
+      }
+    }
+    double elapsed = watch.elapsedSeconds();
+    std::sort(wakeLatency.begin(), wakeLatency.end());
+
+    bench::report("fired", static_cast<double>(scheduler.delivered()), "");
+    bench::report("throughput", scheduler.delivered() / elapsed / 1e6,
+                  "M timers/s");
+    bench::report("advance to first firing, median",
+                  wakeLatency[wakeLatency.size() / 2], "us");
+    bench::report("advance to first firing, p99",
+                  wakeLatency[wakeLatency.size() * 99 / 100], "us");
+    // Half a step: the clock jumps kStepSeconds at a time.
+    bench::report("mean simulated lateness",
+                  micros(DateTime::duration(simulatedLate)) / 1e6 /
+                      static_cast<double>(scheduler.delivered()),
+                  "s");
+  }
+
+  for (NotificationId id : ids) {
+    manager.cancel(id);
+  }
+
+  // Wall-clock timers a millisecond apart: how late does the thread wake?
+  std::vector<double> lateness;
+  lateness.reserve(kWallTimers);
+  std::uint64_t wallWakeups = 0;
+  {
+    NotificationScheduler wall({[&](const NotificationFiring &firing) {
+      lateness.push_back(micros(firing.fired - firing.due));
+    }});
+    DateTime now = std::chrono::system_clock::now();
+    ids.clear();
+    for (std::size_t i = 0; i < kWallTimers; ++i) {
+      ids.push_back(manager.addNotification(std::make_shared<Notification>(
+          "Wall", now + std::chrono::milliseconds(10 + i), nullptr)));
+    }
+    while (wall.delivered() < kWallTimers) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    wallWakeups = wall.wakeups();
+  }
+  std::sort(lateness.begin(), lateness.end());
+  std::cout << kWallTimers << " timers on the system clock" << std::endl;
+  bench::report("lateness, median", lateness[lateness.size() / 2], "us");
+  bench::report("lateness, p99", lateness[lateness.size() * 99 / 100], "us");
+  bench::report("thread wakeups", static_cast<double>(wallWakeups), "");
+
+  for (NotificationId id : ids) {
+    manager.cancel(id);
+  }
+  return 0;
+}
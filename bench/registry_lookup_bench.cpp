@@ -0,0 +1,121 @@
+// Memory per entry and lookup latency of the interned registry maps compared
+// with the std::unordered_map<std::string, ...> they replaced. "requested"
+// memory excludes allocator headers, which favours the node-based map; the
+// allocation count shows how many such headers each layout pays for.
+//
+// Usage: registry_lookup_bench [entries]   (default: 1000000)
+
+#include "AllocationCounter.h"
+#include "BenchCommon.h"
+
+#include "../include/InternedMap.h"
+#include "../include/Internship.h"
+#include "../include/SymbolTable.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using InternshipPtr = std::shared_ptr<Internship>;
+
+template <typename Map>
+double measureLookups(const Map &map, const std::vector<std::string> &probes,
+                      std::size_t &found) {
+  bench::Stopwatch watch;
+  for (const auto &key : probes) {
+    auto it = map.find(key);
+    if (it != map.end()) {
+      found += it->second != nullptr;
+    }
+  }
+  return watch.elapsedSeconds() * 1e9 / probes.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t entries = bench::sizeArg(argc, argv, 1000000);
+
+  std::vector<std::string> keys;
+  keys.reserve(entries);
+  for (std::size_t i = 0; i < entries; ++i) {
+    keys.push_back("internship_" + std::to_string(i));
+  }
+
+  auto value = std::make_shared<Internship>("internship_0", "Google", "Intern",
+                                            InternshipStatus::STARTED,
+                                            "2024-06-01", "2024-08-31");
+
+  std::vector<std::string> hits = keys;
+  std::shuffle(hits.begin(), hits.end(), std::mt19937_64(42));
+  std::vector<std::string> misses;
+  misses.reserve(entries);
+  for (std::size_t i = 0; i < entries; ++i) {
+    misses.push_back("internship_" + std::to_string(entries + i));
+  }
+
+  std::cout << "Registry lookup benchmark, " << entries << " entries"
+            << std::endl;
+
+  std::size_t found = 0;
+
+  {
+    std::size_t before = bench::liveBytes();
+    std::size_t blocksBefore = bench::allocationCount();
+    bench::Stopwatch watch;
+    std::unordered_map<std::string, InternshipPtr> map;
+    for (const auto &key : keys) {
+      map[key] = value;
+    }
+    double buildSeconds = watch.elapsedSeconds();
+    std::size_t bytes = bench::liveBytes() - before;
+    std::size_t blocks = bench::allocationCount() - blocksBefore;
+
+    std::cout << "std::unordered_map<std::string, shared_ptr>" << std::endl;
+    bench::report("insert", buildSeconds * 1e9 / entries, "ns/entry");
+    bench::report("memory (requested)", static_cast<double>(bytes) / entries,
+                  "bytes/entry");
+    bench::report("heap allocations", static_cast<double>(blocks) / entries,
+                  "allocs/entry");
+    bench::report("lookup (hit)", measureLookups(map, hits, found),
+                  "ns/lookup");
+    bench::report("lookup (miss)", measureLookups(map, misses, found),
+                  "ns/lookup");
+  }
+
+  {
+    std::size_t before = bench::liveBytes();
+    std::size_t blocksBefore = bench::allocationCount();
+    bench::Stopwatch watch;
+    SymbolTable symbols;
+    InternedMap<InternshipPtr> map(symbols);
+    for (const auto &key : keys) {
+      map[key] = value;
+    }
+    double buildSeconds = watch.elapsedSeconds();
+    std::size_t bytes = bench::liveBytes() - before;
+    std::size_t blocks = bench::allocationCount() - blocksBefore;
+
+    std::cout << "SymbolTable + InternedMap<shared_ptr>" << std::endl;
+    bench::report("insert", buildSeconds * 1e9 / entries, "ns/entry");
+    bench::report("memory (requested)", static_cast<double>(bytes) / entries,
+                  "bytes/entry");
+    bench::report("  of which symbol table",
+                  static_cast<double>(symbols.memoryUsage()) / entries,
+                  "bytes/entry");
+    bench::report("heap allocations", static_cast<double>(blocks) / entries,
+                  "allocs/entry");
+    bench::report("lookup (hit)", measureLookups(map, hits, found),
+                  "ns/lookup");
+    bench::report("lookup (miss)", measureLookups(map, misses, found),
+                  "ns/lookup");
+  }
+
+  bench::doNotOptimize(found);
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Throughput of independent per-student registries as workers are added.
+// Every student gets its own subjects and tasks, so scaling would be linear
+// in the number of workers up to the number of cores, except for the locks
+// all shards still share (see RegistryPool.h). The second part times the
+// work an operation does under those locks on one thread, which bounds the
+// speedup any number of workers can reach.
+//
+// Usage: registry_pool_bench [operations]   (default: 200000)
+
+#include "BenchCommon.h"
+
+#include "../include/RegistryPool.h"
+#include "../include/Task.h"
+#include "../include/TaskStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kStudents = 256;
+constexpr std::size_t kTasksPerSubject = 20;
+
+double operationsPerSecond(std::size_t workers, std::size_t operations) {
+  RegistryPool pool(workers);
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+  std::vector<std::future<void>> pending;
+  pending.reserve(operations);
+
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < operations; ++i) {
+    std::string student = "student" + std::to_string(i % kStudents);
+    std::size_t n = i / kStudents;
+    pending.push_back(pool.submit(student, [n, deadline](Registry &registry) {
+      std::string code = "C" + std::to_string(n / kTasksPerSubject);
+      if (n % kTasksPerSubject == 0) {
+        registry.createSubject("Course", code, "");
+      }
+      registry.createTask(code, "Task " + std::to_string(n), "", deadline,
+                          static_cast<int>(n % 3) + 1);
+    }));
+  }
+  for (auto &future : pending) {
+    future.get();
+  }
+  return static_cast<double>(operations) / watch.elapsedSeconds();
+}
+
+// Each createTask below takes TaskStore::global()'s mutex twice, interning
+// its strings each time: once for the live task's row and once for the row
+// of the copy frozen into the next version. The subject slot map is locked
+// once per kTasksPerSubject tasks, and NotificationManager not at all while
+// no notifications exist; both are left out.
+double sharedSecondsPerOperation(std::size_t operations) {
+  auto &store = TaskStore::global();
+  std::vector<std::string> titles;
+  titles.reserve(operations);
+  for (std::size_t i = 0; i < operations; ++i) {
+    titles.push_back("Task " + std::to_string(i / kStudents));
+  }
+  std::vector<TaskStore::Row> rows;
+  rows.reserve(2 * operations);
+
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < operations; ++i) {
+    auto type = static_cast<TaskType>(i % 3);
+    rows.push_back(store.allocate(titles[i], "", 0, type));
+    rows.push_back(store.allocate(titles[i], "", 0, type));
+  }
+  double seconds = watch.elapsedSeconds();
+  for (TaskStore::Row row : rows) {
+    store.release(row);
+  }
+  return seconds / static_cast<double>(operations);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t operations = bench::sizeArg(argc, argv, 200000);
+  const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "Registry pool benchmark, " << operations << " operations over "
+            << kStudents << " students, " << cores << " hardware threads"
+            << std::endl;
+
+  double single = 0;
+  for (std::size_t workers = 1; workers <= std::max<std::size_t>(cores, 4);
+       workers *= 2) {
+    double rate = operationsPerSecond(workers, operations);
+    if (workers == 1) {
+      single = rate;
+    }
+    bench::report(std::to_string(workers) + " workers", rate / 1e3,
+                  "K ops/s (x" + std::to_string(rate / single).substr(0, 4) +
+                      ")");
+  }
+
+  double shared = sharedSecondsPerOperation(operations);
+  bench::report("shared-lock work per operation", shared * 1e9, "ns");
+  bench::report("share of a 1-worker operation", shared * single * 100,
+                "%");
+  bench::report("speedup ceiling", 1 / (shared * single), "x");
+  return 0;
+}
@@ -0,0 +1,140 @@
+// Read throughput while one writer keeps changing task states: readers
+// working on published versions compared with readers sharing a mutex with
+// the writer on the live maps.
+//
+// Usage: registry_read_scaling_bench [milliseconds per run]   (default: 500)
+
+#include "BenchCommon.h"
+
+#include "../include/CommandManager.h"
+#include "../include/PerformanceStrategy.h"
+#include "../include/Registry.h"
+#include "../include/RegistryVersion.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskStore.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kSubjects = 100;
+constexpr int kTasksPerSubject = 100;
+
+std::string subjectCode(int i) { return "SUBJ" + std::to_string(i); }
+
+void populate(Registry &registry) {
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+  for (int s = 0; s < kSubjects; ++s) {
+    registry.createSubject("Subject " + std::to_string(s), subjectCode(s), "");
+    for (int t = 0; t < kTasksPerSubject; ++t) {
+      registry.createTask(subjectCode(s), "Task " + std::to_string(t), "",
+                          deadline, 1 + t % 3);
+    }
+  }
+}
+
+struct Result {
+  double readsPerSecond;
+  double writesPerSecond;
+};
+
+// read(subjectIndex) must be safe to call concurrently with write(i).
+template <typename Read, typename Write>
+Result run(int readers, double seconds, Read read, Write write) {
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> reads{0};
+  std::size_t writes = 0;
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&, r] {
+      std::size_t local = 0;
+      double sink = 0.0;
+      for (int i = r; !done.load(std::memory_order_relaxed); ++i) {
+        sink += read(i % kSubjects);
+        ++local;
+      }
+      bench::doNotOptimize(sink);
+      reads += local;
+    });
+  }
+
+  bench::Stopwatch watch;
+  while (watch.elapsedSeconds() < seconds) {
+    write(writes++);
+    if (writes % 1024 == 0) {
+      CommandManager::instance().clearHistory();
+    }
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed = watch.elapsedSeconds();
+
+  return {static_cast<double>(reads.load()) / elapsed,
+          static_cast<double>(writes) / elapsed};
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const double seconds =
+      static_cast<double>(bench::sizeArg(argc, argv, 500)) / 1000.0;
+  auto &registry = Registry::instance();
+
+  // Task state changes log every transition to stdout.
+  std::cout.setstate(std::ios::failbit);
+  populate(registry);
+  std::cout.clear();
+
+  std::cout << "Registry read scaling benchmark, " << kSubjects << " x "
+            << kTasksPerSubject << " tasks, one writer" << std::endl;
+
+  CompletionRateStrategy strategy;
+  std::mutex liveMutex;
+
+  auto writeVersioned = [&](std::size_t i) {
+    registry.changeTaskState(subjectCode(static_cast<int>(i % kSubjects)),
+                             static_cast<int>(i / kSubjects % kTasksPerSubject),
+                             static_cast<int>(i % 3));
+  };
+  auto writeLocked = [&](std::size_t i) {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    writeVersioned(i);
+  };
+
+  auto readVersioned = [&](int s) {
+    auto version = registry.snapshot();
+    return strategy.calculate(TaskStore::global().stats(
+        version->findSubject(subjectCode(s))->taskView()));
+  };
+  auto readLocked = [&](int s) {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    return strategy.calculate(TaskStore::global().stats(
+        registry.subjects.at(subjectCode(s))->taskView()));
+  };
+
+  for (int readers : {1, 2, 4, 8}) {
+    std::cout.setstate(std::ios::failbit);
+    Result locked = run(readers, seconds, readLocked, writeLocked);
+    Result versioned = run(readers, seconds, readVersioned, writeVersioned);
+    std::cout.clear();
+
+    std::string prefix = std::to_string(readers) + " readers, ";
+    bench::report(prefix + "mutex reads", locked.readsPerSecond, "reads/s");
+    bench::report(prefix + "mutex writes", locked.writesPerSecond,
+                  "writes/s");
+    bench::report(prefix + "snapshot reads", versioned.readsPerSecond,
+                  "reads/s");
+    bench::report(prefix + "snapshot writes", versioned.writesPerSecond,
+                  "writes/s");
+  }
+
+  return 0;
+}
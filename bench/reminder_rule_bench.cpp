@@ -0,0 +1,106 @@
+// "Remind me 7, 3 and 1 days before every exam": one DeadlineNotification
+// per exam and offset, against a single ReminderRule expanded when polled.
+// Both are polled hourly through NotificationManager for 30 simulated days.
+// The rule skips reminders whose time had passed before it was added, while
+// the materialized ones still fire inside their day, so they count a few
+// more.
+//
+// Usage: reminder_rule_bench [tasks]   (default: 100000)
+
+#include "AllocationCounter.h"
+#include "BenchCommon.h"
+
+#include "../include/Notification.h"
+#include "../include/Registry.h"
+#include "../include/ReminderRule.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 100;
+constexpr int kPollHours = 30 * 24;
+const std::vector<int> kDaysBefore = {7, 3, 1};
+
+// Polls hourly from start; returns the reminders handed out.
+std::size_t pollHourly(NotificationManager &manager, DateTime start,
+                       double &seconds) {
+  std::size_t delivered = 0;
+  bench::Stopwatch watch;
+  for (int hour = 1; hour <= kPollHours; ++hour) {
+    delivered += manager.takeDue(start + std::chrono::hours(hour)).size();
+  }
+  seconds = watch.elapsedSeconds();
+  return delivered;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 100000);
+  auto &registry = Registry::instance();
+  auto &manager = NotificationManager::getInstance();
+  const DateTime start =
+      std::chrono::floor<std::chrono::hours>(std::chrono::system_clock::now());
+
+  // Deadlines spread over 60 days; every third task is an exam.
+  std::vector<std::shared_ptr<Task>> exams;
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    std::string code = "SUBJ" + std::to_string(i / kTasksPerSubject);
+    if (i % kTasksPerSubject == 0) {
+      registry.createSubject("Subject " + code, code, "");
+    }
+    auto task = registry.createTask(
+        code, "Task " + std::to_string(i), "",
+        start + std::chrono::minutes((i * 7919) % (60 * 24 * 60)),
+        1 + static_cast<int>(i % 3));
+    if (task && task->getTaskType() == TaskType::Exam) {
+      exams.push_back(std::move(task));
+    }
+  }
+
+  std::cout << "Reminder rule benchmark, " << taskCount << " tasks, "
+            << exams.size() << " exams, " << kDaysBefore.size()
+            << " offsets, " << kPollHours << " hourly polls" << std::endl;
+
+  std::size_t before = bench::liveBytes();
+  std::vector<NotificationId> ids;
+  for (const auto &exam : exams) {
+    for (int days : kDaysBefore) {
+      ids.push_back(manager.addNotification(
+          std::make_shared<DeadlineNotification>("Exam soon", exam, days)));
+    }
+  }
+  std::size_t materializedBytes = bench::liveBytes() - before;
+  double materializedSeconds = 0;
+  std::size_t materialized = pollHourly(manager, start, materializedSeconds);
+  for (NotificationId id : ids) {
+    manager.cancel(id);
+  }
+
+  TaskFilter filter;
+  filter.type = TaskType::Exam;
+  before = bench::liveBytes();
+  NotificationId rule = manager.addNotification(std::make_shared<ReminderRule>(
+      "Exam soon", registry, filter, kDaysBefore, start));
+  std::size_t ruleBytes = bench::liveBytes() - before;
+  double ruleSeconds = 0;
+  std::size_t expanded = pollHourly(manager, start, ruleSeconds);
+  manager.cancel(rule);
+
+  std::cout << "one notification per exam and offset (" << ids.size() << ")"
+            << std::endl;
+  bench::report("memory", materializedBytes / 1048576.0, "MiB");
+  bench::report("poll", materializedSeconds * 1e6 / kPollHours, "us");
+  bench::report("reminders", static_cast<double>(materialized), "");
+  std::cout << "one reminder rule" << std::endl;
+  bench::report("memory", ruleBytes / 1024.0, "KiB");
+  bench::report("poll", ruleSeconds * 1e6 / kPollHours, "us");
+  bench::report("reminders", static_cast<double>(expanded), "");
+  return 0;
+}
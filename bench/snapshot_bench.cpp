@@ -0,0 +1,111 @@
+// Cold start from a registry snapshot compared with rebuilding the registry.
+//
+// Usage: snapshot_bench [tasks] [path]   (default: 1000000 tasks)
+
+#include "BenchCommon.h"
+
+#include "../include/Registry.h"
+#include "../include/RegistrySnapshot.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 1000;
+
+void populate(Registry &registry, std::size_t taskCount) {
+  LabFactory labFactory;
+  ProjectFactory projectFactory;
+  ExamFactory examFactory;
+  TaskFactory *factories[] = {&labFactory, &projectFactory, &examFactory};
+
+  auto now = std::chrono::system_clock::now();
+  std::vector<std::shared_ptr<Task>> batch;
+
+  for (std::size_t first = 0; first < taskCount; first += kTasksPerSubject) {
+    std::string code = "SUBJ" + std::to_string(first / kTasksPerSubject);
+    auto subject = std::make_shared<Subject>("Subject " + code, code,
+                                             "Generated for the benchmark");
+    batch.clear();
+    for (std::size_t i = first; i < taskCount && i < first + kTasksPerSubject;
+         ++i) {
+      auto task = factories[i % 3]->createTask(
+          "Task " + std::to_string(i), now + std::chrono::hours(i % 2000),
+          "Description of task " + std::to_string(i));
+      if (i % 4 == 0) {
+        task->completeTask();
+        task->setMarks(static_cast<int>(i % 100));
+      } else if (i % 4 == 1) {
+        task->startTask();
+      }
+      batch.push_back(std::move(task));
+    }
+    subject->addTasks(batch);
+    registry.subjects[code] = subject;
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 1000000);
+  const std::string path = argc > 2 ? argv[2] : "registry_snapshot_bench.bin";
+  auto &registry = Registry::instance();
+
+  std::cout << "Registry snapshot benchmark, " << taskCount << " tasks"
+            << std::endl;
+
+  bench::Stopwatch watch;
+  populate(registry, taskCount);
+  bench::report("rebuild registry from scratch", watch.elapsedSeconds() * 1e3,
+                "ms");
+
+  watch.reset();
+  RegistrySnapshot::write(registry, path);
+  bench::report("write snapshot", watch.elapsedSeconds() * 1e3, "ms");
+
+  registry.subjects.clear();
+
+  watch.reset();
+  RegistrySnapshot snapshot = RegistrySnapshot::open(path);
+  bench::report("open snapshot (mmap + validate)",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  watch.reset();
+  std::size_t completed = 0;
+  long long marks = 0;
+  for (std::size_t i = 0; i < snapshot.taskCount(); ++i) {
+    SnapshotTask task = snapshot.task(i);
+    if (task.isCompleted()) {
+      ++completed;
+      marks += task.getMarks();
+    }
+  }
+  bench::report("scan marks from the mapping", watch.elapsedSeconds() * 1e3,
+                "ms");
+
+  watch.reset();
+  std::size_t titleBytes = 0;
+  for (std::size_t i = 0; i < snapshot.taskCount(); i += 1000) {
+    titleBytes += snapshot.task(i).getTitle().size();
+  }
+  bench::report("read 1 in 1000 titles lazily", watch.elapsedSeconds() * 1e3,
+                "ms");
+
+  watch.reset();
+  snapshot.restore(registry);
+  bench::report("restore (materialize every object)",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  bench::doNotOptimize(completed);
+  bench::doNotOptimize(marks);
+  bench::doNotOptimize(titleBytes);
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Cost of Subject::addTask, findTask and removeTask as a subject grows. With
+// the hashed title index each add and find is O(1); before it, adding n
+// tasks one at a time was O(n^2) title comparisons. Removal leaves a
+// tombstone, so removing from the front costs no more than from the tail.
+//
+// Usage: subject_title_bench [tasks]   (default: 200000)
+
+#include "BenchCommon.h"
+
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv) {
+  const std::size_t maxTasks = bench::sizeArg(argc, argv, 200000);
+  auto deadline = std::chrono::system_clock::now();
+  ProjectFactory factory;
+
+  std::cout << "Subject title index benchmark" << std::endl;
+  std::cout.setstate(std::ios::failbit);
+  for (std::size_t n = maxTasks / 100; n <= maxTasks; n *= 10) {
+    std::vector<std::shared_ptr<Task>> tasks;
+    tasks.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      tasks.push_back(factory.createTask("Project " + std::to_string(i),
+                                         deadline));
+    }
+    Subject subject("Capstone", "CAP" + std::to_string(n));
+
+    bench::Stopwatch watch;
+    for (const auto &task : tasks) {
+      subject.addTask(task);
+    }
+    double addNs = watch.elapsedSeconds() * 1e9 / static_cast<double>(n);
+
+    watch.reset();
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      found += subject.findTask("Project " + std::to_string(i)) ? 1 : 0;
+    }
+    double findNs = watch.elapsedSeconds() * 1e9 / static_cast<double>(n);
+
+    // Remove the newest tenth, which leaves the order of the rest intact.
+    std::size_t removals = n / 10;
+    watch.reset();
+    for (std::size_t i = 0; i < removals; ++i) {
+      subject.removeTask("Project " + std::to_string(n - 1 - i));
+    }
+    double removeTailNs =
+        watch.elapsedSeconds() * 1e9 / static_cast<double>(removals);
+
+    // Before tombstones, removing from the front shifted every later
+    // position.
+    removals = n / 100;
+    watch.reset();
+    for (std::size_t i = 0; i < removals; ++i) {
+      subject.removeTask("Project " + std::to_string(i));
+    }
+    double removeFrontNs =
+        watch.elapsedSeconds() * 1e9 / static_cast<double>(removals);
+
+    std::cout.clear();
+    std::cout << n << " tasks" << std::endl;
+    bench::report("addTask", addNs, "ns/task");
+    bench::report("findTask", findNs, "ns/task");
+    bench::report("removeTask (tail)", removeTailNs, "ns/task");
+    bench::report("removeTask (front)", removeFrontNs, "ns/task");
+    bench::doNotOptimize(found);
+    std::cout.setstate(std::ios::failbit);
+  }
+  std::cout.clear();
+  return 0;
+}
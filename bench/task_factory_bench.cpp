@@ -0,0 +1,81 @@
+// Task creation through the factories and TaskBuilder, which allocate from
+// per-type pools, against plain make_shared, plus create/destroy churn.
+//
+// Usage: task_factory_bench [tasks]   (default: 1000000)
+
+#include "AllocationCounter.h"
+#include "BenchCommon.h"
+
+#include "../include/Task.h"
+#include "../include/TaskBuilder.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kChurnRounds = 5;
+
+template <typename Create>
+void run(const std::string &label, std::size_t taskCount, Create &&create) {
+  std::vector<std::shared_ptr<Task>> tasks;
+  tasks.reserve(taskCount);
+  std::size_t allocations = bench::allocationCount();
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    tasks.push_back(create(i));
+  }
+  double seconds = watch.elapsedSeconds();
+  bench::report(label + ": created", taskCount / seconds / 1e6, "M tasks/s");
+  bench::report(label + ": heap allocations per task",
+                static_cast<double>(bench::allocationCount() - allocations) /
+                    static_cast<double>(taskCount),
+                "");
+
+  watch.reset();
+  for (int round = 0; round < kChurnRounds; ++round) {
+    for (std::size_t i = 0; i < taskCount; i += 2) {
+      tasks[i].reset();
+    }
+    for (std::size_t i = 0; i < taskCount; i += 2) {
+      tasks[i] = create(i);
+    }
+  }
+  double churned = kChurnRounds * static_cast<double>((taskCount + 1) / 2);
+  bench::report(label + ": churn", churned / watch.elapsedSeconds() / 1e6,
+                "M tasks/s");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 1000000);
+  auto deadline = std::chrono::system_clock::now();
+  // Titles repeat, as across students' copies of a course, so the string
+  // pool is not what is measured.
+  std::vector<std::string> titles;
+  for (int i = 0; i < 64; ++i) {
+    titles.push_back("Lab " + std::to_string(i));
+  }
+
+  std::cout << "Task factory benchmark, " << taskCount << " tasks"
+            << std::endl;
+
+  run("make_shared", taskCount, [&](std::size_t i) -> std::shared_ptr<Task> {
+    return std::make_shared<LabTask>(titles[i % titles.size()], deadline);
+  });
+
+  LabFactory factory;
+  run("pooled factory", taskCount, [&](std::size_t i) {
+    return factory.createTask(titles[i % titles.size()], deadline);
+  });
+
+  TaskBuilder builder;
+  builder.setDeadline(deadline);
+  run("builder", taskCount, [&](std::size_t i) {
+    return builder.setTitle(titles[i % titles.size()]).asLab().build();
+  });
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Task state transitions: start, complete, reopen, reopen, back to Pending,
+// repeated over many tasks, plus the SetTaskStateCommand path the registry
+// uses.
+//
+// Usage: task_state_bench [tasks]   (default: 200000)
+
+#include "BenchCommon.h"
+
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kRounds = 10;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 200000);
+  auto deadline = std::chrono::system_clock::now();
+
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  tasks.reserve(taskCount);
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    tasks.push_back(factory.createTask(std::to_string(i), deadline));
+  }
+
+  std::cout << "Task state benchmark, " << taskCount << " tasks, " << kRounds
+            << " rounds" << std::endl;
+
+  bench::Stopwatch watch;
+  std::size_t completed = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const auto &task : tasks) {
+      task->startTask();
+      task->completeTask();
+      completed += task->isCompleted() ? 1 : 0;
+      task->reopenTask();
+      task->reopenTask();
+    }
+  }
+  double transitions = 4.0 * kRounds * static_cast<double>(taskCount);
+  bench::report("transitions", watch.elapsedSeconds() * 1e9 / transitions,
+                "ns each");
+
+  watch.reset();
+  std::cout.setstate(std::ios::failbit);
+  for (const auto &task : tasks) {
+    SetTaskStateCommand(*task, std::make_shared<CompletedState>()).execute();
+    SetTaskStateCommand(*task, std::make_shared<PendingState>()).execute();
+  }
+  std::cout.clear();
+  bench::report("SetTaskStateCommand execute",
+                watch.elapsedSeconds() * 1e9 / (2.0 * taskCount), "ns each");
+
+  bench::doNotOptimize(completed);
+  return completed == kRounds * taskCount ? 0 : 1;
+}
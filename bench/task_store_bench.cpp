@@ -0,0 +1,97 @@
+// Per-subject analytics (average marks, completion rate, average progress)
+// computed by walking Task objects compared with one pass over the packed
+// TaskStore columns.
+//
+// Usage: task_store_bench [tasks]   (default: 5000000)
+
+#include "BenchCommon.h"
+
+#include "../include/PerformanceStrategy.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskStore.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 1000;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 5000000);
+  auto deadline = std::chrono::system_clock::now();
+
+  LabFactory labFactory;
+  ProjectFactory projectFactory;
+  ExamFactory examFactory;
+  TaskFactory *factories[] = {&labFactory, &projectFactory, &examFactory};
+
+  std::vector<std::shared_ptr<Subject>> subjects;
+  std::vector<std::shared_ptr<Task>> batch;
+  for (std::size_t first = 0; first < taskCount; first += kTasksPerSubject) {
+    auto subject = std::make_shared<Subject>(
+        "S", "S" + std::to_string(subjects.size()));
+    batch.clear();
+    for (std::size_t i = first; i < taskCount && i < first + kTasksPerSubject;
+         ++i) {
+      auto task = factories[i % 3]->createTask(std::to_string(i), deadline);
+      if (i % 5 == 0) {
+        task->completeTask();
+        task->setMarks(static_cast<int>(i % 100));
+      } else if (i % 5 == 1) {
+        task->startTask();
+      }
+      batch.push_back(std::move(task));
+    }
+    subject->addTasks(batch);
+    subjects.push_back(std::move(subject));
+  }
+
+  std::cout << "Task store benchmark, " << taskCount << " tasks in "
+            << subjects.size() << " subjects" << std::endl;
+  bench::report("string pool",
+                static_cast<double>(TaskStore::global().arenaBytes()) /
+                    (1 << 20),
+                "MiB");
+
+  AverageMarksStrategy marks;
+  CompletionRateStrategy completion;
+  AverageProgressStrategy progress;
+  const PerformanceStrategy *strategies[] = {&marks, &completion, &progress};
+
+  bench::Stopwatch watch;
+  double objectTotal = 0;
+  for (const auto &subject : subjects) {
+    TaskSpan tasks = subject->taskView();
+    for (const PerformanceStrategy *strategy : strategies) {
+      objectTotal += strategy->calculate(tasks);
+    }
+  }
+  bench::report("task objects: 3 strategies per subject",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  watch.reset();
+  auto stats = TaskStore::global().statsBySubject();
+  double columnTotal = 0;
+  for (const auto &subject : subjects) {
+    const TaskStats &subjectStats = stats[subject->getId()];
+    for (const PerformanceStrategy *strategy : strategies) {
+      columnTotal += strategy->calculate(subjectStats);
+    }
+  }
+  bench::report("columns: one pass, 3 strategies per subject",
+                watch.elapsedSeconds() * 1e3, "ms");
+
+  bench::doNotOptimize(objectTotal);
+  bool agree = objectTotal > columnTotal - 1e-6 * objectTotal &&
+               objectTotal < columnTotal + 1e-6 * objectTotal;
+  if (!agree) {
+    std::cout << "  results differ between objects and columns" << std::endl;
+  }
+  return agree ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Per-subject aggregation over Subject::getTasks() (a copied vector, one
+// reference count increment and decrement per task) compared with the
+// zero-copy taskView() and forEachTask().
+//
+// Usage: task_view_bench [tasks]   (default: 2000000)
+
+#include "BenchCommon.h"
+
+#include "../include/PerformanceStrategy.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 200;
+constexpr int kRounds = 10;
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t taskCount = bench::sizeArg(argc, argv, 2000000);
+  auto deadline = std::chrono::system_clock::now();
+
+  LabFactory labFactory;
+  std::vector<std::shared_ptr<Subject>> subjects;
+  std::vector<std::shared_ptr<Task>> batch;
+  for (std::size_t first = 0; first < taskCount; first += kTasksPerSubject) {
+    auto subject = std::make_shared<Subject>(
+        "S", "S" + std::to_string(subjects.size()));
+    batch.clear();
+    for (std::size_t i = first; i < taskCount && i < first + kTasksPerSubject;
+         ++i) {
+      auto task = labFactory.createTask(std::to_string(i), deadline);
+      if (i % 4 == 0) {
+        task->completeTask();
+      }
+      batch.push_back(std::move(task));
+    }
+    subject->addTasks(batch);
+    subjects.push_back(std::move(subject));
+  }
+
+  std::cout << "Task view benchmark, " << taskCount << " tasks in "
+            << subjects.size() << " subjects, " << kRounds << " rounds"
+            << std::endl;
+
+  CompletionRateStrategy completion;
+
+  bench::Stopwatch watch;
+  double copied = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const auto &subject : subjects) {
+      copied += completion.calculate(subject->getTasks());
+    }
+  }
+  double copiedMs = watch.elapsedSeconds() * 1e3;
+  bench::report("getTasks(): copied vector", copiedMs, "ms");
+
+  watch.reset();
+  double viewed = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const auto &subject : subjects) {
+      viewed += completion.calculate(subject->taskView());
+    }
+  }
+  double viewedMs = watch.elapsedSeconds() * 1e3;
+  bench::report("taskView(): span", viewedMs, "ms");
+
+  watch.reset();
+  std::size_t completed = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const auto &subject : subjects) {
+      subject->forEachTask([&](const Task &task) {
+        completed += task.isCompleted() ? 1 : 0;
+      });
+    }
+  }
+  bench::report("forEachTask(): completed count",
+                watch.elapsedSeconds() * 1e3, "ms");
+  bench::report("speedup of taskView() over getTasks()", copiedMs / viewedMs,
+                "x");
+
+  bench::doNotOptimize(copied);
+  bench::doNotOptimize(completed);
+  return copied == viewed ? 0 : 1;
+}
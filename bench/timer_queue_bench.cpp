@@ -0,0 +1,109 @@
+// NotificationManager's timer queues at scale: the binary heap against the
+// hierarchical timing wheel, arming timers an hour to a month out, cancelling
+// a tenth of them, peeking at the earliest and ticking a minute at a time
+// through three days.
+//
+// Usage: timer_queue_bench [timers]   (default: 10000000)
+
+#include "BenchCommon.h"
+
+#include "../include/TimerQueue.h"
+#include "../include/TimingWheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::int64_t kTickMinutes = 3 * 24 * 60;
+constexpr std::size_t kPeeks = 1000000;
+constexpr std::size_t kEarliestCancels = 1000;
+
+void run(const std::string &name, TimerQueue &queue, DateTime start,
+         const std::vector<DateTime> &times,
+         const std::vector<std::uint32_t> &cancels) {
+  std::cout << name << std::endl;
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    queue.schedule(NotificationId{static_cast<std::uint32_t>(i), 1}, times[i]);
+  }
+  bench::report("insert", watch.elapsedSeconds() * 1e9 / times.size(), "ns");
+
+  watch.reset();
+  for (std::uint32_t index : cancels) {
+    queue.unschedule(NotificationId{index, 1});
+  }
+  bench::report("cancel", watch.elapsedSeconds() * 1e9 / cancels.size(), "ns");
+
+  // What the scheduler asks for after every poll.
+  std::int64_t peeked = 0;
+  watch.reset();
+  for (std::size_t i = 0; i < kPeeks; ++i) {
+    peeked += queue.peek().has_value();
+  }
+  bench::report("peek", watch.elapsedSeconds() * 1e9 / kPeeks, "ns");
+  bench::doNotOptimize(peeked);
+
+  // Cancelling the earliest timer each time, as dismissing the next
+  // reminder does.
+  std::size_t cancelled = 0;
+  watch.reset();
+  for (; cancelled < kEarliestCancels && queue.size() > 0; ++cancelled) {
+    queue.unschedule(queue.peek()->id);
+  }
+  bench::report("cancel earliest + peek",
+                watch.elapsedSeconds() * 1e9 /
+                    std::max<std::size_t>(cancelled, 1),
+                "ns");
+
+  std::vector<TimerQueue::Timer> due;
+  std::size_t fired = 0;
+  watch.reset();
+  for (std::int64_t minute = 1; minute <= kTickMinutes; ++minute) {
+    due.clear();
+    queue.popDue(start + std::chrono::minutes(minute), due);
+    fired += due.size();
+  }
+  double elapsed = watch.elapsedSeconds();
+  bench::report("tick", elapsed * 1e9 / kTickMinutes, "ns/minute");
+  bench::report("tick per fired timer", elapsed * 1e9 / fired, "ns");
+  bench::report("fired", static_cast<double>(fired), "");
+  bench::doNotOptimize(due);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t count = bench::sizeArg(argc, argv, 10000000);
+  const DateTime start =
+      std::chrono::floor<std::chrono::minutes>(std::chrono::system_clock::now());
+
+  std::mt19937_64 random(42);
+  std::vector<DateTime> times(count);
+  for (DateTime &time : times) {
+    time = start + std::chrono::hours(1) +
+           std::chrono::seconds(random() % (30 * 24 * 3600));
+  }
+  std::vector<std::uint32_t> cancels(count / 10);
+  for (std::uint32_t &index : cancels) {
+    index = static_cast<std::uint32_t>(random() % count);
+  }
+
+  std::cout << "Timer queue benchmark, " << count << " timers, "
+            << cancels.size() << " cancels, " << kTickMinutes
+            << " one-minute ticks" << std::endl;
+  {
+    HeapTimerQueue heap;
+    run("binary heap", heap, start, times, cancels);
+  }
+  {
+    TimingWheel wheel(start);
+    run("timing wheel", wheel, start, times, cancels);
+  }
+  return 0;
+}
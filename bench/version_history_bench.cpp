@@ -0,0 +1,126 @@
+// Memory held by Registry's undo history of 1000 versions, against what
+// 1000 full copies of the registry would take, and the cost of undo and
+// redo across them. Then the cost of a state change in one large subject,
+// which should not grow with the subject since only the task is frozen.
+//
+// Usage: version_history_bench [subjects]   (default: 1000, 10 tasks each)
+
+#include "AllocationCounter.h"
+#include "BenchCommon.h"
+
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr std::size_t kTasksPerSubject = 10;
+constexpr std::size_t kVersions = 1000;
+constexpr std::size_t kLargeSubjectTasks = 100000;
+
+std::string subjectCode(std::size_t s) { return "SUBJ" + std::to_string(s); }
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t subjectCount = bench::sizeArg(argc, argv, 1000);
+  auto &registry = Registry::instance();
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+
+  std::cout.setstate(std::ios::failbit);
+  for (std::size_t s = 0; s < subjectCount; ++s) {
+    registry.createSubject("Subject " + std::to_string(s), subjectCode(s), "");
+    for (std::size_t t = 0; t < kTasksPerSubject; ++t) {
+      registry.createTask(subjectCode(s), "Task " + std::to_string(t),
+                          "Description of task " + std::to_string(t),
+                          deadline, static_cast<int>(t % 3) + 1);
+    }
+  }
+  for (int r = 0; r < 100; ++r) {
+    registry.createResume("CV " + std::to_string(r), "<p>Resume</p>");
+  }
+
+  // publish() freezes everything again; the old version is kept alive so
+  // the difference is one full copy. The first publish() drops setup's
+  // history and change log.
+  registry.publish();
+  auto held = registry.snapshot();
+  std::size_t beforeCopy = bench::liveBytes();
+  registry.publish();
+  double fullCopy = static_cast<double>(bench::liveBytes() - beforeCopy);
+  held.reset();
+
+  registry.setHistoryDepth(kVersions);
+  std::mt19937 rng(42);
+  bench::Stopwatch watch;
+  for (std::size_t i = 0; i < kVersions; ++i) {
+    std::size_t s = rng() % subjectCount;
+    switch (i % 10) {
+    case 8:
+      registry.createTask(subjectCode(s), "Extra " + std::to_string(i), "",
+                          deadline, 1);
+      break;
+    case 9:
+      registry.createResume("Extra " + std::to_string(i), "<p></p>");
+      break;
+    default:
+      registry.changeTaskState(subjectCode(s),
+                               static_cast<int>(rng() % kTasksPerSubject),
+                               static_cast<int>(rng() % 3));
+      break;
+    }
+  }
+  double commitSeconds = watch.elapsedSeconds();
+
+  watch.reset();
+  std::size_t undone = 0;
+  while (registry.undo()) {
+    ++undone;
+  }
+  double undoSeconds = watch.elapsedSeconds();
+  watch.reset();
+  while (registry.redo()) {
+  }
+  double redoSeconds = watch.elapsedSeconds();
+
+  std::size_t withHistory = bench::liveBytes();
+  registry.setHistoryDepth(1);
+  double retained = static_cast<double>(withHistory - bench::liveBytes());
+
+  registry.createSubject("Large", "LARGE", "");
+  for (std::size_t t = 0; t < kLargeSubjectTasks; ++t) {
+    registry.createTask("LARGE", "Task " + std::to_string(t), "", deadline,
+                        1);
+  }
+  watch.reset();
+  for (std::size_t i = 0; i < kVersions; ++i) {
+    registry.changeTaskState("LARGE",
+                             static_cast<int>(rng() % kLargeSubjectTasks),
+                             static_cast<int>(rng() % 3));
+  }
+  double largeSeconds = watch.elapsedSeconds();
+  std::cout.clear();
+
+  std::cout << "Version history benchmark, " << subjectCount << " subjects x "
+            << kTasksPerSubject << " tasks, " << kVersions << " versions"
+            << std::endl;
+  bench::report("one full copy of the registry", fullCopy / 1024.0, "KiB");
+  bench::report("1000 full copies (estimate)",
+                fullCopy * kVersions / (1024.0 * 1024.0), "MiB");
+  bench::report("retained by the history", retained / (1024.0 * 1024.0),
+                "MiB");
+  bench::report("retained per version", retained / (kVersions - 1) / 1024.0,
+                "KiB");
+  bench::report("mutation", commitSeconds * 1e6 / kVersions, "us");
+  bench::report("undo", undoSeconds * 1e6 / static_cast<double>(undone),
+                "us");
+  bench::report("redo", redoSeconds * 1e6 / static_cast<double>(undone),
+                "us");
+  std::cout << "one subject of " << kLargeSubjectTasks << " tasks"
+            << std::endl;
+  bench::report("state change", largeSeconds * 1e6 / kVersions, "us");
+  return 0;
+}
@@ -0,0 +1,65 @@
+// Durable append throughput: one fsync per operation compared with group
+// commit, for a growing number of concurrent writers.
+//
+// Usage: wal_bench [ops per thread] [path]   (default: 200 ops per thread)
+
+#include "BenchCommon.h"
+
+#include "../include/WriteAheadLog.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void run(const std::string &path, WriteAheadLog::SyncMode mode,
+         const char *modeName, int threads, std::size_t opsPerThread) {
+  std::remove(path.c_str());
+  WriteAheadLog log(path, mode);
+
+  bench::Stopwatch watch;
+  std::vector<std::thread> writers;
+  for (int t = 0; t < threads; ++t) {
+    writers.emplace_back([&log, t, opsPerThread] {
+      for (std::size_t i = 0; i < opsPerThread; ++i) {
+        log.append({WalOp::CreateTask,
+                    {"SUBJ" + std::to_string(t), "Task " + std::to_string(i),
+                     "Generated for the benchmark"},
+                    {static_cast<std::int64_t>(i), 1}});
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  double seconds = watch.elapsedSeconds();
+
+  double ops = static_cast<double>(threads) * opsPerThread;
+  std::string label = std::string(modeName) + ", " + std::to_string(threads) +
+                      " threads";
+  bench::report(label + " (ops/s)", ops / seconds, "ops/s");
+  bench::report(label + " (ops/fsync)",
+                ops / static_cast<double>(log.syncCount()), "ops");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const std::size_t opsPerThread = bench::sizeArg(argc, argv, 200);
+  const std::string path = argc > 2 ? argv[2] : "registry_wal_bench.log";
+
+  std::cout << "Write-ahead log benchmark, " << opsPerThread
+            << " appends per thread" << std::endl;
+
+  for (int threads : {1, 4, 16}) {
+    run(path, WriteAheadLog::SyncMode::PerOperation, "fsync per op", threads,
+        opsPerThread);
+    run(path, WriteAheadLog::SyncMode::GroupCommit, "group commit", threads,
+        opsPerThread);
+  }
+
+  std::remove(path.c_str());
+  return 0;
+}
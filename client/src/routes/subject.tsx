@@ -14,7 +14,7 @@ import {
 
 import { CreateTaskDialog } from "@/components/CreateTaskDialog";
 import { Button } from "@/components/ui/button";
-import { UndoIcon } from "lucide-react";
+import { RedoIcon, UndoIcon } from "lucide-react";
 
 const subjectRoute = createRoute({
   getParentRoute: () => rootRoute,
@@ -68,6 +68,16 @@ function Route() {
             <UndoIcon />
             Undo
           </Button>
+          <Button
+            variant={"ghost"}
+            onClick={() => {
+              at.redoLastTaskCommand();
+              router.invalidate();
+            }}
+          >
+            <RedoIcon />
+            Redo
+          </Button>
           <CreateTaskDialog />
         </div>
       </div>
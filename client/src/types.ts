@@ -56,7 +56,7 @@ export type AcademicTracker = {
     description: string,
     deadline: string,
     type: number,
-  ) => void;
+  ) => string;
 
   convertMarkdownToHtml: (markdown: string) => string;
   convertAsciiDocToHtml: (asciidoc: string) => string;
@@ -80,4 +80,5 @@ export type AcademicTracker = {
   ) => void;
 
   undoLastTaskCommand: () => void;
+  redoLastTaskCommand: () => void;
 };
@@ -0,0 +1,103 @@
+#ifndef BULK_IMPORTER_H
+#define BULK_IMPORTER_H
+
+#include "Subject.h"
+#include "Task.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct Registry;
+
+// Rows parsed from one chunk of input, ready for Registry::importBatch.
+// Tasks are grouped into runs of consecutive rows for the same subject.
+struct ImportBatch {
+  std::vector<std::shared_ptr<Subject>> subjects;
+  std::vector<std::pair<std::string, std::vector<std::shared_ptr<Task>>>>
+      tasks;
+};
+
+struct ImportError {
+  std::size_t line;
+  std::string message;
+};
+
+struct ImportStats {
+  std::size_t subjects = 0;
+  std::size_t tasks = 0;
+  // Well-formed rows the registry refused: duplicate subject codes or task
+  // titles, and tasks whose subject does not exist.
+  std::size_t rejected = 0;
+  // Rows that could not be parsed; the first few are described in errors.
+  std::size_t malformed = 0;
+  std::vector<ImportError> errors;
+};
+
+// Loads subjects and tasks in bulk from CSV or JSON Lines.
+//
+// CSV rows (RFC 4180 quoting; blank lines, '#' comments and a header row
+// whose first field is "kind" are skipped):
+//
+//   S,<code>,<name>,<description>
+//   T,<subject code>,<title>,<description>,<deadline>,<type>[,<state>,<marks>]
+//
+// JSON Lines holds one flat object per line with the same information:
+//
+//   {"kind":"subject","code":..,"name":..,"description":..}
+//   {"kind":"task","subject":..,"title":..,"description":..,"deadline":..,
+//    "type":..,"state":..,"marks":..}
+//
+// Quoted CSV fields may contain commas and doubled quotes but not line
+// breaks, so chunks can be cut at any newline.
+//
+// Deadlines are ISO 8601, YYYY-MM-DD[THH:MM[:SS]][Z|+HH:MM|-HH:MM]; without
+// an offset they are local time, like the deadlines entered in the UI. Types
+// are Lab/Project/Exam or 1/2/3 as in Registry::createTask, states are
+// Pending/InProgress/Completed or 0/1/2 as in Registry::changeTaskState.
+// Marks only stick to completed tasks, as with Task::setMarks.
+//
+// Input is cut into chunks at line boundaries and the chunks are parsed on
+// worker threads straight from the buffer, copying only the strings a Subject
+// or Task keeps. Parsed chunks are handed to the registry in input order, one
+// importBatch() call per chunk, while later chunks are still being parsed.
+class BulkImporter {
+public:
+  enum class Format { Csv, JsonLines };
+
+  struct Options {
+    Format format = Format::Csv;
+    // 0 uses one worker per hardware thread.
+    std::size_t threads = 0;
+    // Bytes of input per parsing task and registry batch.
+    std::size_t chunkBytes = std::size_t(1) << 20;
+    // Bytes read from a file at a time by importFile().
+    std::size_t blockBytes = std::size_t(32) << 20;
+    std::size_t maxErrors = 100;
+  };
+
+private:
+  Registry &registry_;
+  Options options_;
+
+  // Imports whole lines; returns how many lines the block held.
+  std::size_t importBlock(std::string_view block, std::size_t firstLine,
+                          ImportStats &stats);
+
+public:
+  explicit BulkImporter(Registry &registry);
+  BulkImporter(Registry &registry, const Options &options);
+
+  ImportStats importBuffer(std::string_view data);
+  // Streams the file in blocks of options.blockBytes. Throws
+  // std::runtime_error when it cannot be read.
+  ImportStats importFile(const std::string &path);
+
+  // The deadline parser, iso_date::parse. Returns false when text is not a
+  // valid ISO 8601 date.
+  static bool parseDateTime(std::string_view text, DateTime &out);
+};
+
+#endif // BULK_IMPORTER_H
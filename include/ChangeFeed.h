@@ -0,0 +1,98 @@
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include "TaskListener.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Subject;
+
+enum class EntityKind : std::uint8_t { Subject, Task, Internship, Resume };
+enum class ChangeType : std::uint8_t { Created, Updated, Deleted };
+
+// A task is identified by its subject code and title; every other entity by
+// its key in the registry (subject code, internship or resume id).
+struct Change {
+  std::uint64_t generation;
+  EntityKind kind;
+  ChangeType type;
+  std::string key;
+  std::string subject;
+};
+
+struct ChangeSet {
+  // Pass this to the next changesSince() call.
+  std::uint64_t generation = 0;
+  // False when the requested generation is older than the retained log or
+  // the registry was rebuilt since (Registry::publish); the caller must then
+  // reload everything.
+  bool complete = true;
+  // At most one entry per entity, in the order of its last change.
+  std::vector<Change> changes;
+};
+
+// Log of what changed in a registry, stamped with a generation number that
+// grows by one per change. Task events arrive through the TaskListener
+// interface from attached subjects; the registry records subject, internship
+// and resume events itself. Only the newest `capacity` changes are kept.
+class ChangeFeed : public TaskListener {
+private:
+  struct EntityHash {
+    std::size_t operator()(const Change &change) const;
+  };
+  struct EntityEqual {
+    bool operator()(const Change &a, const Change &b) const;
+  };
+
+  std::size_t capacity_;
+  std::deque<Change> log_;
+  std::atomic<std::uint64_t> generation_{0};
+  // Requests for generations before this cannot be answered from the log.
+  std::uint64_t horizon_ = 0;
+  // Generation of the last change to each live entity.
+  std::unordered_set<Change, EntityHash, EntityEqual> stamps_;
+  std::unordered_set<Subject *> attached_;
+
+  void taskEvent(Task &task, ChangeType type);
+
+public:
+  explicit ChangeFeed(std::size_t capacity = 65536);
+  ~ChangeFeed() override;
+
+  ChangeFeed(const ChangeFeed &) = delete;
+  ChangeFeed &operator=(const ChangeFeed &) = delete;
+
+  void attach(Subject &subject);
+  void detach(Subject &subject);
+  void clear();
+
+  void record(EntityKind kind, ChangeType type, const std::string &key,
+              const std::string &subject = "");
+  // Forgets all history: every earlier generation becomes incomplete.
+  void reset();
+
+  std::uint64_t generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+  // Generation of the entity's last change, or 0 if it has none on record.
+  std::uint64_t stamp(EntityKind kind, const std::string &key,
+                      const std::string &subject = "") const;
+  ChangeSet changesSince(std::uint64_t generation) const;
+
+  void onTaskAdded(Task &task) override;
+  void onTaskRemoved(Task &task) override;
+  void onDeadlineChanged(Task &task, const DateTime &previous) override;
+  void onStateChanged(Task &task) override;
+  void onMarksChanged(Task &task) override;
+  void onDescriptionChanged(Task &task) override;
+  void onTitleChanged(Task &task, const std::string &previous) override;
+  void onSubjectDestroyed(Subject &subject) override;
+};
+
+#endif // CHANGE_FEED_H
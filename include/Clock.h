@@ -0,0 +1,76 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using DateTime = std::chrono::system_clock::time_point;
+
+// Where a NotificationScheduler gets the time from and how it sleeps until
+// a given time. SystemClock is the wall clock; VirtualClock only moves when
+// told to, so tests and benchmarks can run days of timers in no time.
+class Clock {
+public:
+  virtual ~Clock() = default;
+
+  virtual DateTime now() const = 0;
+
+  // Blocks on wake, whose mutex lock holds, until deadline on this clock or
+  // until wake is notified. May return early; callers check again.
+  virtual void waitUntil(std::unique_lock<std::mutex> &lock,
+                         std::condition_variable &wake,
+                         const DateTime &deadline) = 0;
+
+  // A waiter that must also be woken when the clock moves by other means
+  // than the passing of time. Not called with mutex held.
+  virtual void attach(std::mutex &mutex, std::condition_variable &wake) {
+    (void)mutex;
+    (void)wake;
+  }
+  virtual void detach(std::condition_variable &wake) { (void)wake; }
+};
+
+class SystemClock : public Clock {
+public:
+  static SystemClock &instance();
+
+  DateTime now() const override;
+  void waitUntil(std::unique_lock<std::mutex> &lock,
+                 std::condition_variable &wake,
+                 const DateTime &deadline) override;
+};
+
+// Time stands still until advance() or set(), which wake every attached
+// waiter. It never goes backwards.
+class VirtualClock : public Clock {
+private:
+  struct Waiter {
+    std::mutex *mutex;
+    std::condition_variable *wake;
+  };
+
+  std::atomic<DateTime::rep> now_;
+  std::mutex mutex_;
+  std::vector<Waiter> waiters_;
+
+  void wakeAll();
+
+public:
+  explicit VirtualClock(const DateTime &start = DateTime());
+
+  DateTime now() const override;
+  void waitUntil(std::unique_lock<std::mutex> &lock,
+                 std::condition_variable &wake,
+                 const DateTime &deadline) override;
+  void attach(std::mutex &mutex, std::condition_variable &wake) override;
+  void detach(std::condition_variable &wake) override;
+
+  void advance(DateTime::duration by);
+  // Ignored when time is earlier than now().
+  void set(const DateTime &time);
+};
+
+#endif // CLOCK_H
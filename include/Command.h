@@ -1,13 +1,28 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
+#include "SlotMap.h"
+#include <cstdint>
 #include <memory>
 
+enum class TaskStateKind : std::uint8_t;
+
+// A command as CommandManager keeps it in its history: a few plain bytes
+// instead of an object. Only a change between built-in task states has one.
+struct CommandRecord {
+  TaskId task;
+  TaskStateKind from;
+  TaskStateKind to;
+};
+
 class Command {
 public:
   virtual ~Command() = default;
   virtual void execute() = 0;
   virtual void undo() = 0;
+  // After execute(), describes the command as a record if it can be undone
+  // and redone from one; otherwise the history keeps the object.
+  virtual bool compact(CommandRecord &) const { return false; }
 };
 
 #endif // COMMAND_H
@@ -0,0 +1,100 @@
+#ifndef COMMAND_EXECUTOR_H
+#define COMMAND_EXECUTOR_H
+
+#include "Command.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+class CommandManager;
+
+// Runs a CommandManager on its own apply thread. Producers on any thread
+// push commands into a lock-free multi-producer single-consumer queue
+// (D. Vyukov's intrusive design: one atomic exchange per push) and return
+// at once; the apply thread drains everything queued in one batch per
+// wakeup and executes it in submission order, so mutations are serialized
+// without a lock around the history. Commands from one producer are applied
+// in the order it submitted them.
+//
+// While an executor is running, its CommandManager and the tasks its
+// commands touch belong to the apply thread: submit undo and redo here
+// rather than calling the manager directly. Completions run on the apply
+// thread. The destructor applies whatever is still queued.
+class CommandExecutor {
+public:
+  // Called with null on success, or with what execute() threw. Must not
+  // throw.
+  using Completion = std::function<void(std::exception_ptr)>;
+
+private:
+  enum class Action : std::uint8_t { Execute, Undo, Redo, Flush };
+
+  struct Node {
+    std::atomic<Node *> next{nullptr};
+    Action action = Action::Flush;
+    std::shared_ptr<Command> command;
+    std::optional<std::promise<void>> promise;
+    Completion done;
+  };
+
+  CommandManager &history_;
+
+  // Producers swing head_; only the apply thread touches tail_. stub_ keeps
+  // the list non-empty so a push never has to look at the consumer's end.
+  std::atomic<Node *> head_;
+  Node *tail_;
+  Node stub_;
+  // Pushed but not yet applied; the apply thread only sleeps at 0.
+  std::atomic<std::size_t> pending_{0};
+
+  // Parking for the apply thread when idle; producers only take the mutex
+  // when it is asleep.
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::atomic<bool> sleeping_{false};
+  bool stopping_ = false;
+
+  std::atomic<std::uint64_t> applied_{0};
+  std::atomic<std::uint64_t> batches_{0};
+
+  std::thread worker_;
+
+  void push(Node *node);
+  // Null when empty, or while a producer is between its two stores.
+  Node *pop();
+  // Counts, pushes and wakes the apply thread if it sleeps.
+  void post(Node *node);
+  std::future<void> post(Action action, std::shared_ptr<Command> command);
+  void apply(Node &node);
+  void run();
+
+public:
+  explicit CommandExecutor(CommandManager &history);
+  ~CommandExecutor();
+
+  CommandExecutor(const CommandExecutor &) = delete;
+  CommandExecutor &operator=(const CommandExecutor &) = delete;
+
+  // CommandManager::executeCommand on the apply thread. The future becomes
+  // ready once the command is in the history, or holds what it threw.
+  std::future<void> submit(std::shared_ptr<Command> command);
+  void submit(std::shared_ptr<Command> command, Completion done);
+  std::future<void> submitUndo();
+  std::future<void> submitRedo();
+  // Ready once everything submitted before it has been applied.
+  std::future<void> flush();
+
+  // Submissions applied so far, and the batches they were drained in.
+  std::uint64_t applied() const { return applied_.load(); }
+  std::uint64_t batches() const { return batches_.load(); }
+};
+
+#endif // COMMAND_EXECUTOR_H
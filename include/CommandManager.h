@@ -2,17 +2,45 @@
 #define COMMAND_MANAGER_H
 
 #include "Command.h"
+#include <cstddef>
 #include <memory>
 #include <vector>
 
+class CompositeCommand;
+class Task;
+
+// Undo and redo history. instance() belongs to the default registry;
+// registries in a RegistryPool own one each.
+//
+// The history is a ring of depth() CommandRecords: the oldest command is
+// dropped once it is full, so memory stays fixed however long the session
+// runs. Entries before the cursor can be undone and entries after it
+// redone; executing a new command discards the redo side. Commands that do
+// not compact to a record (custom task states) are kept as objects beside
+// the ring.
 class CommandManager {
+public:
+  static constexpr std::size_t kDefaultDepth = 1024;
+
 private:
-  std::vector<std::shared_ptr<Command>> history_;
+  std::vector<CommandRecord> ring_;
+  // Same length as ring_ once any command failed to compact; the entry at a
+  // slot is that command, or null when the record is used.
+  std::vector<std::shared_ptr<Command>> objects_;
+  std::size_t oldest_ = 0;
+  std::size_t undoable_ = 0;
+  std::size_t redoable_ = 0;
 
-  CommandManager() = default;
-  ~CommandManager() = default;
+  std::size_t slot(std::size_t position) const {
+    return (oldest_ + position) % ring_.size();
+  }
+  void release(std::size_t position);
+  void push(const CommandRecord &record, std::shared_ptr<Command> object);
 
 public:
+  explicit CommandManager(std::size_t depth = kDefaultDepth);
+  ~CommandManager() = default;
+
   static CommandManager &instance();
 
   CommandManager(const CommandManager &) = delete;
@@ -21,8 +49,23 @@ public:
   CommandManager &operator=(CommandManager &&) = delete;
 
   void executeCommand(std::shared_ptr<Command> command);
+  // SetTaskStateCommand without the object: allocation-free once the ring
+  // exists, unless the task is in a custom state.
+  void executeStateChange(Task &task, TaskStateKind target);
+  // Applies the whole batch as one history entry. Returns false, recording
+  // nothing, if it was not applied; exceptions from a step propagate after
+  // the batch has been rolled back.
+  bool executeTransaction(std::shared_ptr<CompositeCommand> transaction);
+
   void undoLastCommand();
+  void redoLastCommand();
   bool canUndo() const;
+  bool canRedo() const;
+
+  std::size_t depth() const { return ring_.size(); }
+  // Keeps the newest commands that fit and drops anything to redo. Throws
+  // std::invalid_argument for 0.
+  void setDepth(std::size_t depth);
 
   void clearHistory();
 };
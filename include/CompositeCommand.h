@@ -0,0 +1,50 @@
+#ifndef COMPOSITE_COMMAND_H
+#define COMPOSITE_COMMAND_H
+
+#include "Command.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Task;
+class TaskState;
+
+// A batch of task state changes applied as one transaction: either every
+// step takes effect or none does, the batch logs one line, and
+// CommandManager keeps it as a single history entry so one undo reverts the
+// whole batch. Listeners still see each task's change, since the indexes
+// behind them track tasks individually.
+class CompositeCommand : public Command {
+private:
+  struct Step {
+    CommandRecord record;
+    // Restored by undo; reopening clears marks.
+    std::int32_t marks;
+  };
+
+  std::vector<Step> steps_;
+  // Tasks that were in a custom state, by step, in step order.
+  std::vector<std::pair<std::size_t, std::shared_ptr<TaskState>>> custom_;
+  bool applied_ = false;
+
+  // Reverts steps [0, count) in reverse order.
+  void revert(std::size_t count);
+
+public:
+  CompositeCommand() = default;
+
+  void reserve(std::size_t steps) { steps_.reserve(steps); }
+  void addStateChange(Task &task, TaskStateKind target);
+  std::size_t size() const { return steps_.size(); }
+  // Whether the last execute() took effect.
+  bool applied() const { return applied_; }
+
+  // Applies nothing if a task has been destroyed. If a step throws, the
+  // steps before it are reverted and the exception propagates.
+  void execute() override;
+  void undo() override;
+};
+
+#endif // COMPOSITE_COMMAND_H
@@ -0,0 +1,92 @@
+#ifndef DEADLINE_INDEX_H
+#define DEADLINE_INDEX_H
+
+#include "Task.h"
+#include "TaskBitmapIndex.h"
+#include "TaskListener.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+class Subject;
+
+// A task as returned by deadline queries. The pointer stays valid until the
+// task is removed from its subject or the subject is destroyed.
+struct DueTask {
+  DateTime deadline;
+  Task *task;
+
+  bool operator<(const DueTask &other) const {
+    return deadline < other.deadline ||
+           (deadline == other.deadline && std::less<Task *>()(task, other.task));
+  }
+};
+
+// Ordered index of the tasks of every attached subject, kept current through
+// the TaskListener events. Open (not completed) tasks are also kept in a
+// second set so overdue() and nextDue() never step over completed work.
+class DeadlineIndex : public TaskListener {
+private:
+  std::set<DueTask> all_;
+  std::set<DueTask> open_;
+  std::unordered_set<Subject *> attached_;
+
+  void insert(Task &task);
+  void erase(Task &task, const DateTime &deadline);
+
+public:
+  DeadlineIndex() = default;
+  ~DeadlineIndex() override;
+
+  DeadlineIndex(const DeadlineIndex &) = delete;
+  DeadlineIndex &operator=(const DeadlineIndex &) = delete;
+
+  // Indexes the subject's tasks and follows its changes from now on.
+  void attach(Subject &subject);
+  void detach(Subject &subject);
+  void clear();
+
+  // Tasks with from <= deadline < to, in deadline order.
+  std::vector<DueTask> tasksDueBetween(const DateTime &from,
+                                       const DateTime &to) const;
+  // Open tasks matching filter with from <= deadline < to, in deadline
+  // order, at most limit of them. Tasks the filter rejects are stepped over.
+  std::vector<DueTask> openDueBetween(const DateTime &from, const DateTime &to,
+                                      const TaskFilter &filter,
+                                      std::size_t limit = SIZE_MAX) const;
+  // The same tasks handed to fn(const DueTask &) one at a time.
+  template <typename Fn>
+  void forEachOpenDue(const DateTime &from, const DateTime &to,
+                      const TaskFilter &filter, std::size_t limit,
+                      Fn &&fn) const {
+    std::size_t found = 0;
+    for (auto it = open_.lower_bound(DueTask{from, nullptr});
+         it != open_.end() && it->deadline < to && found < limit; ++it) {
+      if (filter.matches(*it->task)) {
+        fn(*it);
+        ++found;
+      }
+    }
+  }
+  // The k earliest open tasks whose deadline is at or after now.
+  std::vector<DueTask> nextDue(std::size_t k, const DateTime &now) const;
+  // Open tasks whose deadline is before now, earliest first.
+  std::vector<DueTask> overdue(const DateTime &now) const;
+
+  std::size_t size() const { return all_.size(); }
+  std::size_t openCount() const { return open_.size(); }
+
+  void onTaskAdded(Task &task) override;
+  void onTaskRemoved(Task &task) override;
+  void onDeadlineChanged(Task &task, const DateTime &previous) override;
+  void onStateChanged(Task &task) override;
+  void onMarksChanged(Task &task) override;
+  void onDescriptionChanged(Task &task) override;
+  void onTitleChanged(Task &task, const std::string &previous) override;
+  void onSubjectDestroyed(Subject &subject) override;
+};
+
+#endif // DEADLINE_INDEX_H
@@ -0,0 +1,221 @@
+#ifndef INTERNED_MAP_H
+#define INTERNED_MAP_H
+
+#include "SymbolTable.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// String-keyed flat hash map whose keys are interned in a shared SymbolTable.
+// The index is an open-addressing table of (hash, entry) pairs with linear
+// probing; entries live densely in insertion order, so iteration is a vector
+// walk. Slots carry the interned key pointer, so the key compare and the
+// entry load are independent and a hit costs two dependent cache misses.
+// erase() moves the last entry into the hole, so it reorders and invalidates
+// iterators the same way std::vector does.
+template <typename V> class InternedMap {
+public:
+  using key_type = std::string_view;
+  using mapped_type = V;
+  using value_type = std::pair<std::string_view, V>;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+  struct Slot {
+    const char *key;
+    std::uint32_t hash;
+    std::uint32_t entry; // entry index + 1, 0 marks an empty slot
+  };
+
+  static constexpr std::size_t kInitialSlots = 8;
+
+  SymbolTable *symbols_;
+  std::vector<value_type> entries_;
+  std::vector<Slot> slots_;
+
+  std::size_t mask() const { return slots_.size() - 1; }
+
+  std::size_t probe(std::uint32_t hash, std::string_view key) const {
+    std::size_t index = hash & mask();
+    while (slots_[index].entry != 0) {
+      const Slot &slot = slots_[index];
+      if (slot.hash == hash && SymbolTable::equals(slot.key, key)) {
+        break;
+      }
+      index = (index + 1) & mask();
+    }
+    return index;
+  }
+
+  // Interned keys are unique, so a key is identified by its data pointer.
+  std::size_t probeInterned(std::uint32_t hash, const char *key) const {
+    std::size_t index = hash & mask();
+    while (slots_[index].entry != 0 && slots_[index].key != key) {
+      index = (index + 1) & mask();
+    }
+    return index;
+  }
+
+  std::uint32_t lookup(std::string_view key) const {
+    if (entries_.empty()) {
+      return 0;
+    }
+    return slots_[probe(SymbolTable::hash(key), key)].entry;
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<Slot> fresh(capacity, Slot{nullptr, 0, 0});
+    std::size_t freshMask = capacity - 1;
+    for (const Slot &slot : slots_) {
+      if (slot.entry == 0) {
+        continue;
+      }
+      std::size_t index = slot.hash & freshMask;
+      while (fresh[index].entry != 0) {
+        index = (index + 1) & freshMask;
+      }
+      fresh[index] = slot;
+    }
+    slots_.swap(fresh);
+  }
+
+  // Backward-shift deletion keeps probe chains intact without tombstones.
+  void removeSlot(std::size_t hole) {
+    std::size_t next = (hole + 1) & mask();
+    while (slots_[next].entry != 0) {
+      std::size_t home = slots_[next].hash & mask();
+      if (((next - home) & mask()) >= ((next - hole) & mask())) {
+        slots_[hole] = slots_[next];
+        hole = next;
+      }
+      next = (next + 1) & mask();
+    }
+    slots_[hole] = Slot{nullptr, 0, 0};
+  }
+
+public:
+  explicit InternedMap(SymbolTable &symbols) : symbols_(&symbols) {}
+
+  InternedMap(const InternedMap &) = delete;
+  InternedMap &operator=(const InternedMap &) = delete;
+
+  V &operator[](std::string_view key) {
+    if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+      rehash(slots_.empty() ? kInitialSlots : slots_.size() * 2);
+    }
+
+    std::uint32_t hash = SymbolTable::hash(key);
+    std::size_t index = probe(hash, key);
+    if (slots_[index].entry == 0) {
+      SymbolId id = symbols_->intern(key, hash);
+      entries_.emplace_back(symbols_->name(id), V{});
+      slots_[index] = Slot{entries_.back().first.data(), hash,
+                           static_cast<std::uint32_t>(entries_.size())};
+    }
+    return entries_[slots_[index].entry - 1].second;
+  }
+
+  iterator find(std::string_view key) {
+    std::uint32_t entry = lookup(key);
+    return entry == 0 ? entries_.end() : entries_.begin() + (entry - 1);
+  }
+
+  const_iterator find(std::string_view key) const {
+    std::uint32_t entry = lookup(key);
+    return entry == 0 ? entries_.end() : entries_.begin() + (entry - 1);
+  }
+
+  // Lookup by an id obtained from the shared SymbolTable; compares integers
+  // instead of key bytes.
+  iterator findId(SymbolId id) {
+    if (entries_.empty() || id >= symbols_->size()) {
+      return entries_.end();
+    }
+    std::uint32_t entry =
+        slots_[probeInterned(symbols_->hashOf(id), symbols_->name(id).data())]
+            .entry;
+    return entry == 0 ? entries_.end() : entries_.begin() + (entry - 1);
+  }
+
+  V &at(std::string_view key) {
+    auto it = find(key);
+    if (it == entries_.end()) {
+      throw std::out_of_range("InternedMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  const V &at(std::string_view key) const {
+    auto it = find(key);
+    if (it == entries_.end()) {
+      throw std::out_of_range("InternedMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  std::size_t count(std::string_view key) const {
+    return lookup(key) != 0 ? 1 : 0;
+  }
+
+  std::size_t erase(std::string_view key) {
+    if (entries_.empty()) {
+      return 0;
+    }
+
+    std::size_t index = probe(SymbolTable::hash(key), key);
+    if (slots_[index].entry == 0) {
+      return 0;
+    }
+
+    std::size_t removed = slots_[index].entry - 1;
+    std::size_t last = entries_.size() - 1;
+    removeSlot(index);
+
+    if (removed != last) {
+      std::string_view moved = entries_[last].first;
+      slots_[probeInterned(SymbolTable::hash(moved), moved.data())].entry =
+          static_cast<std::uint32_t>(removed + 1);
+      entries_[removed] = std::move(entries_[last]);
+    }
+    entries_.pop_back();
+    return 1;
+  }
+
+  void clear() {
+    entries_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot{nullptr, 0, 0});
+  }
+
+  void reserve(std::size_t n) {
+    entries_.reserve(n);
+    std::size_t capacity = slots_.empty() ? kInitialSlots : slots_.size();
+    while (n * 4 > capacity * 3) {
+      capacity *= 2;
+    }
+    if (capacity != slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // Bytes owned by this map, excluding the shared symbol table and whatever
+  // the mapped values point to.
+  std::size_t memoryUsage() const {
+    return entries_.capacity() * sizeof(value_type) +
+           slots_.capacity() * sizeof(Slot);
+  }
+};
+
+#endif // INTERNED_MAP_H
@@ -0,0 +1,104 @@
+#ifndef ISO_DATE_H
+#define ISO_DATE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+using DateTime = std::chrono::system_clock::time_point;
+
+// Parsing and formatting of ISO 8601 dates without the C library's
+// broken-down time: calendar arithmetic is done on day numbers, and the
+// local UTC offset is looked up once per day and cached per thread, so
+// neither direction allocates or takes the global locale or timezone lock.
+// The cache assumes TZ does not change while the process runs.
+namespace iso_date {
+
+struct CivilDate {
+  std::int64_t year;
+  unsigned month;
+  unsigned day;
+};
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar (H. Hinnant).
+constexpr std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// Inverse of daysFromCivil.
+constexpr CivilDate civilFromDays(std::int64_t z) {
+  z += 719468;
+  const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+  const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+  return {static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+constexpr unsigned daysInMonth(std::int64_t year, unsigned month) {
+  constexpr unsigned days[] = {31, 28, 31, 30, 31, 30,
+                               31, 31, 30, 31, 30, 31};
+  bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  return month == 2 && leap ? 29 : days[month - 1];
+}
+
+static_assert(daysFromCivil(2000, 3, 1) == 11017, "");
+static_assert(civilFromDays(11017).year == 2000 &&
+                  civilFromDays(11017).month == 3,
+              "");
+
+// Seconds local time is ahead of UTC at the instant utcSeconds.
+std::int64_t utcOffset(std::int64_t utcSeconds);
+// Seconds local time is ahead of UTC when local clocks read localSeconds
+// (seconds since the epoch as if local time were UTC). For a wall-clock
+// time repeated by a DST change this is the offset mktime picks.
+std::int64_t localOffset(std::int64_t localSeconds);
+
+// YYYY-MM-DD[THH:MM[:SS[.fff]]][Z|+HH:MM|-HH:MM], with ' ' also accepted
+// before the time. Without an offset the time is local. Fractions of a
+// second are accepted and dropped. Returns false for anything else,
+// including dates that do not exist.
+bool parse(std::string_view text, DateTime &out);
+
+enum class DateStyle : std::uint8_t {
+  // YYYY-MM-DD HH:MM, as shown in the console UI.
+  Minutes,
+  // YYYY-MM-DDTHH:MM:SS, as handed to JavaScript.
+  Seconds,
+};
+
+// Formatted text in a fixed buffer; no allocation unless str() is used.
+class FormattedDate {
+private:
+  char text_[24];
+  std::uint8_t size_ = 0;
+
+  friend FormattedDate format(DateTime time, DateStyle style);
+
+public:
+  std::string_view view() const { return {text_, size_}; }
+  std::string str() const { return std::string(view()); }
+
+  friend std::ostream &operator<<(std::ostream &out,
+                                  const FormattedDate &date) {
+    return out << date.view();
+  }
+};
+
+// time in local time, truncated to the style's precision.
+FormattedDate format(DateTime time, DateStyle style = DateStyle::Minutes);
+
+} // namespace iso_date
+
+#endif // ISO_DATE_H
@@ -1,33 +1,66 @@
 #ifndef NOTIFICATION_H
 #define NOTIFICATION_H
 
+#include "SlotMap.h"
+#include "TimerQueue.h"
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+class ReminderRule;
 class Task;
 
 using DateTime = std::chrono::system_clock::time_point;
 
 class Notification {
+public:
+  // What a notification knows of its task: copied from the task when the
+  // notification is created and again by NotificationManager::refreshTask
+  // whenever the task changes. shouldTrigger() and display() read only
+  // this, so a poll on another thread never touches the task itself.
+  struct TaskDetails {
+    std::string title;
+    DateTime deadline;
+    // "Name (CODE)", or empty if the task had no subject.
+    std::string subject;
+  };
+
 private:
   std::string message;
   DateTime triggerTime;
-  std::weak_ptr<Task> task;
+  TaskId task;
+  // Replaced whole through std::atomic_*, so display() on the scheduler
+  // thread can read it while the manager refreshes it.
+  std::shared_ptr<const TaskDetails> details;
 
 public:
   Notification(const std::string &message, const DateTime &triggerTime,
                std::shared_ptr<Task> task);
+  Notification(const std::string &message, const DateTime &triggerTime,
+               TaskId task);
 
   virtual ~Notification() = default;
 
   std::string getMessage() const;
   DateTime getTriggerTime() const;
-  std::shared_ptr<Task> getTask() const;
+  // nullptr once the task has been destroyed. Resolves the live task, so
+  // call it only where that task is not being changed meanwhile.
+  Task *getTask() const;
+  TaskId getTaskHandle() const { return task; }
+  // nullptr without a task, or once the task has been destroyed.
+  std::shared_ptr<const TaskDetails> getTaskDetails() const;
+
+  // Copies task's details again.
+  virtual void refresh(const Task &task);
+  // Drops the details; called when the task is destroyed.
+  void forgetTask();
 
   void setMessage(const std::string &message);
   void setTriggerTime(const DateTime &triggerTime);
@@ -44,14 +77,38 @@ private:
 public:
   DeadlineNotification(const std::string &message, std::shared_ptr<Task> task,
                        int daysBeforeDeadline);
+  DeadlineNotification(const std::string &message, const Task &task,
+                       int daysBeforeDeadline);
 
   int getDaysBeforeDeadline() const;
   void setDaysBeforeDeadline(int days);
 
+  // Also moves the trigger time to the task's current deadline.
+  void refresh(const Task &task) override;
   bool shouldTrigger(const DateTime &currentTime) const override;
   void display() const override;
 };
 
+// A notification taken off the queue, with the trigger time it was due at.
+struct DueNotification {
+  std::shared_ptr<Notification> notification;
+  DateTime due;
+};
+
+// Notifications wait in a TimerQueue keyed by trigger time, so a poll
+// touches only the k notifications that are due. The default HeapTimerQueue
+// polls in O(k log n) and cancels and reschedules by NotificationId in
+// O(log n); setTimerQueue() swaps in a TimingWheel for populations in the
+// millions, where both are O(1). A notification leaves the queue
+// when it fires or turns out to have expired (a deadline window that has
+// passed, a destroyed task); it stays registered until cancelled and can be
+// armed again with reschedule().
+//
+// The manager is safe to use from several threads, so a
+// NotificationScheduler can poll it while others add and cancel; the
+// notifications themselves are not locked. Polls read the task details
+// notifications carry, which tasks keep current through refreshTask() and
+// forgetTask(), and never the tasks.
 class NotificationManager {
 private:
   NotificationManager() = default;
@@ -65,21 +122,100 @@ private:
       instance;
   static std::mutex mutex;
 
-  std::vector<std::shared_ptr<Notification>> notifications;
+  struct Entry {
+    std::shared_ptr<Notification> notification;
+  };
+
+  // A ReminderRule taken off the queue, to be expanded without the lock:
+  // it queries the registry, whose writers call back into the manager.
+  struct DueRule {
+    NotificationId id;
+    std::shared_ptr<ReminderRule> rule;
+  };
+
+  // Owns the notifications. order keeps them in the order they were added,
+  // which is what the index-based API refers to; cancelled ids are left in
+  // it and skipped until they make up half of it. byTask lists them per
+  // TaskId::value() so tasks need not carry a list of their own. Entries
+  // for destroyed tasks are dropped with their last notification.
+  SlotMap<Entry, NotificationTag> notifications;
+  std::vector<NotificationId> order;
+  std::size_t cancelledInOrder = 0;
+  std::unordered_map<std::uint64_t, std::vector<NotificationId>> byTask;
+  // byTask.size(), readable without the lock: most tasks have no
+  // notifications, and Task calls refreshTask() and forgetTask() on every
+  // change and destruction.
+  std::atomic<std::size_t> trackedTasks{0};
+  std::unique_ptr<TimerQueue> queue = std::make_unique<HeapTimerQueue>();
+  // Called when the earliest trigger time moves earlier; see setWakeup().
+  std::function<void()> wakeup;
+  mutable std::mutex guard;
+
+  // The rest expect guard to be held.
+  // Arms the entry at its trigger time or moves it there, and calls wakeup
+  // if it may now be the first to fire.
+  void schedule(NotificationId id, const Entry &entry);
+  void compactOrder();
+  bool cancelLocked(NotificationId id);
+  std::vector<DueNotification> takeDueLocked(const DateTime &now,
+                                             std::vector<DueRule> &rules);
+  // Adds the rules' occurrences to due and arms the rules again.
+  void expandRules(const DateTime &now, const std::vector<DueRule> &rules,
+                   std::vector<DueNotification> &due);
 
 public:
   static NotificationManager &getInstance();
 
-  void addNotification(std::shared_ptr<Notification> notification);
-
+  NotificationId addNotification(std::shared_ptr<Notification> notification);
+  // nullptr for an id that was removed.
+  std::shared_ptr<Notification> find(NotificationId id) const;
+
+  // Removes the notification for good. Returns false for a stale id.
+  bool cancel(NotificationId id);
+  // Sets the trigger time and arms the notification again if it had fired.
+  bool reschedule(NotificationId id, const DateTime &triggerTime);
+  // Copies task's details into its notifications again and recomputes its
+  // deadline reminders; Task calls it when its title, deadline or subject
+  // changes.
+  void refreshTask(const Task &task);
+  // Disarms the deadline reminders of a task being destroyed; ~Task calls
+  // it.
+  void forgetTask(TaskId task);
+
+  // By position in getNotifications(); linear, prefer cancel().
   void removeNotification(size_t index);
 
+  // Takes every notification due at now off the queue, earliest first, and
+  // returns those whose shouldTrigger(now) holds. A ReminderRule due is
+  // replaced by its occurrences and armed again. A trigger time moved later
+  // with setTriggerTime() is noticed here; use reschedule() to move one
+  // earlier.
+  std::vector<std::shared_ptr<Notification>> pollDue(const DateTime &now);
+  // pollDue() with the time each notification was due.
+  std::vector<DueNotification> takeDue(const DateTime &now);
+  // Polls and displays what is due now.
   void checkNotifications();
 
+  // Notifications still waiting to fire, the one that fires next, and when.
+  std::size_t scheduledCount() const;
+  std::shared_ptr<Notification> nextScheduled() const;
+  std::optional<DateTime> nextTriggerTime() const;
+
+  // Installs the function called, with the manager locked, whenever a
+  // notification is armed ahead of everything else waiting. One at a time:
+  // throws std::logic_error if another is installed. Empty removes it.
+  void setWakeup(std::function<void()> wakeup);
+  // Moves every armed notification into queue, which must be empty, and
+  // polls it from then on.
+  void setTimerQueue(std::unique_ptr<TimerQueue> queue);
+
   std::vector<std::shared_ptr<Notification>> getNotifications() const;
 
   std::vector<std::shared_ptr<Notification>>
   getNotificationsForTask(std::shared_ptr<Task> task) const;
+  // In the order they were added; no scan over other tasks' notifications.
+  std::vector<std::shared_ptr<Notification>>
+  getNotificationsForTask(TaskId task) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef NOTIFICATION_SCHEDULER_H
+#define NOTIFICATION_SCHEDULER_H
+
+#include "Clock.h"
+#include "Notification.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// What a sink is handed for each notification that fires.
+struct NotificationFiring {
+  std::shared_ptr<Notification> notification;
+  // The trigger time it was due at, and the clock's time when it was handed
+  // over; the difference is the firing latency.
+  DateTime due;
+  DateTime fired;
+};
+
+// Fires notifications on a thread of its own instead of waiting for
+// someone to call checkNotifications(). The thread sleeps on the clock until
+// the earliest trigger time in the NotificationManager, takes everything due
+// off the heap and hands each notification to every sink in turn. Arming a
+// notification ahead of the earliest one wakes it early, through the
+// manager's wakeup.
+//
+// Sinks run on the scheduler thread, in the order given, and must not
+// throw. Notifications are polled and displayed from the copies of their
+// task's details they carry (Notification::TaskDetails), so the scheduler
+// thread does not read tasks. One scheduler per manager at a time.
+class NotificationScheduler {
+public:
+  using Sink = std::function<void(const NotificationFiring &)>;
+
+  // Notification::display(), as checkNotifications() does.
+  static Sink displaySink();
+
+private:
+  NotificationManager &manager_;
+  Clock &clock_;
+  std::vector<Sink> sinks_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  // Set by the manager's wakeup and by sync(): poll again before sleeping.
+  bool woken_ = false;
+  bool stopping_ = false;
+  // The clock time of the last finished poll.
+  DateTime polledThrough_ = DateTime::min();
+
+  std::atomic<std::uint64_t> delivered_{0};
+  std::atomic<std::uint64_t> wakeups_{0};
+
+  std::thread worker_;
+
+  void wake();
+  void run();
+
+public:
+  // Throws std::logic_error if the manager already has a scheduler.
+  explicit NotificationScheduler(
+      std::vector<Sink> sinks, Clock &clock = SystemClock::instance(),
+      NotificationManager &manager = NotificationManager::getInstance());
+  ~NotificationScheduler();
+
+  NotificationScheduler(const NotificationScheduler &) = delete;
+  NotificationScheduler &operator=(const NotificationScheduler &) = delete;
+
+  // Returns once everything due at the clock's current time has been handed
+  // to the sinks.
+  void sync();
+
+  // Notifications handed to the sinks, and times the thread woke up.
+  std::uint64_t delivered() const { return delivered_.load(); }
+  std::uint64_t wakeups() const { return wakeups_.load(); }
+};
+
+#endif // NOTIFICATION_SCHEDULER_H
@@ -0,0 +1,94 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Fixed-size blocks carved from large slabs and recycled through an
+// intrusive free list, so objects created together sit together and a
+// freed block is reused by the next allocation instead of going back to the
+// heap. Slabs are only released with the pool. Thread-safe.
+class ObjectPool {
+public:
+  static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  static constexpr std::size_t kSlabBytes = 64 * 1024;
+
+private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  std::mutex mutex_;
+  std::size_t blockSize_;
+  std::vector<std::unique_ptr<char[]>> slabs_;
+  char *next_ = nullptr;
+  char *end_ = nullptr;
+  FreeBlock *free_ = nullptr;
+  std::size_t live_ = 0;
+
+public:
+  // Blocks hold objects of up to size bytes, rounded up to its size class.
+  explicit ObjectPool(std::size_t size);
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  void *allocate();
+  void deallocate(void *block);
+
+  std::size_t blockSize() const { return blockSize_; }
+  std::size_t live();
+  std::size_t reservedBytes();
+
+  // size rounded up to a multiple of kAlignment.
+  static constexpr std::size_t sizeClass(std::size_t size) {
+    return size < sizeof(FreeBlock)
+               ? kAlignment
+               : (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+};
+
+// Standard allocator over one ObjectPool per type. Meant for
+// std::allocate_shared, which rebinds it to its control block type, so each
+// kind of object gets a pool of its own. Arrays and over-aligned types fall
+// back to operator new.
+template <typename T> class PoolAllocator {
+public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+  template <typename U> PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+  // Never destroyed, so objects owned by other statics can be freed at exit.
+  static ObjectPool &pool() {
+    static ObjectPool *instance = new ObjectPool(sizeof(T));
+    return *instance;
+  }
+
+  T *allocate(std::size_t n) {
+    if (n == 1 && alignof(T) <= ObjectPool::kAlignment) {
+      return static_cast<T *>(pool().allocate());
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    if (n == 1 && alignof(T) <= ObjectPool::kAlignment) {
+      pool().deallocate(p);
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  template <typename U> bool operator==(const PoolAllocator<U> &) const {
+    return true;
+  }
+  template <typename U> bool operator!=(const PoolAllocator<U> &) const {
+    return false;
+  }
+};
+
+#endif // OBJECT_POOL_H
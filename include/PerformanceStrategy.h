@@ -1,20 +1,34 @@
 #pragma once
 
 #include "Task.h"
+#include "TaskSpan.h"
+#include "TaskState.h"
+#include "TaskStore.h"
 #include <memory>
 #include <vector>
 
 class PerformanceStrategy {
 public:
   virtual ~PerformanceStrategy() = default;
-  virtual double
-  calculate(const std::vector<std::shared_ptr<Task>> &tasks) const = 0;
+  // Takes a view, so Subject::taskView() is passed without copying; a
+  // vector converts implicitly.
+  virtual double calculate(TaskSpan tasks) const = 0;
+  // Same result from column aggregates, for passes over TaskStore.
+  virtual double calculate(const TaskStats &stats) const = 0;
 };
 
+namespace performance_detail {
+inline std::uint64_t completed(const TaskStats &stats) {
+  return stats.byState[static_cast<std::size_t>(TaskStateKind::Completed)];
+}
+inline std::uint64_t inProgress(const TaskStats &stats) {
+  return stats.byState[static_cast<std::size_t>(TaskStateKind::InProgress)];
+}
+} // namespace performance_detail
+
 class AverageMarksStrategy : public PerformanceStrategy {
 public:
-  double
-  calculate(const std::vector<std::shared_ptr<Task>> &tasks) const override {
+  double calculate(TaskSpan tasks) const override {
     if (tasks.empty()) {
       return 0.0;
     }
@@ -28,12 +42,18 @@ public:
     }
     return (completedTasksCount == 0) ? 0.0 : totalMarks / completedTasksCount;
   }
+
+  double calculate(const TaskStats &stats) const override {
+    std::uint64_t completed = performance_detail::completed(stats);
+    return completed == 0 ? 0.0
+                          : static_cast<double>(stats.completedMarks) /
+                                static_cast<double>(completed);
+  }
 };
 
 class CompletionRateStrategy : public PerformanceStrategy {
 public:
-  double
-  calculate(const std::vector<std::shared_ptr<Task>> &tasks) const override {
+  double calculate(TaskSpan tasks) const override {
     if (tasks.empty()) {
       return 0.0;
     }
@@ -46,12 +66,19 @@ public:
     }
     return (static_cast<double>(completedCount) / tasks.size()) * 100.0;
   }
+
+  double calculate(const TaskStats &stats) const override {
+    if (stats.total == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(performance_detail::completed(stats)) /
+           static_cast<double>(stats.total) * 100.0;
+  }
 };
 
 class AverageProgressStrategy : public PerformanceStrategy {
 public:
-  double
-  calculate(const std::vector<std::shared_ptr<Task>> &tasks) const override {
+  double calculate(TaskSpan tasks) const override {
     if (tasks.empty()) {
       return 0.0;
     }
@@ -66,4 +93,15 @@ public:
 
     return totalProgress / tasks.size();
   }
+
+  // Progress per state as in TaskState::getConceptualProgress.
+  double calculate(const TaskStats &stats) const override {
+    if (stats.total == 0) {
+      return 0.0;
+    }
+    double totalProgress =
+        50.0 * static_cast<double>(performance_detail::inProgress(stats)) +
+        100.0 * static_cast<double>(performance_detail::completed(stats));
+    return totalProgress / static_cast<double>(stats.total);
+  }
 };
@@ -1,7 +1,8 @@
 #pragma once
 
 class Subject;
-class Registry;
+struct Registry;
+struct RegistryVersion;
 
 class PerformanceVisitor {
 public:
@@ -9,4 +10,5 @@ public:
   virtual double visit(Subject &subject) = 0;
 
   virtual double visit(Registry &registry) = 0;
+  virtual double visit(const RegistryVersion &version) = 0;
 };
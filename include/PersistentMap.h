@@ -0,0 +1,410 @@
+#ifndef PERSISTENT_MAP_H
+#define PERSISTENT_MAP_H
+
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// String-keyed map with structural sharing: a hash array mapped trie in the
+// compressed CHAMP layout (Steindorfer and Vinju), branching 32 ways on five
+// bits of SymbolTable::hash per level. Nodes are immutable and shared
+// between copies, so copying a map is O(1) and set() or erase() copies only
+// the path to the key, O(log32 n) nodes; every other copy of the map is left
+// as it was. Keys whose 32-bit hashes collide share a list node below the
+// last level. Iteration order follows the hashes, not insertion.
+template <typename V> class PersistentMap {
+public:
+  using key_type = std::string_view;
+  using mapped_type = std::shared_ptr<const V>;
+  using value_type = std::pair<std::string, mapped_type>;
+
+private:
+  static constexpr unsigned kBits = 5;
+  static constexpr unsigned kHashBits = 32;
+
+  struct Node {
+    std::uint32_t dataMap = 0;
+    std::uint32_t nodeMap = 0;
+    // Inline entries and children, each in bit order. Below the last level
+    // the maps are unused and entries is the collision list.
+    std::vector<value_type> entries;
+    std::vector<std::shared_ptr<const Node>> children;
+  };
+  using NodePtr = std::shared_ptr<const Node>;
+
+  NodePtr root_;
+  std::size_t size_ = 0;
+
+  static std::uint32_t bitAt(std::uint32_t hash, unsigned shift) {
+    return 1u << ((hash >> shift) & 31u);
+  }
+
+  static std::size_t rank(std::uint32_t map, std::uint32_t bit) {
+    std::uint32_t below = map & (bit - 1);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcount(below));
+#else
+    std::size_t count = 0;
+    for (; below; below &= below - 1) {
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  static NodePtr pair(unsigned shift, std::uint32_t hashA, value_type a,
+                      std::uint32_t hashB, value_type b) {
+    auto node = std::make_shared<Node>();
+    if (shift >= kHashBits) {
+      node->entries.push_back(std::move(a));
+      node->entries.push_back(std::move(b));
+      return node;
+    }
+    std::uint32_t bitA = bitAt(hashA, shift);
+    std::uint32_t bitB = bitAt(hashB, shift);
+    if (bitA == bitB) {
+      node->nodeMap = bitA;
+      node->children.push_back(
+          pair(shift + kBits, hashA, std::move(a), hashB, std::move(b)));
+    } else {
+      node->dataMap = bitA | bitB;
+      if (bitA > bitB) {
+        std::swap(a, b);
+      }
+      node->entries.push_back(std::move(a));
+      node->entries.push_back(std::move(b));
+    }
+    return node;
+  }
+
+  static NodePtr insert(const Node *node, unsigned shift, std::uint32_t hash,
+                        value_type &entry, bool &added) {
+    auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    if (shift >= kHashBits) {
+      for (auto &existing : copy->entries) {
+        if (existing.first == entry.first) {
+          existing.second = std::move(entry.second);
+          return copy;
+        }
+      }
+      copy->entries.push_back(std::move(entry));
+      added = true;
+      return copy;
+    }
+
+    std::uint32_t bit = bitAt(hash, shift);
+    if (copy->dataMap & bit) {
+      auto at = copy->entries.begin() + rank(copy->dataMap, bit);
+      if (at->first == entry.first) {
+        at->second = std::move(entry.second);
+        return copy;
+      }
+      // Two keys on one slot: both move down into a new child.
+      value_type moved = std::move(*at);
+      std::uint32_t movedHash = SymbolTable::hash(moved.first);
+      copy->entries.erase(at);
+      copy->dataMap ^= bit;
+      copy->nodeMap |= bit;
+      copy->children.insert(copy->children.begin() + rank(copy->nodeMap, bit),
+                            pair(shift + kBits, movedHash, std::move(moved),
+                                 hash, std::move(entry)));
+      added = true;
+    } else if (copy->nodeMap & bit) {
+      auto &child = copy->children[rank(copy->nodeMap, bit)];
+      child = insert(child.get(), shift + kBits, hash, entry, added);
+    } else {
+      copy->entries.insert(copy->entries.begin() + rank(copy->dataMap, bit),
+                           std::move(entry));
+      copy->dataMap |= bit;
+      added = true;
+    }
+    return copy;
+  }
+
+  // Returns node itself when key is absent, null when the node empties.
+  static NodePtr remove(const NodePtr &node, unsigned shift,
+                        std::uint32_t hash, std::string_view key,
+                        bool &removed) {
+    if (!node) {
+      return node;
+    }
+    if (shift >= kHashBits) {
+      for (std::size_t i = 0; i < node->entries.size(); ++i) {
+        if (node->entries[i].first == key) {
+          auto copy = std::make_shared<Node>(*node);
+          copy->entries.erase(copy->entries.begin() + i);
+          removed = true;
+          return copy->entries.empty() ? nullptr : copy;
+        }
+      }
+      return node;
+    }
+
+    std::uint32_t bit = bitAt(hash, shift);
+    if (node->dataMap & bit) {
+      std::size_t at = rank(node->dataMap, bit);
+      if (node->entries[at].first != key) {
+        return node;
+      }
+      auto copy = std::make_shared<Node>(*node);
+      copy->entries.erase(copy->entries.begin() + at);
+      copy->dataMap ^= bit;
+      removed = true;
+      return copy->dataMap == 0 && copy->nodeMap == 0 ? nullptr : copy;
+    }
+    if (node->nodeMap & bit) {
+      std::size_t at = rank(node->nodeMap, bit);
+      NodePtr child = remove(node->children[at], shift + kBits, hash, key,
+                             removed);
+      if (!removed) {
+        return node;
+      }
+      auto copy = std::make_shared<Node>(*node);
+      if (child && (!child->children.empty() || child->entries.size() > 1)) {
+        copy->children[at] = std::move(child);
+        return copy;
+      }
+      // A child left with one entry is folded back into this node.
+      copy->children.erase(copy->children.begin() + at);
+      copy->nodeMap ^= bit;
+      if (child) {
+        copy->entries.insert(copy->entries.begin() + rank(copy->dataMap, bit),
+                             child->entries.front());
+        copy->dataMap |= bit;
+      }
+      return copy->dataMap == 0 && copy->nodeMap == 0 ? nullptr : copy;
+    }
+    return node;
+  }
+
+  static void collect(const Node *node,
+                      std::vector<const value_type *> &out) {
+    if (!node) {
+      return;
+    }
+    for (const auto &entry : node->entries) {
+      out.push_back(&entry);
+    }
+    for (const auto &child : node->children) {
+      collect(child.get(), out);
+    }
+  }
+
+  template <typename Visit>
+  static void diffLists(const std::vector<const value_type *> &before,
+                        const std::vector<const value_type *> &after,
+                        Visit &visit) {
+    for (const value_type *old : before) {
+      const value_type *match = nullptr;
+      for (const value_type *candidate : after) {
+        if (candidate->first == old->first) {
+          match = candidate;
+          break;
+        }
+      }
+      if (!match) {
+        visit(old->first, old->second, mapped_type());
+      } else if (match->second != old->second) {
+        visit(old->first, old->second, match->second);
+      }
+    }
+    for (const value_type *added : after) {
+      bool found = false;
+      for (const value_type *old : before) {
+        if (old->first == added->first) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        visit(added->first, mapped_type(), added->second);
+      }
+    }
+  }
+
+  template <typename Visit>
+  static void diffNodes(const Node *before, const Node *after, unsigned shift,
+                        Visit &visit) {
+    if (before == after) {
+      return;
+    }
+    if (!before || !after || shift >= kHashBits) {
+      std::vector<const value_type *> a, b;
+      collect(before, a);
+      collect(after, b);
+      diffLists(a, b, visit);
+      return;
+    }
+
+    std::uint32_t used = before->dataMap | before->nodeMap | after->dataMap |
+                         after->nodeMap;
+    for (; used; used &= used - 1) {
+      std::uint32_t bit = used & (~used + 1);
+      const Node *childA = before->nodeMap & bit
+                               ? before->children[rank(before->nodeMap, bit)]
+                                     .get()
+                               : nullptr;
+      const Node *childB = after->nodeMap & bit
+                               ? after->children[rank(after->nodeMap, bit)]
+                                     .get()
+                               : nullptr;
+      if (childA && childB) {
+        diffNodes(childA, childB, shift + kBits, visit);
+        continue;
+      }
+      std::vector<const value_type *> a, b;
+      if (before->dataMap & bit) {
+        a.push_back(&before->entries[rank(before->dataMap, bit)]);
+      }
+      if (after->dataMap & bit) {
+        b.push_back(&after->entries[rank(after->dataMap, bit)]);
+      }
+      collect(childA, a);
+      collect(childB, b);
+      diffLists(a, b, visit);
+    }
+  }
+
+public:
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename PersistentMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+  private:
+    struct Frame {
+      const Node *node;
+      std::size_t entry;
+      std::size_t child;
+    };
+    std::vector<Frame> stack_;
+    const value_type *current_ = nullptr;
+
+    void advance() {
+      while (!stack_.empty()) {
+        Frame &top = stack_.back();
+        if (top.entry < top.node->entries.size()) {
+          current_ = &top.node->entries[top.entry++];
+          return;
+        }
+        if (top.child < top.node->children.size()) {
+          const Node *child = top.node->children[top.child++].get();
+          stack_.push_back(Frame{child, 0, 0});
+          continue;
+        }
+        stack_.pop_back();
+      }
+      current_ = nullptr;
+    }
+
+  public:
+    const_iterator() = default;
+    explicit const_iterator(const Node *root) {
+      if (root) {
+        stack_.push_back(Frame{root, 0, 0});
+        advance();
+      }
+    }
+
+    reference operator*() const { return *current_; }
+    pointer operator->() const { return current_; }
+    const_iterator &operator++() {
+      advance();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      advance();
+      return previous;
+    }
+    bool operator==(const const_iterator &other) const {
+      return current_ == other.current_;
+    }
+    bool operator!=(const const_iterator &other) const {
+      return current_ != other.current_;
+    }
+  };
+  using iterator = const_iterator;
+
+  // Null if key is absent.
+  mapped_type find(std::string_view key) const {
+    std::uint32_t hash = SymbolTable::hash(key);
+    const Node *node = root_.get();
+    for (unsigned shift = 0; node; shift += kBits) {
+      if (shift >= kHashBits) {
+        for (const auto &entry : node->entries) {
+          if (entry.first == key) {
+            return entry.second;
+          }
+        }
+        return nullptr;
+      }
+      std::uint32_t bit = bitAt(hash, shift);
+      if (node->dataMap & bit) {
+        const auto &entry = node->entries[rank(node->dataMap, bit)];
+        return entry.first == key ? entry.second : nullptr;
+      }
+      if (!(node->nodeMap & bit)) {
+        return nullptr;
+      }
+      node = node->children[rank(node->nodeMap, bit)].get();
+    }
+    return nullptr;
+  }
+
+  std::size_t count(std::string_view key) const {
+    return find(key) ? 1 : 0;
+  }
+
+  // Inserts or replaces; a null value is stored like any other.
+  void set(std::string_view key, mapped_type value) {
+    value_type entry(std::string(key), std::move(value));
+    bool added = false;
+    root_ = insert(root_.get(), 0, SymbolTable::hash(key), entry, added);
+    size_ += added;
+  }
+
+  std::size_t erase(std::string_view key) {
+    bool removed = false;
+    root_ = remove(root_, 0, SymbolTable::hash(key), key, removed);
+    size_ -= removed;
+    return removed ? 1 : 0;
+  }
+
+  void clear() {
+    root_.reset();
+    size_ = 0;
+  }
+
+  const_iterator begin() const { return const_iterator(root_.get()); }
+  const_iterator end() const { return const_iterator(); }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Whether two maps are the same version: true only when they share the
+  // root, not for equal contents built separately.
+  bool shares(const PersistentMap &other) const {
+    return root_ == other.root_;
+  }
+
+  // Calls visit(key, before, after) for every key whose value differs,
+  // with null for the side it is missing from. Subtrees both maps share are
+  // skipped, so the cost follows the size of the change, not of the maps.
+  template <typename Visit>
+  static void diff(const PersistentMap &before, const PersistentMap &after,
+                   Visit &&visit) {
+    diffNodes(before.root_.get(), after.root_.get(), 0, visit);
+  }
+};
+
+#endif // PERSISTENT_MAP_H
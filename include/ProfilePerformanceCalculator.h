@@ -2,6 +2,7 @@
 #include "PerformanceVisitor.h"
 #include "Registry.h"
 #include "Subject.h"
+#include "TaskStore.h"
 
 class ProfilePerformanceCalculator : public PerformanceVisitor {
 private:
@@ -13,19 +14,42 @@ public:
       : subjectStrategy(std::move(subStrategy)) {}
 
   double visit(Subject &subject) override {
-    return subjectStrategy->calculate(subject.getTasks());
+    return subjectStrategy->calculate(subject.taskView());
   }
 
+  // Registry::accept() holds the registry's write lock, so this registry's
+  // tasks cannot change meanwhile; other registries' tasks can, and only
+  // this registry's rows are read.
   double visit(Registry &registry) override {
     if (registry.subjects.empty())
       return 0.0;
 
+    auto &store = TaskStore::global();
     double totalPerformanceScore = 0.0;
     int count = 0;
 
     for (const auto &pair : registry.subjects) {
       if (pair.second) {
-        totalPerformanceScore += pair.second->accept(*this);
+        totalPerformanceScore +=
+            subjectStrategy->calculate(store.stats(pair.second->taskView()));
+        count++;
+      }
+    }
+
+    return (count == 0) ? 0.0 : totalPerformanceScore / count;
+  }
+
+  // Readers may run this while writers change other tasks, so it only reads
+  // the rows of the frozen tasks instead of scanning the store.
+  double visit(const RegistryVersion &version) override {
+    auto &store = TaskStore::global();
+    double totalPerformanceScore = 0.0;
+    int count = 0;
+
+    for (const auto &pair : version.subjects) {
+      if (pair.second) {
+        totalPerformanceScore +=
+            subjectStrategy->calculate(store.stats(pair.second->taskView()));
         count++;
       }
     }
@@ -1,30 +1,228 @@
 #ifndef REGISTRY_H
 #define REGISTRY_H
 
+#include "ChangeFeed.h"
+#include "DeadlineIndex.h"
+#include "InternedMap.h"
 #include "Internship.h"
 #include "PerformanceVisitable.h"
 #include "PerformanceVisitor.h"
+#include "RegistryVersion.h"
 #include "Resume.h"
 #include "Subject.h"
+#include "SymbolTable.h"
+#include "Task.h"
+#include "TaskBitmapIndex.h"
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
+class CommandManager;
+class WriteAheadLog;
+struct ImportBatch;
+struct ImportStats;
+struct WalRecord;
+
+// The maps below are the live state and belong to the writers: they are
+// changed by the mutation methods (which serialize on an internal mutex) or
+// directly during single-threaded setup. Other threads read through
+// snapshot(), which returns an immutable RegistryVersion and never blocks
+// writers.
 struct Registry : public PerformanceVisitable {
-  std::unordered_map<std::string, std::shared_ptr<Subject>> subjects;
-  std::unordered_map<std::string, std::shared_ptr<Internship>> internships;
-  std::unordered_map<std::string, std::shared_ptr<Resume>> resumes;
+  // Shared by all three maps: a subject code and an internship id are
+  // interned once and then addressed by dense integer ids.
+  SymbolTable symbols;
+
+  InternedMap<std::shared_ptr<Subject>> subjects{symbols};
+  InternedMap<std::shared_ptr<Internship>> internships{symbols};
+  InternedMap<std::shared_ptr<Resume>> resumes{symbols};
 
+  // The default shard: the registry of RegistryPool::kDefaultStudent.
   static Registry &instance();
 
+  // Visits with mutations paused; the visitor must not call back into the
+  // registry.
   double accept(PerformanceVisitor &visitor) override;
 
+  // Mutations that must survive a restart. Each one is validated, appended
+  // to the attached write-ahead log (if any) and applied to the live maps;
+  // the new version is published to readers once the record is durable.
+  bool createSubject(const std::string &name, const std::string &code,
+                     const std::string &description);
+  // taskType: 1 = Lab, 2 = Project, 3 = Exam. Returns nullptr if the subject
+  // does not exist or already has a task with this title.
+  std::shared_ptr<Task> createTask(const std::string &subjectCode,
+                                   const std::string &title,
+                                   const std::string &description,
+                                   const DateTime &deadline, int taskType);
+  // Return the generated id, or an empty string if a field is missing.
+  std::string createInternship(const std::string &company,
+                               const std::string &position,
+                               InternshipStatus status,
+                               const std::string &startDate,
+                               const std::string &endDate);
+  std::string createResume(const std::string &title,
+                           const std::string &htmlBody);
+  // targetState: 0 = Pending, 1 = In Progress, 2 = Completed. Undone by
+  // undo(), like every other mutation.
+  bool changeTaskState(const std::string &subjectCode, int taskIndex,
+                       int targetState);
+  // Same, addressing the task by its stable id (Task::getHandle) rather than
+  // by a position that shifts when earlier tasks are removed. Fails for
+  // destroyed tasks and for tasks not in this registry's live maps, such as
+  // those of a snapshot.
+  bool changeTaskState(TaskId task, int targetState);
+  // Several changes by id as one transaction: every change is validated
+  // first and then all of them are applied or none is. Written as one log
+  // record, published as one version and undone as one step of undo().
+  bool changeTaskStates(const std::vector<std::pair<TaskId, int>> &changes);
+
+  // Undo and redo of whole mutations of any kind, by moving between the
+  // retained versions: readers see the earlier version again at the cost
+  // of a root swap, and the live maps take back only the entries that
+  // differ between the two versions, found by diffing the persistent maps.
+  // Tasks that differ are changed in place, so ids, shared_ptrs and
+  // notifications taken before undo() or redo() stay with the live tasks;
+  // only a subject or task brought back after it was removed is a new
+  // object. Both are logged like any other
+  // mutation. A new mutation discards what could be redone; publish(),
+  // importBatch() and checkpoint() start a new history.
+  bool undo();
+  bool redo();
+  bool canUndo();
+  bool canRedo();
+  // Versions retained behind the latest; at least 1. A change is logged
+  // and, while it differs from the default, logged again by checkpoint().
+  std::size_t historyDepth();
+  void setHistoryDepth(std::size_t depth);
+  static constexpr std::size_t kDefaultHistoryDepth = 256;
+
+  // Bulk path used by BulkImporter: adds the batch's new subjects, then its
+  // tasks, under one lock acquisition and publishes a single version. Rows
+  // are counted as rejected in stats when a subject code or task title
+  // already exists or a task's subject does not. Imports are not written to
+  // the log; checkpoint() afterwards to make them durable.
+  void importBatch(const ImportBatch &batch, ImportStats &stats);
+
+  // The log is not owned; pass nullptr to stop logging.
+  void attachLog(WriteAheadLog *log) { log_ = log; }
+  // Re-executes a logged mutation without logging it again.
+  void apply(const WalRecord &record);
+  // Snapshots the live state and empties the attached log, with mutations
+  // paused for the duration.
+  void checkpoint(const std::string &snapshotPath);
+
+  // The latest published version. Cheap: one atomic shared_ptr load.
+  std::shared_ptr<const RegistryVersion> snapshot() const;
+  // Republishes everything from the live maps. Needed after changing them
+  // directly (setup code, undo) rather than through the mutation methods.
+  void publish();
+
+  // Deadline queries over the tasks of every subject, in O(log n + k). The
+  // index follows subjects created through createSubject() and everything
+  // present at the last publish(), including later task and state changes.
+  std::vector<DueTask> tasksDueBetween(const DateTime &from,
+                                       const DateTime &to);
+  // Open tasks only, filtered, handed to fn(const DueTask &) with
+  // mutations paused; see DeadlineIndex::openDueBetween(). subjectCode, if
+  // not empty, replaces filter.subject with the live subject of that code
+  // at the time of the call. The tasks are live: fn must not keep them or
+  // call back into the registry.
+  template <typename Fn>
+  void forEachOpenTaskDueBetween(const DateTime &from, const DateTime &to,
+                                 TaskFilter filter,
+                                 const std::string &subjectCode,
+                                 std::size_t limit, Fn &&fn) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (!subjectCode.empty()) {
+      auto it = subjects.find(subjectCode);
+      if (it == subjects.end()) {
+        return;
+      }
+      filter.subject = it->second.get();
+    }
+    deadlineIndex_.forEachOpenDue(from, to, filter, limit,
+                                  std::forward<Fn>(fn));
+  }
+  std::vector<DueTask>
+  nextDue(std::size_t k,
+          const DateTime &now = std::chrono::system_clock::now());
+  std::vector<DueTask>
+  overdue(const DateTime &now = std::chrono::system_clock::now());
+
+  // Counts and selections by state, type and subject, answered from bitmap
+  // indexes that follow the same subjects as the deadline index.
+  std::uint64_t countTasks(const TaskFilter &filter);
+  std::vector<Task *> findTasks(const TaskFilter &filter);
+
+  // Change feed: the generation grows by one for every created, updated or
+  // deleted subject, task, internship or resume, so a consumer can poll
+  // generation() and fetch only what changed since the last value it saw.
+  // Entities removed by editing the maps directly are not seen; publish()
+  // therefore starts a new history and older generations come back
+  // incomplete.
+  std::uint64_t generation() const { return changes_.generation(); }
+  ChangeSet changesSince(std::uint64_t generation);
+  // Generation of the entity's last change, 0 if unknown. Tasks are keyed by
+  // title within their subject.
+  std::uint64_t stamp(EntityKind kind, const std::string &key,
+                      const std::string &subject = "");
+
+  // Command history for edits made to this registry's tasks directly; the
+  // registry's own mutations are never recorded here (see undo()). The
+  // default shard uses CommandManager::instance(); every other shard has
+  // its own.
+  CommandManager &commands() { return *commands_; }
+
+  ~Registry();
   Registry(const Registry &) = delete;
   Registry &operator=(const Registry &) = delete;
 
 private:
-  Registry() {}
-  ~Registry() {}
+  friend class RegistryPool;
+
+  WriteAheadLog *log_ = nullptr;
+  std::unique_ptr<CommandManager> ownCommands_;
+  CommandManager *commands_;
+  long long nextResumeId_ = 1;
+  long long nextInternshipId_ = 1;
+
+  std::mutex writeMutex_;
+  // Newest version built by a writer; guarded by writeMutex_.
+  std::shared_ptr<const RegistryVersion> latest_;
+  // Newest version readers may see; only accessed through std::atomic_*.
+  std::shared_ptr<const RegistryVersion> published_;
+  // Versions undo() and redo() move between, oldest first; history_[cursor_]
+  // has the same maps as latest_. Guarded by writeMutex_.
+  std::deque<std::shared_ptr<const RegistryVersion>> history_;
+  std::size_t cursor_ = 0;
+  std::size_t historyDepth_ = kDefaultHistoryDepth;
+  // Indexes over the live tasks, guarded by writeMutex_ for queries.
+  DeadlineIndex deadlineIndex_;
+  TaskBitmapIndex taskBitmaps_;
+  ChangeFeed changes_;
+
+  void attachIndexes(Subject &subject);
+  void detachIndexes(Subject &subject);
+  // Makes version the only entry of the history.
+  void resetHistory(std::shared_ptr<const RegistryVersion> version);
+  void remember(std::shared_ptr<const RegistryVersion> version);
+  // Brings the live maps from latest_ to target, entry by entry. Tasks that
+  // had to be created again have new ids, so target is replaced by a copy
+  // whose subjects name them.
+  void restoreLocked(std::shared_ptr<const RegistryVersion> &target);
+  std::shared_ptr<Task> commit(std::unique_lock<std::mutex> &lock,
+                               const WalRecord &record);
+  std::shared_ptr<Task> applyLocked(const WalRecord &record);
+  std::shared_ptr<const RegistryVersion> stage(const WalRecord &record);
+  void publishVersion(std::shared_ptr<const RegistryVersion> version);
+
+  // Shards other than the default one are created by RegistryPool.
+  explicit Registry(bool ownCommands);
 };
 
 #endif
@@ -0,0 +1,109 @@
+#ifndef REGISTRY_POOL_H
+#define REGISTRY_POOL_H
+
+#include "Registry.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Independent registries, one per student, spread over a fixed set of worker
+// threads by a hash of the student id. A worker is the only thread that runs
+// operations on its students' registries, so their maps, histories and
+// write locks are never contended, and work for students on different
+// workers runs in parallel. Operations for one student run one at a time,
+// in submission order.
+//
+// Shards are not entirely shared-nothing. Every task's row, and the
+// interned title and description, live in TaskStore::global(), whose mutex
+// is taken to create or destroy a task, including the copies frozen into
+// versions. Subjects take a slot in one process-wide slot map, and
+// NotificationManager is a singleton locked on task changes while any
+// notification exists. These are short sections, a few per operation;
+// bench/registry_pool_bench.cpp measures their share of an operation.
+//
+// A shard is created on the first operation for its student.
+// kDefaultStudent maps to Registry::instance(), so code using the singleton
+// sees the same registry as pool operations for that student. Such code
+// still runs on its own thread, though; the registry's mutation methods lock,
+// but direct access to its maps must not overlap with pool operations.
+class RegistryPool {
+public:
+  static const std::string kDefaultStudent;
+
+private:
+  struct alignas(64) Worker {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> queue;
+    bool stopping = false;
+
+    // Touched only by the worker thread.
+    std::unordered_map<std::string, Registry *> shards;
+    std::vector<std::unique_ptr<Registry>> owned;
+
+    Registry &shard(const std::string &studentId);
+    void run();
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  void post(const std::string &studentId,
+            std::function<void(Registry &)> operation);
+
+public:
+  // 0 starts one worker per hardware thread.
+  explicit RegistryPool(std::size_t workers = 0);
+  // Finishes queued operations, then stops the workers and destroys every
+  // shard except the default one.
+  ~RegistryPool();
+
+  RegistryPool(const RegistryPool &) = delete;
+  RegistryPool &operator=(const RegistryPool &) = delete;
+
+  // Queues operation(registry) on the worker that owns the student's shard.
+  // The future carries its result or exception.
+  template <typename Operation>
+  auto submit(const std::string &studentId, Operation operation)
+      -> std::future<std::invoke_result_t<Operation, Registry &>> {
+    using Result = std::invoke_result_t<Operation, Registry &>;
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+    post(studentId, [promise, operation = std::move(operation)](
+                        Registry &registry) mutable {
+      try {
+        if constexpr (std::is_void_v<Result>) {
+          operation(registry);
+          promise->set_value();
+        } else {
+          promise->set_value(operation(registry));
+        }
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    });
+    return future;
+  }
+
+  // submit() and wait for the result.
+  template <typename Operation>
+  auto run(const std::string &studentId, Operation operation)
+      -> std::invoke_result_t<Operation, Registry &> {
+    return submit(studentId, std::move(operation)).get();
+  }
+
+  std::size_t workerCount() const { return workers_.size(); }
+  std::size_t workerFor(const std::string &studentId) const;
+};
+
+#endif // REGISTRY_POOL_H
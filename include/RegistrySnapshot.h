@@ -0,0 +1,181 @@
+#ifndef REGISTRY_SNAPSHOT_H
+#define REGISTRY_SNAPSHOT_H
+
+#include "Internship.h"
+#include "Resume.h"
+#include "Task.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+struct Registry;
+struct RegistryVersion;
+
+// On-disk layout (little-endian, every section 8-byte aligned):
+//
+//   Header | SubjectRecord[] | TaskRecord[] | InternshipRecord[] |
+//   ResumeRecord[] | string blob
+//
+// Tasks are stored grouped by subject, so a subject refers to its tasks by a
+// [firstTask, firstTask + taskCount) range. Strings are (offset, size) pairs
+// into the blob and are only turned into std::string when a caller asks.
+namespace snapshot_format {
+
+constexpr char kMagic[8] = {'A', 'P', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kEndianTag = 0x01020304u;
+
+struct StringRef {
+  std::uint32_t offset;
+  std::uint32_t size;
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endianTag;
+  std::uint64_t fileSize;
+  std::uint64_t subjectCount;
+  std::uint64_t taskCount;
+  std::uint64_t internshipCount;
+  std::uint64_t resumeCount;
+  std::uint64_t subjectOffset;
+  std::uint64_t taskOffset;
+  std::uint64_t internshipOffset;
+  std::uint64_t resumeOffset;
+  std::uint64_t stringOffset;
+  std::uint64_t stringBytes;
+};
+
+struct SubjectRecord {
+  StringRef name;
+  StringRef code;
+  StringRef description;
+  std::uint32_t firstTask;
+  std::uint32_t taskCount;
+};
+
+struct TaskRecord {
+  StringRef title;
+  StringRef description;
+  std::int64_t deadlineNs;
+  std::int32_t marks;
+  std::uint8_t type;
+  std::uint8_t state;
+  std::uint8_t reserved[2];
+};
+
+struct InternshipRecord {
+  StringRef id;
+  StringRef company;
+  StringRef position;
+  StringRef startDate;
+  StringRef endDate;
+  std::uint8_t status;
+  std::uint8_t reserved[3];
+};
+
+struct ResumeRecord {
+  StringRef id;
+  StringRef title;
+  StringRef htmlBody;
+};
+
+} // namespace snapshot_format
+
+class RegistrySnapshot;
+
+class SnapshotTask {
+private:
+  const RegistrySnapshot *snapshot_;
+  const snapshot_format::TaskRecord *record_;
+
+public:
+  SnapshotTask(const RegistrySnapshot *snapshot,
+               const snapshot_format::TaskRecord *record)
+      : snapshot_(snapshot), record_(record) {}
+
+  std::string_view getTitle() const;
+  std::string_view getDescription() const;
+  DateTime getDeadline() const;
+  std::string_view getType() const;
+  std::string_view getStateName() const;
+  bool isCompleted() const;
+  int getMarks() const { return record_->marks; }
+
+  // Raw encodings: type 0/1/2 = Lab/Project/Exam, state 0/1/2 =
+  // Pending/In Progress/Completed.
+  std::uint8_t typeCode() const { return record_->type; }
+  std::uint8_t stateCode() const { return record_->state; }
+};
+
+class SnapshotSubject {
+private:
+  const RegistrySnapshot *snapshot_;
+  const snapshot_format::SubjectRecord *record_;
+
+public:
+  SnapshotSubject(const RegistrySnapshot *snapshot,
+                  const snapshot_format::SubjectRecord *record)
+      : snapshot_(snapshot), record_(record) {}
+
+  std::string_view getName() const;
+  std::string_view getCode() const;
+  std::string_view getDescription() const;
+
+  std::size_t taskCount() const { return record_->taskCount; }
+  SnapshotTask task(std::size_t index) const;
+};
+
+// A read-only, memory-mapped registry image. Opening a snapshot only maps the
+// file and validates the header, so its cost does not depend on the number of
+// records; restore() materializes the objects into a Registry when needed.
+class RegistrySnapshot {
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;
+  const snapshot_format::Header *header_ = nullptr;
+
+  RegistrySnapshot() = default;
+  void release();
+
+  template <typename Record>
+  const Record *section(std::uint64_t offset, std::uint64_t count) const;
+
+public:
+  ~RegistrySnapshot();
+
+  RegistrySnapshot(RegistrySnapshot &&other) noexcept;
+  RegistrySnapshot &operator=(RegistrySnapshot &&other) noexcept;
+  RegistrySnapshot(const RegistrySnapshot &) = delete;
+  RegistrySnapshot &operator=(const RegistrySnapshot &) = delete;
+
+  // Serializes the registry into one buffer and writes it with a single
+  // sequential write to a temporary file that is then renamed over path.
+  static void write(const Registry &registry, const std::string &path);
+  // Same, from a published version, so an export can run while writers keep
+  // going.
+  static void write(const RegistryVersion &version, const std::string &path);
+
+  static RegistrySnapshot open(const std::string &path);
+
+  std::uint32_t version() const { return header_->version; }
+  std::size_t subjectCount() const { return header_->subjectCount; }
+  std::size_t taskCount() const { return header_->taskCount; }
+  std::size_t internshipCount() const { return header_->internshipCount; }
+  std::size_t resumeCount() const { return header_->resumeCount; }
+
+  SnapshotSubject subject(std::size_t index) const;
+  SnapshotTask task(std::size_t index) const;
+  Internship internship(std::size_t index) const;
+  Resume resume(std::size_t index) const;
+
+  std::string_view str(const snapshot_format::StringRef &ref) const;
+
+  // Replaces the registry contents with the snapshot contents.
+  void restore(Registry &registry) const;
+};
+
+#endif // REGISTRY_SNAPSHOT_H
@@ -0,0 +1,40 @@
+#ifndef REGISTRY_VERSION_H
+#define REGISTRY_VERSION_H
+
+#include "Internship.h"
+#include "PersistentMap.h"
+#include "Resume.h"
+#include "SubjectVersion.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class PerformanceVisitor;
+
+// An immutable, published state of the Registry. Readers get one from
+// Registry::snapshot() and can use it from any thread for as long as they
+// hold it; writers never modify a version, they publish a new one that
+// shares every unchanged subject, internship and resume with its parent.
+// The maps are persistent, so the new version also shares all but the path
+// to each changed entry, and copying a version costs three pointer copies.
+// Subjects are frozen task by task (see SubjectVersion), so a change to one
+// task does not copy the others.
+struct RegistryVersion {
+  template <typename V> using Entries = PersistentMap<V>;
+
+  std::uint64_t version = 0;
+  Entries<SubjectVersion> subjects;
+  Entries<Internship> internships;
+  Entries<Resume> resumes;
+
+  // O(log32 n) in the number of entries of that kind.
+  std::shared_ptr<const SubjectVersion>
+  findSubject(std::string_view code) const;
+  std::shared_ptr<const Internship> findInternship(std::string_view id) const;
+  std::shared_ptr<const Resume> findResume(std::string_view id) const;
+
+  double accept(PerformanceVisitor &visitor) const;
+};
+
+#endif // REGISTRY_VERSION_H
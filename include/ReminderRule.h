@@ -0,0 +1,68 @@
+#ifndef REMINDER_RULE_H
+#define REMINDER_RULE_H
+
+#include "Notification.h"
+#include "TaskBitmapIndex.h"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct Registry;
+
+// "Remind me 7, 3 and 1 days before the deadline of every exam", stored
+// once instead of as a DeadlineNotification per task and offset. It is added
+// to NotificationManager like any notification. The manager arms it at its
+// next occurrence, looked up in the registry's deadline index, and when it
+// comes due hands out a DeadlineNotification for each task reminded,
+// created on the spot, in place of the rule, then arms it again.
+//
+// Occurrences are only looked up when the rule wakes, so a task added or
+// moved since it was armed is seen at the next wakeup; the rule wakes at
+// least every recheck, which bounds how late such a reminder can be.
+// Reminder times that had already passed at the previous wakeup are not
+// looked at again, and completed tasks are not reminded.
+//
+// A subject in the filter is kept by its code and looked up again at each
+// wakeup, so the rule follows the subject even when undo() removes it and
+// redo() brings it back as a new object. Occurrences are created while the
+// registry is locked and carry copies of their task's details, not the
+// task.
+class ReminderRule : public Notification {
+private:
+  Registry &registry;
+  // Without its subject, which is subjectCode.
+  TaskFilter filter;
+  std::string subjectCode;
+  std::vector<int> daysBefore;
+  DateTime::duration recheck;
+  // Reminders due up to here have been handed out.
+  DateTime covered;
+
+public:
+  ReminderRule(const std::string &message, Registry &registry,
+               const TaskFilter &filter, std::vector<int> daysBefore,
+               const DateTime &since = std::chrono::system_clock::now(),
+               DateTime::duration recheck = std::chrono::hours(1));
+
+  // The filter's state and type; the subject is getSubjectCode().
+  const TaskFilter &getFilter() const { return filter; }
+  // Empty when the rule covers every subject.
+  const std::string &getSubjectCode() const { return subjectCode; }
+  const std::vector<int> &getDaysBefore() const { return daysBefore; }
+
+  // The reminders whose time, a deadline less an offset, falls after the
+  // previous call and no later than now, earliest first.
+  std::vector<DueNotification> takeOccurrences(const DateTime &now);
+  // The first reminder time after after, if any task is left to remind.
+  std::optional<DateTime> nextOccurrence(const DateTime &after) const;
+  // When the rule should wake next: its next occurrence, or after + recheck
+  // if that comes first.
+  DateTime nextCheck(const DateTime &after) const;
+
+  // The rule itself never fires; its occurrences do.
+  bool shouldTrigger(const DateTime &currentTime) const override;
+  void display() const override;
+};
+
+#endif // REMINDER_RULE_H
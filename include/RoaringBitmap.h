@@ -0,0 +1,82 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed set of 32-bit integers in the style of Roaring bitmaps. Values
+// are split by their high 16 bits into containers; a container holds its low
+// 16 bits either as a sorted array (sparse, up to kArrayMax values) or as a
+// 65536-bit bitmap (dense), so counts and intersections reduce to merges and
+// popcounts over at most 1024 words per container.
+class RoaringBitmap {
+public:
+  static constexpr std::uint32_t kArrayMax = 4096;
+  static constexpr std::size_t kBitmapWords = 1024;
+
+private:
+  struct Container {
+    std::uint16_t key = 0;
+    std::uint32_t cardinality = 0;
+    std::vector<std::uint16_t> array;
+    std::vector<std::uint64_t> bits;
+
+    bool isBitmap() const { return !bits.empty(); }
+    bool contains(std::uint16_t low) const;
+    bool add(std::uint16_t low);
+    bool remove(std::uint16_t low);
+    void toBitmap();
+    void toArray();
+  };
+
+  std::vector<Container> containers_;
+
+  std::vector<Container>::iterator findContainer(std::uint16_t key);
+  std::vector<Container>::const_iterator
+  findContainer(std::uint16_t key) const;
+
+  static std::uint32_t andCardinality(const Container &a, const Container &b);
+  static Container intersect(const Container &a, const Container &b);
+
+public:
+  // Return whether the set changed.
+  bool add(std::uint32_t value);
+  bool remove(std::uint32_t value);
+  bool contains(std::uint32_t value) const;
+
+  std::uint64_t cardinality() const;
+  bool empty() const { return containers_.empty(); }
+  void clear() { containers_.clear(); }
+  std::size_t memoryUsage() const;
+
+  static std::uint64_t andCardinality(const RoaringBitmap &a,
+                                      const RoaringBitmap &b);
+  static RoaringBitmap intersect(const RoaringBitmap &a,
+                                 const RoaringBitmap &b);
+
+  // Calls visit(value) for every value in increasing order.
+  template <typename Visit> void forEach(Visit &&visit) const {
+    for (const auto &container : containers_) {
+      std::uint32_t high = static_cast<std::uint32_t>(container.key) << 16;
+      if (container.isBitmap()) {
+        for (std::size_t w = 0; w < kBitmapWords; ++w) {
+          std::uint64_t word = container.bits[w];
+          while (word) {
+            visit(high | static_cast<std::uint32_t>(w * 64 + lowestBit(word)));
+            word &= word - 1;
+          }
+        }
+      } else {
+        for (std::uint16_t low : container.array) {
+          visit(high | low);
+        }
+      }
+    }
+  }
+
+  static unsigned popcount(std::uint64_t word);
+  static unsigned lowestBit(std::uint64_t word);
+};
+
+#endif // ROARING_BITMAP_H
@@ -0,0 +1,148 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Generational handle: a slot index plus the generation the slot had when
+// the object was stored. Once the object is gone the slot's generation
+// moves on, so a stale handle resolves to nothing instead of to whatever
+// reuses the slot. The default handle is null.
+template <typename Tag> struct Handle {
+  std::uint32_t index = 0;
+  std::uint32_t generation = 0;
+
+  explicit operator bool() const { return generation != 0; }
+  bool operator==(const Handle &other) const {
+    return index == other.index && generation == other.generation;
+  }
+  bool operator!=(const Handle &other) const { return !(*this == other); }
+
+  // Both fields in one integer, e.g. to hand to JavaScript as a string.
+  std::uint64_t value() const {
+    return (std::uint64_t(generation) << 32) | index;
+  }
+  static Handle fromValue(std::uint64_t value) {
+    return {static_cast<std::uint32_t>(value),
+            static_cast<std::uint32_t>(value >> 32)};
+  }
+};
+
+struct SubjectTag;
+struct TaskTag;
+struct NotificationTag;
+
+using SubjectId = Handle<SubjectTag>;
+// Resolved through TaskStore, whose rows are the task slots.
+using TaskId = Handle<TaskTag>;
+using NotificationId = Handle<NotificationTag>;
+
+// Slots addressed by Handle<Tag>. A slot's generation is odd while it holds
+// a value and even while free, so a handle is only ever valid for one
+// occupant. Slots live in fixed chunks that never move: insert and erase
+// lock, get() does not and is safe while other slots change.
+template <typename T, typename Tag> class SlotMap {
+public:
+  using Id = Handle<Tag>;
+  static constexpr std::size_t kChunkSlots = 4096;
+  static constexpr std::size_t kMaxChunks = 4096;
+
+private:
+  struct Slot {
+    std::atomic<std::uint32_t> generation{0};
+    T value{};
+  };
+
+  std::mutex mutex_;
+  std::unique_ptr<std::unique_ptr<Slot[]>[]> chunks_;
+  std::atomic<std::uint32_t> used_{0};
+  std::vector<std::uint32_t> free_;
+  std::size_t size_ = 0;
+
+  Slot &slot(std::uint32_t index) const {
+    return chunks_[index / kChunkSlots][index % kChunkSlots];
+  }
+
+  Slot *find(Id id) const {
+    if (!id || id.index >= used_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    Slot &s = slot(id.index);
+    return s.generation.load(std::memory_order_acquire) == id.generation
+               ? &s
+               : nullptr;
+  }
+
+public:
+  SlotMap()
+      : chunks_(std::make_unique<std::unique_ptr<Slot[]>[]>(kMaxChunks)) {}
+
+  SlotMap(const SlotMap &) = delete;
+  SlotMap &operator=(const SlotMap &) = delete;
+
+  Id insert(T value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint32_t index;
+    if (!free_.empty()) {
+      index = free_.back();
+      free_.pop_back();
+    } else {
+      index = used_.load(std::memory_order_relaxed);
+      std::size_t chunk = index / kChunkSlots;
+      if (chunk >= kMaxChunks) {
+        throw std::length_error("SlotMap: too many slots");
+      }
+      if (!chunks_[chunk]) {
+        chunks_[chunk] = std::make_unique<Slot[]>(kChunkSlots);
+      }
+    }
+    Slot &s = slot(index);
+    s.value = std::move(value);
+    std::uint32_t generation =
+        s.generation.load(std::memory_order_relaxed) + 1;
+    s.generation.store(generation, std::memory_order_release);
+    if (index == used_.load(std::memory_order_relaxed)) {
+      used_.store(index + 1, std::memory_order_release);
+    }
+    ++size_;
+    return {index, generation};
+  }
+
+  // Returns false if the handle is stale or null.
+  bool erase(Id id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *s = find(id);
+    if (!s) {
+      return false;
+    }
+    s->generation.store(id.generation + 1, std::memory_order_release);
+    s->value = T{};
+    free_.push_back(id.index);
+    --size_;
+    return true;
+  }
+
+  // nullptr for a stale or null handle.
+  T *get(Id id) {
+    Slot *s = find(id);
+    return s ? &s->value : nullptr;
+  }
+  const T *get(Id id) const {
+    const Slot *s = find(id);
+    return s ? &s->value : nullptr;
+  }
+  bool contains(Id id) const { return find(id) != nullptr; }
+
+  std::size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+};
+
+#endif // SLOT_MAP_H
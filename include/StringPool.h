@@ -0,0 +1,47 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+// Reference-counted interned strings. Each distinct string is stored once,
+// behind its 4-byte length as SymbolTable::view() expects and with a use
+// count in front of that, and is freed when its last user releases it.
+// Not synchronised; TaskStore calls it under its mutex.
+class StringPool {
+private:
+  struct Header {
+    std::uint32_t uses;
+    std::uint32_t size;
+  };
+  struct Hash {
+    std::size_t operator()(std::string_view text) const;
+  };
+
+  // Keys view the stored bytes they map to.
+  std::unordered_map<std::string_view, char *, Hash> strings_;
+  std::size_t bytes_ = 0;
+
+  static Header &header(const char *stored);
+
+public:
+  StringPool() = default;
+  ~StringPool();
+
+  StringPool(const StringPool &) = delete;
+  StringPool &operator=(const StringPool &) = delete;
+
+  // The stored bytes equal to text, with one more use.
+  const char *acquire(std::string_view text);
+  // Drops one use of a pointer returned by acquire(); frees the bytes after
+  // the last.
+  void release(const char *stored);
+
+  // Distinct strings in use.
+  std::size_t size() const { return strings_.size(); }
+  std::size_t memoryUsage() const;
+};
+
+#endif // STRING_POOL_H
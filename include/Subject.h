@@ -3,38 +3,112 @@
 
 #include "PerformanceVisitable.h"
 #include "PerformanceVisitor.h"
+#include "SlotMap.h"
+#include "TaskSpan.h"
+#include "TitleIndex.h"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Task;
+class TaskListener;
 
 class SubjectBuilder;
 
 class Subject : public PerformanceVisitable {
 private:
+  std::uint32_t id;
+  SubjectId handle;
   std::string name;
   std::string code;
   std::string description;
-  std::vector<std::shared_ptr<Task>> tasks;
+  // removeTask() leaves a null tombstone; compact() squeezes them out. The
+  // three members below are mutable for the lazy compaction in the const
+  // positional readers.
+  mutable std::vector<std::shared_ptr<Task>> tasks;
+  // Title -> position in tasks; titles are unique within a subject.
+  mutable TitleIndex titleIndex{tasks};
+  // Parallel to tasks: the order in which each task was added, which
+  // SubjectVersion keeps to list frozen tasks in the same order.
+  mutable std::vector<std::uint64_t> sequence;
+  mutable std::size_t tombstones = 0;
+  std::uint64_t nextSequence = 0;
+  std::vector<TaskListener *> listeners;
 
   friend class SubjectBuilder;
+  friend class SubjectVersion;
+  friend class Task;
+
+  // Called by Task::setTitle for tasks of this subject.
+  void retitleTask(Task &task, const std::string &title);
+  // Drops the tombstones, keeping the order of the remaining tasks. O(n).
+  void compact() const;
 
 public:
   Subject(const std::string &name, const std::string &code,
           const std::string &description = "");
+  ~Subject() override;
+  // Use clone(): a copy would share the id and the listeners.
+  Subject(const Subject &) = delete;
+  Subject &operator=(const Subject &) = delete;
 
+  // Process-unique and never reused; identifies the subject in TaskStore's
+  // subject column.
+  std::uint32_t getId() const { return id; }
+  // Generational handle held by this subject's tasks in place of a pointer.
+  SubjectId getHandle() const { return handle; }
+  // The subject with this handle, or nullptr once it has been destroyed.
+  static Subject *resolve(SubjectId handle);
   std::string getName() const;
   std::string getCode() const;
   std::string getDescription() const;
+  // Owning copy: one reference count increment per task. Prefer taskView() or
+  // forEachTask() unless the result has to outlive changes to the subject.
   std::vector<std::shared_ptr<Task>> getTasks() const;
+  // Zero-copy view in insertion order; see TaskSpan for when it goes stale.
+  // Like getTasks(), compacts first if tasks were removed since the last
+  // call, so it must not race with other calls on this subject even though
+  // it is const.
+  TaskSpan taskView() const {
+    compact();
+    return TaskSpan(tasks);
+  }
+  // Calls fn(Task &) for every task in insertion order. fn must not add or
+  // remove tasks of this subject; changing a task's state or deadline is
+  // fine.
+  template <typename Fn> void forEachTask(Fn &&fn) const {
+    for (const auto &task : tasks) {
+      if (task) {
+        fn(*task);
+      }
+    }
+  }
+  std::size_t getTaskCount() const;
 
   void addTask(std::shared_ptr<Task> task);
-  void removeTask(const std::string &title);
-  std::shared_ptr<Task> findTask(const std::string &title) const;
+  // Adds many tasks with one duplicate-title pass instead of one per task.
+  void addTasks(const std::vector<std::shared_ptr<Task>> &batch);
+  // Title lookups are hashed. Removal keeps the order of the other tasks
+  // and is O(1) amortised: it leaves a tombstone, and the tombstones are
+  // compacted away once they are half the vector or by the next positional
+  // read.
+  void removeTask(std::string_view title);
+  std::shared_ptr<Task> findTask(std::string_view title) const;
+  // Deep copy: the returned subject owns clones of every task.
+  std::shared_ptr<Subject> clone() const;
 
   void displayInfo() const;
 
+  // Listeners receive add/remove events for this subject's tasks and are
+  // forwarded their deadline, state, marks, description and title changes.
+  // Not copied by clone().
+  void addListener(TaskListener *listener);
+  void removeListener(TaskListener *listener);
+  const std::vector<TaskListener *> &getListeners() const;
+
   double accept(PerformanceVisitor &visitor) override;
 };
 
@@ -0,0 +1,98 @@
+#ifndef SUBJECT_VERSION_H
+#define SUBJECT_VERSION_H
+
+#include "PersistentMap.h"
+#include "SlotMap.h"
+#include "TaskSpan.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Subject;
+class Task;
+
+// The frozen form of a Subject, as held by a RegistryVersion. Its tasks are
+// copies of the live ones, kept in a persistent map by title: the version
+// that follows a change to one task copies that task and the O(log32 n)
+// nodes on its path, and shares every other task with the version before.
+// Each task keeps the live subject's insertion sequence, and the list in
+// that order behind taskView() is built on first use, once per version.
+//
+// Frozen tasks (Task::freeze()) are read-only, belong to no subject
+// (getSubject() is nullptr), so the registry's mutations do not accept their
+// ids, and are unknown to NotificationManager. Each one is kept with the id
+// of the live task it was copied from, which is what those mutations take.
+class SubjectVersion {
+public:
+  struct FrozenTask {
+    std::uint64_t sequence;
+    std::shared_ptr<const Task> task;
+    TaskId live;
+  };
+
+private:
+  std::string name;
+  std::string code;
+  std::string description;
+  PersistentMap<FrozenTask> tasks;
+  mutable std::once_flag orderedOnce;
+  mutable std::vector<std::shared_ptr<const Task>> ordered;
+
+  SubjectVersion(std::string name, std::string code, std::string description,
+                 PersistentMap<FrozenTask> tasks);
+
+  const std::vector<std::shared_ptr<const Task>> &inOrder() const;
+
+public:
+  SubjectVersion(const SubjectVersion &) = delete;
+  SubjectVersion &operator=(const SubjectVersion &) = delete;
+
+  // Copies every task of subject; O(n).
+  static std::shared_ptr<const SubjectVersion> freeze(const Subject &subject);
+  // This version with the tasks titled titles copied again from subject, or
+  // dropped where subject no longer has them. O(log n) and one task copy per
+  // title; everything else is shared.
+  std::shared_ptr<const SubjectVersion>
+  refreeze(const Subject &subject,
+           const std::vector<std::string_view> &titles) const;
+  // This version with the tasks titled titles naming the ids they have in
+  // subject; the copies themselves are shared. O(log n) per title.
+  std::shared_ptr<const SubjectVersion>
+  relink(const Subject &subject, const std::vector<std::string> &titles) const;
+  // A live subject owning copies of these tasks, in the same order.
+  std::shared_ptr<Subject> thaw() const;
+  // Brings live, whose tasks match from, to this version through its own
+  // tasks: those that differ are changed in place by their setters, so
+  // their ids, notifications and listeners stay with them; those from does
+  // not have are added as copies and those this version lacks are removed.
+  // Returns the titles whose live id is no longer the one kept here, for
+  // relink(). O(changed tasks).
+  std::vector<std::string> restoreInto(Subject &live,
+                                       const SubjectVersion &from) const;
+
+  std::string getName() const { return name; }
+  std::string getCode() const { return code; }
+  std::string getDescription() const { return description; }
+  std::vector<std::shared_ptr<const Task>> getTasks() const {
+    return inOrder();
+  }
+  // In the live subject's order; valid for as long as this version is held.
+  ConstTaskSpan taskView() const { return ConstTaskSpan(inOrder()); }
+  template <typename Fn> void forEachTask(Fn &&fn) const {
+    for (const auto &task : inOrder()) {
+      fn(*task);
+    }
+  }
+  std::size_t getTaskCount() const { return tasks.size(); }
+  // O(log32 n); does not build the ordered list.
+  std::shared_ptr<const Task> findTask(std::string_view title) const;
+  // The id of the live task this copy was taken from; null if there is no
+  // such title. Stale, and resolving to nothing, once that task is gone.
+  TaskId findLiveId(std::string_view title) const;
+};
+
+#endif // SUBJECT_VERSION_H
@@ -0,0 +1,62 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using SymbolId = std::uint32_t;
+
+constexpr SymbolId kInvalidSymbol = 0xFFFFFFFFu;
+
+// Interns string keys (subject codes, "internship_N", ...) into dense integer
+// ids. The hash index is a flat open-addressing table with linear probing;
+// interned bytes live in an append-only arena so views never move.
+class SymbolTable {
+private:
+  struct Slot {
+    std::uint32_t hash;
+    SymbolId id;
+  };
+
+  std::vector<const char *> names_;
+  std::vector<std::uint32_t> hashes_;
+  std::vector<Slot> slots_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::size_t blockUsed_ = 0;
+  std::size_t blockCapacity_ = 0;
+  std::size_t arenaBytes_ = 0;
+
+  const char *store(std::string_view text);
+  void rehash(std::size_t newCapacity);
+
+public:
+  SymbolTable() = default;
+
+  SymbolTable(const SymbolTable &) = delete;
+  SymbolTable &operator=(const SymbolTable &) = delete;
+
+  SymbolId intern(std::string_view text);
+  // Same as intern(text) for callers that already hold hash(text).
+  SymbolId intern(std::string_view text, std::uint32_t textHash);
+  SymbolId find(std::string_view text) const;
+  std::string_view name(SymbolId id) const;
+  std::uint32_t hashOf(SymbolId id) const { return hashes_[id]; }
+
+  // Compares text against interned bytes given only name(id).data().
+  static bool equals(const char *stored, std::string_view text);
+  // name(id) recovered from name(id).data() alone; the pointer is stable
+  // for the table's lifetime, so it can be stored in place of the id.
+  static std::string_view view(const char *stored);
+
+  std::size_t size() const { return names_.size(); }
+  std::size_t memoryUsage() const;
+
+  // 32-bit hash used by every flat table keyed by interned strings, so a
+  // symbol's stored hash can seed probes in those tables too.
+  static std::uint32_t hash(std::string_view text);
+};
+
+#endif // SYMBOL_TABLE_H
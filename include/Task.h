@@ -1,66 +1,120 @@
 #ifndef TASK_H
 #define TASK_H
 
+#include "SlotMap.h"
+#include "TaskStore.h"
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Subject;
 class Notification;
 class TaskState;
+enum class TaskStateKind : std::uint8_t;
+enum class TaskEvent : std::uint8_t;
 
 using DateTime = std::chrono::system_clock::time_point;
 
+// Same order as the type codes used by the snapshot format.
+enum class TaskType : std::uint8_t { Lab, Project, Exam };
+
+constexpr const char *taskTypeName(TaskType type) {
+  constexpr const char *names[] = {"Lab", "Project", "Exam"};
+  return names[static_cast<std::size_t>(type)];
+}
+
+// A handle onto a row of TaskStore::global(), which holds the interned
+// title and description, deadline, state kind, type, marks and subject id in
+// packed columns; the state is the one-byte kind in that row, moved by the
+// table in TaskState.h. The object itself is the row plus a generational
+// handle to its subject, which resolves to nothing once the subject is gone.
+// Notifications are looked up in NotificationManager by getHandle(), and a
+// state that is not built in is kept by the store.
 class Task {
 private:
-  std::string title_;
-  std::string description_;
-  DateTime deadline_;
-  std::shared_ptr<Subject> subject_;
-  std::vector<std::shared_ptr<Notification>> notifications_;
-  int marks_;
-  std::shared_ptr<TaskState> state_;
+  TaskStore::Row row_;
+  SubjectId subject_;
+  // Set by freeze(); NotificationManager never hears of this copy.
+  bool frozen_ = false;
 
-public:
-  Task(const std::string &title, const DateTime &deadline,
-       const std::string &description = "");
+  std::shared_ptr<TaskState> customState() const {
+    return TaskStore::global().customState(row_);
+  }
 
-  virtual ~Task() = default;
+protected:
+  Task(TaskType type, const std::string &title, const DateTime &deadline,
+       const std::string &description = "");
+  // Copies into a new row; used by copy().
+  Task(const Task &other);
+  // A copy of the same type, still naming this task's subject.
+  virtual std::shared_ptr<Task> copy() const = 0;
 
+public:
+  virtual ~Task();
+  Task &operator=(const Task &) = delete;
+
+  TaskStore::Row getRow() const { return row_; }
+  // Stable id of this task; never matches a later task reusing the row.
+  TaskId getHandle() const {
+    return {row_, TaskStore::global().generation(row_)};
+  }
+  // The task with this id, or nullptr once it has been destroyed.
+  static Task *resolve(TaskId id) {
+    return TaskStore::global().owner(id.index, id.generation);
+  }
+
+  // Built-in states are stored as their kind; any other TaskState is kept
+  // and asked to handle later events.
   void setState(std::shared_ptr<TaskState> newState);
+  // Allocation-free; notifies listeners even if the kind is unchanged.
+  void setStateKind(TaskStateKind kind);
+  // The custom state, or the shared flyweight for the built-in kind.
   std::shared_ptr<TaskState> getState() const;
-
-  std::string getTitle() const;
-  std::string getDescription() const;
+  // Fires event through kTaskTransitions from the current kind, running
+  // the transition's hooks. Does nothing if the table has no transition.
+  void apply(TaskEvent event);
+
+  // Views of interned bytes, valid while the task exists and keeps this
+  // title or description; copy them to keep them longer.
+  std::string_view getTitle() const;
+  std::string_view getDescription() const;
   DateTime getDeadline() const;
-  std::shared_ptr<Subject> getSubject() const;
+  // nullptr if unassigned or the subject has been destroyed.
+  Subject *getSubject() const;
+  SubjectId getSubjectHandle() const { return subject_; }
+  // The notifications NotificationManager holds for this task.
   std::vector<std::shared_ptr<Notification>> getNotifications() const;
   int getMarks() const;
 
   bool isCompleted() const;
   float getProgress() const;
   std::string getStateName() const;
+  TaskStateKind getStateKind() const;
 
   void setTitle(const std::string &title);
   void setDescription(const std::string &description);
   void setDeadline(const DateTime &deadline);
-  void setSubject(std::shared_ptr<Subject> subject);
+  void setSubject(Subject *subject);
   void setMarks(int marks);
 
   void startTask();
   void completeTask();
   void reopenTask();
 
-  void addNotification(std::shared_ptr<Notification> notification);
-  void removeNotification(size_t index);
-
   virtual void displayInfo() const;
-  virtual std::string getType() const = 0;
-
-  friend class PendingState;
-  friend class InProgressState;
-  friend class CompletedState;
+  // Read from the row, so neither allocates nor dispatches.
+  std::string_view getType() const { return taskTypeName(getTaskType()); }
+  TaskType getTaskType() const { return TaskStore::global().type(row_); }
+  // Copy of the task, including its state and marks, not yet attached to a
+  // subject.
+  std::shared_ptr<Task> clone() const;
+  // The same, as kept by a published SubjectVersion: read-only, and neither
+  // its creation nor its destruction reaches NotificationManager.
+  std::shared_ptr<const Task> freeze() const;
+  bool isFrozen() const { return frozen_; }
 };
 
 class LabTask : public Task {
@@ -68,7 +122,8 @@ public:
   LabTask(const std::string &title, const DateTime &deadline,
           const std::string &description = "");
 
-  std::string getType() const override { return "Lab"; }
+protected:
+  std::shared_ptr<Task> copy() const override;
 };
 
 class ProjectTask : public Task {
@@ -76,7 +131,8 @@ public:
   ProjectTask(const std::string &title, const DateTime &deadline,
               const std::string &description = "");
 
-  std::string getType() const override { return "Project"; }
+protected:
+  std::shared_ptr<Task> copy() const override;
 };
 
 class ExamTask : public Task {
@@ -84,7 +140,8 @@ public:
   ExamTask(const std::string &title, const DateTime &deadline,
            const std::string &description = "");
 
-  std::string getType() const override { return "Exam"; }
+protected:
+  std::shared_ptr<Task> copy() const override;
 };
 
 class TaskFactory {
@@ -0,0 +1,81 @@
+#ifndef TASK_BITMAP_INDEX_H
+#define TASK_BITMAP_INDEX_H
+
+#include "RoaringBitmap.h"
+#include "Task.h"
+#include "TaskListener.h"
+#include "TaskState.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Subject;
+
+// Unset members match every task.
+struct TaskFilter {
+  std::optional<TaskStateKind> state;
+  std::optional<TaskType> type;
+  const Subject *subject = nullptr;
+
+  // Checks one task directly, for callers that already hold it.
+  bool matches(const Task &task) const;
+};
+
+// Bitmap indexes over the tasks of every attached subject: one bitmap per
+// state kind, per task type and per subject, keyed by a dense task id. Counts
+// such as "completed exams in CS101" are popcounts of an intersection and
+// never touch the tasks themselves.
+class TaskBitmapIndex : public TaskListener {
+private:
+  static constexpr std::size_t kStateKinds = 3;
+  static constexpr std::size_t kTaskTypes = 3;
+
+  std::vector<Task *> tasks_;
+  std::vector<const Subject *> subjectOf_;
+  std::vector<TaskStateKind> stateOf_;
+  std::vector<std::uint32_t> freeIds_;
+  std::unordered_map<const Task *, std::uint32_t> ids_;
+
+  RoaringBitmap byState_[kStateKinds];
+  RoaringBitmap byType_[kTaskTypes];
+  std::unordered_map<const Subject *, RoaringBitmap> bySubject_;
+  std::unordered_set<Subject *> attached_;
+
+  void insert(Task &task, const Subject *subject);
+  void erase(std::uint32_t id);
+  // Bitmaps selected by the filter; empty when it matches every task.
+  std::vector<const RoaringBitmap *> bitmapsFor(const TaskFilter &filter,
+                                                bool &matchesNothing) const;
+
+public:
+  TaskBitmapIndex() = default;
+  ~TaskBitmapIndex() override;
+
+  TaskBitmapIndex(const TaskBitmapIndex &) = delete;
+  TaskBitmapIndex &operator=(const TaskBitmapIndex &) = delete;
+
+  void attach(Subject &subject);
+  void detach(Subject &subject);
+  void clear();
+
+  std::uint64_t count(const TaskFilter &filter) const;
+  // Matching tasks in id order.
+  std::vector<Task *> select(const TaskFilter &filter) const;
+
+  std::size_t size() const { return ids_.size(); }
+  std::size_t memoryUsage() const;
+
+  void onTaskAdded(Task &task) override;
+  void onTaskRemoved(Task &task) override;
+  void onDeadlineChanged(Task &task, const DateTime &previous) override;
+  void onStateChanged(Task &task) override;
+  void onMarksChanged(Task &task) override;
+  void onDescriptionChanged(Task &task) override;
+  void onTitleChanged(Task &task, const std::string &previous) override;
+  void onSubjectDestroyed(Subject &subject) override;
+};
+
+#endif // TASK_BITMAP_INDEX_H
@@ -11,7 +11,8 @@ private:
   std::string title;
   std::string description;
   DateTime deadline;
-  std::shared_ptr<TaskFactory> factory;
+  // One of the shared factory singletons; they hold no state.
+  TaskFactory *factory;
 
 public:
   TaskBuilder();
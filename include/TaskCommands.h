@@ -8,19 +8,33 @@
 
 class SetTaskStateCommand : public Command {
 private:
-  Task &task_;
+  // Resolved on execute and undo, so a command left in the history after
+  // its task was destroyed does nothing instead of touching freed memory.
+  TaskId task_;
 
-  std::shared_ptr<TaskState> newState_;
+  TaskStateKind target_;
+  // Set only when the target is not a built-in state.
+  std::shared_ptr<TaskState> customTarget_;
 
+  // The task's state before execute(): a shared flyweight or custom state.
   std::shared_ptr<TaskState> previousState_;
 
 public:
   SetTaskStateCommand(Task &taskToModify,
                       std::shared_ptr<TaskState> targetState);
+  SetTaskStateCommand(Task &task, TaskStateKind target);
 
   void execute() override;
 
   void undo() override;
+  bool compact(CommandRecord &record) const override;
+
+  // What execute() and undo() do for built-in states, without an object;
+  // CommandManager replays its records through these. transition() is run()
+  // without the log line.
+  static void transition(Task &task, TaskStateKind target);
+  static void run(Task &task, TaskStateKind target);
+  static void revert(Task &task, TaskStateKind previous);
 };
 
 #endif // TASK_COMMANDS_H
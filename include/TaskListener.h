@@ -0,0 +1,26 @@
+#ifndef TASK_LISTENER_H
+#define TASK_LISTENER_H
+
+#include "Task.h"
+#include <string>
+
+class Subject;
+
+// Typed change notifications for indexes kept over a subject's tasks. A
+// subject forwards events for its own tasks to every registered listener.
+class TaskListener {
+public:
+  virtual ~TaskListener() = default;
+
+  virtual void onTaskAdded(Task &task) = 0;
+  virtual void onTaskRemoved(Task &task) = 0;
+  virtual void onDeadlineChanged(Task &task, const DateTime &previous) = 0;
+  virtual void onStateChanged(Task &task) = 0;
+  virtual void onMarksChanged(Task &task) = 0;
+  virtual void onDescriptionChanged(Task &task) = 0;
+  // The task already carries its new title.
+  virtual void onTitleChanged(Task &task, const std::string &previous) = 0;
+  virtual void onSubjectDestroyed(Subject &subject) = 0;
+};
+
+#endif // TASK_LISTENER_H
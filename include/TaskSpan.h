@@ -0,0 +1,46 @@
+#ifndef TASK_SPAN_H
+#define TASK_SPAN_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Task;
+
+// Non-owning, read-only view of a contiguous run of task pointers, such as
+// the tasks of a Subject. Copying a span copies two pointers; nothing is
+// reference counted. A span is invalidated by whatever invalidates iterators
+// of the underlying vector: for Subject::taskView() that is addTask, addTasks,
+// removeTask (and so the compaction of its tombstones by a later taskView()
+// or getTasks()) and destroying the subject. Hold a shared_ptr to an element (or
+// call Subject::getTasks()) to keep tasks beyond that.
+template <typename T> class BasicTaskSpan {
+public:
+  using value_type = std::shared_ptr<T>;
+  using const_iterator = const value_type *;
+  using iterator = const_iterator;
+
+private:
+  const value_type *first_ = nullptr;
+  std::size_t size_ = 0;
+
+public:
+  BasicTaskSpan() = default;
+  BasicTaskSpan(const value_type *first, std::size_t size)
+      : first_(first), size_(size) {}
+  // Implicit so that existing vector arguments keep working.
+  BasicTaskSpan(const std::vector<value_type> &tasks)
+      : first_(tasks.data()), size_(tasks.size()) {}
+
+  const_iterator begin() const { return first_; }
+  const_iterator end() const { return first_ + size_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const value_type &operator[](std::size_t i) const { return first_[i]; }
+};
+
+using TaskSpan = BasicTaskSpan<Task>;
+// Over the frozen tasks of a SubjectVersion, which must not change.
+using ConstTaskSpan = BasicTaskSpan<const Task>;
+
+#endif // TASK_SPAN_H
@@ -1,11 +1,72 @@
 #ifndef TASK_STATE_H
 #define TASK_STATE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 class Task;
 
+// Same order as the state codes used by the snapshot format.
+enum class TaskStateKind : std::uint8_t { Pending, InProgress, Completed };
+
+enum class TaskEvent : std::uint8_t { Start, Complete, Reopen };
+
+// Side effects run when a transition fires.
+enum TaskTransitionHook : std::uint8_t {
+  kNoHook = 0,
+  // Marks only mean something for completed work.
+  kResetMarks = 1 << 0,
+};
+
+struct TaskTransition {
+  TaskStateKind to;
+  std::uint8_t hooks;
+};
+
+// The whole built-in state machine: kTaskTransitions[from][event]. An entry
+// whose target equals its source is a no-op.
+constexpr TaskTransition kTaskTransitions[3][3] = {
+    // Pending
+    {{TaskStateKind::InProgress, kNoHook},
+     {TaskStateKind::Completed, kNoHook},
+     {TaskStateKind::Pending, kNoHook}},
+    // InProgress
+    {{TaskStateKind::InProgress, kNoHook},
+     {TaskStateKind::Completed, kNoHook},
+     {TaskStateKind::Pending, kResetMarks}},
+    // Completed
+    {{TaskStateKind::Completed, kNoHook},
+     {TaskStateKind::Completed, kNoHook},
+     {TaskStateKind::InProgress, kResetMarks}},
+};
+
+constexpr TaskTransition taskTransition(TaskStateKind from, TaskEvent event) {
+  return kTaskTransitions[static_cast<std::size_t>(from)]
+                         [static_cast<std::size_t>(event)];
+}
+
+constexpr const char *taskStateName(TaskStateKind kind) {
+  constexpr const char *names[] = {"Pending", "In Progress", "Completed"};
+  return names[static_cast<std::size_t>(kind)];
+}
+
+constexpr float taskStateProgress(TaskStateKind kind) {
+  constexpr float progress[] = {0.0f, 50.0f, 100.0f};
+  return progress[static_cast<std::size_t>(kind)];
+}
+
+static_assert(taskTransition(TaskStateKind::Pending, TaskEvent::Start).to ==
+                  TaskStateKind::InProgress,
+              "transition table rows follow TaskStateKind order");
+
+// Optional extension point. Built-in states are just the TaskStateKind
+// stored in the task's TaskStore row, driven by kTaskTransitions; these
+// classes remain so callers can name a state as an object (commands, the
+// State-pattern API). A task only holds a TaskState object when given one
+// that is not built in; its start/complete/reopen then decide transitions,
+// defaulting to the table.
 class TaskState {
 public:
   virtual ~TaskState() = default;
@@ -15,35 +76,39 @@ public:
   virtual void reopen(Task &task);
 
   virtual std::string getName() const = 0;
+  virtual TaskStateKind getKind() const = 0;
   virtual float getConceptualProgress() const = 0;
   virtual bool isFinished() const;
+  // True for the classes below, which are fully described by getKind().
+  virtual bool isBuiltin() const { return false; }
+
+  // Shared immutable instances of the built-in states; never allocates.
+  static const std::shared_ptr<TaskState> &flyweight(TaskStateKind kind);
 };
 
-class PendingState : public TaskState {
+class PendingState final : public TaskState {
 public:
-  void start(Task &task) override;
-  void complete(Task &task) override;
-
   std::string getName() const override { return "Pending"; }
+  TaskStateKind getKind() const override { return TaskStateKind::Pending; }
   float getConceptualProgress() const override { return 0.0f; }
+  bool isBuiltin() const override { return true; }
 };
 
-class InProgressState : public TaskState {
+class InProgressState final : public TaskState {
 public:
-  void complete(Task &task) override;
-  void reopen(Task &task) override;
-
   std::string getName() const override { return "In Progress"; }
+  TaskStateKind getKind() const override { return TaskStateKind::InProgress; }
   float getConceptualProgress() const override { return 50.0f; }
+  bool isBuiltin() const override { return true; }
 };
 
-class CompletedState : public TaskState {
+class CompletedState final : public TaskState {
 public:
-  void reopen(Task &task) override;
-
   std::string getName() const override { return "Completed"; }
+  TaskStateKind getKind() const override { return TaskStateKind::Completed; }
   float getConceptualProgress() const override { return 100.0f; }
   bool isFinished() const override;
+  bool isBuiltin() const override { return true; }
 };
 
 #endif
@@ -0,0 +1,199 @@
+#ifndef TASK_STORE_H
+#define TASK_STORE_H
+
+#include "StringPool.h"
+#include "SymbolTable.h"
+#include "TaskSpan.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Task;
+class TaskState;
+enum class TaskStateKind : std::uint8_t;
+enum class TaskType : std::uint8_t;
+
+// Aggregates over a set of tasks, computed from the packed columns.
+struct TaskStats {
+  std::uint64_t total = 0;
+  std::uint64_t byState[3] = {};
+  std::uint64_t byType[3] = {};
+  // Sum of the marks of completed tasks.
+  std::int64_t completedMarks = 0;
+};
+
+// Column storage for every Task in the process. A Task object is a handle
+// holding its row number; the scalar fields live here in struct-of-arrays
+// segments (deadline, state, type, marks, subject id). Titles and
+// descriptions are interned: each distinct string in use is stored once in
+// a StringPool and rows keep a pointer to its bytes, so the thousands of
+// tasks sharing "Lab 1" or a course's boilerplate description pay 8 bytes
+// each. A string is freed with the last row using it, so a view returned by
+// title() is valid only while the row keeps that title. A pass over
+// marks or deadlines reads a few packed arrays instead of one heap object,
+// plus its TaskState, per task.
+//
+// Rows are allocated and released under a mutex, so tasks can be created
+// and destroyed on any thread. Each row is then read and written without
+// locking by whoever owns its Task, exactly as the Task's own members were.
+// The scans below read every row: run them when no other thread is
+// changing tasks, as with the registry's live maps.
+//
+// Rows double as the slots behind TaskId: a row's generation is odd while a
+// Task owns it and even once released, in the same scheme as SlotMap.
+class TaskStore {
+public:
+  using Row = std::uint32_t;
+  static constexpr std::size_t kSegmentRows = 4096;
+  static constexpr std::size_t kMaxSegments = std::size_t(1) << 16;
+  // Subject ids start at 1; see Subject::getId.
+  static constexpr std::uint32_t kNoSubject = 0;
+
+  struct Segment {
+    std::int64_t deadline[kSegmentRows];
+    std::int32_t marks[kSegmentRows];
+    std::uint32_t subject[kSegmentRows];
+    TaskStateKind state[kSegmentRows];
+    TaskType type[kSegmentRows];
+    std::uint8_t live[kSegmentRows];
+    // Set while customStates_ holds a TaskState for the row.
+    std::uint8_t custom[kSegmentRows];
+    std::uint32_t generation[kSegmentRows];
+    Task *owner[kSegmentRows];
+    // Interned: SymbolTable::view() recovers the length.
+    const char *title[kSegmentRows];
+    const char *description[kSegmentRows];
+  };
+
+private:
+  std::mutex mutex_;
+  // Fixed-size table so segments never move while other threads read them.
+  std::unique_ptr<std::unique_ptr<Segment>[]> segments_;
+  std::atomic<std::uint32_t> rows_{0};
+  std::vector<Row> freeRows_;
+  std::size_t liveRows_ = 0;
+
+  StringPool strings_;
+  // Rows in a state that is not built in; few, so kept off the columns.
+  std::unordered_map<Row, std::shared_ptr<TaskState>> customStates_;
+
+  Segment &segment(Row row) const {
+    return *segments_[row / kSegmentRows];
+  }
+  // Points slot at text's interned bytes and releases the ones it held.
+  void replaceString(const char *&slot, std::string_view text);
+  template <typename Span> TaskStats statsOf(Span tasks) const;
+
+public:
+  TaskStore();
+  ~TaskStore();
+
+  TaskStore(const TaskStore &) = delete;
+  TaskStore &operator=(const TaskStore &) = delete;
+
+  // The store behind every Task. Never destroyed, so tasks owned by other
+  // statics can outlive it safely at exit.
+  static TaskStore &global();
+
+  Row allocate(std::string_view title, std::string_view description,
+               std::int64_t deadline, TaskType type);
+  // Copies every column of source into a new row.
+  Row duplicate(Row source);
+  void release(Row row);
+
+  std::string_view title(Row row) const {
+    return SymbolTable::view(segment(row).title[row % kSegmentRows]);
+  }
+  std::string_view description(Row row) const {
+    return SymbolTable::view(segment(row).description[row % kSegmentRows]);
+  }
+  std::int64_t deadline(Row row) const {
+    return segment(row).deadline[row % kSegmentRows];
+  }
+  TaskStateKind state(Row row) const {
+    return segment(row).state[row % kSegmentRows];
+  }
+  TaskType type(Row row) const {
+    return segment(row).type[row % kSegmentRows];
+  }
+  int marks(Row row) const { return segment(row).marks[row % kSegmentRows]; }
+  std::uint32_t subject(Row row) const {
+    return segment(row).subject[row % kSegmentRows];
+  }
+  std::uint32_t generation(Row row) const {
+    return segment(row).generation[row % kSegmentRows];
+  }
+  // The Task owning the row if generation still matches, else nullptr.
+  Task *owner(Row row, std::uint32_t generation) const {
+    if (row >= rows_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    const Segment &seg = segment(row);
+    std::size_t i = row % kSegmentRows;
+    return seg.generation[i] == generation ? seg.owner[i] : nullptr;
+  }
+
+  // These two lock: they may free the row's previous string.
+  void setTitle(Row row, std::string_view title) {
+    replaceString(segment(row).title[row % kSegmentRows], title);
+  }
+  void setDescription(Row row, std::string_view description) {
+    replaceString(segment(row).description[row % kSegmentRows], description);
+  }
+  void setDeadline(Row row, std::int64_t deadline) {
+    segment(row).deadline[row % kSegmentRows] = deadline;
+  }
+  void setState(Row row, TaskStateKind state) {
+    segment(row).state[row % kSegmentRows] = state;
+  }
+  void setMarks(Row row, int marks) {
+    segment(row).marks[row % kSegmentRows] = marks;
+  }
+  void setSubject(Row row, std::uint32_t subject) {
+    segment(row).subject[row % kSegmentRows] = subject;
+  }
+  void setOwner(Row row, Task *owner) {
+    segment(row).owner[row % kSegmentRows] = owner;
+  }
+
+  // The row's TaskState if it is in a state that is not built in, else
+  // nullptr. Checks the column first, so built-in rows never lock.
+  std::shared_ptr<TaskState> customState(Row row);
+  // Pass nullptr to go back to a built-in state.
+  void setCustomState(Row row, std::shared_ptr<TaskState> state);
+
+  // Calls visit(segment, rows) for every allocated segment, where rows is
+  // how many of its leading rows have ever been used; check live[] before
+  // reading a row.
+  template <typename Visit> void forEachSegment(Visit &&visit) const {
+    std::size_t used = rows_.load(std::memory_order_acquire);
+    for (std::size_t first = 0; first < used; first += kSegmentRows) {
+      std::size_t rows = used - first < kSegmentRows ? used - first
+                                                     : kSegmentRows;
+      visit(static_cast<const Segment &>(*segments_[first / kSegmentRows]),
+            rows);
+    }
+  }
+
+  // One linear pass over the packed columns of every row in the process,
+  // including the tasks of other registries and of frozen versions.
+  TaskStats stats(std::uint32_t subjectId) const;
+  std::unordered_map<std::uint32_t, TaskStats> statsBySubject() const;
+  // Reads only the rows of these tasks, so it costs O(tasks.size()) and
+  // needs no more than whatever keeps those tasks from changing.
+  TaskStats stats(TaskSpan tasks) const;
+  TaskStats stats(ConstTaskSpan tasks) const;
+
+  std::size_t size();
+  // Bytes held by the string pool.
+  std::size_t arenaBytes();
+  // Distinct titles and descriptions of live rows.
+  std::size_t internedStrings();
+};
+
+#endif // TASK_STORE_H
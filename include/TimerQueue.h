@@ -0,0 +1,62 @@
+#ifndef TIMER_QUEUE_H
+#define TIMER_QUEUE_H
+
+#include "SlotMap.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using DateTime = std::chrono::system_clock::time_point;
+
+// The armed trigger times NotificationManager polls. Timers are keyed by
+// NotificationId; the manager only arms live ids and disarms them before it
+// lets a slot go, so implementations index by NotificationId::index and keep
+// the generation only to answer contains().
+class TimerQueue {
+public:
+  struct Timer {
+    DateTime time;
+    NotificationId id;
+  };
+
+  virtual ~TimerQueue() = default;
+
+  // Arms id at time, or moves it there if it is armed. Returns true when it
+  // may now be the earliest timer; a false positive only costs a wakeup.
+  virtual bool schedule(NotificationId id, const DateTime &time) = 0;
+  // Returns false if id was not armed.
+  virtual bool unschedule(NotificationId id) = 0;
+  virtual bool contains(NotificationId id) const = 0;
+
+  // Disarms every timer due at now and appends them to due, earliest first.
+  virtual void popDue(const DateTime &now, std::vector<Timer> &due) = 0;
+  virtual std::optional<Timer> peek() const = 0;
+  virtual std::size_t size() const = 0;
+};
+
+// Binary min-heap by time, with each timer's heap position indexed by id:
+// O(log n) schedule, unschedule and pop, O(1) peek.
+class HeapTimerQueue : public TimerQueue {
+private:
+  static constexpr std::uint32_t kNotArmed = UINT32_MAX;
+
+  std::vector<Timer> heap_;
+  std::vector<std::uint32_t> position_;
+
+  void place(std::size_t position, const Timer &timer);
+  void siftUp(std::size_t position);
+  void siftDown(std::size_t position);
+  void removeAt(std::size_t position);
+
+public:
+  bool schedule(NotificationId id, const DateTime &time) override;
+  bool unschedule(NotificationId id) override;
+  bool contains(NotificationId id) const override;
+  void popDue(const DateTime &now, std::vector<Timer> &due) override;
+  std::optional<Timer> peek() const override;
+  std::size_t size() const override { return heap_.size(); }
+};
+
+#endif // TIMER_QUEUE_H
@@ -0,0 +1,94 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include "TimerQueue.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Hierarchical timing wheel for very many timers, mostly hours to days out.
+// Time advances in one-minute ticks through three wheels: 60 minute slots
+// for the current hour, 24 hour slots for the current day and 256 day slots
+// for the current run of 256 days, with an overflow list beyond. A timer
+// sits in the finest wheel whose current period it shares: all minute slots
+// fall before all hour slots, and those before all day slots, so slot order
+// is time order.
+//
+// Timers are intrusive doubly-linked list nodes indexed by
+// NotificationId::index, so schedule and unschedule are O(1) and allocate
+// nothing once the node table has grown. popDue moves the current tick
+// forward, skipping empty slots with the occupancy bitmap; crossing into a
+// new hour, day or 256-day run spreads the slot it enters over the finer
+// wheels, so each timer is moved at most three times plus once per run it
+// waits in overflow. Times keep full precision: a minute slot is only
+// partly due until its minute has passed, and popDue sorts each slot it
+// empties. Each slot remembers its earliest node, so peek() and the jump
+// over overflow are O(1); unscheduling that node forgets it, and the next
+// look at the slot scans it once to find the new earliest.
+class TimingWheel : public TimerQueue {
+private:
+  static constexpr std::int64_t kMinutesPerHour = 60;
+  static constexpr std::int64_t kMinutesPerDay = 24 * kMinutesPerHour;
+  static constexpr std::int64_t kDaysPerRun = 256;
+  static constexpr std::int64_t kMinutesPerRun = kDaysPerRun * kMinutesPerDay;
+
+  // Slots of the three wheels in time order, then overflow.
+  static constexpr std::uint16_t kHourSlots = 60;
+  static constexpr std::uint16_t kDaySlots = kHourSlots + 24;
+  static constexpr std::uint16_t kOverflow = kDaySlots + kDaysPerRun;
+  static constexpr std::uint16_t kSlots = kOverflow + 1;
+  static constexpr std::uint16_t kNotArmed = UINT16_MAX;
+  static constexpr std::uint32_t kNil = UINT32_MAX;
+
+  struct Node {
+    DateTime time;
+    std::uint32_t generation = 0;
+    std::uint32_t prev = kNil;
+    std::uint32_t next = kNil;
+    std::uint16_t slot = kNotArmed;
+  };
+
+  std::vector<Node> nodes_;
+  std::array<std::uint32_t, kSlots> heads_;
+  std::array<std::uint64_t, (kSlots + 63) / 64> occupied_{};
+  // Earliest node of each slot, or kNil when the slot is empty or its
+  // earliest was unlinked since; filled in again on demand.
+  mutable std::array<std::uint32_t, kSlots> earliest_;
+  // The current tick, in minutes since the epoch.
+  std::int64_t tick_;
+  std::size_t size_ = 0;
+
+  static std::int64_t tickOf(const DateTime &time);
+
+  void link(std::uint32_t index, std::uint16_t slot);
+  void unlink(std::uint32_t index);
+  // Links the node into the slot its time belongs in as of tick_.
+  void place(std::uint32_t index);
+  // Unlinks a whole slot and places its nodes again.
+  void spread(std::uint16_t slot);
+  // Earliest node of an occupied slot.
+  std::uint32_t earliestIn(std::uint16_t slot) const;
+  // First occupied slot at or after from, or kSlots.
+  std::uint16_t firstOccupied(std::uint16_t from) const;
+  // The next tick after tick_ at which an occupied slot starts.
+  std::optional<std::int64_t> nextStop() const;
+  void moveTo(std::int64_t tick);
+  // Pops the due nodes of the current minute slot.
+  void collect(const DateTime &now, std::vector<Timer> &due);
+
+public:
+  // Ticks start at the minute holding start; timers armed before it are
+  // due at once.
+  explicit TimingWheel(const DateTime &start);
+
+  bool schedule(NotificationId id, const DateTime &time) override;
+  bool unschedule(NotificationId id) override;
+  bool contains(NotificationId id) const override;
+  void popDue(const DateTime &now, std::vector<Timer> &due) override;
+  std::optional<Timer> peek() const override;
+  std::size_t size() const override { return size_; }
+};
+
+#endif // TIMING_WHEEL_H
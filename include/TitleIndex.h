@@ -0,0 +1,64 @@
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class Task;
+
+// Hash index from title to position in a subject's task vector, used for
+// O(1) duplicate checks and lookups. Open addressing with linear probing;
+// each slot holds the title's hash and the position, and keys are compared
+// against the title column in TaskStore, so neither inserts nor string_view
+// probes copy a string. The vector is not owned and must outlive the index;
+// the index has to be told about every change to it and before a title
+// changes.
+class TitleIndex {
+public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+  static constexpr std::uint32_t kEmpty = UINT32_MAX;
+
+  // 8 bytes, so the position pass in renumber() touches little memory. The low
+  // 32 bits of the hash pick the home slot and filter comparisons.
+  struct Slot {
+    std::uint32_t hash;
+    std::uint32_t position; // kEmpty: free
+  };
+
+  const std::vector<std::shared_ptr<Task>> &tasks_;
+  std::vector<Slot> slots_;
+  std::size_t size_ = 0;
+
+  std::size_t mask() const { return slots_.size() - 1; }
+  // Slot holding position, or slots_.size() if it is not indexed.
+  std::size_t slotOf(std::size_t position) const;
+  void removeSlot(std::size_t slot);
+
+public:
+  explicit TitleIndex(const std::vector<std::shared_ptr<Task>> &tasks);
+
+  TitleIndex(const TitleIndex &) = delete;
+  TitleIndex &operator=(const TitleIndex &) = delete;
+
+  // Indexes tasks[position]. Returns false, leaving the index unchanged, if
+  // another indexed task has the same title.
+  bool insert(std::size_t position);
+  // Drops tasks[position] while it is still in the vector.
+  void unlink(std::size_t position);
+  // Moves every indexed position p to to[p], for a compaction of the vector.
+  // One integer pass over the slots; no titles are read.
+  void renumber(const std::vector<std::uint32_t> &to);
+  // Position of the task with this title, or npos.
+  std::size_t find(std::string_view title) const;
+  void reserve(std::size_t count);
+  void clear();
+
+  std::size_t size() const { return size_; }
+};
+
+#endif // TITLE_INDEX_H
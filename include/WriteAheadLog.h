@@ -0,0 +1,117 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct Registry;
+
+enum class WalOp : std::uint8_t {
+  CreateSubject = 1,
+  CreateTask = 2,
+  CreateInternship = 3,
+  CreateResume = 4,
+  ChangeTaskState = 5,
+  ChangeTaskStates = 6,
+  Undo = 7,
+  Redo = 8,
+  SetHistoryDepth = 9,
+};
+
+// One logged Registry mutation. The meaning of fields/values depends on op;
+// see Registry::apply for the layout of each operation.
+struct WalRecord {
+  WalOp op;
+  std::vector<std::string> fields;
+  std::vector<std::int64_t> values;
+};
+
+// Append-only log of Registry mutations. Each record is framed as
+//
+//   u32 payload size | u32 CRC-32 of payload | payload
+//
+// so recovery can stop cleanly at a torn or corrupted tail. append() returns
+// once the record is on stable storage. In GroupCommit mode concurrent
+// writers share fsyncs: the first waiter becomes the leader and flushes every
+// record queued so far while the others wait for it.
+//
+// A failed write or fsync may leave part of a batch in the file, and what
+// follows it would be lost behind the tear at the next recovery. So the
+// log fails for good: the call that hit the error throws it, and every
+// later enqueue(), waitDurable() or checkpoint() throws as well. Recover
+// from the file and open a new log to carry on.
+class WriteAheadLog {
+public:
+  enum class SyncMode { PerOperation, GroupCommit };
+
+private:
+  int fd_ = -1;
+  std::string path_;
+  SyncMode mode_;
+
+  std::mutex mutex_;
+  std::condition_variable flushed_;
+  std::vector<char> pending_;
+  std::uint64_t nextLsn_ = 0;
+  std::uint64_t durableLsn_ = 0;
+  bool flushing_ = false;
+  bool failed_ = false;
+  std::uint64_t syncCount_ = 0;
+
+  void writeAndSync(const std::vector<char> &bytes);
+  // Throws once a write has failed. Called with mutex_ held.
+  void checkNotFailed() const;
+
+  // read(), also reporting the bytes taken up by the intact records.
+  static std::size_t scan(const std::string &path,
+                          const std::function<void(const WalRecord &)> &visit,
+                          std::size_t &intactBytes);
+
+public:
+  explicit WriteAheadLog(const std::string &path,
+                         SyncMode mode = SyncMode::GroupCommit);
+  ~WriteAheadLog();
+
+  WriteAheadLog(const WriteAheadLog &) = delete;
+  WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+  // Returns the log sequence number of the record, which is durable on
+  // return.
+  std::uint64_t append(const WalRecord &record);
+
+  // append() in two steps, for callers that must fix the order of records
+  // under their own lock but should not hold it while waiting for the disk.
+  // Records become durable in sequence-number order.
+  std::uint64_t enqueue(const WalRecord &record);
+  void waitDurable(std::uint64_t lsn);
+
+  // Writes a snapshot of the registry and then empties the log, so recovery
+  // only has to replay what happened after the checkpoint. Mutations must be
+  // paused meanwhile; Registry::checkpoint takes care of that.
+  void checkpoint(const Registry &registry, const std::string &snapshotPath);
+
+  std::uint64_t syncCount();
+  const std::string &path() const { return path_; }
+
+  // Calls visit for each intact record in order and returns how many were
+  // read; reading stops at the first truncated or corrupted record.
+  static std::size_t
+  read(const std::string &path,
+       const std::function<void(const WalRecord &)> &visit);
+
+  // Loads the snapshot (if present) and replays the log on top of it, then
+  // cuts a torn or corrupted tail off the log, so that records appended
+  // after recovery directly follow the last intact one.
+  static std::size_t recover(Registry &registry,
+                             const std::string &snapshotPath,
+                             const std::string &logPath);
+
+  static std::uint32_t crc32(const char *data, std::size_t size);
+};
+
+#endif // WRITE_AHEAD_LOG_H
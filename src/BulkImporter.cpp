@@ -0,0 +1,659 @@
+#include "../include/BulkImporter.h"
+#include "../include/IsoDate.h"
+#include "../include/Registry.h"
+#include "../include/TaskState.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+enum class RowKind { Subject, Task };
+
+// Views into the input line or into the parser's scratch buffers; valid until
+// the next row is parsed.
+struct Row {
+  RowKind kind = RowKind::Subject;
+  std::string_view code;
+  std::string_view name;
+  std::string_view description;
+  std::string_view title;
+  std::string_view deadline;
+  std::string_view type;
+  std::string_view state;
+  std::string_view marks;
+};
+
+struct ChunkResult {
+  ImportBatch batch;
+  std::size_t lines = 0;
+  std::size_t malformed = 0;
+  std::vector<ImportError> errors;
+};
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool parseTaskType(std::string_view text, TaskType &type) {
+  if (text == "Lab" || text == "1") {
+    type = TaskType::Lab;
+  } else if (text == "Project" || text == "2") {
+    type = TaskType::Project;
+  } else if (text == "Exam" || text == "3") {
+    type = TaskType::Exam;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseStateKind(std::string_view text, TaskStateKind &state) {
+  if (text.empty() || text == "Pending" || text == "0") {
+    state = TaskStateKind::Pending;
+  } else if (text == "InProgress" || text == "1") {
+    state = TaskStateKind::InProgress;
+  } else if (text == "Completed" || text == "2") {
+    state = TaskStateKind::Completed;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+class ChunkParser {
+private:
+  BulkImporter::Format format_;
+  std::size_t maxErrors_;
+  LabFactory labs_;
+  ProjectFactory projects_;
+  ExamFactory exams_;
+
+  std::vector<std::string_view> fields_;
+  // One buffer per field so unescaped values stay valid for the whole row;
+  // a deque so growing it does not move the earlier buffers.
+  std::deque<std::string> scratch_;
+
+  std::string &scratch(std::size_t slot) {
+    if (scratch_.size() <= slot) {
+      scratch_.resize(slot + 1);
+    }
+    return scratch_[slot];
+  }
+
+  const char *splitCsv(std::string_view line);
+  const char *parseCsv(std::string_view line, Row &row, bool &skip);
+  const char *parseJsonString(std::string_view line, std::size_t &pos,
+                              std::size_t slot, std::string_view &out);
+  const char *parseJson(std::string_view line, Row &row);
+  const char *addRow(const Row &row, ImportBatch &batch);
+
+public:
+  ChunkParser(BulkImporter::Format format, std::size_t maxErrors)
+      : format_(format), maxErrors_(maxErrors) {}
+
+  ChunkResult parse(std::string_view chunk);
+};
+
+// Splits a CSV line into fields_. Quoted fields with doubled quotes are
+// unescaped into scratch buffers; everything else is a view of the line.
+const char *ChunkParser::splitCsv(std::string_view line) {
+  fields_.clear();
+  std::size_t pos = 0;
+  while (true) {
+    if (pos < line.size() && line[pos] == '"') {
+      std::size_t start = ++pos;
+      bool escaped = false;
+      while (true) {
+        std::size_t quote = line.find('"', pos);
+        if (quote == std::string_view::npos) {
+          return "unterminated quoted field";
+        }
+        if (quote + 1 < line.size() && line[quote + 1] == '"') {
+          escaped = true;
+          pos = quote + 2;
+          continue;
+        }
+        pos = quote + 1;
+        break;
+      }
+      std::string_view raw = line.substr(start, pos - 1 - start);
+      if (escaped) {
+        std::string &buffer = scratch(fields_.size());
+        buffer.clear();
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+          buffer.push_back(raw[i]);
+          if (raw[i] == '"') {
+            ++i;
+          }
+        }
+        fields_.push_back(buffer);
+      } else {
+        fields_.push_back(raw);
+      }
+      if (pos < line.size() && line[pos] != ',') {
+        return "unexpected character after quoted field";
+      }
+    } else {
+      std::size_t comma = line.find(',', pos);
+      std::size_t end = comma == std::string_view::npos ? line.size() : comma;
+      fields_.push_back(line.substr(pos, end - pos));
+      pos = end;
+    }
+
+    if (pos >= line.size()) {
+      return nullptr;
+    }
+    ++pos; // comma
+  }
+}
+
+const char *ChunkParser::parseCsv(std::string_view line, Row &row,
+                                  bool &skip) {
+  if (const char *error = splitCsv(line)) {
+    return error;
+  }
+
+  std::string_view kind = fields_[0];
+  if (kind == "kind") {
+    skip = true;
+    return nullptr;
+  }
+  auto field = [&](std::size_t i) {
+    return i < fields_.size() ? fields_[i] : std::string_view();
+  };
+
+  if (kind == "S") {
+    row.kind = RowKind::Subject;
+    row.code = field(1);
+    row.name = field(2);
+    row.description = field(3);
+    return nullptr;
+  }
+  if (kind == "T") {
+    if (fields_.size() < 6) {
+      return "task rows need subject, title, description, deadline and type";
+    }
+    row.kind = RowKind::Task;
+    row.code = fields_[1];
+    row.title = fields_[2];
+    row.description = fields_[3];
+    row.deadline = fields_[4];
+    row.type = fields_[5];
+    row.state = field(6);
+    row.marks = field(7);
+    return nullptr;
+  }
+  return "unknown row kind";
+}
+
+void appendUtf8(std::string &out, std::uint32_t cp) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+bool parseHex4(std::string_view text, std::size_t pos, std::uint32_t &value) {
+  if (pos + 4 > text.size()) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = pos; i < pos + 4; ++i) {
+    char c = text[i];
+    value <<= 4;
+    if (isDigit(c)) {
+      value |= static_cast<std::uint32_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      value |= static_cast<std::uint32_t>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      value |= static_cast<std::uint32_t>(c - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// pos is on the opening quote. Strings without escapes are returned as views
+// of the line; others are decoded into scratch(slot).
+const char *ChunkParser::parseJsonString(std::string_view line,
+                                         std::size_t &pos, std::size_t slot,
+                                         std::string_view &out) {
+  std::size_t start = ++pos;
+  while (pos < line.size() && line[pos] != '"' && line[pos] != '\\') {
+    ++pos;
+  }
+  if (pos >= line.size()) {
+    return "unterminated string";
+  }
+  if (line[pos] == '"') {
+    out = line.substr(start, pos - start);
+    ++pos;
+    return nullptr;
+  }
+
+  std::string &buffer = scratch(slot);
+  buffer.assign(line.data() + start, pos - start);
+  while (pos < line.size() && line[pos] != '"') {
+    if (line[pos] != '\\') {
+      buffer.push_back(line[pos++]);
+      continue;
+    }
+    if (++pos >= line.size()) {
+      break;
+    }
+    char escape = line[pos++];
+    switch (escape) {
+    case '"':
+    case '\\':
+    case '/':
+      buffer.push_back(escape);
+      break;
+    case 'b':
+      buffer.push_back('\b');
+      break;
+    case 'f':
+      buffer.push_back('\f');
+      break;
+    case 'n':
+      buffer.push_back('\n');
+      break;
+    case 'r':
+      buffer.push_back('\r');
+      break;
+    case 't':
+      buffer.push_back('\t');
+      break;
+    case 'u': {
+      std::uint32_t cp = 0;
+      if (!parseHex4(line, pos, cp)) {
+        return "invalid \\u escape";
+      }
+      pos += 4;
+      if (cp >= 0xD800 && cp <= 0xDBFF) {
+        std::uint32_t low = 0;
+        if (pos + 1 >= line.size() || line[pos] != '\\' ||
+            line[pos + 1] != 'u' || !parseHex4(line, pos + 2, low) ||
+            low < 0xDC00 || low > 0xDFFF) {
+          return "unpaired surrogate in \\u escape";
+        }
+        pos += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+      }
+      appendUtf8(buffer, cp);
+      break;
+    }
+    default:
+      return "invalid escape";
+    }
+  }
+  if (pos >= line.size()) {
+    return "unterminated string";
+  }
+  ++pos;
+  out = buffer;
+  return nullptr;
+}
+
+const char *ChunkParser::parseJson(std::string_view line, Row &row) {
+  auto skipSpace = [&](std::size_t &pos) {
+    while (pos < line.size() &&
+           (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+      ++pos;
+    }
+  };
+
+  std::size_t pos = 0;
+  skipSpace(pos);
+  if (pos >= line.size() || line[pos] != '{') {
+    return "expected an object";
+  }
+  ++pos;
+
+  std::string_view kind;
+  enum Slot : std::size_t {
+    kKey,
+    kKind,
+    kCode,
+    kName,
+    kDescription,
+    kSubject,
+    kTitle,
+    kDeadline,
+    kType,
+    kState,
+    kMarks,
+    kIgnored,
+  };
+  std::string_view subjectCode;
+
+  skipSpace(pos);
+  if (pos < line.size() && line[pos] == '}') {
+    ++pos;
+  } else {
+    while (true) {
+      skipSpace(pos);
+      if (pos >= line.size() || line[pos] != '"') {
+        return "expected a key";
+      }
+      std::string_view key;
+      if (const char *error = parseJsonString(line, pos, kKey, key)) {
+        return error;
+      }
+      skipSpace(pos);
+      if (pos >= line.size() || line[pos] != ':') {
+        return "expected ':'";
+      }
+      ++pos;
+      skipSpace(pos);
+
+      std::size_t slot = kIgnored;
+      std::string_view *target = nullptr;
+      if (key == "kind") {
+        slot = kKind;
+        target = &kind;
+      } else if (key == "code") {
+        slot = kCode;
+        target = &row.code;
+      } else if (key == "name") {
+        slot = kName;
+        target = &row.name;
+      } else if (key == "description") {
+        slot = kDescription;
+        target = &row.description;
+      } else if (key == "subject") {
+        slot = kSubject;
+        target = &subjectCode;
+      } else if (key == "title") {
+        slot = kTitle;
+        target = &row.title;
+      } else if (key == "deadline") {
+        slot = kDeadline;
+        target = &row.deadline;
+      } else if (key == "type") {
+        slot = kType;
+        target = &row.type;
+      } else if (key == "state") {
+        slot = kState;
+        target = &row.state;
+      } else if (key == "marks") {
+        slot = kMarks;
+        target = &row.marks;
+      }
+
+      std::string_view value;
+      if (pos >= line.size()) {
+        return "expected a value";
+      }
+      if (line[pos] == '"') {
+        if (const char *error = parseJsonString(line, pos, slot, value)) {
+          return error;
+        }
+      } else if (line[pos] == '{' || line[pos] == '[') {
+        return "nested values are not supported";
+      } else {
+        std::size_t start = pos;
+        while (pos < line.size() && line[pos] != ',' && line[pos] != '}' &&
+               line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r') {
+          ++pos;
+        }
+        value = line.substr(start, pos - start);
+        if (value == "null") {
+          value = std::string_view();
+        } else if (value.empty()) {
+          return "expected a value";
+        }
+      }
+      if (target) {
+        *target = value;
+      }
+
+      skipSpace(pos);
+      if (pos < line.size() && line[pos] == ',') {
+        ++pos;
+        continue;
+      }
+      if (pos < line.size() && line[pos] == '}') {
+        ++pos;
+        break;
+      }
+      return "expected ',' or '}'";
+    }
+  }
+
+  skipSpace(pos);
+  if (pos != line.size()) {
+    return "unexpected data after object";
+  }
+  if (kind == "subject") {
+    row.kind = RowKind::Subject;
+  } else if (kind == "task") {
+    row.kind = RowKind::Task;
+    row.code = subjectCode;
+  } else {
+    return "unknown row kind";
+  }
+  return nullptr;
+}
+
+const char *ChunkParser::addRow(const Row &row, ImportBatch &batch) {
+  if (row.code.empty()) {
+    return "missing subject code";
+  }
+  if (row.kind == RowKind::Subject) {
+    batch.subjects.push_back(std::make_shared<Subject>(
+        std::string(row.name), std::string(row.code),
+        std::string(row.description)));
+    return nullptr;
+  }
+
+  if (row.title.empty()) {
+    return "missing task title";
+  }
+  DateTime deadline;
+  if (!BulkImporter::parseDateTime(row.deadline, deadline)) {
+    return "invalid deadline";
+  }
+  TaskType type;
+  if (!parseTaskType(row.type, type)) {
+    return "invalid task type";
+  }
+  TaskStateKind state;
+  if (!parseStateKind(row.state, state)) {
+    return "invalid task state";
+  }
+  int marks = 0;
+  if (!row.marks.empty()) {
+    const char *end = row.marks.data() + row.marks.size();
+    auto result = std::from_chars(row.marks.data(), end, marks);
+    if (result.ec != std::errc() || result.ptr != end) {
+      return "invalid marks";
+    }
+  }
+
+  TaskFactory *factory = &labs_;
+  if (type == TaskType::Project) {
+    factory = &projects_;
+  } else if (type == TaskType::Exam) {
+    factory = &exams_;
+  }
+  auto task = factory->createTask(std::string(row.title), deadline,
+                                  std::string(row.description));
+  if (state != TaskStateKind::Pending) {
+    task->setStateKind(state);
+  }
+  if (marks != 0) {
+    task->setMarks(marks);
+  }
+
+  if (batch.tasks.empty() || batch.tasks.back().first != row.code) {
+    batch.tasks.emplace_back(std::string(row.code),
+                             std::vector<std::shared_ptr<Task>>());
+  }
+  batch.tasks.back().second.push_back(std::move(task));
+  return nullptr;
+}
+
+ChunkResult ChunkParser::parse(std::string_view chunk) {
+  ChunkResult result;
+  std::size_t pos = 0;
+  while (pos < chunk.size()) {
+    std::size_t newline = chunk.find('\n', pos);
+    std::size_t end =
+        newline == std::string_view::npos ? chunk.size() : newline;
+    std::string_view line = chunk.substr(pos, end - pos);
+    pos = end + 1;
+    ++result.lines;
+
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    Row row;
+    bool skip = false;
+    const char *error = format_ == BulkImporter::Format::Csv
+                            ? parseCsv(line, row, skip)
+                            : parseJson(line, row);
+    if (!error && !skip) {
+      error = addRow(row, result.batch);
+    }
+    if (error) {
+      ++result.malformed;
+      if (result.errors.size() < maxErrors_) {
+        result.errors.push_back({result.lines, error});
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+BulkImporter::BulkImporter(Registry &registry)
+    : BulkImporter(registry, Options()) {}
+
+BulkImporter::BulkImporter(Registry &registry, const Options &options)
+    : registry_(registry), options_(options) {
+  if (options_.threads == 0) {
+    options_.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  options_.chunkBytes = std::max<std::size_t>(options_.chunkBytes, 1);
+  options_.blockBytes = std::max<std::size_t>(options_.blockBytes, 1);
+}
+
+bool BulkImporter::parseDateTime(std::string_view text, DateTime &out) {
+  return iso_date::parse(text, out);
+}
+
+std::size_t BulkImporter::importBlock(std::string_view block,
+                                      std::size_t firstLine,
+                                      ImportStats &stats) {
+  std::deque<std::future<ChunkResult>> inflight;
+  std::size_t line = firstLine;
+  Format format = options_.format;
+  std::size_t maxErrors = options_.maxErrors;
+
+  // Batches must reach the registry in input order so that subjects exist
+  // before their tasks; the oldest chunk is applied while newer ones parse.
+  auto applyOldest = [&] {
+    ChunkResult result = inflight.front().get();
+    inflight.pop_front();
+    registry_.importBatch(result.batch, stats);
+    stats.malformed += result.malformed;
+    for (auto &error : result.errors) {
+      if (stats.errors.size() < maxErrors) {
+        error.line += line - 1;
+        stats.errors.push_back(std::move(error));
+      }
+    }
+    line += result.lines;
+  };
+
+  std::size_t pos = 0;
+  while (pos < block.size()) {
+    std::size_t end = std::min(block.size(), pos + options_.chunkBytes);
+    if (end < block.size()) {
+      std::size_t newline = block.find('\n', end - 1);
+      end = newline == std::string_view::npos ? block.size() : newline + 1;
+    }
+    std::string_view chunk = block.substr(pos, end - pos);
+    pos = end;
+
+    if (inflight.size() >= options_.threads) {
+      applyOldest();
+    }
+    inflight.push_back(std::async(std::launch::async, [chunk, format,
+                                                       maxErrors] {
+      return ChunkParser(format, maxErrors).parse(chunk);
+    }));
+  }
+  while (!inflight.empty()) {
+    applyOldest();
+  }
+  return line - firstLine;
+}
+
+ImportStats BulkImporter::importBuffer(std::string_view data) {
+  ImportStats stats;
+  importBlock(data, 1, stats);
+  return stats;
+}
+
+ImportStats BulkImporter::importFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("BulkImporter: cannot open " + path);
+  }
+
+  ImportStats stats;
+  std::string buffer(options_.blockBytes, '\0');
+  std::size_t carried = 0;
+  std::size_t line = 1;
+  while (true) {
+    if (carried == buffer.size()) {
+      // A single line longer than the block; grow until it fits.
+      buffer.resize(buffer.size() * 2);
+    }
+    in.read(&buffer[carried],
+            static_cast<std::streamsize>(buffer.size() - carried));
+    std::size_t filled = carried + static_cast<std::size_t>(in.gcount());
+    if (in.bad()) {
+      throw std::runtime_error("BulkImporter: cannot read " + path);
+    }
+    bool atEnd = in.eof();
+
+    std::string_view data(buffer.data(), filled);
+    std::size_t complete = data.size();
+    if (!atEnd) {
+      std::size_t newline = data.rfind('\n');
+      complete = newline == std::string_view::npos ? 0 : newline + 1;
+    }
+    line += importBlock(data.substr(0, complete), line, stats);
+    if (atEnd) {
+      break;
+    }
+
+    carried = filled - complete;
+    std::memmove(&buffer[0], buffer.data() + complete, carried);
+  }
+  return stats;
+}
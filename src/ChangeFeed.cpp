@@ -0,0 +1,173 @@
+#include "../include/ChangeFeed.h"
+#include "../include/Subject.h"
+#include <algorithm>
+#include <functional>
+
+std::size_t ChangeFeed::EntityHash::operator()(const Change &change) const {
+  std::size_t h = std::hash<std::string>()(change.key);
+  h ^= std::hash<std::string>()(change.subject) + 0x9e3779b97f4a7c15ull +
+       (h << 6) + (h >> 2);
+  return h ^ static_cast<std::size_t>(change.kind);
+}
+
+bool ChangeFeed::EntityEqual::operator()(const Change &a,
+                                         const Change &b) const {
+  return a.kind == b.kind && a.key == b.key && a.subject == b.subject;
+}
+
+ChangeFeed::ChangeFeed(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)) {}
+
+ChangeFeed::~ChangeFeed() { clear(); }
+
+void ChangeFeed::attach(Subject &subject) {
+  if (attached_.insert(&subject).second) {
+    subject.addListener(this);
+  }
+}
+
+void ChangeFeed::detach(Subject &subject) {
+  if (attached_.erase(&subject)) {
+    subject.removeListener(this);
+  }
+}
+
+void ChangeFeed::clear() {
+  for (Subject *subject : attached_) {
+    subject->removeListener(this);
+  }
+  attached_.clear();
+}
+
+void ChangeFeed::record(EntityKind kind, ChangeType type,
+                        const std::string &key, const std::string &subject) {
+  std::uint64_t generation = generation_.load(std::memory_order_relaxed) + 1;
+  Change change{generation, kind, type, key, subject};
+
+  stamps_.erase(change);
+  if (type != ChangeType::Deleted) {
+    stamps_.insert(change);
+  } else if (kind == EntityKind::Subject) {
+    for (auto it = stamps_.begin(); it != stamps_.end();) {
+      if (it->kind == EntityKind::Task && it->subject == key) {
+        it = stamps_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  log_.push_back(std::move(change));
+  if (log_.size() > capacity_) {
+    horizon_ = log_.front().generation;
+    log_.pop_front();
+  }
+  generation_.store(generation, std::memory_order_release);
+}
+
+void ChangeFeed::reset() {
+  log_.clear();
+  stamps_.clear();
+  std::uint64_t generation = generation_.load(std::memory_order_relaxed) + 1;
+  horizon_ = generation;
+  generation_.store(generation, std::memory_order_release);
+}
+
+std::uint64_t ChangeFeed::stamp(EntityKind kind, const std::string &key,
+                                const std::string &subject) const {
+  auto it = stamps_.find(Change{0, kind, ChangeType::Created, key, subject});
+  return it == stamps_.end() ? 0 : it->generation;
+}
+
+ChangeSet ChangeFeed::changesSince(std::uint64_t generation) const {
+  ChangeSet result;
+  result.generation = generation_.load(std::memory_order_acquire);
+  if (generation < horizon_) {
+    result.complete = false;
+    return result;
+  }
+
+  // Net effect per entity relative to the requested generation: an entity
+  // created and deleted since then is omitted, one that existed before and
+  // was recreated counts as updated.
+  struct Net {
+    bool existedBefore;
+    ChangeType last;
+    std::uint64_t generation;
+  };
+  std::unordered_map<Change, Net, EntityHash, EntityEqual> net;
+  auto first = std::upper_bound(
+      log_.begin(), log_.end(), generation,
+      [](std::uint64_t g, const Change &change) { return g < change.generation; });
+  for (auto it = first; it != log_.end(); ++it) {
+    auto [entry, inserted] = net.try_emplace(
+        *it, Net{it->type != ChangeType::Created, it->type, it->generation});
+    if (!inserted) {
+      entry->second.last = it->type;
+      entry->second.generation = it->generation;
+    }
+  }
+
+  for (auto &[entity, state] : net) {
+    ChangeType type;
+    if (state.existedBefore) {
+      type = state.last == ChangeType::Deleted ? ChangeType::Deleted
+                                               : ChangeType::Updated;
+    } else if (state.last == ChangeType::Deleted) {
+      continue;
+    } else {
+      type = ChangeType::Created;
+    }
+    result.changes.push_back(
+        {state.generation, entity.kind, type, entity.key, entity.subject});
+  }
+  std::sort(result.changes.begin(), result.changes.end(),
+            [](const Change &a, const Change &b) {
+              return a.generation < b.generation;
+            });
+  return result;
+}
+
+void ChangeFeed::taskEvent(Task &task, ChangeType type) {
+  auto subject = task.getSubject();
+  record(EntityKind::Task, type, std::string(task.getTitle()),
+         subject ? subject->getCode() : std::string());
+}
+
+void ChangeFeed::onTaskAdded(Task &task) {
+  taskEvent(task, ChangeType::Created);
+}
+
+void ChangeFeed::onTaskRemoved(Task &task) {
+  taskEvent(task, ChangeType::Deleted);
+}
+
+void ChangeFeed::onDeadlineChanged(Task &task, const DateTime &) {
+  taskEvent(task, ChangeType::Updated);
+}
+
+void ChangeFeed::onStateChanged(Task &task) {
+  taskEvent(task, ChangeType::Updated);
+}
+
+void ChangeFeed::onMarksChanged(Task &task) {
+  taskEvent(task, ChangeType::Updated);
+}
+
+void ChangeFeed::onDescriptionChanged(Task &task) {
+  taskEvent(task, ChangeType::Updated);
+}
+
+// Tasks are keyed by title, so a rename ends one entity and starts another.
+void ChangeFeed::onTitleChanged(Task &task, const std::string &previous) {
+  auto subject = task.getSubject();
+  std::string code = subject ? subject->getCode() : std::string();
+  record(EntityKind::Task, ChangeType::Deleted, previous, code);
+  record(EntityKind::Task, ChangeType::Created, std::string(task.getTitle()),
+         code);
+}
+
+void ChangeFeed::onSubjectDestroyed(Subject &subject) {
+  attached_.erase(&subject);
+  record(EntityKind::Subject, ChangeType::Deleted, subject.getCode());
+}
@@ -0,0 +1,67 @@
+#include "../include/Clock.h"
+#include <algorithm>
+
+SystemClock &SystemClock::instance() {
+  static SystemClock clock;
+  return clock;
+}
+
+DateTime SystemClock::now() const { return std::chrono::system_clock::now(); }
+
+void SystemClock::waitUntil(std::unique_lock<std::mutex> &lock,
+                            std::condition_variable &wake,
+                            const DateTime &deadline) {
+  wake.wait_until(lock, deadline);
+}
+
+VirtualClock::VirtualClock(const DateTime &start)
+    : now_(start.time_since_epoch().count()) {}
+
+DateTime VirtualClock::now() const {
+  return DateTime(DateTime::duration(now_.load()));
+}
+
+void VirtualClock::waitUntil(std::unique_lock<std::mutex> &lock,
+                             std::condition_variable &wake,
+                             const DateTime &deadline) {
+  // advance() notifies under the waiter's mutex, so a move after this check
+  // cannot slip in before the wait.
+  if (now() < deadline) {
+    wake.wait(lock);
+  }
+}
+
+void VirtualClock::attach(std::mutex &mutex, std::condition_variable &wake) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  waiters_.push_back(Waiter{&mutex, &wake});
+}
+
+void VirtualClock::detach(std::condition_variable &wake) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  waiters_.erase(std::remove_if(waiters_.begin(), waiters_.end(),
+                                [&wake](const Waiter &waiter) {
+                                  return waiter.wake == &wake;
+                                }),
+                 waiters_.end());
+}
+
+void VirtualClock::wakeAll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Waiter &waiter : waiters_) {
+    std::lock_guard<std::mutex> waiting(*waiter.mutex);
+    waiter.wake->notify_all();
+  }
+}
+
+void VirtualClock::advance(DateTime::duration by) {
+  now_.fetch_add(by.count());
+  wakeAll();
+}
+
+void VirtualClock::set(const DateTime &time) {
+  DateTime::rep target = time.time_since_epoch().count();
+  DateTime::rep current = now_.load();
+  while (current < target && !now_.compare_exchange_weak(current, target)) {
+  }
+  wakeAll();
+}
@@ -0,0 +1,159 @@
+#include "../include/CommandExecutor.h"
+#include "../include/CommandManager.h"
+
+CommandExecutor::CommandExecutor(CommandManager &history)
+    : history_(history), head_(&stub_), tail_(&stub_),
+      worker_(&CommandExecutor::run, this) {}
+
+CommandExecutor::~CommandExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  worker_.join();
+}
+
+void CommandExecutor::push(Node *node) {
+  node->next.store(nullptr, std::memory_order_relaxed);
+  Node *previous = head_.exchange(node, std::memory_order_acq_rel);
+  // Until this store the node is unreachable from tail_; pop() sees an
+  // empty queue meanwhile.
+  previous->next.store(node, std::memory_order_release);
+}
+
+CommandExecutor::Node *CommandExecutor::pop() {
+  Node *tail = tail_;
+  Node *next = tail->next.load(std::memory_order_acquire);
+  if (tail == &stub_) {
+    if (!next) {
+      return nullptr;
+    }
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+  if (tail != head_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  // tail is the last node: put the stub behind it so it can be unlinked.
+  push(&stub_);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+void CommandExecutor::post(Node *node) {
+  // Counted before it is linked, so the apply thread may briefly find
+  // fewer nodes than pending_ says and has to wait for the link.
+  pending_.fetch_add(1);
+  push(node);
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_one();
+  }
+}
+
+std::future<void> CommandExecutor::post(Action action,
+                                        std::shared_ptr<Command> command) {
+  Node *node = new Node;
+  node->action = action;
+  node->command = std::move(command);
+  node->promise.emplace();
+  std::future<void> result = node->promise->get_future();
+  post(node);
+  return result;
+}
+
+std::future<void> CommandExecutor::submit(std::shared_ptr<Command> command) {
+  return post(Action::Execute, std::move(command));
+}
+
+void CommandExecutor::submit(std::shared_ptr<Command> command,
+                             Completion done) {
+  Node *node = new Node;
+  node->action = Action::Execute;
+  node->command = std::move(command);
+  node->done = std::move(done);
+  post(node);
+}
+
+std::future<void> CommandExecutor::submitUndo() {
+  return post(Action::Undo, nullptr);
+}
+
+std::future<void> CommandExecutor::submitRedo() {
+  return post(Action::Redo, nullptr);
+}
+
+std::future<void> CommandExecutor::flush() {
+  return post(Action::Flush, nullptr);
+}
+
+void CommandExecutor::apply(Node &node) {
+  std::exception_ptr error;
+  try {
+    switch (node.action) {
+    case Action::Execute:
+      history_.executeCommand(std::move(node.command));
+      break;
+    case Action::Undo:
+      history_.undoLastCommand();
+      break;
+    case Action::Redo:
+      history_.redoLastCommand();
+      break;
+    case Action::Flush:
+      break;
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  applied_.fetch_add(1);
+  if (node.promise) {
+    if (error) {
+      node.promise->set_exception(error);
+    } else {
+      node.promise->set_value();
+    }
+  }
+  if (node.done) {
+    node.done(error);
+  }
+}
+
+void CommandExecutor::run() {
+  for (;;) {
+    std::size_t ready = pending_.load();
+    if (ready == 0) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // A producer either sees sleeping_ and notifies under the mutex, or
+      // bumped pending_ before the predicate reads it.
+      sleeping_.store(true);
+      wake_.wait(lock, [this] { return pending_.load() != 0 || stopping_; });
+      sleeping_.store(false);
+      if (pending_.load() == 0) {
+        return;
+      }
+      continue;
+    }
+
+    batches_.fetch_add(1);
+    for (std::size_t i = 0; i < ready; ++i) {
+      Node *node;
+      while (!(node = pop())) {
+        std::this_thread::yield();
+      }
+      apply(*node);
+      delete node;
+    }
+    pending_.fetch_sub(ready);
+  }
+}
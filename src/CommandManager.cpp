@@ -1,28 +1,152 @@
 #include "../include/CommandManager.h"
+#include "../include/CompositeCommand.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
 #include <iostream>
+#include <stdexcept>
+
+CommandManager::CommandManager(std::size_t depth) { setDepth(depth); }
 
 CommandManager &CommandManager::instance() {
   static CommandManager singletonInstance;
   return singletonInstance;
 }
 
+void CommandManager::release(std::size_t position) {
+  if (!objects_.empty()) {
+    objects_[slot(position)].reset();
+  }
+}
+
+void CommandManager::push(const CommandRecord &record,
+                          std::shared_ptr<Command> object) {
+  for (std::size_t i = 0; i < redoable_; ++i) {
+    release(undoable_ + i);
+  }
+  redoable_ = 0;
+  if (undoable_ == ring_.size()) {
+    release(0);
+    oldest_ = slot(1);
+    --undoable_;
+  }
+
+  std::size_t index = slot(undoable_);
+  ring_[index] = record;
+  if (object) {
+    if (objects_.empty()) {
+      objects_.resize(ring_.size());
+    }
+    objects_[index] = std::move(object);
+  }
+  ++undoable_;
+}
+
 void CommandManager::executeCommand(std::shared_ptr<Command> command) {
   if (command) {
     command->execute();
-    history_.push_back(command);
+    CommandRecord record{};
+    if (command->compact(record)) {
+      push(record, nullptr);
+    } else {
+      push(record, std::move(command));
+    }
+  }
+}
+
+void CommandManager::executeStateChange(Task &task, TaskStateKind target) {
+  if (!task.getState()->isBuiltin()) {
+    executeCommand(std::make_shared<SetTaskStateCommand>(task, target));
+    return;
+  }
+  CommandRecord record{task.getHandle(), task.getStateKind(), target};
+  SetTaskStateCommand::run(task, target);
+  push(record, nullptr);
+}
+
+bool CommandManager::executeTransaction(
+    std::shared_ptr<CompositeCommand> transaction) {
+  if (!transaction) {
+    return false;
+  }
+  transaction->execute();
+  if (!transaction->applied()) {
+    return false;
   }
+  push(CommandRecord{}, std::move(transaction));
+  return true;
 }
 
 void CommandManager::undoLastCommand() {
-  if (!history_.empty()) {
-    std::shared_ptr<Command> lastCommand = history_.back();
-    history_.pop_back();
-    lastCommand->undo();
-  } else {
+  if (undoable_ == 0) {
     std::cout << "CommandManager: No commands in history to undo." << std::endl;
+    return;
+  }
+  --undoable_;
+  ++redoable_;
+  std::size_t index = slot(undoable_);
+  if (!objects_.empty() && objects_[index]) {
+    objects_[index]->undo();
+  } else if (Task *task = Task::resolve(ring_[index].task)) {
+    SetTaskStateCommand::revert(*task, ring_[index].from);
+  } else {
+    std::cout << "Cannot undo SetTaskStateCommand: the task no longer exists."
+              << std::endl;
+  }
+}
+
+void CommandManager::redoLastCommand() {
+  if (redoable_ == 0) {
+    std::cout << "CommandManager: No commands in history to redo." << std::endl;
+    return;
+  }
+  std::size_t index = slot(undoable_);
+  ++undoable_;
+  --redoable_;
+  if (!objects_.empty() && objects_[index]) {
+    objects_[index]->execute();
+  } else if (Task *task = Task::resolve(ring_[index].task)) {
+    SetTaskStateCommand::run(*task, ring_[index].to);
+  } else {
+    std::cout << "Cannot execute SetTaskStateCommand: the task no longer "
+                 "exists."
+              << std::endl;
   }
 }
 
-bool CommandManager::canUndo() const { return !history_.empty(); }
+bool CommandManager::canUndo() const { return undoable_ != 0; }
 
-void CommandManager::clearHistory() { history_.clear(); }
+bool CommandManager::canRedo() const { return redoable_ != 0; }
+
+void CommandManager::setDepth(std::size_t depth) {
+  if (depth == 0) {
+    throw std::invalid_argument("CommandManager: depth must be positive");
+  }
+  std::size_t kept = undoable_ < depth ? undoable_ : depth;
+  std::vector<CommandRecord> ring(depth);
+  std::vector<std::shared_ptr<Command>> objects;
+  if (!objects_.empty()) {
+    objects.resize(depth);
+  }
+  for (std::size_t i = 0; i < kept; ++i) {
+    std::size_t from = slot(undoable_ - kept + i);
+    ring[i] = ring_[from];
+    if (!objects.empty()) {
+      objects[i] = std::move(objects_[from]);
+    }
+  }
+  ring_.swap(ring);
+  objects_.swap(objects);
+  oldest_ = 0;
+  undoable_ = kept;
+  redoable_ = 0;
+}
+
+void CommandManager::clearHistory() {
+  for (auto &object : objects_) {
+    object.reset();
+  }
+  oldest_ = 0;
+  undoable_ = 0;
+  redoable_ = 0;
+}
@@ -0,0 +1,76 @@
+#include "../include/CompositeCommand.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+#include <iostream>
+
+void CompositeCommand::addStateChange(Task &task, TaskStateKind target) {
+  steps_.push_back({{task.getHandle(), task.getStateKind(), target}, 0});
+}
+
+void CompositeCommand::revert(std::size_t count) {
+  auto custom = custom_.rbegin();
+  while (custom != custom_.rend() && custom->first >= count) {
+    ++custom;
+  }
+  for (std::size_t i = count; i-- > 0;) {
+    const Step &step = steps_[i];
+    Task *task = Task::resolve(step.record.task);
+    if (!task) {
+      continue;
+    }
+    if (custom != custom_.rend() && custom->first == i) {
+      task->setState(custom->second);
+      ++custom;
+    } else {
+      task->setStateKind(step.record.from);
+    }
+    task->setMarks(step.marks);
+  }
+}
+
+void CompositeCommand::execute() {
+  applied_ = false;
+  for (const Step &step : steps_) {
+    if (!Task::resolve(step.record.task)) {
+      std::cout << "Cannot execute CompositeCommand: a task no longer "
+                   "exists; nothing was changed."
+                << std::endl;
+      return;
+    }
+  }
+
+  custom_.clear();
+  std::size_t done = 0;
+  try {
+    for (; done < steps_.size(); ++done) {
+      Step &step = steps_[done];
+      Task &task = *Task::resolve(step.record.task);
+      step.record.from = task.getStateKind();
+      step.marks = task.getMarks();
+      auto state = task.getState();
+      if (!state->isBuiltin()) {
+        custom_.emplace_back(done, std::move(state));
+      }
+      SetTaskStateCommand::transition(task, step.record.to);
+    }
+  } catch (...) {
+    revert(done);
+    throw;
+  }
+  applied_ = true;
+  std::cout << "Command Executed: " << steps_.size()
+            << " task state change(s) applied." << std::endl;
+}
+
+void CompositeCommand::undo() {
+  if (!applied_) {
+    std::cout << "Cannot undo CompositeCommand: it was not applied."
+              << std::endl;
+    return;
+  }
+  revert(steps_.size());
+  applied_ = false;
+  std::cout << "Command Undone: " << steps_.size()
+            << " task state change(s) reverted." << std::endl;
+}
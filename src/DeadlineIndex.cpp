@@ -0,0 +1,118 @@
+#include "../include/DeadlineIndex.h"
+#include "../include/Subject.h"
+
+DeadlineIndex::~DeadlineIndex() { clear(); }
+
+void DeadlineIndex::insert(Task &task) {
+  DueTask entry{task.getDeadline(), &task};
+  all_.insert(entry);
+  if (!task.isCompleted()) {
+    open_.insert(entry);
+  }
+}
+
+void DeadlineIndex::erase(Task &task, const DateTime &deadline) {
+  DueTask entry{deadline, &task};
+  all_.erase(entry);
+  open_.erase(entry);
+}
+
+void DeadlineIndex::attach(Subject &subject) {
+  if (!attached_.insert(&subject).second) {
+    return;
+  }
+  subject.addListener(this);
+  subject.forEachTask([this](Task &task) { insert(task); });
+}
+
+void DeadlineIndex::detach(Subject &subject) {
+  if (attached_.erase(&subject) == 0) {
+    return;
+  }
+  subject.forEachTask(
+      [this](Task &task) { erase(task, task.getDeadline()); });
+  subject.removeListener(this);
+}
+
+void DeadlineIndex::clear() {
+  for (Subject *subject : attached_) {
+    subject->removeListener(this);
+  }
+  attached_.clear();
+  all_.clear();
+  open_.clear();
+}
+
+std::vector<DueTask> DeadlineIndex::tasksDueBetween(const DateTime &from,
+                                                    const DateTime &to) const {
+  std::vector<DueTask> result;
+  if (!(from < to)) {
+    return result;
+  }
+  auto first = all_.lower_bound(DueTask{from, nullptr});
+  auto last = all_.lower_bound(DueTask{to, nullptr});
+  result.assign(first, last);
+  return result;
+}
+
+std::vector<DueTask> DeadlineIndex::openDueBetween(const DateTime &from,
+                                                   const DateTime &to,
+                                                   const TaskFilter &filter,
+                                                   std::size_t limit) const {
+  std::vector<DueTask> result;
+  forEachOpenDue(from, to, filter, limit,
+                 [&](const DueTask &due) { result.push_back(due); });
+  return result;
+}
+
+std::vector<DueTask> DeadlineIndex::nextDue(std::size_t k,
+                                            const DateTime &now) const {
+  std::vector<DueTask> result;
+  for (auto it = open_.lower_bound(DueTask{now, nullptr});
+       it != open_.end() && result.size() < k; ++it) {
+    result.push_back(*it);
+  }
+  return result;
+}
+
+std::vector<DueTask> DeadlineIndex::overdue(const DateTime &now) const {
+  return std::vector<DueTask>(open_.begin(),
+                              open_.lower_bound(DueTask{now, nullptr}));
+}
+
+void DeadlineIndex::onTaskAdded(Task &task) { insert(task); }
+
+void DeadlineIndex::onTaskRemoved(Task &task) {
+  erase(task, task.getDeadline());
+}
+
+void DeadlineIndex::onDeadlineChanged(Task &task, const DateTime &previous) {
+  erase(task, previous);
+  insert(task);
+}
+
+void DeadlineIndex::onStateChanged(Task &task) {
+  DueTask entry{task.getDeadline(), &task};
+  if (all_.count(entry) == 0) {
+    return;
+  }
+  if (task.isCompleted()) {
+    open_.erase(entry);
+  } else {
+    open_.insert(entry);
+  }
+}
+
+void DeadlineIndex::onMarksChanged(Task &) {}
+
+void DeadlineIndex::onDescriptionChanged(Task &) {}
+
+void DeadlineIndex::onTitleChanged(Task &, const std::string &) {}
+
+void DeadlineIndex::onSubjectDestroyed(Subject &subject) {
+  if (attached_.erase(&subject) == 0) {
+    return;
+  }
+  subject.forEachTask(
+      [this](Task &task) { erase(task, task.getDeadline()); });
+}
@@ -0,0 +1,218 @@
+#include "../include/IsoDate.h"
+#include <ctime>
+#include <limits>
+
+namespace iso_date {
+
+namespace {
+
+constexpr std::int64_t kSecondsPerDay = 86400;
+constexpr std::size_t kCacheDays = 1024;
+
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+  return value / divisor - (value % divisor < 0);
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool parseDigits(std::string_view text, std::size_t &pos, int count,
+                 int &value) {
+  if (pos + count > text.size()) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < count; ++i) {
+    char c = text[pos + i];
+    if (!isDigit(c)) {
+      return false;
+    }
+    value = value * 10 + (c - '0');
+  }
+  pos += count;
+  return true;
+}
+
+char *writeDigits(char *out, unsigned value, int count) {
+  for (int i = count - 1; i >= 0; --i) {
+    out[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return out + count;
+}
+
+std::int64_t localtimeOffset(std::int64_t utcSeconds) {
+  std::time_t time = static_cast<std::time_t>(utcSeconds);
+  std::tm tm = {};
+#ifdef _WIN32
+  localtime_s(&tm, &time);
+#else
+  localtime_r(&time, &tm);
+#endif
+  std::int64_t local =
+      daysFromCivil(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1),
+                    static_cast<unsigned>(tm.tm_mday)) *
+          kSecondsPerDay +
+      tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+  return local - utcSeconds;
+}
+
+std::int64_t mktimeOffset(std::int64_t localSeconds) {
+  std::int64_t days = floorDiv(localSeconds, kSecondsPerDay);
+  std::int64_t rest = localSeconds - days * kSecondsPerDay;
+  CivilDate date = civilFromDays(days);
+  std::tm tm = {};
+  tm.tm_year = static_cast<int>(date.year - 1900);
+  tm.tm_mon = static_cast<int>(date.month) - 1;
+  tm.tm_mday = static_cast<int>(date.day);
+  tm.tm_hour = static_cast<int>(rest / 3600);
+  tm.tm_min = static_cast<int>(rest / 60 % 60);
+  tm.tm_sec = static_cast<int>(rest % 60);
+  tm.tm_isdst = -1;
+  return localSeconds - static_cast<std::int64_t>(std::mktime(&tm));
+}
+
+// Offsets are cached per day in a direct-mapped table per thread: a day
+// whose first and last hour agree has no zone change and every second of
+// it shares the offset. Days with a change ask the C library every time.
+template <std::int64_t (*Lookup)(std::int64_t)>
+std::int64_t cachedOffset(std::int64_t seconds) {
+  struct Entry {
+    std::int64_t day = std::numeric_limits<std::int64_t>::min();
+    std::int64_t offset = 0;
+    bool uniform = false;
+  };
+  static thread_local Entry cache[kCacheDays];
+
+  std::int64_t day = floorDiv(seconds, kSecondsPerDay);
+  Entry &entry = cache[static_cast<std::uint64_t>(day) % kCacheDays];
+  if (entry.day != day) {
+    std::int64_t midnight = day * kSecondsPerDay;
+    entry.day = day;
+    entry.offset = Lookup(midnight);
+    entry.uniform = entry.offset == Lookup(midnight + 23 * 3600);
+  }
+  return entry.uniform ? entry.offset : Lookup(seconds);
+}
+
+} // namespace
+
+std::int64_t utcOffset(std::int64_t utcSeconds) {
+  return cachedOffset<localtimeOffset>(utcSeconds);
+}
+
+std::int64_t localOffset(std::int64_t localSeconds) {
+  return cachedOffset<mktimeOffset>(localSeconds);
+}
+
+bool parse(std::string_view text, DateTime &out) {
+  std::size_t pos = 0;
+  int year, month, day, hour = 0, minute = 0, second = 0;
+  if (!parseDigits(text, pos, 4, year) || pos >= text.size() ||
+      text[pos++] != '-' || !parseDigits(text, pos, 2, month) ||
+      pos >= text.size() || text[pos++] != '-' ||
+      !parseDigits(text, pos, 2, day)) {
+    return false;
+  }
+  if (month < 1 || month > 12 || day < 1 ||
+      static_cast<unsigned>(day) >
+          daysInMonth(year, static_cast<unsigned>(month))) {
+    return false;
+  }
+
+  if (pos < text.size() && (text[pos] == 'T' || text[pos] == ' ')) {
+    ++pos;
+    if (!parseDigits(text, pos, 2, hour) || pos >= text.size() ||
+        text[pos++] != ':' || !parseDigits(text, pos, 2, minute)) {
+      return false;
+    }
+    if (pos < text.size() && text[pos] == ':') {
+      ++pos;
+      if (!parseDigits(text, pos, 2, second)) {
+        return false;
+      }
+      // Fractional seconds are accepted but deadlines keep whole seconds.
+      if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        std::size_t digits = pos;
+        while (pos < text.size() && isDigit(text[pos])) {
+          ++pos;
+        }
+        if (pos == digits) {
+          return false;
+        }
+      }
+    }
+    if (hour > 23 || minute > 59 || second > 60) {
+      return false;
+    }
+  }
+
+  std::int64_t days = daysFromCivil(year, static_cast<unsigned>(month),
+                                    static_cast<unsigned>(day));
+  std::int64_t seconds =
+      days * kSecondsPerDay + hour * 3600 + minute * 60 + second;
+
+  if (pos == text.size()) {
+    seconds -= localOffset(seconds);
+  } else if (text[pos] == 'Z' && pos + 1 == text.size()) {
+    // Already UTC.
+  } else if (text[pos] == '+' || text[pos] == '-') {
+    int sign = text[pos++] == '+' ? 1 : -1;
+    int offsetHours, offsetMinutes;
+    if (!parseDigits(text, pos, 2, offsetHours)) {
+      return false;
+    }
+    if (pos < text.size() && text[pos] == ':') {
+      ++pos;
+    }
+    if (!parseDigits(text, pos, 2, offsetMinutes) || pos != text.size() ||
+        offsetHours > 23 || offsetMinutes > 59) {
+      return false;
+    }
+    seconds -= sign * (offsetHours * 3600 + offsetMinutes * 60);
+  } else {
+    return false;
+  }
+
+  out = DateTime(std::chrono::duration_cast<DateTime::duration>(
+      std::chrono::seconds(seconds)));
+  return true;
+}
+
+FormattedDate format(DateTime time, DateStyle style) {
+  std::int64_t utc = std::chrono::floor<std::chrono::seconds>(
+                         time.time_since_epoch())
+                         .count();
+  std::int64_t local = utc + utcOffset(utc);
+  std::int64_t days = floorDiv(local, kSecondsPerDay);
+  unsigned rest = static_cast<unsigned>(local - days * kSecondsPerDay);
+  CivilDate date = civilFromDays(days);
+
+  FormattedDate result;
+  char *out = result.text_;
+  std::int64_t year = date.year;
+  if (year < 0) {
+    *out++ = '-';
+    year = -year;
+  }
+  // system_clock spans a few centuries either side of 1970, so years have
+  // four digits in practice; more are written if they appear.
+  out = writeDigits(out, static_cast<unsigned>(year),
+                    year > 9999 ? (year > 99999 ? 6 : 5) : 4);
+  *out++ = '-';
+  out = writeDigits(out, date.month, 2);
+  *out++ = '-';
+  out = writeDigits(out, date.day, 2);
+  *out++ = style == DateStyle::Seconds ? 'T' : ' ';
+  out = writeDigits(out, rest / 3600, 2);
+  *out++ = ':';
+  out = writeDigits(out, rest / 60 % 60, 2);
+  if (style == DateStyle::Seconds) {
+    *out++ = ':';
+    out = writeDigits(out, rest % 60, 2);
+  }
+  result.size_ = static_cast<std::uint8_t>(out - result.text_);
+  return result;
+}
+
+} // namespace iso_date
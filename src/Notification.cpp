@@ -1,42 +1,58 @@
 #include "../include/Notification.h"
+#include "../include/IsoDate.h"
+#include "../include/ReminderRule.h"
 #include "../include/Subject.h"
 #include "../include/Task.h"
 #include <algorithm>
-#include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 
-std::string formatDateTimeNotif(const DateTime &dt) {
-  auto time = std::chrono::system_clock::to_time_t(dt);
-  std::tm tm_local = {};
+std::unique_ptr<NotificationManager, std::function<void(NotificationManager *)>>
+    NotificationManager::instance{nullptr, [](NotificationManager *p) {}};
+std::mutex NotificationManager::mutex;
 
-#ifdef _WIN32
-  localtime_s(&tm_local, &time);
-#else
-  tm_local = *std::localtime(&time);
-#endif
+namespace {
 
-  std::stringstream ss;
-  ss << std::put_time(&tm_local, "%Y-%m-%d %H:%M");
-  return ss.str();
+std::shared_ptr<const Notification::TaskDetails> detailsOf(const Task &task) {
+  auto details = std::make_shared<Notification::TaskDetails>();
+  details->title = std::string(task.getTitle());
+  details->deadline = task.getDeadline();
+  if (Subject *subject = task.getSubject()) {
+    details->subject = subject->getName() + " (" + subject->getCode() + ")";
+  }
+  return details;
 }
 
-std::unique_ptr<NotificationManager, std::function<void(NotificationManager *)>>
-    NotificationManager::instance{nullptr, [](NotificationManager *p) {}};
-std::mutex NotificationManager::mutex;
+} // namespace
 
 Notification::Notification(const std::string &message,
                            const DateTime &triggerTime,
                            std::shared_ptr<Task> task)
+    : message(message), triggerTime(triggerTime),
+      task(task ? task->getHandle() : TaskId()),
+      details(task ? detailsOf(*task) : nullptr) {}
+
+Notification::Notification(const std::string &message,
+                           const DateTime &triggerTime, TaskId task)
     : message(message), triggerTime(triggerTime), task(task) {}
 
 std::string Notification::getMessage() const { return message; }
 
 DateTime Notification::getTriggerTime() const { return triggerTime; }
 
-std::shared_ptr<Task> Notification::getTask() const {
-  return task.lock();
+Task *Notification::getTask() const { return Task::resolve(task); }
+
+std::shared_ptr<const Notification::TaskDetails>
+Notification::getTaskDetails() const {
+  return std::atomic_load(&details);
+}
+
+void Notification::refresh(const Task &task) {
+  std::atomic_store(&details, detailsOf(task));
+}
+
+void Notification::forgetTask() {
+  std::atomic_store(&details, std::shared_ptr<const TaskDetails>());
 }
 
 void Notification::setMessage(const std::string &message) {
@@ -54,14 +70,12 @@ bool Notification::shouldTrigger(const DateTime &currentTime) const {
 void Notification::display() const {
   std::cout << "NOTIFICATION: " << message << std::endl;
 
-  auto taskPtr = task.lock();
-  if (taskPtr) {
-    std::cout << "For task: " << taskPtr->getTitle() << std::endl;
-    std::cout << "Due: " << formatDateTimeNotif(taskPtr->getDeadline())
-              << std::endl;
+  if (auto task = getTaskDetails()) {
+    std::cout << "For task: " << task->title << std::endl;
+    std::cout << "Due: " << iso_date::format(task->deadline) << std::endl;
   }
 
-  std::cout << "Trigger time: " << formatDateTimeNotif(triggerTime)
+  std::cout << "Trigger time: " << iso_date::format(triggerTime)
             << std::endl;
 }
 
@@ -73,10 +87,15 @@ DeadlineNotification::DeadlineNotification(const std::string &message,
           std::chrono::system_clock::time_point(),
           task),
       daysBeforeDeadline(daysBeforeDeadline) {
+  setDaysBeforeDeadline(daysBeforeDeadline);
+}
 
-  auto deadline = task->getDeadline();
-  auto triggerTime = deadline - std::chrono::hours(24 * daysBeforeDeadline);
-  setTriggerTime(triggerTime);
+DeadlineNotification::DeadlineNotification(const std::string &message,
+                                           const Task &task,
+                                           int daysBeforeDeadline)
+    : Notification(message, DateTime(), task.getHandle()),
+      daysBeforeDeadline(daysBeforeDeadline) {
+  refresh(task);
 }
 
 int DeadlineNotification::getDaysBeforeDeadline() const {
@@ -86,21 +105,24 @@ int DeadlineNotification::getDaysBeforeDeadline() const {
 void DeadlineNotification::setDaysBeforeDeadline(int days) {
   daysBeforeDeadline = days;
 
-  auto taskPtr = getTask();
-  if (taskPtr) {
-    auto deadline = taskPtr->getDeadline();
-    auto triggerTime = deadline - std::chrono::hours(24 * daysBeforeDeadline);
-    setTriggerTime(triggerTime);
+  if (auto task = getTaskDetails()) {
+    setTriggerTime(task->deadline -
+                   std::chrono::hours(24 * daysBeforeDeadline));
   }
 }
 
+void DeadlineNotification::refresh(const Task &task) {
+  Notification::refresh(task);
+  setDaysBeforeDeadline(daysBeforeDeadline);
+}
+
 bool DeadlineNotification::shouldTrigger(const DateTime &currentTime) const {
-  auto taskPtr = getTask();
-  if (!taskPtr) {
+  auto task = getTaskDetails();
+  if (!task) {
     return false;
   }
 
-  auto deadline = taskPtr->getDeadline();
+  auto deadline = task->deadline;
   auto timeToDeadline =
       std::chrono::duration_cast<std::chrono::hours>(deadline - currentTime)
           .count();
@@ -112,20 +134,19 @@ bool DeadlineNotification::shouldTrigger(const DateTime &currentTime) const {
 }
 
 void DeadlineNotification::display() const {
-  auto taskPtr = getTask();
-  if (!taskPtr) {
+  auto task = getTaskDetails();
+  if (!task) {
     std::cout << "NOTIFICATION: Task no longer exists." << std::endl;
     return;
   }
 
   std::cout << "DEADLINE REMINDER: " << getMessage() << std::endl;
-  std::cout << "Task: " << taskPtr->getTitle() << std::endl;
+  std::cout << "Task: " << task->title << std::endl;
   std::cout << "Due in " << daysBeforeDeadline << " days on "
-            << formatDateTimeNotif(taskPtr->getDeadline()) << std::endl;
+            << iso_date::format(task->deadline) << std::endl;
 
-  if (auto subject = taskPtr->getSubject()) {
-    std::cout << "Subject: " << subject->getName() << " (" << subject->getCode()
-              << ")" << std::endl;
+  if (!task->subject.empty()) {
+    std::cout << "Subject: " << task->subject << std::endl;
   }
 }
 
@@ -137,82 +158,325 @@ NotificationManager &NotificationManager::getInstance() {
   return *instance.get();
 }
 
-void NotificationManager::addNotification(
+NotificationId NotificationManager::addNotification(
     std::shared_ptr<Notification> notification) {
-  notifications.push_back(notification);
+  Task *task = notification->getTask();
+  std::lock_guard<std::mutex> lock(guard);
+  NotificationId id = notifications.insert(Entry{std::move(notification)});
+  order.push_back(id);
+  schedule(id, *notifications.get(id));
+
+  if (task) {
+    byTask[task->getHandle().value()].push_back(id);
+    trackedTasks.store(byTask.size(), std::memory_order_relaxed);
+  }
+  return id;
+}
+
+std::shared_ptr<Notification>
+NotificationManager::find(NotificationId id) const {
+  std::lock_guard<std::mutex> lock(guard);
+  const Entry *entry = notifications.get(id);
+  return entry ? entry->notification : nullptr;
+}
 
-  if (auto task = notification->getTask()) {
-    task->addNotification(notification);
+void NotificationManager::setWakeup(std::function<void()> wakeup) {
+  std::lock_guard<std::mutex> lock(guard);
+  if (wakeup && this->wakeup) {
+    throw std::logic_error("NotificationManager already has a wakeup");
   }
+  this->wakeup = std::move(wakeup);
 }
 
-void NotificationManager::removeNotification(size_t index) {
-  if (index < notifications.size()) {
-    if (auto task = notifications[index]->getTask()) {
-      auto taskNotifs = task->getNotifications();
-      auto it =
-          std::find(taskNotifs.begin(), taskNotifs.end(), notifications[index]);
-      if (it != taskNotifs.end()) {
-        task->removeNotification(std::distance(taskNotifs.begin(), it));
-      }
+void NotificationManager::schedule(NotificationId id, const Entry &entry) {
+  if (queue->schedule(id, entry.notification->getTriggerTime()) && wakeup) {
+    wakeup();
+  }
+}
+
+void NotificationManager::setTimerQueue(std::unique_ptr<TimerQueue> queue) {
+  std::lock_guard<std::mutex> lock(guard);
+  for (NotificationId id : order) {
+    if (this->queue->contains(id)) {
+      queue->schedule(id, notifications.get(id)->notification->getTriggerTime());
     }
+  }
+  this->queue = std::move(queue);
+  if (wakeup) {
+    wakeup();
+  }
+}
+
+void NotificationManager::compactOrder() {
+  if (cancelledInOrder == 0) {
+    return;
+  }
+  order.erase(std::remove_if(order.begin(), order.end(),
+                             [this](NotificationId id) {
+                               return !notifications.contains(id);
+                             }),
+              order.end());
+  cancelledInOrder = 0;
+}
+
+bool NotificationManager::cancel(NotificationId id) {
+  std::lock_guard<std::mutex> lock(guard);
+  return cancelLocked(id);
+}
 
-    notifications.erase(notifications.begin() + index);
+bool NotificationManager::cancelLocked(NotificationId id) {
+  Entry *entry = notifications.get(id);
+  if (!entry) {
+    return false;
+  }
+  queue->unschedule(id);
+
+  // By the stored id, which still finds the list once the task is gone.
+  auto it = byTask.find(entry->notification->getTaskHandle().value());
+  if (it != byTask.end()) {
+    auto &ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (ids.empty()) {
+      byTask.erase(it);
+      trackedTasks.store(byTask.size(), std::memory_order_relaxed);
+    }
+  }
+
+  notifications.erase(id);
+  if (++cancelledInOrder * 2 > order.size()) {
+    compactOrder();
+  }
+  return true;
+}
+
+bool NotificationManager::reschedule(NotificationId id,
+                                     const DateTime &triggerTime) {
+  std::lock_guard<std::mutex> lock(guard);
+  Entry *entry = notifications.get(id);
+  if (!entry) {
+    return false;
+  }
+  entry->notification->setTriggerTime(triggerTime);
+  schedule(id, *entry);
+  return true;
+}
+
+void NotificationManager::refreshTask(const Task &task) {
+  if (trackedTasks.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(guard);
+  auto it = byTask.find(task.getHandle().value());
+  if (it == byTask.end()) {
+    return;
+  }
+  for (NotificationId id : it->second) {
+    Entry &entry = *notifications.get(id);
+    entry.notification->refresh(task);
+    if (std::dynamic_pointer_cast<DeadlineNotification>(entry.notification)) {
+      // refresh() moved the trigger time to the current deadline; arm it
+      // again, since a reminder for the old deadline says nothing about the
+      // new one.
+      schedule(id, entry);
+    }
+  }
+}
+
+void NotificationManager::forgetTask(TaskId task) {
+  if (trackedTasks.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(guard);
+  auto it = byTask.find(task.value());
+  if (it == byTask.end()) {
+    return;
+  }
+  for (NotificationId id : it->second) {
+    Entry &entry = *notifications.get(id);
+    entry.notification->forgetTask();
+    if (std::dynamic_pointer_cast<DeadlineNotification>(entry.notification)) {
+      queue->unschedule(id);
+    }
+  }
+}
+
+void NotificationManager::removeNotification(size_t index) {
+  std::lock_guard<std::mutex> lock(guard);
+  compactOrder();
+  if (index < order.size()) {
+    cancelLocked(order[index]);
   } else {
     std::cout << "Invalid notification index." << std::endl;
   }
 }
 
+std::vector<std::shared_ptr<Notification>>
+NotificationManager::pollDue(const DateTime &now) {
+  std::vector<std::shared_ptr<Notification>> result;
+  for (DueNotification &due : takeDue(now)) {
+    result.push_back(std::move(due.notification));
+  }
+  return result;
+}
+
+std::vector<DueNotification> NotificationManager::takeDue(const DateTime &now) {
+  std::vector<DueRule> rules;
+  std::vector<DueNotification> due;
+  {
+    std::lock_guard<std::mutex> lock(guard);
+    due = takeDueLocked(now, rules);
+  }
+  if (!rules.empty()) {
+    expandRules(now, rules, due);
+  }
+  return due;
+}
+
+std::vector<DueNotification>
+NotificationManager::takeDueLocked(const DateTime &now,
+                                   std::vector<DueRule> &rules) {
+  std::vector<TimerQueue::Timer> timers;
+  queue->popDue(now, timers);
+  std::vector<DueNotification> due;
+  for (const TimerQueue::Timer &timer : timers) {
+    const Entry &entry = *notifications.get(timer.id);
+    if (auto rule =
+            std::dynamic_pointer_cast<ReminderRule>(entry.notification)) {
+      rules.push_back(DueRule{timer.id, std::move(rule)});
+      continue;
+    }
+    DateTime time = timer.time;
+    DateTime trigger = entry.notification->getTriggerTime();
+    if (time < trigger) {
+      // Moved later since it was armed.
+      if (now < trigger) {
+        queue->schedule(timer.id, trigger);
+        continue;
+      }
+      time = trigger;
+    }
+    if (entry.notification->shouldTrigger(now)) {
+      due.push_back(DueNotification{entry.notification, time});
+    }
+  }
+  return due;
+}
+
+void NotificationManager::expandRules(const DateTime &now,
+                                      const std::vector<DueRule> &rules,
+                                      std::vector<DueNotification> &due) {
+  std::vector<DateTime> next;
+  for (const DueRule &entry : rules) {
+    for (DueNotification &occurrence : entry.rule->takeOccurrences(now)) {
+      due.push_back(std::move(occurrence));
+    }
+    next.push_back(entry.rule->nextCheck(now));
+  }
+  std::stable_sort(due.begin(), due.end(),
+                   [](const DueNotification &a, const DueNotification &b) {
+                     return a.due < b.due;
+                   });
+
+  std::lock_guard<std::mutex> lock(guard);
+  for (std::size_t i = 0; i < rules.size(); ++i) {
+    // Unless it was cancelled meanwhile.
+    const Entry *entry = notifications.get(rules[i].id);
+    if (entry && entry->notification == rules[i].rule) {
+      rules[i].rule->setTriggerTime(next[i]);
+      schedule(rules[i].id, *entry);
+    }
+  }
+}
+
 void NotificationManager::checkNotifications() {
   auto now = std::chrono::system_clock::now();
-  bool foundNotifications = false;
 
-  std::cout << "Current time: " << formatDateTimeNotif(now) << std::endl;
+  std::cout << "Current time: " << iso_date::format(now) << std::endl;
 
-  for (const auto &notification : notifications) {
-    if (notification->shouldTrigger(now)) {
-      notification->display();
-      foundNotifications = true;
-    }
+  auto due = takeDue(now);
+  std::unique_lock<std::mutex> lock(guard);
+  bool none = order.size() == cancelledInOrder;
+  std::size_t scheduled = queue->size();
+  std::optional<TimerQueue::Timer> first = queue->peek();
+  std::shared_ptr<Notification> next =
+      first ? notifications.get(first->id)->notification : nullptr;
+  lock.unlock();
+
+  for (const auto &entry : due) {
+    entry.notification->display();
   }
 
-  if (!foundNotifications) {
-    if (notifications.empty()) {
+  if (due.empty()) {
+    if (none) {
       std::cout << "You have no notifications set up." << std::endl;
     } else {
       std::cout << "No notifications are due at this time." << std::endl;
 
-      std::cout << "You have " << notifications.size()
+      std::cout << "You have " << scheduled
                 << " notification(s) scheduled." << std::endl;
 
-      if (auto deadlineNotif = std::dynamic_pointer_cast<DeadlineNotification>(
-              notifications[0])) {
-        if (auto task = deadlineNotif->getTask()) {
-          std::cout << "Next deadline: " << task->getTitle() << " on "
-                    << formatDateTimeNotif(task->getDeadline()) << std::endl;
+      if (auto deadlineNotif =
+              std::dynamic_pointer_cast<DeadlineNotification>(next)) {
+        if (auto task = deadlineNotif->getTaskDetails()) {
+          std::cout << "Next deadline: " << task->title << " on "
+                    << iso_date::format(task->deadline) << std::endl;
         }
       }
     }
   }
 }
 
+std::size_t NotificationManager::scheduledCount() const {
+  std::lock_guard<std::mutex> lock(guard);
+  return queue->size();
+}
+
+std::shared_ptr<Notification> NotificationManager::nextScheduled() const {
+  std::lock_guard<std::mutex> lock(guard);
+  std::optional<TimerQueue::Timer> first = queue->peek();
+  return first ? notifications.get(first->id)->notification : nullptr;
+}
+
+std::optional<DateTime> NotificationManager::nextTriggerTime() const {
+  std::lock_guard<std::mutex> lock(guard);
+  std::optional<TimerQueue::Timer> first = queue->peek();
+  if (!first) {
+    return std::nullopt;
+  }
+  return first->time;
+}
+
 std::vector<std::shared_ptr<Notification>>
 NotificationManager::getNotifications() const {
-  return notifications;
+  std::lock_guard<std::mutex> lock(guard);
+  std::vector<std::shared_ptr<Notification>> result;
+  result.reserve(order.size() - cancelledInOrder);
+  for (NotificationId id : order) {
+    if (const Entry *entry = notifications.get(id)) {
+      result.push_back(entry->notification);
+    }
+  }
+  return result;
 }
 
 std::vector<std::shared_ptr<Notification>>
 NotificationManager::getNotificationsForTask(std::shared_ptr<Task> task) const {
+  if (!task) {
+    return {};
+  }
+  return getNotificationsForTask(task->getHandle());
+}
 
+std::vector<std::shared_ptr<Notification>>
+NotificationManager::getNotificationsForTask(TaskId task) const {
+  std::lock_guard<std::mutex> lock(guard);
   std::vector<std::shared_ptr<Notification>> result;
-
-  for (const auto &notification : notifications) {
-    if (auto notifTask = notification->getTask()) {
-      if (notifTask == task) {
-        result.push_back(notification);
-      }
+  auto it = byTask.find(task.value());
+  if (it != byTask.end()) {
+    result.reserve(it->second.size());
+    for (NotificationId id : it->second) {
+      result.push_back(notifications.get(id)->notification);
     }
   }
-
   return result;
 }
\ No newline at end of file
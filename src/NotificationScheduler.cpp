@@ -0,0 +1,77 @@
+#include "../include/NotificationScheduler.h"
+
+NotificationScheduler::Sink NotificationScheduler::displaySink() {
+  return [](const NotificationFiring &firing) {
+    firing.notification->display();
+  };
+}
+
+NotificationScheduler::NotificationScheduler(std::vector<Sink> sinks,
+                                             Clock &clock,
+                                             NotificationManager &manager)
+    : manager_(manager), clock_(clock), sinks_(std::move(sinks)) {
+  manager_.setWakeup([this] { wake(); });
+  clock_.attach(mutex_, wake_);
+  worker_ = std::thread(&NotificationScheduler::run, this);
+}
+
+NotificationScheduler::~NotificationScheduler() {
+  // Once this returns the manager is done calling wake().
+  manager_.setWakeup(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  worker_.join();
+  clock_.detach(wake_);
+}
+
+void NotificationScheduler::wake() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  woken_ = true;
+  wake_.notify_one();
+}
+
+void NotificationScheduler::sync() {
+  DateTime now = clock_.now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  woken_ = true;
+  wake_.notify_one();
+  idle_.wait(lock, [&] { return stopping_ || !(polledThrough_ < now); });
+}
+
+void NotificationScheduler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    woken_ = false;
+    lock.unlock();
+
+    DateTime now = clock_.now();
+    std::vector<DueNotification> due = manager_.takeDue(now);
+    for (DueNotification &entry : due) {
+      NotificationFiring firing{std::move(entry.notification), entry.due,
+                                clock_.now()};
+      for (const Sink &sink : sinks_) {
+        sink(firing);
+      }
+    }
+    delivered_.fetch_add(due.size());
+    std::optional<DateTime> next = manager_.nextTriggerTime();
+
+    lock.lock();
+    polledThrough_ = now;
+    idle_.notify_all();
+    // Anything armed since the poll set woken_ rather than being missed.
+    if (woken_ || stopping_) {
+      continue;
+    }
+    if (next) {
+      clock_.waitUntil(lock, wake_, *next);
+    } else {
+      wake_.wait(lock);
+    }
+    wakeups_.fetch_add(1);
+  }
+  idle_.notify_all();
+}
@@ -0,0 +1,41 @@
+#include "../include/ObjectPool.h"
+
+ObjectPool::ObjectPool(std::size_t size) : blockSize_(sizeClass(size)) {}
+
+void *ObjectPool::allocate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++live_;
+  if (free_) {
+    FreeBlock *block = free_;
+    free_ = block->next;
+    return block;
+  }
+  if (next_ == end_) {
+    std::size_t bytes = blockSize_ > kSlabBytes ? blockSize_ : kSlabBytes;
+    bytes -= bytes % blockSize_;
+    // operator new[] for char aligns to at least kAlignment.
+    slabs_.push_back(std::make_unique<char[]>(bytes));
+    next_ = slabs_.back().get();
+    end_ = next_ + bytes;
+  }
+  void *block = next_;
+  next_ += blockSize_;
+  return block;
+}
+
+void ObjectPool::deallocate(void *block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --live_;
+  free_ = new (block) FreeBlock{free_};
+}
+
+std::size_t ObjectPool::live() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return live_;
+}
+
+std::size_t ObjectPool::reservedBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t bytes = blockSize_ > kSlabBytes ? blockSize_ : kSlabBytes;
+  return slabs_.size() * (bytes - bytes % blockSize_);
+}
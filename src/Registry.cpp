@@ -1,11 +1,857 @@
 #include "../include/Registry.h"
+#include "../include/BulkImporter.h"
+#include "../include/CommandManager.h"
+#include "../include/CompositeCommand.h"
+#include "../include/RegistrySnapshot.h"
+#include "../include/SetTaskStateCommand.h"
+#include "../include/TaskBuilder.h"
+#include "../include/TaskState.h"
+#include "../include/WriteAheadLog.h"
 #include "PerformanceVisitor.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+std::optional<TaskStateKind> targetStateFromInt(std::int64_t targetState) {
+  if (targetState < 0 || targetState > 2) {
+    return std::nullopt;
+  }
+  return static_cast<TaskStateKind>(targetState);
+}
+
+// A ChangeTaskStates batch is packed into one field, since a record holds
+// at most 255 fields: per change, u32 code size, code, u32 title size,
+// title, u8 target state.
+struct PackedStateChange {
+  std::string_view code;
+  std::string_view title;
+  std::int64_t target;
+};
+
+void packString(std::string &out, std::string_view text) {
+  std::uint32_t size = static_cast<std::uint32_t>(text.size());
+  out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+  out.append(text);
+}
+
+bool unpackString(std::string_view &in, std::string_view &text) {
+  std::uint32_t size;
+  if (in.size() < sizeof(size)) {
+    return false;
+  }
+  std::memcpy(&size, in.data(), sizeof(size));
+  in.remove_prefix(sizeof(size));
+  if (in.size() < size) {
+    return false;
+  }
+  text = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+// Returns false, with changes incomplete, for a malformed field.
+bool unpackStateChanges(std::string_view in,
+                        std::vector<PackedStateChange> &changes) {
+  while (!in.empty()) {
+    PackedStateChange change;
+    if (!unpackString(in, change.code) || !unpackString(in, change.title) ||
+        in.empty()) {
+      return false;
+    }
+    change.target = static_cast<unsigned char>(in.front());
+    in.remove_prefix(1);
+    changes.push_back(change);
+  }
+  return true;
+}
+
+// Replaces (or, for a null value, removes) the entry for key.
+template <typename V>
+void replaceEntry(RegistryVersion::Entries<V> &entries, const std::string &key,
+                  std::shared_ptr<const V> value) {
+  if (value) {
+    entries.set(key, std::move(value));
+  } else {
+    entries.erase(key);
+  }
+}
+
+template <typename V>
+std::shared_ptr<const V> freeze(const std::shared_ptr<V> &live) {
+  return live ? std::make_shared<const V>(*live) : nullptr;
+}
+
+std::shared_ptr<const SubjectVersion>
+freeze(const std::shared_ptr<Subject> &live) {
+  return live ? SubjectVersion::freeze(*live) : nullptr;
+}
+
+template <typename V, typename Frozen>
+void freezeAll(const InternedMap<std::shared_ptr<V>> &live,
+               RegistryVersion::Entries<Frozen> &entries) {
+  entries.clear();
+  for (const auto &[key, value] : live) {
+    if (value) {
+      entries.set(key, freeze(value));
+    }
+  }
+}
+
+template <typename V>
+auto freezeOne(InternedMap<std::shared_ptr<V>> &live, const std::string &key)
+    -> decltype(freeze(live.find(key)->second)) {
+  auto it = live.find(key);
+  return it == live.end() ? nullptr : freeze(it->second);
+}
+
+// Copies only the named tasks of a subject into the next version; the rest
+// of its frozen tasks are shared with the previous one. A subject the
+// previous version does not have, or that was replaced in the live maps
+// since, is frozen whole.
+void refreezeTasks(InternedMap<std::shared_ptr<Subject>> &live,
+                   RegistryVersion::Entries<SubjectVersion> &entries,
+                   const std::string &code,
+                   const std::vector<std::string_view> &titles) {
+  auto it = live.find(code);
+  if (it == live.end() || !it->second) {
+    entries.erase(code);
+    return;
+  }
+  auto frozen = entries.find(code);
+  entries.set(code, frozen ? frozen->refreeze(*it->second, titles)
+                           : SubjectVersion::freeze(*it->second));
+}
+
+// Brings the live entries of one kind from the version `from` to `to`.
+// Subjects are handled by Registry::restoreLocked, which also moves the
+// indexes over.
+template <typename V>
+void restoreEntries(InternedMap<std::shared_ptr<V>> &live,
+                    const RegistryVersion::Entries<V> &from,
+                    const RegistryVersion::Entries<V> &to, ChangeFeed &changes,
+                    EntityKind kind) {
+  RegistryVersion::Entries<V>::diff(
+      from, to,
+      [&](const std::string &key, const std::shared_ptr<const V> &before,
+          const std::shared_ptr<const V> &after) {
+        if (after) {
+          live[key] = std::make_shared<V>(*after);
+          changes.record(kind,
+                         before ? ChangeType::Updated : ChangeType::Created,
+                         key);
+        } else {
+          live.erase(key);
+          changes.record(kind, ChangeType::Deleted, key);
+        }
+      });
+}
+
+} // namespace
+
+Registry::Registry(bool ownCommands)
+    : ownCommands_(ownCommands ? std::make_unique<CommandManager>() : nullptr),
+      commands_(ownCommands ? ownCommands_.get() : &CommandManager::instance()),
+      latest_(std::make_shared<const RegistryVersion>()), published_(latest_) {
+  history_.push_back(latest_);
+}
+
+Registry::~Registry() = default;
 
 Registry &Registry::instance() {
-  static Registry s;
+  static Registry s(false);
   return s;
 }
 
 double Registry::accept(PerformanceVisitor &visitor) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
   return visitor.visit(*this);
 }
+
+// The record is queued in the log and applied under the write lock, so log
+// order matches apply order; the wait for the disk happens after the lock is
+// released so concurrent writers can share an fsync.
+std::shared_ptr<Task> Registry::commit(std::unique_lock<std::mutex> &lock,
+                                       const WalRecord &record) {
+  WriteAheadLog *log = log_;
+  std::uint64_t lsn = log ? log->enqueue(record) : 0;
+  auto task = applyLocked(record);
+  auto version = stage(record);
+  lock.unlock();
+
+  if (log) {
+    log->waitDurable(lsn);
+  }
+  publishVersion(std::move(version));
+  return task;
+}
+
+// Builds the version that follows latest_: only the entry the record touched
+// is copied again, and of a subject only the tasks it touched; everything
+// else is shared with the previous version.
+std::shared_ptr<const RegistryVersion>
+Registry::stage(const WalRecord &record) {
+  if (record.op == WalOp::SetHistoryDepth) {
+    // No map changes, so readers keep the version they have.
+    return latest_;
+  }
+  if (record.op == WalOp::Undo || record.op == WalOp::Redo) {
+    // applyLocked has moved cursor_; the maps are taken over whole.
+    auto next = std::make_shared<RegistryVersion>(*history_[cursor_]);
+    next->version = latest_->version + 1;
+    latest_ = next;
+    return next;
+  }
+
+  auto next = std::make_shared<RegistryVersion>(*latest_);
+  next->version = latest_->version + 1;
+  const auto &f = record.fields;
+
+  switch (record.op) {
+  case WalOp::CreateSubject:
+    if (f.size() > 1) {
+      replaceEntry(next->subjects, f[1], freezeOne(subjects, f[1]));
+    }
+    break;
+  case WalOp::CreateTask:
+  case WalOp::ChangeTaskState:
+    if (f.size() > 1) {
+      refreezeTasks(subjects, next->subjects, f[0], {f[1]});
+    }
+    break;
+  case WalOp::ChangeTaskStates: {
+    std::vector<PackedStateChange> changes;
+    if (f.size() == 1) {
+      unpackStateChanges(f[0], changes);
+    }
+    std::unordered_map<std::string_view, std::vector<std::string_view>>
+        touched;
+    for (const auto &change : changes) {
+      touched[change.code].push_back(change.title);
+    }
+    for (const auto &[code, titles] : touched) {
+      refreezeTasks(subjects, next->subjects, std::string(code), titles);
+    }
+    break;
+  }
+  case WalOp::CreateInternship:
+    if (!f.empty()) {
+      replaceEntry(next->internships, f[0], freezeOne(internships, f[0]));
+    }
+    break;
+  case WalOp::CreateResume:
+    if (!f.empty()) {
+      replaceEntry(next->resumes, f[0], freezeOne(resumes, f[0]));
+    }
+    break;
+  case WalOp::Undo:
+  case WalOp::Redo:
+  case WalOp::SetHistoryDepth:
+    break;
+  }
+
+  latest_ = next;
+  remember(next);
+  return next;
+}
+
+void Registry::remember(std::shared_ptr<const RegistryVersion> version) {
+  history_.erase(history_.begin() + static_cast<std::ptrdiff_t>(cursor_) + 1,
+                 history_.end());
+  history_.push_back(std::move(version));
+  if (history_.size() > historyDepth_ + 1) {
+    history_.pop_front();
+  }
+  cursor_ = history_.size() - 1;
+}
+
+void Registry::resetHistory(std::shared_ptr<const RegistryVersion> version) {
+  history_.clear();
+  history_.push_back(std::move(version));
+  cursor_ = 0;
+}
+
+// Only entries whose frozen value differs between the two versions are
+// touched; everything the maps share keeps its live object. A subject in
+// both versions keeps its live object too, and only its tasks that differ
+// are changed, in place. Entries changed since outside the mutation
+// methods are left as they are.
+void Registry::restoreLocked(std::shared_ptr<const RegistryVersion> &target) {
+  std::shared_ptr<RegistryVersion> relinked;
+  auto relink = [&](const std::string &code,
+                    std::shared_ptr<const SubjectVersion> subject) {
+    if (!relinked) {
+      relinked = std::make_shared<RegistryVersion>(*target);
+    }
+    relinked->subjects.set(code, std::move(subject));
+  };
+
+  RegistryVersion::Entries<SubjectVersion>::diff(
+      latest_->subjects, target->subjects,
+      [&](const std::string &code,
+          const std::shared_ptr<const SubjectVersion> &before,
+          const std::shared_ptr<const SubjectVersion> &after) {
+        auto it = subjects.find(code);
+        bool existed = it != subjects.end() && it->second;
+        if (existed && before && after) {
+          // The indexes follow the task changes as listeners.
+          auto titles = after->restoreInto(*it->second, *before);
+          if (!titles.empty()) {
+            relink(code, after->relink(*it->second, titles));
+          }
+          changes_.record(EntityKind::Subject, ChangeType::Updated, code);
+          return;
+        }
+        if (existed) {
+          detachIndexes(*it->second);
+        }
+        if (after) {
+          auto live = after->thaw();
+          subjects[code] = live;
+          attachIndexes(*live);
+          relink(code, SubjectVersion::freeze(*live));
+          changes_.record(EntityKind::Subject,
+                          existed ? ChangeType::Updated : ChangeType::Created,
+                          code);
+        } else {
+          subjects.erase(code);
+          changes_.record(EntityKind::Subject, ChangeType::Deleted, code);
+        }
+      });
+  restoreEntries(internships, latest_->internships, target->internships,
+                 changes_, EntityKind::Internship);
+  restoreEntries(resumes, latest_->resumes, target->resumes, changes_,
+                 EntityKind::Resume);
+  if (relinked) {
+    target = std::move(relinked);
+  }
+}
+
+bool Registry::undo() {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  if (cursor_ == 0) {
+    return false;
+  }
+  commit(lock, {WalOp::Undo, {}, {}});
+  return true;
+}
+
+bool Registry::redo() {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  if (cursor_ + 1 >= history_.size()) {
+    return false;
+  }
+  commit(lock, {WalOp::Redo, {}, {}});
+  return true;
+}
+
+bool Registry::canUndo() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return cursor_ != 0;
+}
+
+bool Registry::canRedo() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return cursor_ + 1 < history_.size();
+}
+
+std::size_t Registry::historyDepth() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return historyDepth_;
+}
+
+void Registry::setHistoryDepth(std::size_t depth) {
+  if (depth == 0) {
+    throw std::invalid_argument("Registry: history depth must be positive");
+  }
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  // Logged, so that replay trims the history where the original run did and
+  // an undo after recovery steps as far back as it could have before.
+  commit(lock,
+         {WalOp::SetHistoryDepth, {}, {static_cast<std::int64_t>(depth)}});
+}
+
+// Versions can finish their log wait out of order; an older one must never
+// replace a newer one that already includes its change.
+void Registry::publishVersion(std::shared_ptr<const RegistryVersion> version) {
+  auto current = std::atomic_load(&published_);
+  while (current->version < version->version &&
+         !std::atomic_compare_exchange_weak(&published_, &current, version)) {
+  }
+}
+
+std::shared_ptr<const RegistryVersion> Registry::snapshot() const {
+  return std::atomic_load(&published_);
+}
+
+void Registry::publish() {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  auto next = std::make_shared<RegistryVersion>();
+  next->version = latest_->version + 1;
+  freezeAll(subjects, next->subjects);
+  freezeAll(internships, next->internships);
+  freezeAll(resumes, next->resumes);
+  latest_ = next;
+  resetHistory(next);
+
+  deadlineIndex_.clear();
+  taskBitmaps_.clear();
+  changes_.clear();
+  // The maps may have been edited directly, so nothing in the change log
+  // can be trusted any more.
+  changes_.reset();
+  for (const auto &[code, subject] : subjects) {
+    if (subject) {
+      attachIndexes(*subject);
+    }
+  }
+  lock.unlock();
+
+  publishVersion(std::move(next));
+}
+
+void Registry::apply(const WalRecord &record) {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  applyLocked(record);
+  auto version = stage(record);
+  lock.unlock();
+
+  publishVersion(std::move(version));
+}
+
+bool Registry::changeTaskStates(
+    const std::vector<std::pair<TaskId, int>> &changes) {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  std::string packed;
+  for (const auto &[taskId, targetState] : changes) {
+    Task *task = Task::resolve(taskId);
+    Subject *subject = task ? task->getSubject() : nullptr;
+    if (!subject) {
+      std::cout << "Error: Task " << taskId.value() << " not found."
+                << std::endl;
+      return false;
+    }
+    auto subjectIt = subjects.find(subject->getCode());
+    if (subjectIt == subjects.end() || subjectIt->second.get() != subject) {
+      std::cout << "Error: Task " << taskId.value()
+                << " does not belong to this registry." << std::endl;
+      return false;
+    }
+    if (!targetStateFromInt(targetState)) {
+      return false;
+    }
+    packString(packed, subject->getCode());
+    packString(packed, task->getTitle());
+    packed.push_back(static_cast<char>(targetState));
+  }
+  if (changes.empty()) {
+    return true;
+  }
+
+  commit(lock, {WalOp::ChangeTaskStates, {std::move(packed)}, {}});
+  return true;
+}
+
+void Registry::importBatch(const ImportBatch &batch, ImportStats &stats) {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  std::unordered_set<std::string> touched;
+
+  for (const auto &subject : batch.subjects) {
+    if (!subject || subjects.count(subject->getCode())) {
+      ++stats.rejected;
+      continue;
+    }
+    subjects[subject->getCode()] = subject;
+    attachIndexes(*subject);
+    changes_.record(EntityKind::Subject, ChangeType::Created,
+                    subject->getCode());
+    touched.insert(subject->getCode());
+    ++stats.subjects;
+  }
+
+  for (const auto &[code, tasks] : batch.tasks) {
+    auto subjectIt = subjects.find(code);
+    if (subjectIt == subjects.end() || !subjectIt->second) {
+      stats.rejected += tasks.size();
+      continue;
+    }
+    std::size_t before = subjectIt->second->getTaskCount();
+    subjectIt->second->addTasks(tasks);
+    std::size_t added = subjectIt->second->getTaskCount() - before;
+    stats.tasks += added;
+    stats.rejected += tasks.size() - added;
+    touched.insert(code);
+  }
+
+  auto next = std::make_shared<RegistryVersion>(*latest_);
+  next->version = latest_->version + 1;
+  for (const auto &code : touched) {
+    replaceEntry(next->subjects, code, freezeOne(subjects, code));
+  }
+  latest_ = next;
+  // Imports are not logged, so a logged undo must never reach behind one.
+  resetHistory(next);
+  lock.unlock();
+
+  publishVersion(std::move(next));
+}
+
+void Registry::attachIndexes(Subject &subject) {
+  deadlineIndex_.attach(subject);
+  taskBitmaps_.attach(subject);
+  changes_.attach(subject);
+}
+
+void Registry::detachIndexes(Subject &subject) {
+  deadlineIndex_.detach(subject);
+  taskBitmaps_.detach(subject);
+  changes_.detach(subject);
+}
+
+ChangeSet Registry::changesSince(std::uint64_t generation) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return changes_.changesSince(generation);
+}
+
+std::uint64_t Registry::stamp(EntityKind kind, const std::string &key,
+                              const std::string &subject) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return changes_.stamp(kind, key, subject);
+}
+
+std::vector<DueTask> Registry::tasksDueBetween(const DateTime &from,
+                                               const DateTime &to) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return deadlineIndex_.tasksDueBetween(from, to);
+}
+
+std::vector<DueTask> Registry::nextDue(std::size_t k, const DateTime &now) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return deadlineIndex_.nextDue(k, now);
+}
+
+std::vector<DueTask> Registry::overdue(const DateTime &now) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return deadlineIndex_.overdue(now);
+}
+
+std::uint64_t Registry::countTasks(const TaskFilter &filter) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return taskBitmaps_.count(filter);
+}
+
+std::vector<Task *> Registry::findTasks(const TaskFilter &filter) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return taskBitmaps_.select(filter);
+}
+
+void Registry::checkpoint(const std::string &snapshotPath) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  if (log_) {
+    log_->checkpoint(*this, snapshotPath);
+  } else {
+    RegistrySnapshot::write(*this, snapshotPath);
+  }
+  // The log no longer holds the records an undo would step back over.
+  resetHistory(latest_);
+  // Nor the depth, unless it is logged again.
+  if (log_ && historyDepth_ != kDefaultHistoryDepth) {
+    log_->append({WalOp::SetHistoryDepth,
+                  {},
+                  {static_cast<std::int64_t>(historyDepth_)}});
+  }
+}
+
+bool Registry::createSubject(const std::string &name, const std::string &code,
+                             const std::string &description) {
+  // Checked before the record is logged: one that cannot be applied must
+  // never reach the log.
+  if (name.empty() || code.empty()) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  commit(lock, {WalOp::CreateSubject, {name, code, description}, {}});
+  return true;
+}
+
+std::shared_ptr<Task> Registry::createTask(const std::string &subjectCode,
+                                           const std::string &title,
+                                           const std::string &description,
+                                           const DateTime &deadline,
+                                           int taskType) {
+  if (title.empty()) {
+    return nullptr;
+  }
+
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  auto subjectIt = subjects.find(subjectCode);
+  if (subjectIt == subjects.end() || !subjectIt->second ||
+      subjectIt->second->findTask(title)) {
+    return nullptr;
+  }
+
+  std::int64_t deadlineNs =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          deadline.time_since_epoch())
+          .count();
+  return commit(lock,
+                {WalOp::CreateTask,
+                 {subjectCode, title, description},
+                 {deadlineNs, taskType}});
+}
+
+std::string Registry::createInternship(const std::string &company,
+                                       const std::string &position,
+                                       InternshipStatus status,
+                                       const std::string &startDate,
+                                       const std::string &endDate) {
+  if (company.empty() || position.empty() || startDate.empty() ||
+      endDate.empty()) {
+    return "";
+  }
+
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  std::string generatedId =
+      "internship_" + std::to_string(nextInternshipId_++);
+  while (internships.count(generatedId)) {
+    generatedId = "internship_" + std::to_string(nextInternshipId_++);
+  }
+
+  commit(lock,
+         {WalOp::CreateInternship,
+          {generatedId, company, position, startDate, endDate},
+          {static_cast<std::int64_t>(status)}});
+  return generatedId;
+}
+
+std::string Registry::createResume(const std::string &title,
+                                   const std::string &htmlBody) {
+  if (title.empty()) {
+    return "";
+  }
+
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  std::string generatedId = "resume_" + std::to_string(nextResumeId_++);
+  while (resumes.count(generatedId)) {
+    generatedId = "resume_" + std::to_string(nextResumeId_++);
+  }
+
+  commit(lock, {WalOp::CreateResume, {generatedId, title, htmlBody}, {}});
+  return generatedId;
+}
+
+bool Registry::changeTaskState(const std::string &subjectCode, int taskIndex,
+                               int targetState) {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  auto subjectIt = subjects.find(subjectCode);
+  if (subjectIt == subjects.end() || !subjectIt->second) {
+    std::cout << "Error: Subject with code '" << subjectCode << "' not found."
+              << std::endl;
+    return false;
+  }
+
+  TaskSpan tasks = subjectIt->second->taskView();
+  if (taskIndex < 0 || static_cast<size_t>(taskIndex) >= tasks.size()) {
+    std::cout << "Error: Invalid task index " << taskIndex << " for subject '"
+              << subjectCode << "'." << std::endl;
+    return false;
+  }
+
+  if (!targetStateFromInt(targetState)) {
+    return false;
+  }
+
+  // Logged by title rather than index so replay does not depend on the
+  // position of the task in the subject.
+  commit(lock,
+         {WalOp::ChangeTaskState,
+          {subjectCode,
+           std::string(tasks[static_cast<size_t>(taskIndex)]->getTitle())},
+          {targetState}});
+  return true;
+}
+
+bool Registry::changeTaskState(TaskId taskId, int targetState) {
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  Task *task = Task::resolve(taskId);
+  Subject *subject = task ? task->getSubject() : nullptr;
+  if (!subject) {
+    std::cout << "Error: Task " << taskId.value() << " not found."
+              << std::endl;
+    return false;
+  }
+  auto subjectIt = subjects.find(subject->getCode());
+  if (subjectIt == subjects.end() || subjectIt->second.get() != subject) {
+    std::cout << "Error: Task " << taskId.value()
+              << " does not belong to this registry." << std::endl;
+    return false;
+  }
+
+  if (!targetStateFromInt(targetState)) {
+    return false;
+  }
+
+  commit(lock,
+         {WalOp::ChangeTaskState,
+          {subject->getCode(), std::string(task->getTitle())},
+          {targetState}});
+  return true;
+}
+
+// Record layouts:
+//   CreateSubject     fields {name, code, description}
+//   CreateTask        fields {subjectCode, title, description}
+//                     values {deadline ns since epoch, taskType}
+//   CreateInternship  fields {id, company, position, startDate, endDate}
+//                     values {status}
+//   CreateResume      fields {id, title, htmlBody}
+//   ChangeTaskState   fields {subjectCode, taskTitle}, values {targetState}
+//   ChangeTaskStates  fields {packed (subjectCode, taskTitle, targetState)
+//                     triples}; applied only if every task is found
+//   Undo, Redo        no fields; a no-op when there is nothing to step to
+//   SetHistoryDepth   values {depth}; ignored unless positive
+// A record whose layout or fields are invalid is skipped, so one bad record
+// cannot stop recovery.
+std::shared_ptr<Task> Registry::applyLocked(const WalRecord &record) {
+  const auto &f = record.fields;
+  const auto &v = record.values;
+
+  switch (record.op) {
+  case WalOp::CreateSubject:
+    if (f.size() == 3 && !f[0].empty() && !f[1].empty()) {
+      auto subject = SubjectBuilder()
+                         .setName(f[0])
+                         .setCode(f[1])
+                         .setDescription(f[2])
+                         .build();
+      subjects[f[1]] = subject;
+      attachIndexes(*subject);
+      changes_.record(EntityKind::Subject, ChangeType::Created, f[1]);
+    }
+    break;
+
+  case WalOp::CreateTask: {
+    if (f.size() != 3 || v.size() != 2 || f[1].empty()) {
+      break;
+    }
+    auto subjectIt = subjects.find(f[0]);
+    if (subjectIt == subjects.end() || !subjectIt->second) {
+      break;
+    }
+
+    TaskBuilder builder;
+    builder.setTitle(f[1]).setDescription(f[2]).setDeadline(
+        DateTime(std::chrono::duration_cast<DateTime::duration>(
+            std::chrono::nanoseconds(v[0]))));
+    switch (v[1]) {
+    case 2:
+      builder.asProject();
+      break;
+    case 3:
+      builder.asExam();
+      break;
+    default:
+      builder.asLab();
+      break;
+    }
+    auto task = builder.build();
+    subjectIt->second->addTask(task);
+    return task;
+  }
+
+  case WalOp::CreateInternship:
+    if (f.size() == 5 && v.size() == 1) {
+      bool existed = internships.count(f[0]) != 0;
+      internships[f[0]] = std::make_shared<Internship>(
+          f[0], f[1], f[2], static_cast<InternshipStatus>(v[0]), f[3], f[4]);
+      changes_.record(EntityKind::Internship,
+                      existed ? ChangeType::Updated : ChangeType::Created,
+                      f[0]);
+    }
+    break;
+
+  case WalOp::CreateResume:
+    if (f.size() == 3) {
+      bool existed = resumes.count(f[0]) != 0;
+      resumes[f[0]] = std::make_shared<Resume>(f[0], f[1], f[2]);
+      changes_.record(EntityKind::Resume,
+                      existed ? ChangeType::Updated : ChangeType::Created,
+                      f[0]);
+    }
+    break;
+
+  case WalOp::ChangeTaskState: {
+    if (f.size() != 2 || v.size() != 1) {
+      break;
+    }
+    auto subjectIt = subjects.find(f[0]);
+    auto state = targetStateFromInt(v[0]);
+    if (subjectIt == subjects.end() || !subjectIt->second || !state) {
+      break;
+    }
+    auto task = subjectIt->second->findTask(f[1]);
+    if (!task) {
+      break;
+    }
+    SetTaskStateCommand(*task, *state).execute();
+    return task;
+  }
+
+  case WalOp::ChangeTaskStates: {
+    std::vector<PackedStateChange> changes;
+    if (f.size() != 1 || !unpackStateChanges(f[0], changes)) {
+      break;
+    }
+    auto batch = std::make_shared<CompositeCommand>();
+    batch->reserve(changes.size());
+    for (const auto &change : changes) {
+      auto subjectIt = subjects.find(change.code);
+      auto state = targetStateFromInt(change.target);
+      if (subjectIt == subjects.end() || !subjectIt->second || !state) {
+        return nullptr;
+      }
+      auto task = subjectIt->second->findTask(change.title);
+      if (!task) {
+        return nullptr;
+      }
+      batch->addStateChange(*task, *state);
+    }
+    batch->execute();
+    break;
+  }
+
+  case WalOp::Undo:
+    if (cursor_ > 0) {
+      restoreLocked(history_[cursor_ - 1]);
+      --cursor_;
+    }
+    break;
+
+  case WalOp::Redo:
+    if (cursor_ + 1 < history_.size()) {
+      restoreLocked(history_[cursor_ + 1]);
+      ++cursor_;
+    }
+    break;
+
+  case WalOp::SetHistoryDepth:
+    if (v.size() == 1 && v[0] > 0) {
+      historyDepth_ = static_cast<std::size_t>(v[0]);
+      history_.erase(history_.begin() + static_cast<std::ptrdiff_t>(cursor_) +
+                         1,
+                     history_.end());
+      while (history_.size() > historyDepth_ + 1) {
+        history_.pop_front();
+      }
+      cursor_ = history_.size() - 1;
+    }
+    break;
+  }
+  return nullptr;
+}
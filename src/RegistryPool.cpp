@@ -0,0 +1,79 @@
+#include "../include/RegistryPool.h"
+#include <algorithm>
+
+const std::string RegistryPool::kDefaultStudent = "default";
+
+Registry &RegistryPool::Worker::shard(const std::string &studentId) {
+  auto it = shards.find(studentId);
+  if (it != shards.end()) {
+    return *it->second;
+  }
+
+  Registry *registry = nullptr;
+  if (studentId == kDefaultStudent) {
+    registry = &Registry::instance();
+  } else {
+    owned.push_back(std::unique_ptr<Registry>(new Registry(true)));
+    registry = owned.back().get();
+  }
+  shards.emplace(studentId, registry);
+  return *registry;
+}
+
+void RegistryPool::Worker::run() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      job = std::move(queue.front());
+      queue.pop_front();
+    }
+    job();
+  }
+}
+
+RegistryPool::RegistryPool(std::size_t workers) {
+  if (workers == 0) {
+    workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    Worker *worker = workers_.back().get();
+    worker->thread = std::thread([worker] { worker->run(); });
+  }
+}
+
+RegistryPool::~RegistryPool() {
+  for (auto &worker : workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->stopping = true;
+    }
+    worker->ready.notify_one();
+  }
+  for (auto &worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+std::size_t RegistryPool::workerFor(const std::string &studentId) const {
+  return std::hash<std::string>()(studentId) % workers_.size();
+}
+
+void RegistryPool::post(const std::string &studentId,
+                        std::function<void(Registry &)> operation) {
+  Worker &worker = *workers_[workerFor(studentId)];
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.queue.push_back(
+        [&worker, studentId, operation = std::move(operation)] {
+          operation(worker.shard(studentId));
+        });
+  }
+  worker.ready.notify_one();
+}
@@ -0,0 +1,502 @@
+#include "../include/RegistrySnapshot.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskState.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace snapshot_format;
+
+namespace {
+
+std::uint64_t align8(std::uint64_t value) { return (value + 7) & ~7ull; }
+
+// TaskType and TaskStateKind are declared in snapshot code order.
+std::uint8_t encodeType(const Task &task) {
+  return static_cast<std::uint8_t>(task.getTaskType());
+}
+
+std::uint8_t encodeState(const Task &task) {
+  return static_cast<std::uint8_t>(task.getStateKind());
+}
+
+const char *const kTypeNames[] = {"Lab", "Project", "Exam"};
+const char *const kStateNames[] = {"Pending", "In Progress", "Completed"};
+
+class StringBlob {
+private:
+  std::vector<char> bytes_;
+
+public:
+  StringRef add(std::string_view text) {
+    if (bytes_.size() + text.size() >
+        std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error("RegistrySnapshot: string data exceeds 4 GiB");
+    }
+    StringRef ref{static_cast<std::uint32_t>(bytes_.size()),
+                  static_cast<std::uint32_t>(text.size())};
+    bytes_.insert(bytes_.end(), text.begin(), text.end());
+    return ref;
+  }
+
+  const std::vector<char> &bytes() const { return bytes_; }
+};
+
+template <typename Record>
+void copySection(std::vector<char> &image, std::uint64_t offset,
+                 const std::vector<Record> &records) {
+  if (!records.empty()) {
+    std::memcpy(image.data() + offset, records.data(),
+                records.size() * sizeof(Record));
+  }
+}
+
+void writeFile(const std::string &path, const std::vector<char> &image) {
+  std::string tempPath = path + ".tmp";
+
+#ifdef _WIN32
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+    if (!out) {
+      throw std::runtime_error("RegistrySnapshot: cannot write " + tempPath);
+    }
+  }
+  std::remove(path.c_str());
+#else
+  int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("RegistrySnapshot: cannot create " + tempPath);
+  }
+
+  const char *cursor = image.data();
+  std::size_t remaining = image.size();
+  while (remaining > 0) {
+    ssize_t written = ::write(fd, cursor, remaining);
+    if (written <= 0) {
+      ::close(fd);
+      throw std::runtime_error("RegistrySnapshot: cannot write " + tempPath);
+    }
+    cursor += written;
+    remaining -= static_cast<std::size_t>(written);
+  }
+
+  bool synced = ::fsync(fd) == 0;
+  ::close(fd);
+  if (!synced) {
+    throw std::runtime_error("RegistrySnapshot: cannot sync " + tempPath);
+  }
+#endif
+
+  if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error("RegistrySnapshot: cannot rename " + tempPath);
+  }
+}
+
+} // namespace
+
+std::string_view SnapshotTask::getTitle() const {
+  return snapshot_->str(record_->title);
+}
+
+std::string_view SnapshotTask::getDescription() const {
+  return snapshot_->str(record_->description);
+}
+
+DateTime SnapshotTask::getDeadline() const {
+  return DateTime(std::chrono::duration_cast<DateTime::duration>(
+      std::chrono::nanoseconds(record_->deadlineNs)));
+}
+
+std::string_view SnapshotTask::getType() const {
+  return record_->type < 3 ? kTypeNames[record_->type] : "Unknown";
+}
+
+std::string_view SnapshotTask::getStateName() const {
+  return record_->state < 3 ? kStateNames[record_->state] : "None";
+}
+
+bool SnapshotTask::isCompleted() const { return record_->state == 2; }
+
+std::string_view SnapshotSubject::getName() const {
+  return snapshot_->str(record_->name);
+}
+
+std::string_view SnapshotSubject::getCode() const {
+  return snapshot_->str(record_->code);
+}
+
+std::string_view SnapshotSubject::getDescription() const {
+  return snapshot_->str(record_->description);
+}
+
+SnapshotTask SnapshotSubject::task(std::size_t index) const {
+  if (index >= record_->taskCount) {
+    throw std::out_of_range("SnapshotSubject::task: index out of range");
+  }
+  return snapshot_->task(record_->firstTask + index);
+}
+
+namespace {
+
+// Source is either the live Registry or a published RegistryVersion; both
+// expose subjects/internships/resumes as ranges of (key, pointer) pairs.
+template <typename Source>
+void writeImage(const Source &registry, const std::string &path) {
+  StringBlob strings;
+  std::vector<SubjectRecord> subjects;
+  std::vector<TaskRecord> tasks;
+  std::vector<InternshipRecord> internships;
+  std::vector<ResumeRecord> resumes;
+
+  subjects.reserve(registry.subjects.size());
+  for (const auto &[code, subject] : registry.subjects) {
+    if (!subject) {
+      continue;
+    }
+
+    SubjectRecord record{};
+    record.name = strings.add(subject->getName());
+    record.code = strings.add(subject->getCode());
+    record.description = strings.add(subject->getDescription());
+    record.firstTask = static_cast<std::uint32_t>(tasks.size());
+
+    for (const auto &task : subject->taskView()) {
+      if (!task) {
+        continue;
+      }
+      TaskRecord taskRecord{};
+      taskRecord.title = strings.add(task->getTitle());
+      taskRecord.description = strings.add(task->getDescription());
+      taskRecord.deadlineNs =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              task->getDeadline().time_since_epoch())
+              .count();
+      taskRecord.marks = task->getMarks();
+      taskRecord.type = encodeType(*task);
+      taskRecord.state = encodeState(*task);
+      tasks.push_back(taskRecord);
+    }
+
+    record.taskCount =
+        static_cast<std::uint32_t>(tasks.size() - record.firstTask);
+    subjects.push_back(record);
+  }
+
+  for (const auto &[id, internship] : registry.internships) {
+    if (!internship) {
+      continue;
+    }
+    InternshipRecord record{};
+    record.id = strings.add(internship->id);
+    record.company = strings.add(internship->company);
+    record.position = strings.add(internship->position);
+    record.startDate = strings.add(internship->startDate);
+    record.endDate = strings.add(internship->endDate);
+    record.status = static_cast<std::uint8_t>(internship->status);
+    internships.push_back(record);
+  }
+
+  for (const auto &[id, resume] : registry.resumes) {
+    if (!resume) {
+      continue;
+    }
+    ResumeRecord record{};
+    record.id = strings.add(resume->getId());
+    record.title = strings.add(resume->getTitle());
+    record.htmlBody = strings.add(resume->getHtmlBody());
+    resumes.push_back(record);
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.endianTag = kEndianTag;
+  header.subjectCount = subjects.size();
+  header.taskCount = tasks.size();
+  header.internshipCount = internships.size();
+  header.resumeCount = resumes.size();
+  header.subjectOffset = align8(sizeof(Header));
+  header.taskOffset =
+      align8(header.subjectOffset + subjects.size() * sizeof(SubjectRecord));
+  header.internshipOffset =
+      align8(header.taskOffset + tasks.size() * sizeof(TaskRecord));
+  header.resumeOffset = align8(header.internshipOffset +
+                               internships.size() * sizeof(InternshipRecord));
+  header.stringOffset =
+      align8(header.resumeOffset + resumes.size() * sizeof(ResumeRecord));
+  header.stringBytes = strings.bytes().size();
+  header.fileSize = header.stringOffset + header.stringBytes;
+
+  std::vector<char> image(header.fileSize, 0);
+  std::memcpy(image.data(), &header, sizeof(header));
+  copySection(image, header.subjectOffset, subjects);
+  copySection(image, header.taskOffset, tasks);
+  copySection(image, header.internshipOffset, internships);
+  copySection(image, header.resumeOffset, resumes);
+  copySection(image, header.stringOffset, strings.bytes());
+
+  writeFile(path, image);
+}
+
+} // namespace
+
+void RegistrySnapshot::write(const Registry &registry,
+                             const std::string &path) {
+  writeImage(registry, path);
+}
+
+void RegistrySnapshot::write(const RegistryVersion &version,
+                             const std::string &path) {
+  writeImage(version, path);
+}
+
+RegistrySnapshot RegistrySnapshot::open(const std::string &path) {
+  RegistrySnapshot snapshot;
+
+#ifdef _WIN32
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("RegistrySnapshot: cannot open " + path);
+  }
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  char *copy = new char[bytes.size()];
+  std::memcpy(copy, bytes.data(), bytes.size());
+  snapshot.data_ = copy;
+  snapshot.size_ = bytes.size();
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("RegistrySnapshot: cannot open " + path);
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    throw std::runtime_error("RegistrySnapshot: cannot stat " + path);
+  }
+
+  void *mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                         PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("RegistrySnapshot: cannot map " + path);
+  }
+
+  snapshot.data_ = static_cast<const char *>(mapping);
+  snapshot.size_ = static_cast<std::size_t>(info.st_size);
+  snapshot.mapped_ = true;
+#endif
+
+  if (snapshot.size_ < sizeof(Header)) {
+    throw std::runtime_error("RegistrySnapshot: truncated header in " + path);
+  }
+
+  snapshot.header_ = reinterpret_cast<const Header *>(snapshot.data_);
+  const Header &header = *snapshot.header_;
+
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("RegistrySnapshot: " + path +
+                             " is not a registry snapshot");
+  }
+  if (header.endianTag != kEndianTag) {
+    throw std::runtime_error("RegistrySnapshot: byte order mismatch in " +
+                             path);
+  }
+  if (header.version != kVersion) {
+    throw std::runtime_error("RegistrySnapshot: unsupported format version " +
+                             std::to_string(header.version));
+  }
+  if (header.fileSize != snapshot.size_ ||
+      header.stringOffset > snapshot.size_ ||
+      header.stringBytes > snapshot.size_ - header.stringOffset) {
+    throw std::runtime_error("RegistrySnapshot: size mismatch in " + path);
+  }
+
+  // Bounds-check every section up front; string references are checked as
+  // they are read.
+  snapshot.section<SubjectRecord>(header.subjectOffset, header.subjectCount);
+  snapshot.section<TaskRecord>(header.taskOffset, header.taskCount);
+  snapshot.section<InternshipRecord>(header.internshipOffset,
+                                     header.internshipCount);
+  snapshot.section<ResumeRecord>(header.resumeOffset, header.resumeCount);
+
+  return snapshot;
+}
+
+template <typename Record>
+const Record *RegistrySnapshot::section(std::uint64_t offset,
+                                        std::uint64_t count) const {
+  if (offset % alignof(Record) != 0 || offset > size_ ||
+      count > (size_ - offset) / sizeof(Record)) {
+    throw std::runtime_error("RegistrySnapshot: corrupt section table");
+  }
+  return reinterpret_cast<const Record *>(data_ + offset);
+}
+
+RegistrySnapshot::~RegistrySnapshot() { release(); }
+
+RegistrySnapshot::RegistrySnapshot(RegistrySnapshot &&other) noexcept
+    : data_(other.data_), size_(other.size_), mapped_(other.mapped_),
+      header_(other.header_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.header_ = nullptr;
+}
+
+RegistrySnapshot &
+RegistrySnapshot::operator=(RegistrySnapshot &&other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = other.data_;
+    size_ = other.size_;
+    mapped_ = other.mapped_;
+    header_ = other.header_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.header_ = nullptr;
+  }
+  return *this;
+}
+
+void RegistrySnapshot::release() {
+  if (!data_) {
+    return;
+  }
+#ifdef _WIN32
+  delete[] data_;
+#else
+  if (mapped_) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+std::string_view RegistrySnapshot::str(const StringRef &ref) const {
+  if (static_cast<std::uint64_t>(ref.offset) + ref.size >
+      header_->stringBytes) {
+    throw std::runtime_error("RegistrySnapshot: string out of bounds");
+  }
+  return std::string_view(data_ + header_->stringOffset + ref.offset,
+                          ref.size);
+}
+
+SnapshotSubject RegistrySnapshot::subject(std::size_t index) const {
+  if (index >= header_->subjectCount) {
+    throw std::out_of_range("RegistrySnapshot::subject: index out of range");
+  }
+  return SnapshotSubject(
+      this, section<SubjectRecord>(header_->subjectOffset,
+                                   header_->subjectCount) +
+                index);
+}
+
+SnapshotTask RegistrySnapshot::task(std::size_t index) const {
+  if (index >= header_->taskCount) {
+    throw std::out_of_range("RegistrySnapshot::task: index out of range");
+  }
+  return SnapshotTask(
+      this,
+      section<TaskRecord>(header_->taskOffset, header_->taskCount) + index);
+}
+
+Internship RegistrySnapshot::internship(std::size_t index) const {
+  if (index >= header_->internshipCount) {
+    throw std::out_of_range(
+        "RegistrySnapshot::internship: index out of range");
+  }
+  const InternshipRecord &record =
+      section<InternshipRecord>(header_->internshipOffset,
+                                header_->internshipCount)[index];
+  InternshipStatus status = record.status <= 3
+                                ? static_cast<InternshipStatus>(record.status)
+                                : InternshipStatus::PENDING;
+  return Internship(std::string(str(record.id)),
+                    std::string(str(record.company)),
+                    std::string(str(record.position)), status,
+                    std::string(str(record.startDate)),
+                    std::string(str(record.endDate)));
+}
+
+Resume RegistrySnapshot::resume(std::size_t index) const {
+  if (index >= header_->resumeCount) {
+    throw std::out_of_range("RegistrySnapshot::resume: index out of range");
+  }
+  const ResumeRecord &record =
+      section<ResumeRecord>(header_->resumeOffset, header_->resumeCount)[index];
+  return Resume(std::string(str(record.id)), std::string(str(record.title)),
+                std::string(str(record.htmlBody)));
+}
+
+void RegistrySnapshot::restore(Registry &registry) const {
+  registry.subjects.clear();
+  registry.internships.clear();
+  registry.resumes.clear();
+
+  LabFactory labFactory;
+  ProjectFactory projectFactory;
+  ExamFactory examFactory;
+  TaskFactory *factories[] = {&labFactory, &projectFactory, &examFactory};
+
+  registry.subjects.reserve(subjectCount());
+  std::vector<std::shared_ptr<Task>> batch;
+
+  for (std::size_t i = 0; i < subjectCount(); ++i) {
+    SnapshotSubject source = subject(i);
+    auto target = std::make_shared<Subject>(
+        std::string(source.getName()), std::string(source.getCode()),
+        std::string(source.getDescription()));
+
+    batch.clear();
+    batch.reserve(source.taskCount());
+    for (std::size_t t = 0; t < source.taskCount(); ++t) {
+      SnapshotTask record = source.task(t);
+      TaskFactory *factory =
+          factories[record.typeCode() < 3 ? record.typeCode() : 0];
+      auto task = factory->createTask(std::string(record.getTitle()),
+                                      record.getDeadline(),
+                                      std::string(record.getDescription()));
+      if (record.stateCode() == 2) {
+        task->completeTask();
+        task->setMarks(record.getMarks());
+      } else if (record.stateCode() == 1) {
+        task->startTask();
+      }
+      batch.push_back(std::move(task));
+    }
+
+    target->addTasks(batch);
+    registry.subjects[target->getCode()] = target;
+  }
+
+  for (std::size_t i = 0; i < internshipCount(); ++i) {
+    auto internship = std::make_shared<Internship>(this->internship(i));
+    registry.internships[internship->id] = internship;
+  }
+
+  for (std::size_t i = 0; i < resumeCount(); ++i) {
+    auto resume = std::make_shared<Resume>(this->resume(i));
+    registry.resumes[resume->getId()] = resume;
+  }
+
+  registry.publish();
+}
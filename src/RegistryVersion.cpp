@@ -0,0 +1,21 @@
+#include "../include/RegistryVersion.h"
+#include "PerformanceVisitor.h"
+
+std::shared_ptr<const SubjectVersion>
+RegistryVersion::findSubject(std::string_view code) const {
+  return subjects.find(code);
+}
+
+std::shared_ptr<const Internship>
+RegistryVersion::findInternship(std::string_view id) const {
+  return internships.find(id);
+}
+
+std::shared_ptr<const Resume>
+RegistryVersion::findResume(std::string_view id) const {
+  return resumes.find(id);
+}
+
+double RegistryVersion::accept(PerformanceVisitor &visitor) const {
+  return visitor.visit(*this);
+}
@@ -0,0 +1,89 @@
+#include "../include/ReminderRule.h"
+#include "../include/IsoDate.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+std::chrono::hours offset(int days) { return std::chrono::hours(24 * days); }
+
+// The index takes half-open ranges; reminder windows are open at the start.
+constexpr DateTime::duration kTick(1);
+
+} // namespace
+
+ReminderRule::ReminderRule(const std::string &message, Registry &registry,
+                           const TaskFilter &filter,
+                           std::vector<int> daysBefore, const DateTime &since,
+                           DateTime::duration recheck)
+    : Notification(message, since, TaskId()), registry(registry),
+      filter(filter), daysBefore(std::move(daysBefore)), recheck(recheck),
+      covered(since) {
+  if (filter.subject) {
+    subjectCode = filter.subject->getCode();
+    this->filter.subject = nullptr;
+  }
+  setTriggerTime(nextCheck(since));
+}
+
+std::vector<DueNotification>
+ReminderRule::takeOccurrences(const DateTime &now) {
+  std::vector<DueNotification> due;
+  if (!(covered < now)) {
+    return due;
+  }
+  for (int days : daysBefore) {
+    registry.forEachOpenTaskDueBetween(
+        covered + offset(days) + kTick, now + offset(days) + kTick, filter,
+        subjectCode, SIZE_MAX, [&](const DueTask &task) {
+          due.push_back(DueNotification{
+              std::make_shared<DeadlineNotification>(getMessage(), *task.task,
+                                                     days),
+              task.deadline - offset(days)});
+        });
+  }
+  covered = now;
+  std::stable_sort(due.begin(), due.end(),
+                   [](const DueNotification &a, const DueNotification &b) {
+                     return a.due < b.due;
+                   });
+  return due;
+}
+
+std::optional<DateTime>
+ReminderRule::nextOccurrence(const DateTime &after) const {
+  std::optional<DateTime> next;
+  for (int days : daysBefore) {
+    registry.forEachOpenTaskDueBetween(
+        after + offset(days) + kTick, DateTime::max(), filter, subjectCode, 1,
+        [&](const DueTask &task) {
+          DateTime time = task.deadline - offset(days);
+          if (!next || time < *next) {
+            next = time;
+          }
+        });
+  }
+  return next;
+}
+
+DateTime ReminderRule::nextCheck(const DateTime &after) const {
+  DateTime latest = after + recheck;
+  std::optional<DateTime> next = nextOccurrence(after);
+  return next && *next < latest ? *next : latest;
+}
+
+bool ReminderRule::shouldTrigger(const DateTime &) const { return false; }
+
+void ReminderRule::display() const {
+  std::cout << "REMINDER RULE: " << getMessage() << std::endl;
+  std::cout << "Days before deadline:";
+  for (int days : daysBefore) {
+    std::cout << " " << days;
+  }
+  std::cout << std::endl;
+  std::cout << "Next check: " << iso_date::format(getTriggerTime())
+            << std::endl;
+}
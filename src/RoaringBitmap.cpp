@@ -0,0 +1,281 @@
+#include "../include/RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+unsigned RoaringBitmap::popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<unsigned>(__popcnt64(word));
+#else
+  unsigned count = 0;
+  for (; word; word &= word - 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+unsigned RoaringBitmap::lowestBit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, word);
+  return static_cast<unsigned>(index);
+#else
+  unsigned index = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+bool RoaringBitmap::Container::contains(std::uint16_t low) const {
+  if (isBitmap()) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+bool RoaringBitmap::Container::add(std::uint16_t low) {
+  if (isBitmap()) {
+    std::uint64_t mask = std::uint64_t(1) << (low & 63);
+    if (bits[low >> 6] & mask) {
+      return false;
+    }
+    bits[low >> 6] |= mask;
+    ++cardinality;
+    return true;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    return false;
+  }
+  array.insert(it, low);
+  ++cardinality;
+  if (cardinality > kArrayMax) {
+    toBitmap();
+  }
+  return true;
+}
+
+bool RoaringBitmap::Container::remove(std::uint16_t low) {
+  if (isBitmap()) {
+    std::uint64_t mask = std::uint64_t(1) << (low & 63);
+    if (!(bits[low >> 6] & mask)) {
+      return false;
+    }
+    bits[low >> 6] &= ~mask;
+    --cardinality;
+    if (cardinality <= kArrayMax / 2) {
+      toArray();
+    }
+    return true;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it == array.end() || *it != low) {
+    return false;
+  }
+  array.erase(it);
+  --cardinality;
+  return true;
+}
+
+void RoaringBitmap::Container::toBitmap() {
+  bits.assign(kBitmapWords, 0);
+  for (std::uint16_t low : array) {
+    bits[low >> 6] |= std::uint64_t(1) << (low & 63);
+  }
+  std::vector<std::uint16_t>().swap(array);
+}
+
+void RoaringBitmap::Container::toArray() {
+  array.clear();
+  array.reserve(cardinality);
+  for (std::size_t w = 0; w < kBitmapWords; ++w) {
+    for (std::uint64_t word = bits[w]; word; word &= word - 1) {
+      array.push_back(static_cast<std::uint16_t>(w * 64 + lowestBit(word)));
+    }
+  }
+  std::vector<std::uint64_t>().swap(bits);
+}
+
+std::vector<RoaringBitmap::Container>::iterator
+RoaringBitmap::findContainer(std::uint16_t key) {
+  return std::lower_bound(
+      containers_.begin(), containers_.end(), key,
+      [](const Container &c, std::uint16_t k) { return c.key < k; });
+}
+
+std::vector<RoaringBitmap::Container>::const_iterator
+RoaringBitmap::findContainer(std::uint16_t key) const {
+  return std::lower_bound(
+      containers_.begin(), containers_.end(), key,
+      [](const Container &c, std::uint16_t k) { return c.key < k; });
+}
+
+bool RoaringBitmap::add(std::uint32_t value) {
+  std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+  auto it = findContainer(key);
+  if (it == containers_.end() || it->key != key) {
+    it = containers_.insert(it, Container());
+    it->key = key;
+  }
+  return it->add(static_cast<std::uint16_t>(value));
+}
+
+bool RoaringBitmap::remove(std::uint32_t value) {
+  std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+  auto it = findContainer(key);
+  if (it == containers_.end() || it->key != key ||
+      !it->remove(static_cast<std::uint16_t>(value))) {
+    return false;
+  }
+  if (it->cardinality == 0) {
+    containers_.erase(it);
+  }
+  return true;
+}
+
+bool RoaringBitmap::contains(std::uint32_t value) const {
+  std::uint16_t key = static_cast<std::uint16_t>(value >> 16);
+  auto it = findContainer(key);
+  return it != containers_.end() && it->key == key &&
+         it->contains(static_cast<std::uint16_t>(value));
+}
+
+std::uint64_t RoaringBitmap::cardinality() const {
+  std::uint64_t total = 0;
+  for (const auto &container : containers_) {
+    total += container.cardinality;
+  }
+  return total;
+}
+
+std::size_t RoaringBitmap::memoryUsage() const {
+  std::size_t bytes = containers_.capacity() * sizeof(Container);
+  for (const auto &container : containers_) {
+    bytes += container.array.capacity() * sizeof(std::uint16_t) +
+             container.bits.capacity() * sizeof(std::uint64_t);
+  }
+  return bytes;
+}
+
+std::uint32_t RoaringBitmap::andCardinality(const Container &a,
+                                            const Container &b) {
+  if (a.isBitmap() && b.isBitmap()) {
+    std::uint32_t count = 0;
+    for (std::size_t w = 0; w < kBitmapWords; ++w) {
+      count += popcount(a.bits[w] & b.bits[w]);
+    }
+    return count;
+  }
+  if (a.isBitmap() || b.isBitmap()) {
+    const Container &sparse = a.isBitmap() ? b : a;
+    const Container &dense = a.isBitmap() ? a : b;
+    std::uint32_t count = 0;
+    for (std::uint16_t low : sparse.array) {
+      count += (dense.bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return count;
+  }
+
+  std::uint32_t count = 0;
+  auto i = a.array.begin();
+  auto j = b.array.begin();
+  while (i != a.array.end() && j != b.array.end()) {
+    if (*i < *j) {
+      ++i;
+    } else if (*j < *i) {
+      ++j;
+    } else {
+      ++count;
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container &a,
+                                                  const Container &b) {
+  Container result;
+  result.key = a.key;
+
+  if (a.isBitmap() && b.isBitmap()) {
+    result.bits.resize(kBitmapWords);
+    for (std::size_t w = 0; w < kBitmapWords; ++w) {
+      result.bits[w] = a.bits[w] & b.bits[w];
+      result.cardinality += popcount(result.bits[w]);
+    }
+    if (result.cardinality <= kArrayMax) {
+      result.toArray();
+    }
+    return result;
+  }
+
+  if (a.isBitmap() || b.isBitmap()) {
+    const Container &sparse = a.isBitmap() ? b : a;
+    const Container &dense = a.isBitmap() ? a : b;
+    for (std::uint16_t low : sparse.array) {
+      if ((dense.bits[low >> 6] >> (low & 63)) & 1) {
+        result.array.push_back(low);
+      }
+    }
+  } else {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                          b.array.end(), std::back_inserter(result.array));
+  }
+  result.cardinality = static_cast<std::uint32_t>(result.array.size());
+  return result;
+}
+
+std::uint64_t RoaringBitmap::andCardinality(const RoaringBitmap &a,
+                                            const RoaringBitmap &b) {
+  std::uint64_t count = 0;
+  auto i = a.containers_.begin();
+  auto j = b.containers_.begin();
+  while (i != a.containers_.end() && j != b.containers_.end()) {
+    if (i->key < j->key) {
+      ++i;
+    } else if (j->key < i->key) {
+      ++j;
+    } else {
+      count += andCardinality(*i, *j);
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+RoaringBitmap RoaringBitmap::intersect(const RoaringBitmap &a,
+                                       const RoaringBitmap &b) {
+  RoaringBitmap result;
+  auto i = a.containers_.begin();
+  auto j = b.containers_.begin();
+  while (i != a.containers_.end() && j != b.containers_.end()) {
+    if (i->key < j->key) {
+      ++i;
+    } else if (j->key < i->key) {
+      ++j;
+    } else {
+      Container container = intersect(*i, *j);
+      if (container.cardinality > 0) {
+        result.containers_.push_back(std::move(container));
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,53 @@
+#include "../include/StringPool.h"
+#include "../include/SymbolTable.h"
+#include <cstring>
+#include <new>
+
+std::size_t StringPool::Hash::operator()(std::string_view text) const {
+  return SymbolTable::hash(text);
+}
+
+StringPool::Header &StringPool::header(const char *stored) {
+  return *reinterpret_cast<Header *>(const_cast<char *>(stored) -
+                                     sizeof(Header));
+}
+
+StringPool::~StringPool() {
+  for (auto &entry : strings_) {
+    ::operator delete(entry.second - sizeof(Header));
+  }
+}
+
+const char *StringPool::acquire(std::string_view text) {
+  auto it = strings_.find(text);
+  if (it != strings_.end()) {
+    ++header(it->second).uses;
+    return it->second;
+  }
+
+  std::size_t needed = sizeof(Header) + text.size();
+  char *block = static_cast<char *>(::operator new(needed));
+  new (block) Header{1, static_cast<std::uint32_t>(text.size())};
+  char *stored = block + sizeof(Header);
+  std::memcpy(stored, text.data(), text.size());
+  strings_.emplace(std::string_view(stored, text.size()), stored);
+  bytes_ += needed;
+  return stored;
+}
+
+void StringPool::release(const char *stored) {
+  Header &h = header(stored);
+  if (--h.uses > 0) {
+    return;
+  }
+  strings_.erase(std::string_view(stored, h.size));
+  bytes_ -= sizeof(Header) + h.size;
+  ::operator delete(const_cast<char *>(stored) - sizeof(Header));
+}
+
+std::size_t StringPool::memoryUsage() const {
+  // Roughly one node and one bucket per string on top of the bytes.
+  return bytes_ + strings_.size() * (sizeof(std::string_view) +
+                                     sizeof(char *) + 2 * sizeof(void *)) +
+         strings_.bucket_count() * sizeof(void *);
+}
@@ -1,18 +1,70 @@
 #include "../include/Subject.h"
 #include "../include/Task.h"
+#include "../include/TaskListener.h"
 #include "PerformanceVisitor.h"
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <stdexcept>
 
+namespace {
+
+std::atomic<std::uint32_t> nextSubjectId{1};
+
+// Never destroyed, like TaskStore::global(): subjects owned by other statics
+// may be destroyed after it would be.
+SlotMap<Subject *, SubjectTag> &liveSubjects() {
+  static auto *subjects = new SlotMap<Subject *, SubjectTag>();
+  return *subjects;
+}
+
+} // namespace
+
 Subject::Subject(const std::string &name, const std::string &code,
                  const std::string &description)
-    : name(name), code(code), description(description) {}
+    : id(nextSubjectId.fetch_add(1, std::memory_order_relaxed)),
+      handle(liveSubjects().insert(this)), name(name), code(code),
+      description(description) {}
+
+Subject *Subject::resolve(SubjectId handle) {
+  Subject *const *subject = liveSubjects().get(handle);
+  return subject ? *subject : nullptr;
+}
+
+Subject::~Subject() {
+  // A listener may remove itself while being notified.
+  auto toNotify = listeners;
+  for (TaskListener *listener : toNotify) {
+    listener->onSubjectDestroyed(*this);
+  }
+  // From here on the tasks' handles to this subject resolve to nullptr.
+  liveSubjects().erase(handle);
+}
+
+void Subject::addListener(TaskListener *listener) {
+  if (std::find(listeners.begin(), listeners.end(), listener) ==
+      listeners.end()) {
+    listeners.push_back(listener);
+  }
+}
+
+void Subject::removeListener(TaskListener *listener) {
+  listeners.erase(std::remove(listeners.begin(), listeners.end(), listener),
+                  listeners.end());
+}
+
+const std::vector<TaskListener *> &Subject::getListeners() const {
+  return listeners;
+}
 
 std::string Subject::getName() const { return name; }
 std::string Subject::getCode() const { return code; }
 std::string Subject::getDescription() const { return description; }
-std::vector<std::shared_ptr<Task>> Subject::getTasks() const { return tasks; }
+std::vector<std::shared_ptr<Task>> Subject::getTasks() const {
+  compact();
+  return tasks;
+}
+std::size_t Subject::getTaskCount() const { return tasks.size() - tombstones; }
 
 void Subject::addTask(std::shared_ptr<Task> task) {
   if (!task) {
@@ -20,38 +72,91 @@ void Subject::addTask(std::shared_ptr<Task> task) {
     return;
   }
 
-  auto it = std::find_if(tasks.begin(), tasks.end(),
-                         [&](const std::shared_ptr<Task> &existingTask) {
-                           return existingTask &&
-                                  existingTask->getTitle() == task->getTitle();
-                         });
-
-  if (it == tasks.end()) {
-    tasks.push_back(task);
-    task->setSubject(
-        std::shared_ptr<Subject>(this, [](Subject *) { /* no-op deleter */ }));
+  tasks.push_back(task);
+  if (titleIndex.insert(tasks.size() - 1)) {
+    sequence.push_back(nextSequence++);
+    task->setSubject(this);
+    for (TaskListener *listener : listeners) {
+      listener->onTaskAdded(*task);
+    }
   } else {
+    tasks.pop_back();
     std::cout << "Task with title '" << task->getTitle()
               << "' already exists in subject '" << this->name << "'."
               << std::endl;
   }
 }
 
+void Subject::addTasks(const std::vector<std::shared_ptr<Task>> &batch) {
+  tasks.reserve(tasks.size() + batch.size());
+  sequence.reserve(tasks.size() + batch.size());
+  titleIndex.reserve(tasks.size() + batch.size());
+
+  for (const auto &task : batch) {
+    if (!task) {
+      std::cout << "Cannot add a null task." << std::endl;
+      continue;
+    }
+    tasks.push_back(task);
+    if (!titleIndex.insert(tasks.size() - 1)) {
+      tasks.pop_back();
+      std::cout << "Task with title '" << task->getTitle()
+                << "' already exists in subject '" << this->name << "'."
+                << std::endl;
+      continue;
+    }
+    sequence.push_back(nextSequence++);
+    task->setSubject(this);
+    for (TaskListener *listener : listeners) {
+      listener->onTaskAdded(*task);
+    }
+  }
+}
+
+std::shared_ptr<Subject> Subject::clone() const {
+  auto copy = std::make_shared<Subject>(name, code, description);
+  copy->tasks.reserve(tasks.size());
+  copy->sequence.reserve(tasks.size());
+  copy->titleIndex.reserve(tasks.size());
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    if (tasks[i]) {
+      auto taskCopy = tasks[i]->clone();
+      taskCopy->setSubject(copy.get());
+      copy->tasks.push_back(std::move(taskCopy));
+      copy->sequence.push_back(sequence[i]);
+      copy->titleIndex.insert(copy->tasks.size() - 1);
+    }
+  }
+  copy->nextSequence = nextSequence;
+  return copy;
+}
+
 double Subject::accept(PerformanceVisitor &visitor) {
   return visitor.visit(*this);
 }
 
-void Subject::removeTask(const std::string &title) {
-  auto it = std::find_if(tasks.begin(), tasks.end(),
-                         [&](const std::shared_ptr<Task> &task_ptr) {
-                           return task_ptr && task_ptr->getTitle() == title;
-                         });
+void Subject::removeTask(std::string_view title) {
+  std::size_t position = titleIndex.find(title);
 
-  if (it != tasks.end()) {
-    if ((*it)->getSubject().get() == this) {
-      (*it)->setSubject(nullptr);
+  if (position != TitleIndex::npos) {
+    // Held to the end: title may view this task's own title.
+    std::shared_ptr<Task> task = tasks[position];
+    for (TaskListener *listener : listeners) {
+      listener->onTaskRemoved(*task);
+    }
+    if (task->getSubject() == this) {
+      task->setSubject(nullptr);
+    }
+    titleIndex.unlink(position);
+    if (position + 1 == tasks.size()) {
+      tasks.pop_back();
+      sequence.pop_back();
+    } else {
+      tasks[position] = nullptr;
+      if (++tombstones * 2 > tasks.size()) {
+        compact();
+      }
     }
-    tasks.erase(it);
     std::cout << "Task with title '" << title << "' removed from subject '"
               << this->name << "'." << std::endl;
   } else {
@@ -60,13 +165,56 @@ void Subject::removeTask(const std::string &title) {
   }
 }
 
-std::shared_ptr<Task> Subject::findTask(const std::string &title) const {
-  auto it = std::find_if(tasks.begin(), tasks.end(),
-                         [&](const std::shared_ptr<Task> &task_ptr) {
-                           return task_ptr && task_ptr->getTitle() == title;
-                         });
+void Subject::compact() const {
+  if (tombstones == 0) {
+    return;
+  }
+  std::vector<std::uint32_t> to(tasks.size());
+  std::size_t live = 0;
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    if (tasks[i]) {
+      to[i] = static_cast<std::uint32_t>(live);
+      tasks[live] = std::move(tasks[i]);
+      sequence[live] = sequence[i];
+      ++live;
+    }
+  }
+  tasks.resize(live);
+  sequence.resize(live);
+  titleIndex.renumber(to);
+  tombstones = 0;
+}
+
+std::shared_ptr<Task> Subject::findTask(std::string_view title) const {
+  std::size_t position = titleIndex.find(title);
+  return position != TitleIndex::npos ? tasks[position] : nullptr;
+}
+
+void Subject::retitleTask(Task &task, const std::string &title) {
+  auto &store = TaskStore::global();
+  std::size_t position = titleIndex.find(store.title(task.getRow()));
+  if (position == TitleIndex::npos || tasks[position].get() != &task) {
+    // Not one of ours (e.g. a clone still pointing here): nothing to index.
+    store.setTitle(task.getRow(), title);
+    return;
+  }
 
-  return (it != tasks.end()) ? *it : nullptr;
+  std::size_t existing = titleIndex.find(title);
+  if (existing == position) {
+    return;
+  }
+  if (existing != TitleIndex::npos) {
+    std::cout << "Task with title '" << title << "' already exists in subject '"
+              << this->name << "'." << std::endl;
+    return;
+  }
+  std::string previous(store.title(task.getRow()));
+  titleIndex.unlink(position);
+  store.setTitle(task.getRow(), title);
+  titleIndex.insert(position);
+  for (TaskListener *listener : listeners) {
+    listener->onTitleChanged(task, previous);
+  }
 }
 
 void Subject::displayInfo() const {
@@ -76,8 +224,8 @@ void Subject::displayInfo() const {
     std::cout << "Description: " << description << std::endl;
   }
 
-  std::cout << "Tasks (" << tasks.size() << "):" << std::endl;
-  if (tasks.empty()) {
+  std::cout << "Tasks (" << getTaskCount() << "):" << std::endl;
+  if (getTaskCount() == 0) {
     std::cout << "  No tasks assigned to this subject." << std::endl;
   } else {
     for (const auto &task : tasks) {
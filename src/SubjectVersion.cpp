@@ -0,0 +1,177 @@
+#include "../include/SubjectVersion.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include <algorithm>
+
+namespace {
+
+std::shared_ptr<const SubjectVersion::FrozenTask>
+freezeTask(std::uint64_t sequence, const Task &task) {
+  return std::make_shared<const SubjectVersion::FrozenTask>(
+      SubjectVersion::FrozenTask{sequence, task.freeze(), task.getHandle()});
+}
+
+std::vector<const SubjectVersion::FrozenTask *>
+bySequence(const PersistentMap<SubjectVersion::FrozenTask> &tasks) {
+  std::vector<const SubjectVersion::FrozenTask *> frozen;
+  frozen.reserve(tasks.size());
+  for (const auto &entry : tasks) {
+    frozen.push_back(entry.second.get());
+  }
+  std::sort(frozen.begin(), frozen.end(),
+            [](const SubjectVersion::FrozenTask *a,
+               const SubjectVersion::FrozenTask *b) {
+              return a->sequence < b->sequence;
+            });
+  return frozen;
+}
+
+// Sets what differs between task and frozen, a copy of an earlier state of
+// the same task, through the task's setters.
+void restoreTask(Task &task, const Task &frozen) {
+  if (task.getDeadline() != frozen.getDeadline()) {
+    task.setDeadline(frozen.getDeadline());
+  }
+  if (task.getDescription() != frozen.getDescription()) {
+    task.setDescription(std::string(frozen.getDescription()));
+  }
+  // Built-in states are shared flyweights, so equal kinds compare equal.
+  auto state = frozen.getState();
+  if (task.getState() != state) {
+    task.setState(std::move(state));
+  }
+  if (task.getMarks() != frozen.getMarks()) {
+    task.setMarks(frozen.getMarks());
+  }
+}
+
+} // namespace
+
+SubjectVersion::SubjectVersion(std::string name, std::string code,
+                               std::string description,
+                               PersistentMap<FrozenTask> tasks)
+    : name(std::move(name)), code(std::move(code)),
+      description(std::move(description)), tasks(std::move(tasks)) {}
+
+std::shared_ptr<const SubjectVersion>
+SubjectVersion::freeze(const Subject &subject) {
+  PersistentMap<FrozenTask> tasks;
+  for (std::size_t i = 0; i < subject.tasks.size(); ++i) {
+    if (const auto &task = subject.tasks[i]) {
+      tasks.set(task->getTitle(), freezeTask(subject.sequence[i], *task));
+    }
+  }
+  return std::shared_ptr<const SubjectVersion>(
+      new SubjectVersion(subject.name, subject.code, subject.description,
+                         std::move(tasks)));
+}
+
+std::shared_ptr<const SubjectVersion>
+SubjectVersion::refreeze(const Subject &subject,
+                         const std::vector<std::string_view> &titles) const {
+  PersistentMap<FrozenTask> next = tasks;
+  for (std::string_view title : titles) {
+    std::size_t position = subject.titleIndex.find(title);
+    if (position == TitleIndex::npos) {
+      next.erase(title);
+    } else {
+      next.set(title,
+               freezeTask(subject.sequence[position], *subject.tasks[position]));
+    }
+  }
+  return std::shared_ptr<const SubjectVersion>(
+      new SubjectVersion(name, code, description, std::move(next)));
+}
+
+std::shared_ptr<const SubjectVersion>
+SubjectVersion::relink(const Subject &subject,
+                       const std::vector<std::string> &titles) const {
+  PersistentMap<FrozenTask> next = tasks;
+  for (const std::string &title : titles) {
+    auto entry = tasks.find(title);
+    auto task = subject.findTask(title);
+    if (entry && task) {
+      next.set(title, std::make_shared<const FrozenTask>(FrozenTask{
+                          entry->sequence, entry->task, task->getHandle()}));
+    }
+  }
+  return std::shared_ptr<const SubjectVersion>(
+      new SubjectVersion(name, code, description, std::move(next)));
+}
+
+std::shared_ptr<Subject> SubjectVersion::thaw() const {
+  auto live = std::make_shared<Subject>(name, code, description);
+  auto frozen = bySequence(tasks);
+
+  live->tasks.reserve(frozen.size());
+  live->sequence.reserve(frozen.size());
+  live->titleIndex.reserve(frozen.size());
+  for (const FrozenTask *entry : frozen) {
+    auto task = entry->task->clone();
+    task->setSubject(live.get());
+    live->tasks.push_back(std::move(task));
+    live->sequence.push_back(entry->sequence);
+    live->titleIndex.insert(live->tasks.size() - 1);
+  }
+  // Sequences carry on from the frozen ones, so the tasks this version
+  // shares with later ones keep their place among new tasks.
+  live->nextSequence = frozen.empty() ? 0 : frozen.back()->sequence + 1;
+  return live;
+}
+
+std::vector<std::string>
+SubjectVersion::restoreInto(Subject &live, const SubjectVersion &from) const {
+  std::vector<std::string> relinked;
+  PersistentMap<FrozenTask>::diff(
+      from.tasks, tasks,
+      [&live, &relinked](const std::string &title,
+                         const std::shared_ptr<const FrozenTask> &,
+                         const std::shared_ptr<const FrozenTask> &after) {
+        std::shared_ptr<Task> task = live.findTask(title);
+        if (task && after &&
+            task->getTaskType() == after->task->getTaskType()) {
+          restoreTask(*task, *after->task);
+        } else {
+          if (task) {
+            live.removeTask(title);
+          }
+          if (after) {
+            task = after->task->clone();
+            live.addTask(task);
+            // Back in the place it had in this version.
+            live.sequence.back() = after->sequence;
+            live.nextSequence =
+                std::max(live.nextSequence, after->sequence + 1);
+          }
+        }
+        // A copy taken before the task was last re-created names its old id.
+        if (after && task->getHandle() != after->live) {
+          relinked.push_back(title);
+        }
+      });
+  return relinked;
+}
+
+const std::vector<std::shared_ptr<const Task>> &
+SubjectVersion::inOrder() const {
+  // Readers on several threads may get here at once.
+  std::call_once(orderedOnce, [this] {
+    auto frozen = bySequence(tasks);
+    ordered.reserve(frozen.size());
+    for (const FrozenTask *entry : frozen) {
+      ordered.push_back(entry->task);
+    }
+  });
+  return ordered;
+}
+
+std::shared_ptr<const Task>
+SubjectVersion::findTask(std::string_view title) const {
+  auto entry = tasks.find(title);
+  return entry ? entry->task : nullptr;
+}
+
+TaskId SubjectVersion::findLiveId(std::string_view title) const {
+  auto entry = tasks.find(title);
+  return entry ? entry->live : TaskId{};
+}
@@ -0,0 +1,151 @@
+#include "../include/SymbolTable.h"
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t kInitialSlots = 16;
+constexpr std::size_t kArenaBlockSize = 16 * 1024;
+
+} // namespace
+
+std::uint32_t SymbolTable::hash(std::string_view text) {
+  std::uint64_t h = 0x9E3779B97F4A7C15ull ^ text.size();
+  const char *p = text.data();
+  std::size_t remaining = text.size();
+
+  while (remaining >= 8) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, p, 8);
+    h = (h ^ chunk) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+    p += 8;
+    remaining -= 8;
+  }
+
+  if (remaining > 0) {
+    std::uint64_t chunk = 0;
+    std::memcpy(&chunk, p, remaining);
+    h = (h ^ chunk) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+  }
+
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+// Keys are stored behind a 4-byte length prefix, so code holding only the
+// data pointer (see InternedMap) can compare against a key with one access.
+const char *SymbolTable::store(std::string_view text) {
+  std::uint32_t size = static_cast<std::uint32_t>(text.size());
+  std::size_t needed = sizeof(size) + text.size();
+
+  if (blocks_.empty() || blockUsed_ + needed > blockCapacity_) {
+    std::size_t capacity = needed > kArenaBlockSize ? needed : kArenaBlockSize;
+    blocks_.push_back(std::make_unique<char[]>(capacity));
+    blockUsed_ = 0;
+    blockCapacity_ = capacity;
+    arenaBytes_ += capacity;
+  }
+
+  char *dest = blocks_.back().get() + blockUsed_;
+  std::memcpy(dest, &size, sizeof(size));
+  std::memcpy(dest + sizeof(size), text.data(), text.size());
+  blockUsed_ += needed;
+  return dest + sizeof(size);
+}
+
+bool SymbolTable::equals(const char *stored, std::string_view text) {
+  std::uint32_t size;
+  std::memcpy(&size, stored - sizeof(size), sizeof(size));
+  return size == text.size() &&
+         std::memcmp(stored, text.data(), text.size()) == 0;
+}
+
+std::string_view SymbolTable::view(const char *stored) {
+  std::uint32_t size;
+  std::memcpy(&size, stored - sizeof(size), sizeof(size));
+  return std::string_view(stored, size);
+}
+
+void SymbolTable::rehash(std::size_t newCapacity) {
+  std::vector<Slot> fresh(newCapacity, Slot{0, kInvalidSymbol});
+  std::size_t mask = newCapacity - 1;
+
+  for (SymbolId id = 0; id < names_.size(); ++id) {
+    std::size_t index = hashes_[id] & mask;
+    while (fresh[index].id != kInvalidSymbol) {
+      index = (index + 1) & mask;
+    }
+    fresh[index] = Slot{hashes_[id], id};
+  }
+
+  slots_.swap(fresh);
+}
+
+SymbolId SymbolTable::find(std::string_view text) const {
+  if (slots_.empty()) {
+    return kInvalidSymbol;
+  }
+
+  std::uint32_t h = hash(text);
+  std::size_t mask = slots_.size() - 1;
+  std::size_t index = h & mask;
+
+  while (true) {
+    const Slot &slot = slots_[index];
+    if (slot.id == kInvalidSymbol) {
+      return kInvalidSymbol;
+    }
+    if (slot.hash == h && equals(names_[slot.id], text)) {
+      return slot.id;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
+SymbolId SymbolTable::intern(std::string_view text) {
+  return intern(text, hash(text));
+}
+
+SymbolId SymbolTable::intern(std::string_view text, std::uint32_t textHash) {
+  // Grow at a load factor of 3/4; linear probing stays short below that.
+  if ((names_.size() + 1) * 4 > slots_.size() * 3) {
+    rehash(slots_.empty() ? kInitialSlots : slots_.size() * 2);
+  }
+
+  std::uint32_t h = textHash;
+  std::size_t mask = slots_.size() - 1;
+  std::size_t index = h & mask;
+
+  while (slots_[index].id != kInvalidSymbol) {
+    const Slot &slot = slots_[index];
+    if (slot.hash == h && equals(names_[slot.id], text)) {
+      return slot.id;
+    }
+    index = (index + 1) & mask;
+  }
+
+  SymbolId id = static_cast<SymbolId>(names_.size());
+  names_.push_back(store(text));
+  hashes_.push_back(h);
+  slots_[index] = Slot{h, id};
+  return id;
+}
+
+std::string_view SymbolTable::name(SymbolId id) const {
+  if (id >= names_.size()) {
+    return {};
+  }
+  std::uint32_t size;
+  std::memcpy(&size, names_[id] - sizeof(size), sizeof(size));
+  return std::string_view(names_[id], size);
+}
+
+std::size_t SymbolTable::memoryUsage() const {
+  return names_.capacity() * sizeof(const char *) +
+         hashes_.capacity() * sizeof(std::uint32_t) +
+         slots_.capacity() * sizeof(Slot) +
+         blocks_.capacity() * sizeof(std::unique_ptr<char[]>) + arenaBytes_;
+}
@@ -1,104 +1,181 @@
 #include "../include/Task.h"
+#include "../include/IsoDate.h"
 #include "../include/Notification.h"
+#include "../include/ObjectPool.h"
 #include "../include/Subject.h"
+#include "../include/TaskListener.h"
 #include "../include/TaskState.h"
 #include <chrono>
-#include <ctime>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
 
-std::string formatDateTime(const DateTime &dt) {
-  auto time = std::chrono::system_clock::to_time_t(dt);
-  std::tm tm_local = {};
+Task::Task(TaskType type, const std::string &title, const DateTime &deadline,
+           const std::string &description)
+    : row_(TaskStore::global().allocate(title, description,
+                                        deadline.time_since_epoch().count(),
+                                        type)) {
+  // The new row starts out Pending.
+  TaskStore::global().setOwner(row_, this);
+}
 
-#ifdef _WIN32
-  localtime_s(&tm_local, &time);
-#else
-  tm_local = *std::localtime(&time);
-#endif
+Task::Task(const Task &other)
+    : row_(TaskStore::global().duplicate(other.row_)),
+      subject_(other.subject_) {
+  TaskStore::global().setOwner(row_, this);
+}
 
-  std::stringstream ss;
-  ss << std::put_time(&tm_local, "%Y-%m-%d %H:%M");
-  return ss.str();
+Task::~Task() {
+  if (!frozen_) {
+    NotificationManager::getInstance().forgetTask(getHandle());
+  }
+  TaskStore::global().release(row_);
 }
 
-Task::Task(const std::string &title, const DateTime &deadline,
-           const std::string &description)
-    : title_(title), description_(description), deadline_(deadline), marks_(0),
-      subject_(nullptr) {
-  setState(std::make_shared<PendingState>());
+void Task::setState(std::shared_ptr<TaskState> newState) {
+  if (!newState || newState->isBuiltin()) {
+    setStateKind(newState ? newState->getKind() : TaskStateKind::Pending);
+    return;
+  }
+  TaskStateKind kind = newState->getKind();
+  TaskStore::global().setCustomState(row_, std::move(newState));
+  TaskStore::global().setState(row_, kind);
+  if (Subject *subject = getSubject()) {
+    for (TaskListener *listener : subject->getListeners()) {
+      listener->onStateChanged(*this);
+    }
+  }
+}
+
+void Task::setStateKind(TaskStateKind kind) {
+  TaskStore::global().setCustomState(row_, nullptr);
+  TaskStore::global().setState(row_, kind);
+  if (Subject *subject = getSubject()) {
+    for (TaskListener *listener : subject->getListeners()) {
+      listener->onStateChanged(*this);
+    }
+  }
 }
 
-void Task::setState(std::shared_ptr<TaskState> newState) { state_ = newState; }
+std::shared_ptr<TaskState> Task::getState() const {
+  auto custom = customState();
+  return custom ? custom : TaskState::flyweight(getStateKind());
+}
 
-std::shared_ptr<TaskState> Task::getState() const { return state_; }
+void Task::apply(TaskEvent event) {
+  TaskStateKind from = getStateKind();
+  TaskTransition transition = taskTransition(from, event);
+  if (transition.to == from) {
+    return;
+  }
+  if (transition.hooks & kResetMarks) {
+    TaskStore::global().setMarks(row_, 0);
+  }
+  setStateKind(transition.to);
+}
 
-std::string Task::getTitle() const { return title_; }
-std::string Task::getDescription() const { return description_; }
-DateTime Task::getDeadline() const { return deadline_; }
-std::shared_ptr<Subject> Task::getSubject() const { return subject_; }
+std::string_view Task::getTitle() const {
+  return TaskStore::global().title(row_);
+}
+std::string_view Task::getDescription() const {
+  return TaskStore::global().description(row_);
+}
+DateTime Task::getDeadline() const {
+  return DateTime(DateTime::duration(TaskStore::global().deadline(row_)));
+}
+Subject *Task::getSubject() const { return Subject::resolve(subject_); }
 
 std::string Task::getStateName() const {
-  if (state_) {
-    return state_->getName();
-  }
-  return "None";
+  auto custom = customState();
+  return custom ? custom->getName() : taskStateName(getStateKind());
 }
 
 std::vector<std::shared_ptr<Notification>> Task::getNotifications() const {
-  return notifications_;
+  return NotificationManager::getInstance().getNotificationsForTask(
+      getHandle());
 }
 
-int Task::getMarks() const { return marks_; }
+TaskStateKind Task::getStateKind() const {
+  return TaskStore::global().state(row_);
+}
+
+int Task::getMarks() const { return TaskStore::global().marks(row_); }
 
-bool Task::isCompleted() const { return state_ ? state_->isFinished() : false; }
+bool Task::isCompleted() const {
+  return TaskStore::global().state(row_) == TaskStateKind::Completed;
+}
 
 float Task::getProgress() const {
-  return state_ ? state_->getConceptualProgress() : 0.0f;
+  auto custom = customState();
+  return custom ? custom->getConceptualProgress()
+                : taskStateProgress(getStateKind());
 }
 
-void Task::setTitle(const std::string &title) { this->title_ = title; }
+void Task::setTitle(const std::string &title) {
+  // Titles are unique within a subject and indexed there.
+  if (Subject *subject = getSubject()) {
+    subject->retitleTask(*this, title);
+  } else {
+    TaskStore::global().setTitle(row_, title);
+  }
+  NotificationManager::getInstance().refreshTask(*this);
+}
 
 void Task::setDescription(const std::string &description) {
-  this->description_ = description;
+  TaskStore::global().setDescription(row_, description);
+  if (Subject *subject = getSubject()) {
+    for (TaskListener *listener : subject->getListeners()) {
+      listener->onDescriptionChanged(*this);
+    }
+  }
+}
+void Task::setDeadline(const DateTime &deadline) {
+  DateTime previous = getDeadline();
+  TaskStore::global().setDeadline(row_, deadline.time_since_epoch().count());
+  if (Subject *subject = getSubject()) {
+    for (TaskListener *listener : subject->getListeners()) {
+      listener->onDeadlineChanged(*this, previous);
+    }
+  }
+  NotificationManager::getInstance().refreshTask(*this);
 }
-void Task::setDeadline(const DateTime &deadline) { this->deadline_ = deadline; }
 
-void Task::setSubject(std::shared_ptr<Subject> subject) {
-  this->subject_ = subject;
+void Task::setSubject(Subject *subject) {
+  subject_ = subject ? subject->getHandle() : SubjectId();
+  TaskStore::global().setSubject(row_, subject ? subject->getId()
+                                               : TaskStore::kNoSubject);
+  if (!frozen_) {
+    NotificationManager::getInstance().refreshTask(*this);
+  }
 }
 
 void Task::setMarks(int marks) {
-  if (isCompleted()) {
-    this->marks_ = marks;
-  } else {
-    this->marks_ = 0;
+  TaskStore::global().setMarks(row_, isCompleted() ? marks : 0);
+  if (Subject *subject = getSubject()) {
+    for (TaskListener *listener : subject->getListeners()) {
+      listener->onMarksChanged(*this);
+    }
   }
 }
 
 void Task::startTask() {
-  if (state_)
-    state_->start(*this);
+  if (auto custom = customState()) {
+    custom->start(*this);
+  } else {
+    apply(TaskEvent::Start);
+  }
 }
 void Task::completeTask() {
-  if (state_)
-    state_->complete(*this);
+  if (auto custom = customState()) {
+    custom->complete(*this);
+  } else {
+    apply(TaskEvent::Complete);
+  }
 }
 void Task::reopenTask() {
-  if (state_)
-    state_->reopen(*this);
-}
-
-void Task::addNotification(std::shared_ptr<Notification> notification) {
-  notifications_.push_back(notification);
-}
-
-void Task::removeNotification(size_t index) {
-  if (index < notifications_.size()) {
-    notifications_.erase(notifications_.begin() + index);
+  if (auto custom = customState()) {
+    custom->reopen(*this);
   } else {
-    std::cout << "Invalid notification index for removal." << std::endl;
+    apply(TaskEvent::Reopen);
   }
 }
 
@@ -109,7 +186,7 @@ void Task::displayInfo() const {
     std::cout << "Description: " << getDescription() << std::endl;
   }
 
-  std::cout << "Deadline: " << formatDateTime(getDeadline()) << std::endl;
+  std::cout << "Deadline: " << iso_date::format(getDeadline()) << std::endl;
 
   if (getSubject()) {
     std::cout << "Subject: " << getSubject()->getName() << " ("
@@ -139,30 +216,61 @@ void Task::displayInfo() const {
 
 LabTask::LabTask(const std::string &title, const DateTime &deadline,
                  const std::string &description)
-    : Task(title, deadline, description) {}
+    : Task(TaskType::Lab, title, deadline, description) {}
 
 ProjectTask::ProjectTask(const std::string &title, const DateTime &deadline,
                          const std::string &description)
-    : Task(title, deadline, description) {}
+    : Task(TaskType::Project, title, deadline, description) {}
 
 ExamTask::ExamTask(const std::string &title, const DateTime &deadline,
                    const std::string &description)
-    : Task(title, deadline, description) {}
+    : Task(TaskType::Exam, title, deadline, description) {}
+
+std::shared_ptr<Task> Task::clone() const {
+  auto result = copy();
+  result->setSubject(nullptr);
+  return result;
+}
+
+std::shared_ptr<const Task> Task::freeze() const {
+  auto result = copy();
+  result->frozen_ = true;
+  result->setSubject(nullptr);
+  return result;
+}
+
+std::shared_ptr<Task> LabTask::copy() const {
+  return std::allocate_shared<LabTask>(PoolAllocator<LabTask>(), *this);
+}
+
+std::shared_ptr<Task> ProjectTask::copy() const {
+  return std::allocate_shared<ProjectTask>(PoolAllocator<ProjectTask>(),
+                                           *this);
+}
+
+std::shared_ptr<Task> ExamTask::copy() const {
+  return std::allocate_shared<ExamTask>(PoolAllocator<ExamTask>(), *this);
+}
 
+// Tasks come from per-type pools: one block holds the object and its
+// control block, and a bulk load fills consecutive blocks.
 std::shared_ptr<Task> LabFactory::createTask(const std::string &title,
                                              const DateTime &deadline,
                                              const std::string &description) {
-  return std::make_shared<LabTask>(title, deadline, description);
+  return std::allocate_shared<LabTask>(PoolAllocator<LabTask>(), title,
+                                       deadline, description);
 }
 
 std::shared_ptr<Task>
 ProjectFactory::createTask(const std::string &title, const DateTime &deadline,
                            const std::string &description) {
-  return std::make_shared<ProjectTask>(title, deadline, description);
+  return std::allocate_shared<ProjectTask>(PoolAllocator<ProjectTask>(), title,
+                                           deadline, description);
 }
 
 std::shared_ptr<Task> ExamFactory::createTask(const std::string &title,
                                               const DateTime &deadline,
                                               const std::string &description) {
-  return std::make_shared<ExamTask>(title, deadline, description);
+  return std::allocate_shared<ExamTask>(PoolAllocator<ExamTask>(), title,
+                                        deadline, description);
 }
@@ -0,0 +1,230 @@
+#include "../include/TaskBitmapIndex.h"
+#include "../include/Subject.h"
+#include <algorithm>
+
+bool TaskFilter::matches(const Task &task) const {
+  return (!state || task.getStateKind() == *state) &&
+         (!type || task.getTaskType() == *type) &&
+         (!subject || task.getSubject() == subject);
+}
+
+TaskBitmapIndex::~TaskBitmapIndex() { clear(); }
+
+void TaskBitmapIndex::insert(Task &task, const Subject *subject) {
+  if (ids_.count(&task)) {
+    return;
+  }
+
+  std::uint32_t id;
+  if (!freeIds_.empty()) {
+    id = freeIds_.back();
+    freeIds_.pop_back();
+  } else {
+    id = static_cast<std::uint32_t>(tasks_.size());
+    tasks_.push_back(nullptr);
+    subjectOf_.push_back(nullptr);
+    stateOf_.push_back(TaskStateKind::Pending);
+  }
+
+  TaskStateKind state = task.getStateKind();
+  tasks_[id] = &task;
+  subjectOf_[id] = subject;
+  stateOf_[id] = state;
+  ids_.emplace(&task, id);
+
+  byState_[static_cast<std::size_t>(state)].add(id);
+  byType_[static_cast<std::size_t>(task.getTaskType())].add(id);
+  bySubject_[subject].add(id);
+}
+
+void TaskBitmapIndex::erase(std::uint32_t id) {
+  Task *task = tasks_[id];
+  byState_[static_cast<std::size_t>(stateOf_[id])].remove(id);
+  byType_[static_cast<std::size_t>(task->getTaskType())].remove(id);
+
+  auto subjectIt = bySubject_.find(subjectOf_[id]);
+  if (subjectIt != bySubject_.end()) {
+    subjectIt->second.remove(id);
+    if (subjectIt->second.empty()) {
+      bySubject_.erase(subjectIt);
+    }
+  }
+
+  ids_.erase(task);
+  tasks_[id] = nullptr;
+  subjectOf_[id] = nullptr;
+  freeIds_.push_back(id);
+}
+
+void TaskBitmapIndex::attach(Subject &subject) {
+  if (!attached_.insert(&subject).second) {
+    return;
+  }
+  subject.addListener(this);
+  subject.forEachTask([&](Task &task) { insert(task, &subject); });
+}
+
+void TaskBitmapIndex::detach(Subject &subject) {
+  if (attached_.erase(&subject) == 0) {
+    return;
+  }
+  onSubjectDestroyed(subject);
+  subject.removeListener(this);
+}
+
+void TaskBitmapIndex::clear() {
+  for (Subject *subject : attached_) {
+    subject->removeListener(this);
+  }
+  attached_.clear();
+  tasks_.clear();
+  subjectOf_.clear();
+  stateOf_.clear();
+  freeIds_.clear();
+  ids_.clear();
+  for (auto &bitmap : byState_) {
+    bitmap.clear();
+  }
+  for (auto &bitmap : byType_) {
+    bitmap.clear();
+  }
+  bySubject_.clear();
+}
+
+std::vector<const RoaringBitmap *>
+TaskBitmapIndex::bitmapsFor(const TaskFilter &filter,
+                            bool &matchesNothing) const {
+  std::vector<const RoaringBitmap *> bitmaps;
+  matchesNothing = false;
+
+  if (filter.state) {
+    bitmaps.push_back(&byState_[static_cast<std::size_t>(*filter.state)]);
+  }
+  if (filter.type) {
+    bitmaps.push_back(&byType_[static_cast<std::size_t>(*filter.type)]);
+  }
+  if (filter.subject) {
+    auto it = bySubject_.find(filter.subject);
+    if (it == bySubject_.end()) {
+      matchesNothing = true;
+      return {};
+    }
+    bitmaps.push_back(&it->second);
+  }
+
+  // Intersecting the smallest sets first keeps intermediate results small.
+  std::sort(bitmaps.begin(), bitmaps.end(),
+            [](const RoaringBitmap *a, const RoaringBitmap *b) {
+              return a->cardinality() < b->cardinality();
+            });
+  return bitmaps;
+}
+
+std::uint64_t TaskBitmapIndex::count(const TaskFilter &filter) const {
+  bool matchesNothing = false;
+  auto bitmaps = bitmapsFor(filter, matchesNothing);
+  if (matchesNothing) {
+    return 0;
+  }
+
+  switch (bitmaps.size()) {
+  case 0:
+    return ids_.size();
+  case 1:
+    return bitmaps[0]->cardinality();
+  case 2:
+    return RoaringBitmap::andCardinality(*bitmaps[0], *bitmaps[1]);
+  default:
+    return RoaringBitmap::andCardinality(
+        RoaringBitmap::intersect(*bitmaps[0], *bitmaps[1]), *bitmaps[2]);
+  }
+}
+
+std::vector<Task *> TaskBitmapIndex::select(const TaskFilter &filter) const {
+  std::vector<Task *> result;
+  bool matchesNothing = false;
+  auto bitmaps = bitmapsFor(filter, matchesNothing);
+  if (matchesNothing) {
+    return result;
+  }
+
+  if (bitmaps.empty()) {
+    for (Task *task : tasks_) {
+      if (task) {
+        result.push_back(task);
+      }
+    }
+    return result;
+  }
+
+  RoaringBitmap matches = *bitmaps[0];
+  for (std::size_t i = 1; i < bitmaps.size(); ++i) {
+    matches = RoaringBitmap::intersect(matches, *bitmaps[i]);
+  }
+  result.reserve(matches.cardinality());
+  matches.forEach([&](std::uint32_t id) { result.push_back(tasks_[id]); });
+  return result;
+}
+
+std::size_t TaskBitmapIndex::memoryUsage() const {
+  std::size_t bytes = 0;
+  for (const auto &bitmap : byState_) {
+    bytes += bitmap.memoryUsage();
+  }
+  for (const auto &bitmap : byType_) {
+    bytes += bitmap.memoryUsage();
+  }
+  for (const auto &[subject, bitmap] : bySubject_) {
+    bytes += bitmap.memoryUsage();
+  }
+  return bytes;
+}
+
+void TaskBitmapIndex::onTaskAdded(Task &task) {
+  insert(task, task.getSubject());
+}
+
+void TaskBitmapIndex::onTaskRemoved(Task &task) {
+  auto it = ids_.find(&task);
+  if (it != ids_.end()) {
+    erase(it->second);
+  }
+}
+
+void TaskBitmapIndex::onDeadlineChanged(Task &, const DateTime &) {}
+
+void TaskBitmapIndex::onStateChanged(Task &task) {
+  auto it = ids_.find(&task);
+  if (it == ids_.end()) {
+    return;
+  }
+
+  std::uint32_t id = it->second;
+  TaskStateKind state = task.getStateKind();
+  if (state != stateOf_[id]) {
+    byState_[static_cast<std::size_t>(stateOf_[id])].remove(id);
+    byState_[static_cast<std::size_t>(state)].add(id);
+    stateOf_[id] = state;
+  }
+}
+
+void TaskBitmapIndex::onMarksChanged(Task &) {}
+
+void TaskBitmapIndex::onDescriptionChanged(Task &) {}
+
+void TaskBitmapIndex::onTitleChanged(Task &, const std::string &) {}
+
+void TaskBitmapIndex::onSubjectDestroyed(Subject &subject) {
+  attached_.erase(&subject);
+  auto it = bySubject_.find(&subject);
+  if (it == bySubject_.end()) {
+    return;
+  }
+
+  std::vector<std::uint32_t> ids;
+  ids.reserve(it->second.cardinality());
+  it->second.forEach([&](std::uint32_t id) { ids.push_back(id); });
+  for (std::uint32_t id : ids) {
+    erase(id);
+  }
+}
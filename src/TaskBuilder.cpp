@@ -19,17 +19,20 @@ TaskBuilder &TaskBuilder::setDeadline(const DateTime &deadline) {
 }
 
 TaskBuilder &TaskBuilder::asLab() {
-  factory = std::make_shared<LabFactory>();
+  static LabFactory instance;
+  factory = &instance;
   return *this;
 }
 
 TaskBuilder &TaskBuilder::asProject() {
-  factory = std::make_shared<ProjectFactory>();
+  static ProjectFactory instance;
+  factory = &instance;
   return *this;
 }
 
 TaskBuilder &TaskBuilder::asExam() {
-  factory = std::make_shared<ExamFactory>();
+  static ExamFactory instance;
+  factory = &instance;
   return *this;
 }
 
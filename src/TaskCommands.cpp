@@ -5,59 +5,86 @@
 
 SetTaskStateCommand::SetTaskStateCommand(Task &task,
                                          std::shared_ptr<TaskState> targetState)
-    : task_(task), newState_(std::move(targetState)), previousState_(nullptr) {}
+    : task_(task.getHandle()),
+      target_(targetState ? targetState->getKind() : TaskStateKind::Pending),
+      previousState_(nullptr) {
+  if (targetState && !targetState->isBuiltin()) {
+    customTarget_ = std::move(targetState);
+  }
+}
 
-void SetTaskStateCommand::execute() {
-  previousState_ = task_.getState(); // Store the current state of the task
+SetTaskStateCommand::SetTaskStateCommand(Task &task, TaskStateKind target)
+    : task_(task.getHandle()), target_(target), previousState_(nullptr) {}
 
-  // Trigger the appropriate semantic action on the task based on the target
-  // state type This assumes newState_ is an instance representing the desired
-  // state, e.g., std::make_shared<InProgressState>()
-  if (dynamic_cast<PendingState *>(newState_.get())) {
-    // This case might be used by a "reset" or "revert to pending" action.
-    // If task is already Pending, its reopen/start might do nothing.
-    // If task is Completed/InProgress, its reopenTask should handle transition
-    // to Pending/InProgress
-    task_
-        .reopenTask(); // A general "reopen" could lead to Pending or InProgress
-                       // depending on the current state's reopen() logic.
-                       // If specifically targeting Pending, ensure reopen leads
-                       // there or use task.setState() directly. For simplicity,
-                       // we assume reopen might put it back to Pending if
-                       // appropriate. Or, if truly just setting state:
-                       // task_.setState(std::make_shared<PendingState>());
-    if (task_.getStateName() !=
-        "Pending") { // If reopen didn't make it pending, force it.
-      task_.setState(std::make_shared<PendingState>());
+void SetTaskStateCommand::transition(Task &task, TaskStateKind target) {
+  // Reach the target through the task's own events so their hooks (such as
+  // resetting marks on reopen) run, rather than overwriting the state.
+  switch (target) {
+  case TaskStateKind::Pending:
+    // Reopening a completed task only goes back to In Progress.
+    task.reopenTask();
+    if (task.getStateKind() != TaskStateKind::Pending) {
+      task.setStateKind(TaskStateKind::Pending);
     }
+    break;
+  case TaskStateKind::InProgress:
+    task.startTask();
+    break;
+  case TaskStateKind::Completed:
+    task.completeTask();
+    break;
+  }
+}
 
-  } else if (dynamic_cast<InProgressState *>(newState_.get())) {
-    task_.startTask(); // This method on Task should transition its state to
-                       // InProgressState
-  } else if (dynamic_cast<CompletedState *>(newState_.get())) {
-    task_.completeTask(); // This method on Task should transition its state to
-                          // CompletedState
-  } else {
-    // Fallback for any other state types you might add, or if newState_ is just
-    // a generic state. This is less likely if you always pass concrete target
-    // states.
-    task_.setState(newState_);
-    std::cout << "Warning: SetTaskStateCommand executed with an unhandled "
-                 "target state type, direct setState applied."
+void SetTaskStateCommand::run(Task &task, TaskStateKind target) {
+  std::string previous = task.getStateName();
+  transition(task, target);
+  std::cout << "Command Executed: Task '" << task.getTitle()
+            << "' state changed from '" << previous << "' to '"
+            << task.getStateName() << "'." << std::endl;
+}
+
+void SetTaskStateCommand::revert(Task &task, TaskStateKind previous) {
+  task.setStateKind(previous);
+  std::cout << "Command Undone: Task '" << task.getTitle()
+            << "' state reverted to '" << task.getStateName() << "'."
+            << std::endl;
+}
+
+void SetTaskStateCommand::execute() {
+  Task *task = Task::resolve(task_);
+  if (!task) {
+    std::cout << "Cannot execute SetTaskStateCommand: the task no longer "
+                 "exists."
               << std::endl;
+    return;
   }
+  previousState_ = task->getState(); // Store the current state of the task
 
-  std::cout << "Command Executed: Task '" << task_.getTitle()
-            << "' state changed from '"
-            << (previousState_ ? previousState_->getName() : "null") << "' to '"
-            << task_.getStateName() << "'." << std::endl;
+  if (!customTarget_) {
+    run(*task, target_);
+    return;
+  }
+  task->setState(customTarget_);
+  std::cout << "Warning: SetTaskStateCommand executed with an unhandled "
+               "target state type, direct setState applied."
+            << std::endl;
+  std::cout << "Command Executed: Task '" << task->getTitle()
+            << "' state changed from '" << previousState_->getName()
+            << "' to '" << task->getStateName() << "'." << std::endl;
 }
 
 void SetTaskStateCommand::undo() {
+  Task *task = Task::resolve(task_);
+  if (!task) {
+    std::cout << "Cannot undo SetTaskStateCommand: the task no longer exists."
+              << std::endl;
+    return;
+  }
   if (previousState_) {
-    task_.setState(previousState_); // Restore the previous state object
-    std::cout << "Command Undone: Task '" << task_.getTitle()
-              << "' state reverted to '" << task_.getStateName() << "'."
+    task->setState(previousState_); // Restore the previous state object
+    std::cout << "Command Undone: Task '" << task->getTitle()
+              << "' state reverted to '" << task->getStateName() << "'."
               << std::endl;
   } else {
     std::cout
@@ -65,3 +92,11 @@ void SetTaskStateCommand::undo() {
         << std::endl;
   }
 }
+
+bool SetTaskStateCommand::compact(CommandRecord &record) const {
+  if (customTarget_ || !previousState_ || !previousState_->isBuiltin()) {
+    return false;
+  }
+  record = {task_, previousState_->getKind(), target_};
+  return true;
+}
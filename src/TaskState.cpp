@@ -2,29 +2,16 @@
 #include "../include/Task.h"
 #include <iostream>
 
-void TaskState::start(Task &task) {}
-void TaskState::complete(Task &task) {}
-void TaskState::reopen(Task &task) {}
+void TaskState::start(Task &task) { task.apply(TaskEvent::Start); }
+void TaskState::complete(Task &task) { task.apply(TaskEvent::Complete); }
+void TaskState::reopen(Task &task) { task.apply(TaskEvent::Reopen); }
 bool TaskState::isFinished() const { return false; }
 
-void PendingState::start(Task &task) {
-  task.setState(std::make_shared<InProgressState>());
-}
-void PendingState::complete(Task &task) {
-  task.setState(std::make_shared<CompletedState>());
-}
-
-void InProgressState::complete(Task &task) {
-  task.setState(std::make_shared<CompletedState>());
-}
-void InProgressState::reopen(Task &task) {
-  task.setState(std::make_shared<PendingState>());
-  task.setMarks(0);
-}
-
-void CompletedState::reopen(Task &task) {
-  task.setMarks(0);
-  task.setState(std::make_shared<InProgressState>());
+const std::shared_ptr<TaskState> &TaskState::flyweight(TaskStateKind kind) {
+  static const std::shared_ptr<TaskState> states[] = {
+      std::make_shared<PendingState>(), std::make_shared<InProgressState>(),
+      std::make_shared<CompletedState>()};
+  return states[static_cast<std::size_t>(kind)];
 }
 
 bool CompletedState::isFinished() const { return true; }
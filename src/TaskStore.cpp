@@ -0,0 +1,206 @@
+#include "../include/TaskStore.h"
+#include "../include/Task.h"
+#include "../include/TaskState.h"
+#include <stdexcept>
+
+TaskStore::TaskStore()
+    : segments_(std::make_unique<std::unique_ptr<Segment>[]>(kMaxSegments)) {}
+
+TaskStore::~TaskStore() = default;
+
+TaskStore &TaskStore::global() {
+  static TaskStore *store = new TaskStore();
+  return *store;
+}
+
+void TaskStore::replaceString(const char *&slot, std::string_view text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Acquired first: text may view the bytes being released.
+  const char *previous = slot;
+  slot = strings_.acquire(text);
+  strings_.release(previous);
+}
+
+TaskStore::Row TaskStore::allocate(std::string_view title,
+                                   std::string_view description,
+                                   std::int64_t deadline, TaskType type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Row row;
+  if (!freeRows_.empty()) {
+    row = freeRows_.back();
+    freeRows_.pop_back();
+  } else {
+    row = rows_.load(std::memory_order_relaxed);
+    std::size_t index = row / kSegmentRows;
+    if (index >= kMaxSegments) {
+      throw std::length_error("TaskStore: too many tasks");
+    }
+    if (!segments_[index]) {
+      segments_[index] = std::make_unique<Segment>();
+    }
+  }
+
+  Segment &seg = segment(row);
+  std::size_t i = row % kSegmentRows;
+  seg.deadline[i] = deadline;
+  seg.marks[i] = 0;
+  seg.subject[i] = kNoSubject;
+  seg.state[i] = TaskStateKind::Pending;
+  seg.type[i] = type;
+  seg.live[i] = 1;
+  seg.custom[i] = 0;
+  ++seg.generation[i];
+  seg.owner[i] = nullptr;
+  seg.title[i] = strings_.acquire(title);
+  seg.description[i] = strings_.acquire(description);
+  ++liveRows_;
+
+  // Published last so scans never see a row before its columns.
+  if (row == rows_.load(std::memory_order_relaxed)) {
+    rows_.store(row + 1, std::memory_order_release);
+  }
+  return row;
+}
+
+TaskStore::Row TaskStore::duplicate(Row source) {
+  Row row = allocate(title(source), description(source), deadline(source),
+                     type(source));
+  Segment &seg = segment(row);
+  std::size_t i = row % kSegmentRows;
+  seg.marks[i] = marks(source);
+  seg.subject[i] = subject(source);
+  seg.state[i] = state(source);
+  if (auto custom = customState(source)) {
+    setCustomState(row, std::move(custom));
+  }
+  return row;
+}
+
+void TaskStore::release(Row row) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Segment &seg = segment(row);
+  std::size_t i = row % kSegmentRows;
+  seg.live[i] = 0;
+  ++seg.generation[i];
+  seg.owner[i] = nullptr;
+  seg.subject[i] = kNoSubject;
+  strings_.release(seg.title[i]);
+  strings_.release(seg.description[i]);
+  seg.title[i] = nullptr;
+  seg.description[i] = nullptr;
+  if (seg.custom[i]) {
+    seg.custom[i] = 0;
+    customStates_.erase(row);
+  }
+  freeRows_.push_back(row);
+  --liveRows_;
+}
+
+namespace {
+
+void accumulate(TaskStats &stats, TaskStateKind state, TaskType type,
+                std::int32_t marks) {
+  ++stats.total;
+  ++stats.byState[static_cast<std::size_t>(state)];
+  ++stats.byType[static_cast<std::size_t>(type)];
+  if (state == TaskStateKind::Completed) {
+    stats.completedMarks += marks;
+  }
+}
+
+} // namespace
+
+TaskStats TaskStore::stats(std::uint32_t subjectId) const {
+  TaskStats stats;
+  forEachSegment([&](const Segment &seg, std::size_t rows) {
+    for (std::size_t i = 0; i < rows; ++i) {
+      // Released rows have kNoSubject, so live[] need not be checked.
+      if (seg.subject[i] == subjectId) {
+        accumulate(stats, seg.state[i], seg.type[i], seg.marks[i]);
+      }
+    }
+  });
+  return stats;
+}
+
+template <typename Span>
+TaskStats TaskStore::statsOf(Span tasks) const {
+  TaskStats stats;
+  for (const auto &task : tasks) {
+    if (task) {
+      Row row = task->getRow();
+      const Segment &seg = segment(row);
+      std::size_t i = row % kSegmentRows;
+      accumulate(stats, seg.state[i], seg.type[i], seg.marks[i]);
+    }
+  }
+  return stats;
+}
+
+TaskStats TaskStore::stats(TaskSpan tasks) const { return statsOf(tasks); }
+
+TaskStats TaskStore::stats(ConstTaskSpan tasks) const {
+  return statsOf(tasks);
+}
+
+std::unordered_map<std::uint32_t, TaskStats>
+TaskStore::statsBySubject() const {
+  std::unordered_map<std::uint32_t, TaskStats> result;
+  // A subject's tasks are mostly created together, so consecutive rows
+  // usually share a subject and the hash lookup is skipped.
+  std::uint32_t lastSubject = kNoSubject;
+  TaskStats *last = nullptr;
+  forEachSegment([&](const Segment &seg, std::size_t rows) {
+    for (std::size_t i = 0; i < rows; ++i) {
+      std::uint32_t subject = seg.subject[i];
+      if (subject == kNoSubject) {
+        continue;
+      }
+      if (subject != lastSubject) {
+        lastSubject = subject;
+        last = &result[subject];
+      }
+      accumulate(*last, seg.state[i], seg.type[i], seg.marks[i]);
+    }
+  });
+  return result;
+}
+
+std::shared_ptr<TaskState> TaskStore::customState(Row row) {
+  if (!segment(row).custom[row % kSegmentRows]) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = customStates_.find(row);
+  return it != customStates_.end() ? it->second : nullptr;
+}
+
+void TaskStore::setCustomState(Row row, std::shared_ptr<TaskState> state) {
+  std::uint8_t &custom = segment(row).custom[row % kSegmentRows];
+  if (!state && !custom) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (state) {
+    customStates_[row] = std::move(state);
+    custom = 1;
+  } else {
+    customStates_.erase(row);
+    custom = 0;
+  }
+}
+
+std::size_t TaskStore::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return liveRows_;
+}
+
+std::size_t TaskStore::arenaBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return strings_.memoryUsage();
+}
+
+std::size_t TaskStore::internedStrings() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return strings_.size();
+}
@@ -0,0 +1,102 @@
+#include "../include/TimerQueue.h"
+
+void HeapTimerQueue::place(std::size_t position, const Timer &timer) {
+  heap_[position] = timer;
+  position_[timer.id.index] = static_cast<std::uint32_t>(position);
+}
+
+void HeapTimerQueue::siftUp(std::size_t position) {
+  Timer moving = heap_[position];
+  while (position > 0) {
+    std::size_t parent = (position - 1) / 2;
+    if (!(moving.time < heap_[parent].time)) {
+      break;
+    }
+    place(position, heap_[parent]);
+    position = parent;
+  }
+  place(position, moving);
+}
+
+void HeapTimerQueue::siftDown(std::size_t position) {
+  Timer moving = heap_[position];
+  for (;;) {
+    std::size_t child = 2 * position + 1;
+    if (child >= heap_.size()) {
+      break;
+    }
+    if (child + 1 < heap_.size() &&
+        heap_[child + 1].time < heap_[child].time) {
+      ++child;
+    }
+    if (!(heap_[child].time < moving.time)) {
+      break;
+    }
+    place(position, heap_[child]);
+    position = child;
+  }
+  place(position, moving);
+}
+
+void HeapTimerQueue::removeAt(std::size_t position) {
+  position_[heap_[position].id.index] = kNotArmed;
+  Timer last = heap_.back();
+  heap_.pop_back();
+  if (position == heap_.size()) {
+    return;
+  }
+  place(position, last);
+  if (position > 0 && last.time < heap_[(position - 1) / 2].time) {
+    siftUp(position);
+  } else {
+    siftDown(position);
+  }
+}
+
+bool HeapTimerQueue::schedule(NotificationId id, const DateTime &time) {
+  if (id.index >= position_.size()) {
+    position_.resize(id.index + 1, kNotArmed);
+  }
+  std::uint32_t position = position_[id.index];
+  if (position == kNotArmed) {
+    heap_.push_back(Timer{time, id});
+    position_[id.index] = static_cast<std::uint32_t>(heap_.size() - 1);
+    siftUp(heap_.size() - 1);
+  } else {
+    bool earlier = time < heap_[position].time;
+    heap_[position] = Timer{time, id};
+    if (earlier) {
+      siftUp(position);
+    } else {
+      siftDown(position);
+    }
+  }
+  return position_[id.index] == 0;
+}
+
+bool HeapTimerQueue::unschedule(NotificationId id) {
+  if (!contains(id)) {
+    return false;
+  }
+  removeAt(position_[id.index]);
+  return true;
+}
+
+bool HeapTimerQueue::contains(NotificationId id) const {
+  return id.index < position_.size() && position_[id.index] != kNotArmed &&
+         heap_[position_[id.index]].id == id;
+}
+
+void HeapTimerQueue::popDue(const DateTime &now, std::vector<Timer> &due) {
+  while (!heap_.empty() && !(now < heap_.front().time)) {
+    due.push_back(heap_.front());
+    removeAt(0);
+  }
+}
+
+std::optional<TimerQueue::Timer> HeapTimerQueue::peek() const {
+  if (heap_.empty()) {
+    return std::nullopt;
+  }
+  return heap_.front();
+}
@@ -0,0 +1,247 @@
+#include "../include/TimingWheel.h"
+#include "../include/RoaringBitmap.h"
+#include <algorithm>
+
+namespace {
+
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+  return value / divisor - (value % divisor < 0);
+}
+
+std::int64_t floorMod(std::int64_t value, std::int64_t divisor) {
+  return value - floorDiv(value, divisor) * divisor;
+}
+
+} // namespace
+
+TimingWheel::TimingWheel(const DateTime &start) : tick_(tickOf(start)) {
+  heads_.fill(kNil);
+  earliest_.fill(kNil);
+}
+
+std::int64_t TimingWheel::tickOf(const DateTime &time) {
+  return std::chrono::floor<std::chrono::minutes>(time.time_since_epoch())
+      .count();
+}
+
+void TimingWheel::link(std::uint32_t index, std::uint16_t slot) {
+  Node &node = nodes_[index];
+  std::uint32_t &earliest = earliest_[slot];
+  if (heads_[slot] == kNil ||
+      (earliest != kNil && node.time < nodes_[earliest].time)) {
+    earliest = index;
+  }
+  node.slot = slot;
+  node.prev = kNil;
+  node.next = heads_[slot];
+  if (node.next != kNil) {
+    nodes_[node.next].prev = index;
+  }
+  heads_[slot] = index;
+  occupied_[slot / 64] |= std::uint64_t(1) << (slot % 64);
+}
+
+void TimingWheel::unlink(std::uint32_t index) {
+  Node &node = nodes_[index];
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    heads_[node.slot] = node.next;
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  if (heads_[node.slot] == kNil) {
+    occupied_[node.slot / 64] &= ~(std::uint64_t(1) << (node.slot % 64));
+  }
+  if (earliest_[node.slot] == index) {
+    earliest_[node.slot] = kNil;
+  }
+  node.slot = kNotArmed;
+}
+
+void TimingWheel::place(std::uint32_t index) {
+  std::int64_t tick = tickOf(nodes_[index].time);
+  std::uint16_t slot;
+  if (tick <= tick_) {
+    // Due already: the current minute slot is checked on every poll.
+    slot = static_cast<std::uint16_t>(floorMod(tick_, kMinutesPerHour));
+  } else if (floorDiv(tick, kMinutesPerHour) ==
+             floorDiv(tick_, kMinutesPerHour)) {
+    slot = static_cast<std::uint16_t>(floorMod(tick, kMinutesPerHour));
+  } else if (floorDiv(tick, kMinutesPerDay) ==
+             floorDiv(tick_, kMinutesPerDay)) {
+    slot = static_cast<std::uint16_t>(
+        kHourSlots + floorMod(floorDiv(tick, kMinutesPerHour), 24));
+  } else if (floorDiv(tick, kMinutesPerRun) ==
+             floorDiv(tick_, kMinutesPerRun)) {
+    slot = static_cast<std::uint16_t>(
+        kDaySlots + floorMod(floorDiv(tick, kMinutesPerDay), kDaysPerRun));
+  } else {
+    slot = kOverflow;
+  }
+  link(index, slot);
+}
+
+void TimingWheel::spread(std::uint16_t slot) {
+  std::uint32_t index = heads_[slot];
+  heads_[slot] = kNil;
+  earliest_[slot] = kNil;
+  occupied_[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+  while (index != kNil) {
+    std::uint32_t next = nodes_[index].next;
+    place(index);
+    index = next;
+  }
+}
+
+std::uint32_t TimingWheel::earliestIn(std::uint16_t slot) const {
+  std::uint32_t &best = earliest_[slot];
+  if (best == kNil) {
+    best = heads_[slot];
+    for (std::uint32_t index = nodes_[best].next; index != kNil;
+         index = nodes_[index].next) {
+      if (nodes_[index].time < nodes_[best].time) {
+        best = index;
+      }
+    }
+  }
+  return best;
+}
+
+std::uint16_t TimingWheel::firstOccupied(std::uint16_t from) const {
+  for (std::size_t word = from / 64; word < occupied_.size(); ++word) {
+    std::uint64_t bits = occupied_[word];
+    if (word == from / 64u) {
+      bits &= ~std::uint64_t(0) << (from % 64);
+    }
+    if (bits) {
+      return static_cast<std::uint16_t>(word * 64 +
+                                        RoaringBitmap::lowestBit(bits));
+    }
+  }
+  return kSlots;
+}
+
+std::optional<std::int64_t> TimingWheel::nextStop() const {
+  std::uint16_t slot = firstOccupied(
+      static_cast<std::uint16_t>(floorMod(tick_, kMinutesPerHour) + 1));
+  if (slot < kHourSlots) {
+    return floorDiv(tick_, kMinutesPerHour) * kMinutesPerHour + slot;
+  }
+  if (slot < kDaySlots) {
+    return floorDiv(tick_, kMinutesPerDay) * kMinutesPerDay +
+           (slot - kHourSlots) * kMinutesPerHour;
+  }
+  if (slot < kOverflow) {
+    return floorDiv(tick_, kMinutesPerRun) * kMinutesPerRun +
+           (slot - kDaySlots) * kMinutesPerDay;
+  }
+  if (slot == kOverflow) {
+    // Straight to the run holding the earliest of them.
+    std::int64_t earliest = tickOf(nodes_[earliestIn(kOverflow)].time);
+    return floorDiv(earliest, kMinutesPerRun) * kMinutesPerRun;
+  }
+  return std::nullopt;
+}
+
+void TimingWheel::moveTo(std::int64_t tick) {
+  std::int64_t previous = tick_;
+  tick_ = tick;
+  // Coarsest first: each spread may feed the finer wheels below it. The
+  // slots passed over on the way were empty, or tick would have stopped
+  // at them.
+  if (floorDiv(tick, kMinutesPerRun) != floorDiv(previous, kMinutesPerRun)) {
+    spread(kOverflow);
+  }
+  if (floorDiv(tick, kMinutesPerDay) != floorDiv(previous, kMinutesPerDay)) {
+    spread(static_cast<std::uint16_t>(
+        kDaySlots + floorMod(floorDiv(tick, kMinutesPerDay), kDaysPerRun)));
+  }
+  if (floorDiv(tick, kMinutesPerHour) != floorDiv(previous, kMinutesPerHour)) {
+    spread(static_cast<std::uint16_t>(
+        kHourSlots + floorMod(floorDiv(tick, kMinutesPerHour), 24)));
+  }
+}
+
+void TimingWheel::collect(const DateTime &now, std::vector<Timer> &due) {
+  std::size_t first = due.size();
+  std::uint16_t slot =
+      static_cast<std::uint16_t>(floorMod(tick_, kMinutesPerHour));
+  std::uint32_t index = heads_[slot];
+  if (tick_ < tickOf(now)) {
+    // The minute is over: take the whole list without relinking.
+    heads_[slot] = kNil;
+    earliest_[slot] = kNil;
+    occupied_[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+    for (; index != kNil; index = nodes_[index].next) {
+      Node &node = nodes_[index];
+      node.slot = kNotArmed;
+      due.push_back(Timer{node.time, NotificationId{index, node.generation}});
+      --size_;
+    }
+    index = kNil;
+  }
+  while (index != kNil) {
+    std::uint32_t next = nodes_[index].next;
+    const Node &node = nodes_[index];
+    if (!(now < node.time)) {
+      due.push_back(Timer{node.time, NotificationId{index, node.generation}});
+      unlink(index);
+      --size_;
+    }
+    index = next;
+  }
+  std::sort(due.begin() + first, due.end(),
+            [](const Timer &a, const Timer &b) { return a.time < b.time; });
+}
+
+bool TimingWheel::schedule(NotificationId id, const DateTime &time) {
+  if (id.index >= nodes_.size()) {
+    nodes_.resize(id.index + 1);
+  }
+  Node &node = nodes_[id.index];
+  if (node.slot != kNotArmed) {
+    unlink(id.index);
+  } else {
+    ++size_;
+  }
+  node.time = time;
+  node.generation = id.generation;
+  place(id.index);
+  return firstOccupied(0) == node.slot;
+}
+
+bool TimingWheel::unschedule(NotificationId id) {
+  if (!contains(id)) {
+    return false;
+  }
+  unlink(id.index);
+  --size_;
+  return true;
+}
+
+bool TimingWheel::contains(NotificationId id) const {
+  return id.index < nodes_.size() && nodes_[id.index].slot != kNotArmed &&
+         nodes_[id.index].generation == id.generation;
+}
+
+void TimingWheel::popDue(const DateTime &now, std::vector<Timer> &due) {
+  std::int64_t target = tickOf(now);
+  collect(now, due);
+  while (tick_ < target) {
+    std::optional<std::int64_t> stop = nextStop();
+    moveTo(stop && *stop < target ? *stop : target);
+    collect(now, due);
+  }
+}
+
+std::optional<TimerQueue::Timer> TimingWheel::peek() const {
+  std::uint16_t slot = firstOccupied(0);
+  if (slot == kSlots) {
+    return std::nullopt;
+  }
+  std::uint32_t best = earliestIn(slot);
+  return Timer{nodes_[best].time,
+               NotificationId{best, nodes_[best].generation}};
+}
@@ -0,0 +1,125 @@
+#include "../include/TitleIndex.h"
+#include "../include/Task.h"
+#include "../include/TaskStore.h"
+#include <functional>
+
+namespace {
+
+constexpr std::size_t kMinSlots = 8;
+
+std::uint32_t hashTitle(std::string_view title) {
+  return static_cast<std::uint32_t>(std::hash<std::string_view>()(title));
+}
+
+} // namespace
+
+TitleIndex::TitleIndex(const std::vector<std::shared_ptr<Task>> &tasks)
+    : tasks_(tasks) {}
+
+void TitleIndex::reserve(std::size_t count) {
+  // Kept at most half full so probe runs stay short.
+  std::size_t wanted = kMinSlots;
+  while (wanted < count * 2) {
+    wanted *= 2;
+  }
+  if (wanted <= slots_.size()) {
+    return;
+  }
+  std::vector<Slot> old(wanted, Slot{0, kEmpty});
+  old.swap(slots_);
+  for (const Slot &slot : old) {
+    if (slot.position != kEmpty) {
+      std::size_t i = slot.hash & mask();
+      while (slots_[i].position != kEmpty) {
+        i = (i + 1) & mask();
+      }
+      slots_[i] = slot;
+    }
+  }
+}
+
+bool TitleIndex::insert(std::size_t position) {
+  if ((size_ + 1) * 2 > slots_.size()) {
+    reserve(size_ + 1);
+  }
+  auto &store = TaskStore::global();
+  std::string_view title = store.title(tasks_[position]->getRow());
+  std::uint32_t hash = hashTitle(title);
+  std::size_t i = hash & mask();
+  for (; slots_[i].position != kEmpty; i = (i + 1) & mask()) {
+    if (slots_[i].hash == hash &&
+        store.title(tasks_[slots_[i].position]->getRow()) == title) {
+      return false;
+    }
+  }
+  slots_[i] = Slot{hash, static_cast<std::uint32_t>(position)};
+  ++size_;
+  return true;
+}
+
+std::size_t TitleIndex::find(std::string_view title) const {
+  if (size_ == 0) {
+    return npos;
+  }
+  auto &store = TaskStore::global();
+  std::uint32_t hash = hashTitle(title);
+  for (std::size_t i = hash & mask(); slots_[i].position != kEmpty;
+       i = (i + 1) & mask()) {
+    if (slots_[i].hash == hash &&
+        store.title(tasks_[slots_[i].position]->getRow()) == title) {
+      return slots_[i].position;
+    }
+  }
+  return npos;
+}
+
+std::size_t TitleIndex::slotOf(std::size_t position) const {
+  if (size_ == 0) {
+    return slots_.size();
+  }
+  std::uint32_t hash =
+      hashTitle(TaskStore::global().title(tasks_[position]->getRow()));
+  for (std::size_t i = hash & mask(); slots_[i].position != kEmpty;
+       i = (i + 1) & mask()) {
+    if (slots_[i].position == position) {
+      return i;
+    }
+  }
+  return slots_.size();
+}
+
+void TitleIndex::removeSlot(std::size_t hole) {
+  // Backward-shift deletion: pull later entries of the probe run into the
+  // hole when their home slot does not lie between the hole and them, so no
+  // tombstones are needed.
+  for (std::size_t i = (hole + 1) & mask(); slots_[i].position != kEmpty;
+       i = (i + 1) & mask()) {
+    std::size_t home = slots_[i].hash & mask();
+    if (((i - home) & mask()) >= ((i - hole) & mask())) {
+      slots_[hole] = slots_[i];
+      hole = i;
+    }
+  }
+  slots_[hole] = Slot{0, kEmpty};
+  --size_;
+}
+
+void TitleIndex::unlink(std::size_t position) {
+  std::size_t slot = slotOf(position);
+  if (slot != slots_.size()) {
+    removeSlot(slot);
+  }
+}
+
+void TitleIndex::renumber(const std::vector<std::uint32_t> &to) {
+  for (Slot &slot : slots_) {
+    if (slot.position != kEmpty) {
+      slot.position = to[slot.position];
+    }
+  }
+}
+
+void TitleIndex::clear() {
+  slots_.clear();
+  size_ = 0;
+}
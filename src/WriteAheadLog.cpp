@@ -0,0 +1,363 @@
+#include "../include/WriteAheadLog.h"
+#include "../include/Registry.h"
+#include "../include/RegistrySnapshot.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kFrameHeader = 8;
+
+std::array<std::uint32_t, 256> makeCrcTable() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t c = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    table[i] = c;
+  }
+  return table;
+}
+
+template <typename T> void put(std::vector<char> &out, T value) {
+  const char *bytes = reinterpret_cast<const char *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool take(const char *&cursor, const char *end, T &value) {
+  if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return true;
+}
+
+void encode(const WalRecord &record, std::vector<char> &out) {
+  if (record.fields.size() > 255 || record.values.size() > 255) {
+    throw std::invalid_argument("WriteAheadLog: record has too many fields");
+  }
+
+  std::size_t frameStart = out.size();
+  out.resize(out.size() + kFrameHeader);
+
+  put<std::uint8_t>(out, static_cast<std::uint8_t>(record.op));
+  put<std::uint8_t>(out, static_cast<std::uint8_t>(record.fields.size()));
+  for (const auto &field : record.fields) {
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(field.size()));
+    out.insert(out.end(), field.begin(), field.end());
+  }
+  put<std::uint8_t>(out, static_cast<std::uint8_t>(record.values.size()));
+  for (std::int64_t value : record.values) {
+    put<std::int64_t>(out, value);
+  }
+
+  std::uint32_t size =
+      static_cast<std::uint32_t>(out.size() - frameStart - kFrameHeader);
+  std::uint32_t crc = WriteAheadLog::crc32(
+      out.data() + frameStart + kFrameHeader, size);
+  std::memcpy(out.data() + frameStart, &size, sizeof(size));
+  std::memcpy(out.data() + frameStart + sizeof(size), &crc, sizeof(crc));
+}
+
+bool decode(const char *cursor, const char *end, WalRecord &record) {
+  std::uint8_t op = 0;
+  std::uint8_t fieldCount = 0;
+  if (!take(cursor, end, op) || !take(cursor, end, fieldCount)) {
+    return false;
+  }
+
+  record.op = static_cast<WalOp>(op);
+  record.fields.clear();
+  record.values.clear();
+
+  for (std::uint8_t i = 0; i < fieldCount; ++i) {
+    std::uint32_t size = 0;
+    if (!take(cursor, end, size) ||
+        static_cast<std::size_t>(end - cursor) < size) {
+      return false;
+    }
+    record.fields.emplace_back(cursor, size);
+    cursor += size;
+  }
+
+  std::uint8_t valueCount = 0;
+  if (!take(cursor, end, valueCount)) {
+    return false;
+  }
+  for (std::uint8_t i = 0; i < valueCount; ++i) {
+    std::int64_t value = 0;
+    if (!take(cursor, end, value)) {
+      return false;
+    }
+    record.values.push_back(value);
+  }
+
+  return cursor == end;
+}
+
+// Shortens the file to size bytes and syncs the change.
+void truncateFile(const std::string &path, std::size_t size) {
+#ifdef _WIN32
+  int fd = ::_open(path.c_str(), _O_WRONLY | _O_BINARY);
+  bool truncated = fd >= 0 && ::_chsize_s(fd, static_cast<__int64>(size)) ==
+                                  0 && ::_commit(fd) == 0;
+  if (fd >= 0) {
+    ::_close(fd);
+  }
+#else
+  int fd = ::open(path.c_str(), O_WRONLY);
+  bool truncated = fd >= 0 &&
+                   ::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+                   ::fsync(fd) == 0;
+  if (fd >= 0) {
+    ::close(fd);
+  }
+#endif
+  if (!truncated) {
+    throw std::runtime_error("WriteAheadLog: cannot truncate " + path);
+  }
+}
+
+} // namespace
+
+std::uint32_t WriteAheadLog::crc32(const char *data, std::size_t size) {
+  static const std::array<std::uint32_t, 256> table = makeCrcTable();
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ static_cast<std::uint8_t>(data[i])) & 0xFF] ^
+          (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+WriteAheadLog::WriteAheadLog(const std::string &path, SyncMode mode)
+    : path_(path), mode_(mode) {
+#ifdef _WIN32
+  fd_ = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+                0644);
+#else
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+  if (fd_ < 0) {
+    throw std::runtime_error("WriteAheadLog: cannot open " + path);
+  }
+}
+
+WriteAheadLog::~WriteAheadLog() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  flushed_.wait(lock, [this] { return !flushing_; });
+#ifdef _WIN32
+  ::_close(fd_);
+#else
+  ::close(fd_);
+#endif
+}
+
+void WriteAheadLog::writeAndSync(const std::vector<char> &bytes) {
+  const char *cursor = bytes.data();
+  std::size_t remaining = bytes.size();
+
+  while (remaining > 0) {
+#ifdef _WIN32
+    int written = ::_write(fd_, cursor, static_cast<unsigned>(remaining));
+#else
+    ssize_t written = ::write(fd_, cursor, remaining);
+#endif
+    if (written <= 0) {
+      throw std::runtime_error("WriteAheadLog: write failed on " + path_);
+    }
+    cursor += written;
+    remaining -= static_cast<std::size_t>(written);
+  }
+
+#ifdef _WIN32
+  bool synced = ::_commit(fd_) == 0;
+#else
+  bool synced = ::fsync(fd_) == 0;
+#endif
+  if (!synced) {
+    throw std::runtime_error("WriteAheadLog: fsync failed on " + path_);
+  }
+}
+
+void WriteAheadLog::checkNotFailed() const {
+  if (failed_) {
+    throw std::runtime_error("WriteAheadLog: an earlier write failed on " +
+                             path_);
+  }
+}
+
+std::uint64_t WriteAheadLog::append(const WalRecord &record) {
+  std::uint64_t lsn = enqueue(record);
+  waitDurable(lsn);
+  return lsn;
+}
+
+std::uint64_t WriteAheadLog::enqueue(const WalRecord &record) {
+  std::vector<char> frame;
+  encode(record, frame);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  checkNotFailed();
+  std::uint64_t lsn = ++nextLsn_;
+
+  if (mode_ == SyncMode::PerOperation) {
+    try {
+      writeAndSync(frame);
+    } catch (...) {
+      failed_ = true;
+      throw;
+    }
+    ++syncCount_;
+    durableLsn_ = lsn;
+  } else {
+    pending_.insert(pending_.end(), frame.begin(), frame.end());
+  }
+  return lsn;
+}
+
+void WriteAheadLog::waitDurable(std::uint64_t lsn) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (durableLsn_ < lsn) {
+    checkNotFailed();
+    if (flushing_) {
+      flushed_.wait(lock);
+      continue;
+    }
+
+    // Become the leader: take everything queued so far and flush it without
+    // holding the lock, so followers can keep queueing the next batch.
+    flushing_ = true;
+    std::vector<char> batch;
+    batch.swap(pending_);
+    std::uint64_t batchEnd = nextLsn_;
+
+    lock.unlock();
+    try {
+      writeAndSync(batch);
+    } catch (...) {
+      // The batch may be partly written; nothing after it can be trusted to
+      // survive recovery, so followers fail rather than wait for it.
+      lock.lock();
+      failed_ = true;
+      flushing_ = false;
+      flushed_.notify_all();
+      throw;
+    }
+    lock.lock();
+
+    ++syncCount_;
+    durableLsn_ = batchEnd;
+    flushing_ = false;
+    flushed_.notify_all();
+  }
+}
+
+void WriteAheadLog::checkpoint(const Registry &registry,
+                               const std::string &snapshotPath) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  flushed_.wait(lock, [this] { return !flushing_; });
+  checkNotFailed();
+
+  RegistrySnapshot::write(registry, snapshotPath);
+
+#ifdef _WIN32
+  bool truncated = ::_chsize_s(fd_, 0) == 0;
+#else
+  bool truncated = ::ftruncate(fd_, 0) == 0 && ::fsync(fd_) == 0;
+#endif
+  if (!truncated) {
+    throw std::runtime_error("WriteAheadLog: cannot truncate " + path_);
+  }
+
+  // Records still queued were applied before the snapshot was taken, so the
+  // snapshot already made them durable.
+  pending_.clear();
+  durableLsn_ = nextLsn_;
+  flushed_.notify_all();
+}
+
+std::uint64_t WriteAheadLog::syncCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return syncCount_;
+}
+
+std::size_t
+WriteAheadLog::read(const std::string &path,
+                    const std::function<void(const WalRecord &)> &visit) {
+  std::size_t intactBytes = 0;
+  return scan(path, visit, intactBytes);
+}
+
+std::size_t
+WriteAheadLog::scan(const std::string &path,
+                    const std::function<void(const WalRecord &)> &visit,
+                    std::size_t &intactBytes) {
+  intactBytes = 0;
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return 0;
+  }
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+
+  const char *cursor = bytes.data();
+  const char *end = bytes.data() + bytes.size();
+  std::size_t count = 0;
+  WalRecord record{WalOp::CreateSubject, {}, {}};
+
+  while (static_cast<std::size_t>(end - cursor) >= kFrameHeader) {
+    std::uint32_t size = 0;
+    std::uint32_t crc = 0;
+    std::memcpy(&size, cursor, sizeof(size));
+    std::memcpy(&crc, cursor + sizeof(size), sizeof(crc));
+
+    const char *payload = cursor + kFrameHeader;
+    if (static_cast<std::size_t>(end - payload) < size ||
+        crc32(payload, size) != crc ||
+        !decode(payload, payload + size, record)) {
+      break;
+    }
+
+    visit(record);
+    ++count;
+    cursor = payload + size;
+  }
+
+  intactBytes = static_cast<std::size_t>(cursor - bytes.data());
+  return count;
+}
+
+std::size_t WriteAheadLog::recover(Registry &registry,
+                                   const std::string &snapshotPath,
+                                   const std::string &logPath) {
+  if (std::ifstream(snapshotPath, std::ios::binary).good()) {
+    RegistrySnapshot::open(snapshotPath).restore(registry);
+  }
+
+  std::size_t intactBytes = 0;
+  std::size_t count = scan(
+      logPath, [&registry](const WalRecord &record) { registry.apply(record); },
+      intactBytes);
+  std::ifstream in(logPath, std::ios::binary | std::ios::ate);
+  if (in && static_cast<std::size_t>(in.tellg()) > intactBytes) {
+    in.close();
+    truncateFile(logPath, intactBytes);
+  }
+  return count;
+}
@@ -1,17 +1,16 @@
+#include <algorithm>
 #include <chrono>
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
-#include <iomanip>
 #include <memory>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "../include/Command.h"
-#include "../include/CommandManager.h"
 #include "../include/HtmlProvider.h"
+#include "../include/IsoDate.h"
 #include "../include/Internship.h"
 #include "../include/MarkdownParser.h"
 #include "../include/Notification.h"
@@ -62,45 +61,45 @@ void seed() {
                                          "Basic algebraic manipulations");
   math_lab1->completeTask();
   math_lab1->setMarks(90);
-  math_lab1->setSubject(math);
+  math_lab1->setSubject(math.get());
   math->addTask(math_lab1);
 
   auto math_exam = examFactory.createTask("Midterm Exam", deadline_soon,
                                           "Covers first half of the course");
   math_exam->startTask();
-  math_exam->setSubject(math);
+  math_exam->setSubject(math.get());
   math->addTask(math_exam);
 
   auto cs_project = projectFactory.createTask(
       "Project: Web App", deadline_future, "Develop a simple web application");
   cs_project->startTask();
-  cs_project->setSubject(cs);
+  cs_project->setSubject(cs.get());
   cs->addTask(cs_project);
 
   auto cs_lab1 = labFactory.createTask("Lab 1: Python Basics", deadline_past,
                                        "Introduction to Python syntax");
   cs_lab1->completeTask();
   cs_lab1->setMarks(95);
-  cs_lab1->setSubject(cs);
+  cs_lab1->setSubject(cs.get());
   cs->addTask(cs_lab1);
 
   auto cs_lab2 = labFactory.createTask("Lab 2: Data Structures", deadline_soon,
                                        "Implement lists and dictionaries");
   cs_lab2->completeTask();
   cs_lab2->setMarks(88);
-  cs_lab2->setSubject(cs);
+  cs_lab2->setSubject(cs.get());
   cs->addTask(cs_lab2);
 
   auto physics_lab = labFactory.createTask("Lab: Kinematics", deadline_soon,
                                            "Experiments on motion");
   physics_lab->startTask();
-  physics_lab->setSubject(physics);
+  physics_lab->setSubject(physics.get());
   physics->addTask(physics_lab);
 
   auto physics_exam = examFactory.createTask(
       "Final Exam", deadline_future, "Comprehensive exam on all topics");
   physics_exam->startTask();
-  physics_exam->setSubject(physics);
+  physics_exam->setSubject(physics.get());
   physics->addTask(physics_exam);
 
   registry.subjects[math->getCode()] = math;
@@ -109,6 +108,7 @@ void seed() {
 
   std::cout << "Registry populated with initial data." << std::endl;
   registry.subjects[physics->getCode()] = physics;
+  registry.publish();
 }
 
 InternshipStatus internshipStatusFromInt(int statusInt) {
@@ -126,20 +126,7 @@ InternshipStatus internshipStatusFromInt(int statusInt) {
   }
 }
 
-std::shared_ptr<TaskState> getTargetStateFromInt(int targetStateInt) {
-  switch (targetStateInt) {
-  case 0:
-    return std::make_shared<PendingState>();
-  case 1:
-    return std::make_shared<InProgressState>();
-  case 2:
-    return std::make_shared<CompletedState>();
-  default:
-    return nullptr;
-  }
-}
-
-val internshipToJS(const std::shared_ptr<Internship> &internship) {
+val internshipToJS(const std::shared_ptr<const Internship> &internship) {
   val jsInternship = val::object();
   if (internship) {
     jsInternship.set("id", internship->id);
@@ -152,57 +139,53 @@ val internshipToJS(const std::shared_ptr<Internship> &internship) {
   return jsInternship;
 }
 
-val taskToJS(const std::shared_ptr<Task> &task) {
+val taskToJS(const std::shared_ptr<const Task> &task, TaskId live) {
   val result = val::object();
   if (task) {
-    result.set("title", task->getTitle());
-    result.set("description", task->getDescription());
-
-    auto time_point = task->getDeadline();
-    auto c_time_t =
-        std::chrono::system_clock::to_time_t(time_point); // Convert to time_t
-    std::tm tm_local = {};
-#ifdef _WIN32
-    localtime_s(&tm_local, &c_time_t);
-#else
-    localtime_r(&c_time_t, &tm_local);
-#endif
-
-    char buffer[32];
-    if (std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm_local)) {
-      result.set("deadline", std::string(buffer));
-    } else {
-      result.set("deadline", "Error formatting date");
-    }
+    result.set("title", std::string(task->getTitle()));
+    result.set("description", std::string(task->getDescription()));
 
-    result.set("type", task->getType());
+    result.set("deadline", iso_date::format(task->getDeadline(),
+                                            iso_date::DateStyle::Seconds)
+                               .str());
+
+    result.set("type", std::string(task->getType()));
     result.set("completed", task->isCompleted());
     result.set("marks", task->getMarks());
     result.set("progress", task->getProgress());
     result.set("stateName", task->getStateName());
+
+    // Snapshot tasks are copies that belong to no subject; hand out the id
+    // of the live task, which is what changeTaskStateById resolves.
+    if (live) {
+      result.set("id", std::to_string(live.value()));
+    }
   }
   return result;
 }
 
-val subjectToJS(const std::shared_ptr<Subject> &subject) {
+val tasksToJS(const SubjectVersion &subject) {
+  val jsTasks = val::array();
+  ConstTaskSpan tasks = subject.taskView();
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    jsTasks.set(i, taskToJS(tasks[i],
+                            subject.findLiveId(tasks[i]->getTitle())));
+  }
+  return jsTasks;
+}
+
+val subjectToJS(const std::shared_ptr<const SubjectVersion> &subject) {
   val result = val::object();
   if (subject) {
     result.set("name", subject->getName());
     result.set("code", subject->getCode());
     result.set("description", subject->getDescription());
-
-    val jsTasks = val::array();
-    auto tasks = subject->getTasks();
-
-    for (size_t i = 0; i < tasks.size(); ++i) {
-      jsTasks.set(i, taskToJS(tasks[i]));
-    }
-    result.set("tasks", jsTasks);
+    result.set("tasks", tasksToJS(*subject));
   }
   return result;
 }
 
-val resumeToJS(const std::shared_ptr<Resume> &resume) {
+val resumeToJS(const std::shared_ptr<const Resume> &resume) {
   val jsResume = val::object();
   if (resume) {
     jsResume.set("id", resume->getId());
@@ -214,22 +197,39 @@ val resumeToJS(const std::shared_ptr<Resume> &resume) {
 
 std::string createSubject(const std::string &name, const std::string &code,
                           const std::string &description) {
-  auto subject = SubjectBuilder()
-                     .setName(name)
-                     .setCode(code)
-                     .setDescription(description)
-                     .build();
+  registry.createSubject(name, code, description);
+  return code;
+}
 
-  registry.subjects[subject->getCode()] = subject;
-  return subject->getCode();
+// Versions iterate in hash order; lists reach the UI sorted by key, and
+// generated ids by length first so that "resume_10" follows "resume_9".
+template <typename V>
+std::vector<std::shared_ptr<const V>>
+sortedValues(const RegistryVersion::Entries<V> &entries, bool generatedIds) {
+  std::vector<const typename RegistryVersion::Entries<V>::value_type *> sorted;
+  for (const auto &entry : entries) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(), [generatedIds](auto a, auto b) {
+    if (generatedIds && a->first.size() != b->first.size()) {
+      return a->first.size() < b->first.size();
+    }
+    return a->first < b->first;
+  });
+  std::vector<std::shared_ptr<const V>> values;
+  for (const auto *entry : sorted) {
+    values.push_back(entry->second);
+  }
+  return values;
 }
 
 val getAllSubjects() {
   auto result = val::array();
 
   size_t i = 0;
-  for (const auto &[_, value] : registry.subjects) {
-    result.set(i, subjectToJS(value));
+  auto version = registry.snapshot();
+  for (const auto &subject : sortedValues(version->subjects, false)) {
+    result.set(i, subjectToJS(subject));
     ++i;
   }
 
@@ -237,70 +237,32 @@ val getAllSubjects() {
 }
 
 val getSubject(const std::string &code) {
-  try {
-    auto subject = registry.subjects.at(code);
-
-    return subjectToJS(subject);
-  } catch (const std::out_of_range &e) {
+  auto subject = registry.snapshot()->findSubject(code);
+  if (!subject) {
     return val::null();
   }
+  return subjectToJS(subject);
 }
 
-int createTask(const std::string &subjectCode, const std::string &title,
-               const std::string &description, const std::string &deadlineStr,
-               int taskType) {
-  try {
-    std::tm timeinfo = {};
-    std::stringstream ss(deadlineStr);
-    ss >> std::get_time(&timeinfo, "%Y-%m-%dT%H:%M:%S");
-
-    if (ss.fail()) {
-      return -1;
-    }
-
-    std::time_t time = std::mktime(&timeinfo);
-    DateTime deadline = std::chrono::system_clock::from_time_t(time);
-
-    TaskBuilder builder;
-    builder.setTitle(title).setDescription(description).setDeadline(deadline);
-
-    switch (taskType) {
-    case 1:
-      builder.asLab();
-      break;
-    case 2:
-      builder.asProject();
-      break;
-    case 3:
-      builder.asExam();
-      break;
-    default:
-      builder.asLab();
-      break;
-    }
-
-    auto task = builder.build();
-    registry.subjects[subjectCode]->addTask(task);
-
-    auto tasks = registry.subjects[subjectCode]->getTasks();
-    return tasks.size() - 1;
-  } catch (const std::out_of_range &e) {
-    return -1;
+// The id of the new task, or "" if it was not created.
+std::string createTask(const std::string &subjectCode,
+                       const std::string &title,
+                       const std::string &description,
+                       const std::string &deadlineStr, int taskType) {
+  DateTime deadline;
+  if (!iso_date::parse(deadlineStr, deadline)) {
+    return "";
   }
+
+  // The handle is fixed when the task is made, under the registry's lock.
+  auto task = registry.createTask(subjectCode, title, description, deadline,
+                                  taskType);
+  return task ? std::to_string(task->getHandle().value()) : "";
 }
 
 val getSubjectTasks(const std::string &subjectCode) {
-  val result = val::array();
-
-  try {
-    auto tasks = registry.subjects[subjectCode]->getTasks();
-    for (size_t i = 0; i < tasks.size(); i++) {
-      result.set(i, taskToJS(tasks[i]));
-    }
-  } catch (std::out_of_range &e) {
-  }
-
-  return result;
+  auto subject = registry.snapshot()->findSubject(subjectCode);
+  return subject ? tasksToJS(*subject) : val::array();
 }
 
 std::string convertMarkdownToHtml(const std::string &markdownInput) {
@@ -331,115 +293,64 @@ std::string convertAsciiDocToHtml(const std::string &asciiDocInput) {
   }
 }
 
-static long long nextResumeIdCounter = 1;
-
 std::string createNewResume(const std::string &title,
                             const std::string &htmlBody) {
-  if (title.empty()) {
-    return "";
-  }
-
-  std::string generatedId = "resume_" + std::to_string(nextResumeIdCounter++);
-
-  while (registry.resumes.count(generatedId)) {
-    generatedId = "resume_" + std::to_string(nextResumeIdCounter++);
-  }
-
-  auto resume = std::make_shared<Resume>(generatedId, title, htmlBody);
-  registry.resumes[resume->getId()] = resume;
-  return resume->getId();
+  return registry.createResume(title, htmlBody);
 }
 
 val getSpecificResume(const std::string &resumeId) {
-  try {
-    const auto &resume = registry.resumes.at(resumeId);
-    return resumeToJS(resume);
-  } catch (const std::out_of_range &e) {
+  auto resume = registry.snapshot()->findResume(resumeId);
+  if (!resume) {
     return val::null();
   }
+  return resumeToJS(resume);
 }
 
 val getAllStoredResumes() {
   val jsResumesArray = val::array();
   size_t index = 0;
-  for (const auto &pair : registry.resumes) { // Iterate through the resumes map
-    jsResumesArray.set(index++, resumeToJS(pair.second));
+  auto version = registry.snapshot();
+  for (const auto &resume : sortedValues(version->resumes, true)) {
+    jsResumesArray.set(index++, resumeToJS(resume));
   }
   return jsResumesArray;
 }
 
-static long long nextInternshipIdCounter = 1;
-
 std::string createNewInternship(const std::string &company,
                                 const std::string &position, int statusInt,
                                 const std::string &startDate,
                                 const std::string &endDate) {
-  if (company.empty() || position.empty() || startDate.empty() ||
-      endDate.empty()) {
-    return "";
-  }
-
-  std::string generatedId =
-      "internship_" + std::to_string(nextInternshipIdCounter++);
-
-  while (registry.internships.count(generatedId)) {
-    generatedId = "internship_" + std::to_string(nextInternshipIdCounter++);
-  }
-
-  InternshipStatus status = internshipStatusFromInt(statusInt);
-
-  auto internship = std::make_shared<Internship>(generatedId, company, position,
-                                                 status, startDate, endDate);
-  registry.internships[generatedId] = internship;
-  return generatedId;
+  return registry.createInternship(company, position,
+                                   internshipStatusFromInt(statusInt),
+                                   startDate, endDate);
 }
 
 val getAllStoredInternships() {
   val jsInternshipsArray = val::array();
   size_t index = 0;
-  for (const auto &pair : registry.internships) {
-    jsInternshipsArray.set(index++, internshipToJS(pair.second));
+  auto version = registry.snapshot();
+  for (const auto &internship : sortedValues(version->internships, true)) {
+    jsInternshipsArray.set(index++, internshipToJS(internship));
   }
   return jsInternshipsArray;
 }
 
+// Task ids are passed to JavaScript as decimal strings: a packed 64-bit
+// handle does not fit a JS number exactly.
+bool changeTaskStateById(const std::string &taskId, int targetStateInt) {
+  try {
+    return registry.changeTaskState(TaskId::fromValue(std::stoull(taskId)),
+                                    targetStateInt);
+  } catch (const std::exception &e) {
+    std::cout << "Error changing task state: " << e.what() << std::endl;
+    return false;
+  }
+}
+
 bool changeTaskState(const std::string &subjectCode, int taskIndex,
                      int targetStateInt) {
   try {
-    auto subjectIt = registry.subjects.find(subjectCode);
-    if (subjectIt == registry.subjects.end()) {
-      std::cout << "Error: Subject with code '" << subjectCode << "' not found."
-                << std::endl;
-      return false;
-    }
-    std::shared_ptr<Subject> subject = subjectIt->second;
-
-    auto tasksVec = subject->getTasks();
-
-    if (taskIndex < 0 || static_cast<size_t>(taskIndex) >= tasksVec.size()) {
-      std::cout << "Error: Invalid task index " << taskIndex << " for subject '"
-                << subjectCode << "'. Max index: " << (tasksVec.size() - 1)
-                << std::endl;
-      return false;
-    }
-
-    Task &taskToChange = *tasksVec[static_cast<size_t>(taskIndex)];
-
-    std::shared_ptr<TaskState> targetState =
-        getTargetStateFromInt(targetStateInt);
-    if (!targetState) {
-      return false;
-    }
-
-    auto command =
-        std::make_shared<SetTaskStateCommand>(taskToChange, targetState);
-    CommandManager::instance().executeCommand(command);
-    return true;
-
-  } catch (const std::out_of_range &oor) {
-    std::cout << "Error: Subject or Task not found (out_of_range): "
-              << oor.what() << std::endl;
-    return false;
+    return registry.changeTaskState(subjectCode, taskIndex, targetStateInt);
   } catch (const std::exception &e) {
     std::cout << "Error changing task state: " << e.what() << std::endl;
     return false;
@@ -450,9 +361,10 @@ bool changeTaskState(const std::string &subjectCode, int taskIndex,
   }
 }
 
+// Undo and redo step through the registry's versions, so they cover every
+// change made from the UI, not only task state changes.
 bool undoLastTaskCommand() {
-  if (CommandManager::instance().canUndo()) {
-    CommandManager::instance().undoLastCommand();
+  if (registry.undo()) {
     return true;
   }
   emscripten::val::global("console").call<void>(
@@ -460,6 +372,15 @@ bool undoLastTaskCommand() {
   return false;
 }
 
+bool redoLastTaskCommand() {
+  if (registry.redo()) {
+    return true;
+  }
+  emscripten::val::global("console").call<void>(
+      "log", std::string("No command to redo."));
+  return false;
+}
+
 EMSCRIPTEN_BINDINGS(academic_progress_tracker) {
   function("seed", &seed);
 
@@ -481,5 +402,7 @@ EMSCRIPTEN_BINDINGS(academic_progress_tracker) {
   function("getAllInternships", &getAllStoredInternships);
 
   function("changeTaskState", &changeTaskState);
+  function("changeTaskStateById", &changeTaskStateById);
   function("undoLastTaskCommand", &undoLastTaskCommand);
+  function("redoLastTaskCommand", &redoLastTaskCommand);
 }
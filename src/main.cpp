@@ -59,45 +59,45 @@ void populateRegistry() {
                                          "Basic algebraic manipulations");
   math_lab1->completeTask();
   math_lab1->setMarks(90);
-  math_lab1->setSubject(math);
+  math_lab1->setSubject(math.get());
   math->addTask(math_lab1);
 
   auto math_exam = examFactory.createTask("Midterm Exam", deadline_soon,
                                           "Covers first half of the course");
   math_exam->startTask();
-  math_exam->setSubject(math);
+  math_exam->setSubject(math.get());
   math->addTask(math_exam);
 
   auto cs_project = projectFactory.createTask(
       "Project: Web App", deadline_future, "Develop a simple web application");
   cs_project->startTask();
-  cs_project->setSubject(cs);
+  cs_project->setSubject(cs.get());
   cs->addTask(cs_project);
 
   auto cs_lab1 = labFactory.createTask("Lab 1: Python Basics", deadline_past,
                                        "Introduction to Python syntax");
   cs_lab1->completeTask();
   cs_lab1->setMarks(95);
-  cs_lab1->setSubject(cs);
+  cs_lab1->setSubject(cs.get());
   cs->addTask(cs_lab1);
 
   auto cs_lab2 = labFactory.createTask("Lab 2: Data Structures", deadline_soon,
                                        "Implement lists and dictionaries");
   cs_lab2->completeTask();
   cs_lab2->setMarks(88);
-  cs_lab2->setSubject(cs);
+  cs_lab2->setSubject(cs.get());
   cs->addTask(cs_lab2);
 
   auto physics_lab = labFactory.createTask("Lab: Kinematics", deadline_soon,
                                            "Experiments on motion");
   physics_lab->startTask();
-  physics_lab->setSubject(physics);
+  physics_lab->setSubject(physics.get());
   physics->addTask(physics_lab);
 
   auto physics_exam = examFactory.createTask(
       "Final Exam", deadline_future, "Comprehensive exam on all topics");
   physics_exam->startTask();
-  physics_exam->setSubject(physics);
+  physics_exam->setSubject(physics.get());
   physics->addTask(physics_exam);
 
   registry.subjects[math->getCode()] = math;
@@ -232,7 +232,7 @@ void taskStateAndCommands() {
   }
   auto cs_subject = registry.subjects["CS101"];
   std::shared_ptr<Task> csProject = nullptr;
-  for (const auto &task : cs_subject->getTasks()) {
+  for (const auto &task : cs_subject->taskView()) {
     if (task->getTitle() == "Project: Web App") {
       csProject = task;
       break;
@@ -0,0 +1,129 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/RoaringBitmap.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskBitmapIndex.h"
+#include "../include/TaskState.h"
+
+TEST(RoaringBitmapTest, SwitchesContainersWithoutLosingValues) {
+  RoaringBitmap bitmap;
+  std::set<std::uint32_t> expected;
+
+  // Dense enough in the first container to become a bitmap, sparse elsewhere.
+  for (std::uint32_t v = 0; v < 10000; v += 2) {
+    bitmap.add(v);
+    expected.insert(v);
+  }
+  for (std::uint32_t v = 1u << 20; v < (1u << 20) + 300000; v += 997) {
+    bitmap.add(v);
+    expected.insert(v);
+  }
+  EXPECT_FALSE(bitmap.add(4));
+  EXPECT_EQ(expected.size(), bitmap.cardinality());
+
+  for (std::uint32_t v = 0; v < 9000; v += 2) {
+    EXPECT_TRUE(bitmap.remove(v));
+    expected.erase(v);
+  }
+  EXPECT_FALSE(bitmap.remove(3));
+  EXPECT_FALSE(bitmap.contains(8));
+  EXPECT_TRUE(bitmap.contains(9002));
+
+  std::vector<std::uint32_t> values;
+  bitmap.forEach([&](std::uint32_t v) { values.push_back(v); });
+  EXPECT_EQ(std::vector<std::uint32_t>(expected.begin(), expected.end()),
+            values);
+}
+
+TEST(RoaringBitmapTest, IntersectionsMatchAcrossContainerKinds) {
+  RoaringBitmap evens;
+  RoaringBitmap multiplesOfThree;
+  RoaringBitmap sparse;
+  for (std::uint32_t v = 0; v < 200000; ++v) {
+    if (v % 2 == 0)
+      evens.add(v);
+    if (v % 3 == 0)
+      multiplesOfThree.add(v);
+    if (v % 1000 == 0)
+      sparse.add(v);
+  }
+
+  EXPECT_EQ(33334u, RoaringBitmap::andCardinality(evens, multiplesOfThree));
+  EXPECT_EQ(200u, RoaringBitmap::andCardinality(evens, sparse));
+  EXPECT_EQ(67u, RoaringBitmap::andCardinality(multiplesOfThree, sparse));
+
+  RoaringBitmap sixes = RoaringBitmap::intersect(evens, multiplesOfThree);
+  EXPECT_EQ(33334u, sixes.cardinality());
+  EXPECT_TRUE(sixes.contains(199998));
+  EXPECT_FALSE(sixes.contains(199997));
+  EXPECT_EQ(67u, RoaringBitmap::andCardinality(sixes, sparse));
+}
+
+class TaskBitmapIndexTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+    auto &registry = Registry::instance();
+    registry.createSubject("Computer Science", "CS101", "");
+    registry.createSubject("Mathematics", "MATH101", "");
+    registry.createTask("CS101", "Lab 1", "", deadline, 1);
+    registry.createTask("CS101", "Midterm", "", deadline, 3);
+    registry.createTask("CS101", "Final", "", deadline, 3);
+    registry.createTask("MATH101", "Exam", "", deadline, 3);
+    registry.createTask("MATH101", "Project", "", deadline, 2);
+  }
+
+  void TearDown() override {
+    Registry::instance().subjects.clear();
+    Registry::instance().publish();
+    CommandManager::instance().clearHistory();
+  }
+};
+
+TEST_F(TaskBitmapIndexTest, CountsFollowStateTransitions) {
+  auto &registry = Registry::instance();
+  const Subject *cs = registry.subjects.at("CS101").get();
+
+  EXPECT_EQ(5u, registry.countTasks({}));
+  EXPECT_EQ(3u, registry.countTasks({std::nullopt, TaskType::Exam}));
+  EXPECT_EQ(0u, registry.countTasks({TaskStateKind::Completed, TaskType::Exam,
+                                     cs}));
+
+  registry.changeTaskState("CS101", 1, 2);
+  registry.changeTaskState("MATH101", 0, 2);
+  registry.changeTaskState("CS101", 0, 1);
+
+  EXPECT_EQ(1u, registry.countTasks({TaskStateKind::Completed, TaskType::Exam,
+                                     cs}));
+  EXPECT_EQ(2u, registry.countTasks({TaskStateKind::Completed}));
+  EXPECT_EQ(1u, registry.countTasks({TaskStateKind::InProgress,
+                                     TaskType::Lab}));
+
+  auto pending = registry.findTasks({TaskStateKind::Pending});
+  ASSERT_EQ(2u, pending.size());
+  for (Task *task : pending) {
+    EXPECT_EQ("Pending", task->getStateName());
+  }
+
+  registry.subjects.at("CS101")->findTask("Midterm")->reopenTask();
+  EXPECT_EQ(1u, registry.countTasks({TaskStateKind::Completed}));
+}
+
+TEST_F(TaskBitmapIndexTest, FollowsTaskAndSubjectRemoval) {
+  auto &registry = Registry::instance();
+  registry.subjects.at("CS101")->removeTask("Final");
+  EXPECT_EQ(4u, registry.countTasks({}));
+  EXPECT_EQ(2u, registry.countTasks({std::nullopt, TaskType::Exam}));
+
+  const Subject *math = registry.subjects.at("MATH101").get();
+  registry.subjects.erase("MATH101");
+  EXPECT_EQ(2u, registry.countTasks({}));
+  EXPECT_EQ(0u, registry.countTasks({std::nullopt, std::nullopt, math}));
+}
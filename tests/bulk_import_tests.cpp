@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../include/BulkImporter.h"
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskState.h"
+
+namespace {
+
+DateTime utc(int year, int month, int day, int hour, int minute, int second) {
+  std::tm tm = {};
+  tm.tm_year = year - 1900;
+  tm.tm_mon = month - 1;
+  tm.tm_mday = day;
+  tm.tm_hour = hour;
+  tm.tm_min = minute;
+  tm.tm_sec = second;
+#ifdef _WIN32
+  return std::chrono::system_clock::from_time_t(_mkgmtime(&tm));
+#else
+  return std::chrono::system_clock::from_time_t(timegm(&tm));
+#endif
+}
+
+} // namespace
+
+class BulkImportTest : public ::testing::Test {
+protected:
+  void SetUp() override { clearRegistry(); }
+
+  void TearDown() override {
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().publish();
+  }
+};
+
+TEST(BulkImporterDateTest, ParsesIsoDatesAndOffsets) {
+  DateTime parsed;
+  ASSERT_TRUE(BulkImporter::parseDateTime("2024-02-29T13:45:10Z", parsed));
+  EXPECT_EQ(utc(2024, 2, 29, 13, 45, 10), parsed);
+  ASSERT_TRUE(BulkImporter::parseDateTime("2024-03-01T01:30+02:00", parsed));
+  EXPECT_EQ(utc(2024, 2, 29, 23, 30, 0), parsed);
+  ASSERT_TRUE(BulkImporter::parseDateTime("1969-12-31T23:59:59.250-0100",
+                                          parsed));
+  EXPECT_EQ(utc(1970, 1, 1, 0, 59, 59), parsed);
+
+  std::tm local = {};
+  local.tm_year = 2025 - 1900;
+  local.tm_mon = 6;
+  local.tm_mday = 4;
+  local.tm_hour = 9;
+  local.tm_isdst = -1;
+  ASSERT_TRUE(BulkImporter::parseDateTime("2025-07-04T09:00:00", parsed));
+  EXPECT_EQ(std::chrono::system_clock::from_time_t(std::mktime(&local)),
+            parsed);
+
+  EXPECT_FALSE(BulkImporter::parseDateTime("2023-02-29", parsed));
+  EXPECT_FALSE(BulkImporter::parseDateTime("2024-13-01", parsed));
+  EXPECT_FALSE(BulkImporter::parseDateTime("2024-01-01T24:00", parsed));
+  EXPECT_FALSE(BulkImporter::parseDateTime("2024-01-01T10:00Zulu", parsed));
+  EXPECT_FALSE(BulkImporter::parseDateTime("", parsed));
+}
+
+TEST_F(BulkImportTest, ImportsCsvWithQuotingAcrossChunks) {
+  std::string csv = "kind,code,name,description\r\n"
+                    "S,CS101,Computer Science,\"Intro, with \"\"quotes\"\"\"\n"
+                    "# comment\n"
+                    "\n"
+                    "S,MATH101,Mathematics,\n";
+  for (int i = 0; i < 200; ++i) {
+    csv += "T,CS101,Lab " + std::to_string(i) +
+           ",,2030-01-01T10:00:00Z,Lab\n";
+  }
+  csv += "T,MATH101,Final,\"Rooms A, B\",2030-06-01T09:00Z,3,Completed,87\n";
+  csv += "T,MATH101,Midterm,,2030-03-01,Exam,InProgress";
+
+  BulkImporter::Options options;
+  options.threads = 3;
+  options.chunkBytes = 256;
+  ImportStats stats = BulkImporter(Registry::instance(), options)
+                          .importBuffer(csv);
+
+  EXPECT_EQ(2u, stats.subjects);
+  EXPECT_EQ(202u, stats.tasks);
+  EXPECT_EQ(0u, stats.rejected);
+  EXPECT_EQ(0u, stats.malformed);
+
+  auto &registry = Registry::instance();
+  EXPECT_EQ("Intro, with \"quotes\"",
+            registry.subjects.at("CS101")->getDescription());
+  auto final = registry.subjects.at("MATH101")->findTask("Final");
+  ASSERT_NE(nullptr, final);
+  EXPECT_EQ(TaskType::Exam, final->getTaskType());
+  EXPECT_EQ(TaskStateKind::Completed, final->getStateKind());
+  EXPECT_EQ(87, final->getMarks());
+  EXPECT_EQ("Rooms A, B", final->getDescription());
+  EXPECT_EQ(utc(2030, 6, 1, 9, 0, 0), final->getDeadline());
+
+  // Imported rows are indexed and visible to readers like any other write.
+  EXPECT_EQ(200u, registry.countTasks({std::nullopt, TaskType::Lab}));
+  EXPECT_EQ(1u, registry.countTasks({TaskStateKind::InProgress}));
+  auto version = registry.snapshot();
+  ASSERT_NE(nullptr, version->findSubject("CS101"));
+  EXPECT_EQ(200u, version->findSubject("CS101")->getTasks().size());
+}
+
+TEST_F(BulkImportTest, ImportsJsonLinesWithEscapes) {
+  std::string jsonl =
+      "{\"kind\":\"subject\",\"code\":\"PHYS101\",\"name\":\"Physics\"}\n"
+      "{ \"kind\" : \"task\", \"subject\": \"PHYS101\", \"title\": "
+      "\"Lab \\\"A\\\"\\n\\u00e9\\ud83d\\ude00\", \"type\": 1, "
+      "\"deadline\": \"2031-01-02T03:04:05Z\", \"marks\": 0, "
+      "\"state\": null, \"extra\": true }\n"
+      "{\"kind\":\"task\",\"subject\":\"PHYS101\",\"title\":\"Exam\","
+      "\"type\":\"Exam\",\"deadline\":\"2031-05-05T00:00Z\",\"state\":2,"
+      "\"marks\":95}\n";
+
+  BulkImporter::Options options;
+  options.format = BulkImporter::Format::JsonLines;
+  ImportStats stats = BulkImporter(Registry::instance(), options)
+                          .importBuffer(jsonl);
+
+  EXPECT_EQ(1u, stats.subjects);
+  EXPECT_EQ(2u, stats.tasks);
+  EXPECT_EQ(0u, stats.malformed);
+
+  auto &subject = Registry::instance().subjects.at("PHYS101");
+  auto lab = subject->findTask("Lab \"A\"\n\xC3\xA9\xF0\x9F\x98\x80");
+  ASSERT_NE(nullptr, lab);
+  EXPECT_EQ(TaskType::Lab, lab->getTaskType());
+  EXPECT_EQ(utc(2031, 1, 2, 3, 4, 5), lab->getDeadline());
+  auto exam = subject->findTask("Exam");
+  EXPECT_TRUE(exam->isCompleted());
+  EXPECT_EQ(95, exam->getMarks());
+}
+
+TEST_F(BulkImportTest, CountsRejectedAndMalformedRows) {
+  Registry::instance().createSubject("Computer Science", "CS101", "");
+  Registry::instance().createTask("CS101", "Lab 1", "",
+                                  std::chrono::system_clock::now(), 1);
+
+  std::string csv = "S,CS101,Duplicate,\n"
+                    "T,CS101,Lab 1,,2030-01-01,Lab\n"
+                    "T,CS101,Lab 2,,2030-01-01,Lab\n"
+                    "T,NOPE,Lab 3,,2030-01-01,Lab\n"
+                    "T,CS101,Lab 4,,not a date,Lab\n"
+                    "T,CS101,Lab 5,,2030-01-01,Essay\n"
+                    "X,CS101\n"
+                    "T,CS101,\"Lab 6,,2030-01-01,Lab\n";
+
+  ImportStats stats = BulkImporter(Registry::instance()).importBuffer(csv);
+
+  EXPECT_EQ(0u, stats.subjects);
+  EXPECT_EQ(1u, stats.tasks);
+  EXPECT_EQ(3u, stats.rejected);
+  EXPECT_EQ(4u, stats.malformed);
+  ASSERT_EQ(4u, stats.errors.size());
+  EXPECT_EQ(5u, stats.errors[0].line);
+  EXPECT_EQ("invalid deadline", stats.errors[0].message);
+  EXPECT_EQ(8u, stats.errors[3].line);
+  EXPECT_EQ(2u, Registry::instance().subjects.at("CS101")->getTaskCount());
+}
+
+TEST_F(BulkImportTest, StreamsFilesLargerThanOneBlock) {
+  std::string path = ::testing::TempDir() + "bulk_import_test.csv";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "S,HIST101,History,\n";
+    for (int i = 0; i < 1000; ++i) {
+      out << "T,HIST101,Essay " << i << ",,2030-01-01T00:00Z,2\n";
+    }
+    out << "T,HIST101,Broken,,2030-01-01T00:00Z\n";
+  }
+
+  BulkImporter::Options options;
+  options.blockBytes = 100;
+  options.chunkBytes = 64;
+  ImportStats stats = BulkImporter(Registry::instance(), options)
+                          .importFile(path);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(1u, stats.subjects);
+  EXPECT_EQ(1000u, stats.tasks);
+  ASSERT_EQ(1u, stats.errors.size());
+  EXPECT_EQ(1002u, stats.errors[0].line);
+  EXPECT_EQ(1000u, Registry::instance().countTasks(
+                       {std::nullopt, TaskType::Project}));
+}
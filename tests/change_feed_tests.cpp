@@ -0,0 +1,162 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/ChangeFeed.h"
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+namespace {
+
+std::vector<std::string> describe(const ChangeSet &set) {
+  static const char *types[] = {"created", "updated", "deleted"};
+  std::vector<std::string> result;
+  for (const auto &change : set.changes) {
+    std::string key =
+        change.subject.empty() ? change.key : change.subject + "/" + change.key;
+    result.push_back(key + " " + types[static_cast<int>(change.type)]);
+  }
+  return result;
+}
+
+} // namespace
+
+class ChangeFeedTest : public ::testing::Test {
+protected:
+  DateTime now;
+
+  void SetUp() override {
+    now = std::chrono::system_clock::now();
+    clearRegistry();
+
+    auto &registry = Registry::instance();
+    registry.createSubject("Mathematics", "MATH101", "");
+    registry.createTask("MATH101", "Algebra", "", now, 1);
+    registry.createTask("MATH101", "Midterm", "", now, 3);
+  }
+
+  void TearDown() override {
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().internships.clear();
+    Registry::instance().resumes.clear();
+    Registry::instance().publish();
+  }
+};
+
+TEST_F(ChangeFeedTest, ReportsNetChangesSinceAGeneration) {
+  auto &registry = Registry::instance();
+  std::uint64_t seen = registry.generation();
+  EXPECT_TRUE(registry.changesSince(seen).changes.empty());
+
+  registry.createSubject("Physics", "PHYS101", "");
+  registry.createTask("PHYS101", "Optics", "", now, 1);
+  registry.changeTaskState("MATH101", 0, 1);
+  registry.changeTaskState("MATH101", 0, 2);
+  auto math = registry.subjects.at("MATH101");
+  math->removeTask("Midterm");
+  math->addTask(ExamFactory().createTask("Midterm", now));
+  registry.createTask("PHYS101", "Scratch", "", now, 1);
+  registry.subjects.at("PHYS101")->removeTask("Scratch");
+  std::string resume = registry.createResume("CV", "<p/>");
+
+  ChangeSet set = registry.changesSince(seen);
+  EXPECT_TRUE(set.complete);
+  EXPECT_EQ(registry.generation(), set.generation);
+  // Scratch was created and deleted in between, so it is not reported; the
+  // Midterm that was replaced existed before and counts as updated.
+  EXPECT_EQ((std::vector<std::string>{"PHYS101 created",
+                                      "PHYS101/Optics created",
+                                      "MATH101/Algebra updated",
+                                      "MATH101/Midterm updated",
+                                      resume + " created"}),
+            describe(set));
+
+  EXPECT_TRUE(registry.changesSince(set.generation).changes.empty());
+  registry.subjects.at("PHYS101")->findTask("Optics")->setDeadline(now);
+  EXPECT_EQ((std::vector<std::string>{"PHYS101/Optics updated"}),
+            describe(registry.changesSince(set.generation)));
+}
+
+TEST_F(ChangeFeedTest, ReportsMarksAndDescriptionChanges) {
+  auto &registry = Registry::instance();
+  auto math = registry.subjects.at("MATH101");
+
+  std::uint64_t seen = registry.generation();
+  math->findTask("Algebra")->setMarks(7);
+  EXPECT_EQ((std::vector<std::string>{"MATH101/Algebra updated"}),
+            describe(registry.changesSince(seen)));
+
+  seen = registry.generation();
+  math->findTask("Midterm")->setDescription("Chapters 1-4");
+  EXPECT_EQ((std::vector<std::string>{"MATH101/Midterm updated"}),
+            describe(registry.changesSince(seen)));
+}
+
+TEST_F(ChangeFeedTest, ReportsARenameAsDeleteAndCreate) {
+  auto &registry = Registry::instance();
+  auto math = registry.subjects.at("MATH101");
+  std::uint64_t seen = registry.generation();
+
+  math->findTask("Algebra")->setTitle("Linear Algebra");
+  EXPECT_EQ((std::vector<std::string>{"MATH101/Algebra deleted",
+                                      "MATH101/Linear Algebra created"}),
+            describe(registry.changesSince(seen)));
+  EXPECT_EQ(0u, registry.stamp(EntityKind::Task, "Algebra", "MATH101"));
+  EXPECT_EQ(registry.generation(),
+            registry.stamp(EntityKind::Task, "Linear Algebra", "MATH101"));
+
+  // Neither a rename onto a taken title nor onto the same title is a change.
+  std::uint64_t renamed = registry.generation();
+  math->findTask("Midterm")->setTitle("Linear Algebra");
+  math->findTask("Midterm")->setTitle("Midterm");
+  EXPECT_TRUE(registry.changesSince(renamed).changes.empty());
+}
+
+TEST_F(ChangeFeedTest, StampsFollowTheLastChangeOfEachEntity) {
+  auto &registry = Registry::instance();
+  std::uint64_t algebra = registry.stamp(EntityKind::Task, "Algebra", "MATH101");
+  std::uint64_t midterm = registry.stamp(EntityKind::Task, "Midterm", "MATH101");
+  EXPECT_LT(registry.stamp(EntityKind::Subject, "MATH101"), algebra);
+  EXPECT_LT(algebra, midterm);
+  EXPECT_EQ(0u, registry.stamp(EntityKind::Task, "Algebra", "PHYS101"));
+
+  registry.changeTaskState("MATH101", 0, 1);
+  EXPECT_EQ(registry.generation(),
+            registry.stamp(EntityKind::Task, "Algebra", "MATH101"));
+  EXPECT_EQ(midterm, registry.stamp(EntityKind::Task, "Midterm", "MATH101"));
+
+  std::uint64_t before = registry.generation();
+  registry.subjects.erase("MATH101");
+  EXPECT_EQ(0u, registry.stamp(EntityKind::Subject, "MATH101"));
+  EXPECT_EQ(0u, registry.stamp(EntityKind::Task, "Algebra", "MATH101"));
+  EXPECT_EQ((std::vector<std::string>{"MATH101 deleted"}),
+            describe(registry.changesSince(before)));
+}
+
+TEST_F(ChangeFeedTest, OldGenerationsBecomeIncomplete) {
+  auto &registry = Registry::instance();
+  std::uint64_t seen = registry.generation();
+
+  registry.publish();
+  ChangeSet set = registry.changesSince(seen);
+  EXPECT_FALSE(set.complete);
+  EXPECT_TRUE(set.changes.empty());
+  EXPECT_TRUE(registry.changesSince(set.generation).complete);
+
+  ChangeFeed feed(2);
+  feed.record(EntityKind::Resume, ChangeType::Created, "R1");
+  feed.record(EntityKind::Resume, ChangeType::Created, "R2");
+  EXPECT_TRUE(feed.changesSince(0).complete);
+  feed.record(EntityKind::Resume, ChangeType::Updated, "R1");
+  EXPECT_FALSE(feed.changesSince(0).complete);
+  EXPECT_EQ(2u, feed.changesSince(1).changes.size());
+}
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/CommandExecutor.h"
+#include "../include/CommandManager.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+
+namespace {
+
+class FailingCommand : public Command {
+public:
+  void execute() override { throw std::runtime_error("refused"); }
+  void undo() override {}
+};
+
+class CommandExecutorTest : public ::testing::Test {
+protected:
+  DateTime deadline = std::chrono::system_clock::now();
+
+  void SetUp() override { std::cout.setstate(std::ios::failbit); }
+  void TearDown() override { std::cout.clear(); }
+};
+
+} // namespace
+
+TEST_F(CommandExecutorTest, AppliesEachProducersCommandsInOrder) {
+  constexpr int kProducers = 4;
+  constexpr int kCommands = 500;
+  const TaskStateKind targets[] = {TaskStateKind::InProgress,
+                                   TaskStateKind::Completed,
+                                   TaskStateKind::Pending};
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  for (int p = 0; p < kProducers; ++p) {
+    tasks.push_back(factory.createTask("Task " + std::to_string(p), deadline));
+  }
+
+  CommandManager history(kProducers * kCommands);
+  {
+    CommandExecutor executor(history);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+      producers.emplace_back([&, p] {
+        for (int i = 0; i < kCommands; ++i) {
+          executor.submit(
+              std::make_shared<SetTaskStateCommand>(*tasks[p], targets[i % 3]));
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    executor.flush().get();
+    EXPECT_EQ(static_cast<std::uint64_t>(kProducers * kCommands + 1),
+              executor.applied());
+    EXPECT_LE(executor.batches(), executor.applied());
+  }
+
+  for (const auto &task : tasks) {
+    EXPECT_EQ(targets[(kCommands - 1) % 3], task->getStateKind());
+  }
+  int undone = 0;
+  while (history.canUndo()) {
+    history.undoLastCommand();
+    ++undone;
+  }
+  EXPECT_EQ(kProducers * kCommands, undone);
+  for (const auto &task : tasks) {
+    EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+  }
+}
+
+TEST_F(CommandExecutorTest, ReportsFailuresThroughFutureAndCallback) {
+  auto task = LabFactory().createTask("Lab", deadline);
+  CommandManager history;
+  CommandExecutor executor(history);
+
+  EXPECT_THROW(executor.submit(std::make_shared<FailingCommand>()).get(),
+               std::runtime_error);
+
+  std::promise<std::exception_ptr> failure;
+  executor.submit(std::make_shared<FailingCommand>(),
+                  [&](std::exception_ptr error) { failure.set_value(error); });
+  EXPECT_NE(nullptr, failure.get_future().get());
+
+  std::promise<std::exception_ptr> success;
+  executor.submit(
+      std::make_shared<SetTaskStateCommand>(*task, TaskStateKind::Completed),
+      [&](std::exception_ptr error) { success.set_value(error); });
+  EXPECT_EQ(nullptr, success.get_future().get());
+  EXPECT_TRUE(task->isCompleted());
+}
+
+TEST_F(CommandExecutorTest, UndoAndRedoAreQueuedBehindCommands) {
+  auto task = LabFactory().createTask("Lab", deadline);
+  CommandManager history;
+  CommandExecutor executor(history);
+
+  executor.submit(
+      std::make_shared<SetTaskStateCommand>(*task, TaskStateKind::InProgress));
+  executor.submit(
+      std::make_shared<SetTaskStateCommand>(*task, TaskStateKind::Completed));
+  executor.submitUndo().get();
+  EXPECT_EQ(TaskStateKind::InProgress, task->getStateKind());
+  executor.submitRedo().get();
+  EXPECT_TRUE(task->isCompleted());
+}
+
+TEST_F(CommandExecutorTest, DestructorAppliesWhatIsStillQueued) {
+  auto task = LabFactory().createTask("Lab", deadline);
+  CommandManager history;
+  std::atomic<int> completed{0};
+  {
+    CommandExecutor executor(history);
+    for (int i = 0; i < 1000; ++i) {
+      executor.submit(std::make_shared<SetTaskStateCommand>(
+                          *task, i % 2 ? TaskStateKind::Completed
+                                       : TaskStateKind::InProgress),
+                      [&](std::exception_ptr) { ++completed; });
+    }
+  }
+  EXPECT_EQ(1000, completed.load());
+  EXPECT_TRUE(task->isCompleted());
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "../include/CommandManager.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+
+namespace {
+
+class AwaitingReviewState : public TaskState {
+public:
+  std::string getName() const override { return "Awaiting review"; }
+  TaskStateKind getKind() const override { return TaskStateKind::InProgress; }
+  float getConceptualProgress() const override { return 90.0f; }
+};
+
+class CommandHistoryTest : public ::testing::Test {
+protected:
+  std::shared_ptr<Task> task = LabFactory().createTask(
+      "History lab", std::chrono::system_clock::now());
+
+  void SetUp() override { std::cout.setstate(std::ios::failbit); }
+  void TearDown() override { std::cout.clear(); }
+};
+
+} // namespace
+
+TEST_F(CommandHistoryTest, UndoesAndRedoes) {
+  CommandManager history;
+  history.executeStateChange(*task, TaskStateKind::InProgress);
+  history.executeStateChange(*task, TaskStateKind::Completed);
+
+  history.undoLastCommand();
+  EXPECT_EQ(TaskStateKind::InProgress, task->getStateKind());
+  history.undoLastCommand();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+  EXPECT_FALSE(history.canUndo());
+
+  history.redoLastCommand();
+  history.redoLastCommand();
+  EXPECT_TRUE(task->isCompleted());
+  EXPECT_FALSE(history.canRedo());
+
+  // A new command discards what could be redone.
+  history.undoLastCommand();
+  history.executeStateChange(*task, TaskStateKind::Pending);
+  EXPECT_FALSE(history.canRedo());
+  history.redoLastCommand();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+}
+
+TEST_F(CommandHistoryTest, KeepsOnlyTheNewestCommands) {
+  CommandManager history(2);
+  history.executeStateChange(*task, TaskStateKind::InProgress);
+  history.executeStateChange(*task, TaskStateKind::Completed);
+  history.executeStateChange(*task, TaskStateKind::Pending);
+
+  history.undoLastCommand();
+  history.undoLastCommand();
+  EXPECT_FALSE(history.canUndo());
+  EXPECT_EQ(TaskStateKind::InProgress, task->getStateKind());
+
+  history.redoLastCommand();
+  history.setDepth(1);
+  EXPECT_EQ(1u, history.depth());
+  EXPECT_FALSE(history.canRedo());
+  history.undoLastCommand();
+  EXPECT_FALSE(history.canUndo());
+  EXPECT_EQ(TaskStateKind::InProgress, task->getStateKind());
+  EXPECT_THROW(history.setDepth(0), std::invalid_argument);
+}
+
+TEST_F(CommandHistoryTest, KeepsCommandsThatDoNotCompact) {
+  CommandManager history;
+  history.executeCommand(std::make_shared<SetTaskStateCommand>(
+      *task, std::make_shared<AwaitingReviewState>()));
+  history.executeStateChange(*task, TaskStateKind::Completed);
+
+  history.undoLastCommand();
+  EXPECT_EQ("Awaiting review", task->getStateName());
+  history.undoLastCommand();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+  history.redoLastCommand();
+  EXPECT_EQ("Awaiting review", task->getStateName());
+
+  // Records of a destroyed task are skipped rather than replayed.
+  history.redoLastCommand();
+  task.reset();
+  history.undoLastCommand();
+  history.redoLastCommand();
+}
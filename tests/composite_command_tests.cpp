@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/CompositeCommand.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskState.h"
+#include "../include/WriteAheadLog.h"
+
+namespace {
+
+class AwaitingReviewState : public TaskState {
+public:
+  std::string getName() const override { return "Awaiting review"; }
+  TaskStateKind getKind() const override { return TaskStateKind::InProgress; }
+  float getConceptualProgress() const override { return 90.0f; }
+};
+
+class CompositeCommandTest : public ::testing::Test {
+protected:
+  DateTime deadline =
+      std::chrono::system_clock::now() + std::chrono::hours(24);
+
+  void SetUp() override {
+    std::cout.setstate(std::ios::failbit);
+    clearRegistry();
+  }
+
+  void TearDown() override {
+    Registry::instance().attachLog(nullptr);
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+    std::cout.clear();
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().publish();
+  }
+};
+
+} // namespace
+
+TEST_F(CompositeCommandTest, OneUndoRevertsTheWholeBatch) {
+  LabFactory factory;
+  auto graded = factory.createTask("Graded", deadline);
+  auto reviewed = factory.createTask("Reviewed", deadline);
+  auto fresh = factory.createTask("Fresh", deadline);
+  graded->setStateKind(TaskStateKind::Completed);
+  graded->setMarks(85);
+  reviewed->setState(std::make_shared<AwaitingReviewState>());
+
+  CommandManager history;
+  auto batch = std::make_shared<CompositeCommand>();
+  batch->addStateChange(*graded, TaskStateKind::Pending);
+  batch->addStateChange(*reviewed, TaskStateKind::Completed);
+  batch->addStateChange(*fresh, TaskStateKind::InProgress);
+  ASSERT_TRUE(history.executeTransaction(batch));
+
+  EXPECT_EQ(TaskStateKind::Pending, graded->getStateKind());
+  EXPECT_EQ(0, graded->getMarks());
+  EXPECT_TRUE(reviewed->isCompleted());
+  EXPECT_EQ(TaskStateKind::InProgress, fresh->getStateKind());
+
+  history.undoLastCommand();
+  EXPECT_FALSE(history.canUndo());
+  EXPECT_TRUE(graded->isCompleted());
+  EXPECT_EQ(85, graded->getMarks());
+  EXPECT_EQ("Awaiting review", reviewed->getStateName());
+  EXPECT_EQ(TaskStateKind::Pending, fresh->getStateKind());
+
+  history.redoLastCommand();
+  EXPECT_EQ(TaskStateKind::Pending, graded->getStateKind());
+  EXPECT_TRUE(reviewed->isCompleted());
+  EXPECT_EQ(TaskStateKind::InProgress, fresh->getStateKind());
+}
+
+TEST_F(CompositeCommandTest, AppliesNothingIfATaskIsGone) {
+  LabFactory factory;
+  auto kept = factory.createTask("Kept", deadline);
+  auto dropped = factory.createTask("Dropped", deadline);
+
+  CommandManager history;
+  auto batch = std::make_shared<CompositeCommand>();
+  batch->addStateChange(*kept, TaskStateKind::Completed);
+  batch->addStateChange(*dropped, TaskStateKind::Completed);
+  dropped.reset();
+
+  EXPECT_FALSE(history.executeTransaction(batch));
+  EXPECT_FALSE(batch->applied());
+  EXPECT_FALSE(history.canUndo());
+  EXPECT_EQ(TaskStateKind::Pending, kept->getStateKind());
+}
+
+TEST_F(CompositeCommandTest, RegistryBatchIsOneVersionAndOneHistoryEntry) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  registry.createSubject("Physics", "PHYS101", "");
+  std::vector<std::pair<TaskId, int>> changes;
+  for (int i = 0; i < 3; ++i) {
+    changes.emplace_back(registry
+                             .createTask("CS101", "Lab " + std::to_string(i),
+                                         "", deadline, 1)
+                             ->getHandle(),
+                         2);
+  }
+  changes.emplace_back(
+      registry.createTask("PHYS101", "Kinematics", "", deadline, 1)
+          ->getHandle(),
+      1);
+  CommandManager::instance().clearHistory();
+
+  auto before = registry.snapshot();
+  ASSERT_TRUE(registry.changeTaskStates(changes));
+  auto after = registry.snapshot();
+  EXPECT_EQ(before->version + 1, after->version);
+  EXPECT_EQ("Completed",
+            after->findSubject("CS101")->findTask("Lab 2")->getStateName());
+  EXPECT_EQ("In Progress",
+            after->findSubject("PHYS101")->findTask("Kinematics")->getStateName());
+
+  // One step of the registry's own history undoes the whole batch.
+  ASSERT_TRUE(registry.undo());
+  EXPECT_FALSE(registry.commands().canUndo());
+  for (const auto &code : {"CS101", "PHYS101"}) {
+    registry.subjects.at(code)->forEachTask([](Task &task) {
+      EXPECT_EQ(TaskStateKind::Pending, task.getStateKind());
+    });
+  }
+}
+
+TEST_F(CompositeCommandTest, RegistryRejectsTheBatchIfAnyChangeIsInvalid) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  auto lab = registry.createTask("CS101", "Lab", "", deadline, 1);
+  auto loose = LabFactory().createTask("Loose", deadline);
+  const std::uint64_t version = registry.snapshot()->version;
+
+  EXPECT_FALSE(registry.changeTaskStates({{lab->getHandle(), 2},
+                                          {loose->getHandle(), 2}}));
+  EXPECT_FALSE(
+      registry.changeTaskStates({{lab->getHandle(), 2}, {lab->getHandle(), 7}}));
+  EXPECT_EQ(TaskStateKind::Pending, lab->getStateKind());
+  EXPECT_EQ(version, registry.snapshot()->version);
+  EXPECT_TRUE(registry.changeTaskStates({}));
+}
+
+TEST_F(CompositeCommandTest, BatchIsReplayedFromTheLog) {
+  std::string logPath = ::testing::TempDir() + "composite_command_test.log";
+  std::string snapshotPath =
+      ::testing::TempDir() + "composite_command_test.snap";
+  auto &registry = Registry::instance();
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    registry.createSubject("Computer Science", "CS101", "");
+    auto first = registry.createTask("CS101", "Lab 1", "", deadline, 1);
+    auto second = registry.createTask("CS101", "Lab 2", "", deadline, 1);
+    registry.checkpoint(snapshotPath);
+    ASSERT_TRUE(registry.changeTaskStates(
+        {{first->getHandle(), 2}, {second->getHandle(), 1}}));
+    registry.attachLog(nullptr);
+  }
+
+  registry.subjects.clear();
+  EXPECT_EQ(1u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  auto cs = registry.subjects.at("CS101");
+  EXPECT_EQ("Completed", cs->findTask("Lab 1")->getStateName());
+  EXPECT_EQ("In Progress", cs->findTask("Lab 2")->getStateName());
+  std::remove(logPath.c_str());
+  std::remove(snapshotPath.c_str());
+}
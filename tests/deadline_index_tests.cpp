@@ -0,0 +1,117 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/DeadlineIndex.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+namespace {
+
+std::vector<std::string> titles(const std::vector<DueTask> &due) {
+  std::vector<std::string> result;
+  for (const auto &entry : due) {
+    result.emplace_back(entry.task->getTitle());
+  }
+  return result;
+}
+
+} // namespace
+
+class DeadlineIndexTest : public ::testing::Test {
+protected:
+  DateTime now;
+
+  DateTime at(int hours) const { return now + std::chrono::hours(hours); }
+
+  void SetUp() override {
+    now = std::chrono::system_clock::now();
+    clearRegistry();
+
+    auto &registry = Registry::instance();
+    registry.createSubject("Mathematics", "MATH101", "");
+    registry.createSubject("Physics", "PHYS101", "");
+    registry.createTask("MATH101", "Algebra", "", at(-48), 1);
+    registry.createTask("MATH101", "Midterm", "", at(24), 3);
+    registry.createTask("PHYS101", "Kinematics", "", at(-2), 1);
+    registry.createTask("PHYS101", "Final", "", at(72), 3);
+  }
+
+  void TearDown() override {
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().internships.clear();
+    Registry::instance().resumes.clear();
+    Registry::instance().publish();
+  }
+};
+
+TEST_F(DeadlineIndexTest, RangeQueriesSpanSubjectsInDeadlineOrder) {
+  auto &registry = Registry::instance();
+
+  EXPECT_EQ((std::vector<std::string>{"Algebra", "Kinematics", "Midterm",
+                                      "Final"}),
+            titles(registry.tasksDueBetween(at(-100), at(100))));
+  EXPECT_EQ((std::vector<std::string>{"Kinematics", "Midterm"}),
+            titles(registry.tasksDueBetween(at(-2), at(72))));
+  EXPECT_TRUE(registry.tasksDueBetween(at(1), at(1)).empty());
+}
+
+TEST_F(DeadlineIndexTest, OverdueAndNextDueSkipCompletedTasks) {
+  auto &registry = Registry::instance();
+
+  EXPECT_EQ((std::vector<std::string>{"Algebra", "Kinematics"}),
+            titles(registry.overdue(now)));
+  EXPECT_EQ((std::vector<std::string>{"Midterm"}),
+            titles(registry.nextDue(1, now)));
+
+  registry.changeTaskState("MATH101", 0, 2);
+  registry.changeTaskState("MATH101", 1, 2);
+  EXPECT_EQ((std::vector<std::string>{"Kinematics"}),
+            titles(registry.overdue(now)));
+  EXPECT_EQ((std::vector<std::string>{"Final"}),
+            titles(registry.nextDue(5, now)));
+
+  registry.subjects.at("MATH101")->findTask("Algebra")->reopenTask();
+  EXPECT_EQ(2u, registry.overdue(now).size());
+}
+
+TEST_F(DeadlineIndexTest, FollowsDeadlineChangesAndRemovals) {
+  auto &registry = Registry::instance();
+  auto physics = registry.subjects.at("PHYS101");
+
+  physics->findTask("Final")->setDeadline(at(-100));
+  EXPECT_EQ((std::vector<std::string>{"Final", "Algebra", "Kinematics"}),
+            titles(registry.overdue(now)));
+
+  physics->removeTask("Final");
+  EXPECT_EQ(3u, registry.tasksDueBetween(at(-1000), at(1000)).size());
+
+  physics->addTask(LabFactory().createTask("Optics", at(5)));
+  EXPECT_EQ((std::vector<std::string>{"Optics"}),
+            titles(registry.tasksDueBetween(at(0), at(10))));
+}
+
+TEST_F(DeadlineIndexTest, DroppedSubjectsLeaveTheIndex) {
+  auto &registry = Registry::instance();
+
+  registry.subjects.erase("MATH101");
+  EXPECT_EQ((std::vector<std::string>{"Kinematics", "Final"}),
+            titles(registry.tasksDueBetween(at(-1000), at(1000))));
+
+  registry.subjects["CHEM101"] = std::make_shared<Subject>("Chem", "CHEM101");
+  registry.subjects.at("CHEM101")->addTask(
+      ExamFactory().createTask("Titration", at(10)));
+  EXPECT_EQ(2u, registry.tasksDueBetween(at(-1000), at(1000)).size());
+
+  registry.publish();
+  EXPECT_EQ(3u, registry.tasksDueBetween(at(-1000), at(1000)).size());
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "../include/CommandManager.h"
+#include "../include/Notification.h"
+#include "../include/Registry.h"
+#include "../include/SlotMap.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+
+TEST(HandleTest, StaleHandlesNeverResolveToANewOccupant) {
+  SlotMap<std::string, NotificationTag> slots;
+  NotificationId first = slots.insert("first");
+  ASSERT_NE(nullptr, slots.get(first));
+  EXPECT_EQ("first", *slots.get(first));
+  EXPECT_EQ(first, NotificationId::fromValue(first.value()));
+
+  EXPECT_TRUE(slots.erase(first));
+  EXPECT_FALSE(slots.erase(first));
+  NotificationId second = slots.insert("second");
+  EXPECT_EQ(first.index, second.index);
+  EXPECT_EQ(nullptr, slots.get(first));
+  EXPECT_EQ("second", *slots.get(second));
+  EXPECT_EQ(nullptr, slots.get(NotificationId()));
+  EXPECT_EQ(1u, slots.size());
+}
+
+TEST(HandleTest, TasksAndSubjectsResolveOnlyWhileAlive) {
+  auto deadline = std::chrono::system_clock::now();
+  auto task = LabFactory().createTask("Lab", deadline);
+  TaskId id = task->getHandle();
+  EXPECT_EQ(task.get(), Task::resolve(id));
+
+  {
+    Subject subject("Mathematics", "MATH101");
+    subject.addTask(task);
+    EXPECT_EQ(&subject, task->getSubject());
+    EXPECT_EQ(&subject, Subject::resolve(subject.getHandle()));
+  }
+  // The subject is gone; the task no longer points at freed memory.
+  EXPECT_EQ(nullptr, task->getSubject());
+
+  task.reset();
+  EXPECT_EQ(nullptr, Task::resolve(id));
+  auto next = LabFactory().createTask("Reuses the row", deadline);
+  EXPECT_EQ(id.index, next->getHandle().index);
+  EXPECT_EQ(nullptr, Task::resolve(id));
+  EXPECT_EQ(next.get(), Task::resolve(next->getHandle()));
+}
+
+TEST(HandleTest, CommandsOutlivingTheirTaskDoNothing) {
+  auto task = ExamFactory().createTask("Final", std::chrono::system_clock::now());
+  auto command = std::make_shared<SetTaskStateCommand>(
+      *task, std::make_shared<CompletedState>());
+
+  std::cout.setstate(std::ios::failbit);
+  command->execute();
+  EXPECT_TRUE(task->isCompleted());
+  task.reset();
+  command->undo();
+  command->execute();
+  std::cout.clear();
+}
+
+TEST(HandleTest, NotificationsAreOwnedByTheManager) {
+  auto &manager = NotificationManager::getInstance();
+  std::size_t before = manager.getNotifications().size();
+  auto task = ProjectFactory().createTask(
+      "Thesis", std::chrono::system_clock::now() + std::chrono::hours(48));
+
+  NotificationId id = manager.addNotification(
+      std::make_shared<DeadlineNotification>("Due soon", task, 1));
+  ASSERT_EQ(1u, task->getNotifications().size());
+  EXPECT_EQ(manager.find(id), task->getNotifications().front());
+  EXPECT_EQ(task.get(), manager.find(id)->getTask());
+
+  manager.removeNotification(before);
+  EXPECT_EQ(nullptr, manager.find(id));
+  EXPECT_TRUE(task->getNotifications().empty());
+  EXPECT_EQ(before, manager.getNotifications().size());
+}
+
+TEST(HandleTest, RegistryChangesTaskStateById) {
+  auto &registry = Registry::instance();
+  auto deadline = std::chrono::system_clock::now();
+  std::cout.setstate(std::ios::failbit);
+  registry.createSubject("Physics", "PHYS101", "");
+  registry.createTask("PHYS101", "Optics", "", deadline, 1);
+  auto mechanics = registry.createTask("PHYS101", "Mechanics", "", deadline, 1);
+  TaskId id = mechanics->getHandle();
+
+  // The id survives the removal that shifts the task's position.
+  registry.subjects.at("PHYS101")->removeTask("Optics");
+  EXPECT_TRUE(registry.changeTaskState(id, 2));
+  EXPECT_TRUE(mechanics->isCompleted());
+
+  // Snapshot tasks are copies and cannot be changed through their ids.
+  auto frozen = registry.snapshot()->findSubject("PHYS101")->findTask("Mechanics");
+  EXPECT_FALSE(registry.changeTaskState(frozen->getHandle(), 0));
+  EXPECT_FALSE(registry.changeTaskState(TaskId(), 0));
+  std::cout.clear();
+
+  registry.subjects.clear();
+  registry.publish();
+  CommandManager::instance().clearHistory();
+}
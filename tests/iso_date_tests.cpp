@@ -0,0 +1,58 @@
+#include <chrono>
+#include <ctime>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../include/IsoDate.h"
+
+namespace {
+
+std::string strftimeLocal(std::time_t time, const char *pattern) {
+  std::tm tm = {};
+#ifdef _WIN32
+  localtime_s(&tm, &time);
+#else
+  localtime_r(&time, &tm);
+#endif
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), pattern, &tm);
+  return buffer;
+}
+
+} // namespace
+
+TEST(IsoDateTest, CivilDaysRoundTrip) {
+  for (std::int64_t days = -800000; days <= 800000; days += 97) {
+    iso_date::CivilDate date = iso_date::civilFromDays(days);
+    EXPECT_EQ(days, iso_date::daysFromCivil(date.year, date.month, date.day));
+  }
+  EXPECT_EQ(0, iso_date::daysFromCivil(1970, 1, 1));
+  EXPECT_EQ(29u, iso_date::daysInMonth(2000, 2));
+  EXPECT_EQ(28u, iso_date::daysInMonth(1900, 2));
+}
+
+TEST(IsoDateTest, FormatMatchesTheCLibrary) {
+  // Every 7h13m from 1950 to 2100, which crosses DST changes in most zones.
+  for (std::time_t time = -631152000; time < 4102444800;
+       time += 7 * 3600 + 13 * 60) {
+    DateTime instant = std::chrono::system_clock::from_time_t(time);
+    ASSERT_EQ(strftimeLocal(time, "%Y-%m-%d %H:%M"),
+              iso_date::format(instant).view());
+    ASSERT_EQ(strftimeLocal(time, "%Y-%m-%dT%H:%M:%S"),
+              iso_date::format(instant, iso_date::DateStyle::Seconds).view());
+  }
+}
+
+TEST(IsoDateTest, ParsesWhatItFormats) {
+  DateTime deadline = std::chrono::system_clock::from_time_t(1767225600) +
+                      std::chrono::minutes(90) + std::chrono::milliseconds(5);
+  DateTime parsed;
+  ASSERT_TRUE(iso_date::parse(
+      iso_date::format(deadline, iso_date::DateStyle::Seconds).str(), parsed));
+  EXPECT_EQ(std::chrono::floor<std::chrono::seconds>(deadline), parsed);
+
+  // The console style, and the datetime-local inputs of the web UI.
+  ASSERT_TRUE(iso_date::parse(iso_date::format(deadline).view(), parsed));
+  EXPECT_EQ(std::chrono::floor<std::chrono::minutes>(deadline), parsed);
+  EXPECT_FALSE(iso_date::parse("2026-01-01T", parsed));
+}
@@ -0,0 +1,142 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/Notification.h"
+#include "../include/Task.h"
+
+namespace {
+
+// Trigger times in 1970, well away from the reminders other tests set up
+// around the current time in the shared manager.
+DateTime at(int hours) { return DateTime() + std::chrono::hours(hours); }
+
+class NotificationQueueTest : public ::testing::Test {
+protected:
+  NotificationManager &manager = NotificationManager::getInstance();
+  std::vector<NotificationId> added;
+
+  NotificationId add(const std::string &message, DateTime time,
+                     std::shared_ptr<Task> task = nullptr) {
+    added.push_back(manager.addNotification(
+        std::make_shared<Notification>(message, time, task)));
+    return added.back();
+  }
+
+  static std::vector<std::string>
+  messages(const std::vector<std::shared_ptr<Notification>> &notifications) {
+    std::vector<std::string> result;
+    for (const auto &notification : notifications) {
+      result.push_back(notification->getMessage());
+    }
+    return result;
+  }
+
+  void TearDown() override {
+    for (NotificationId id : added) {
+      manager.cancel(id);
+    }
+  }
+};
+
+} // namespace
+
+TEST_F(NotificationQueueTest, PollReturnsWhatIsDueInTriggerOrder) {
+  std::size_t scheduled = manager.scheduledCount();
+  add("third", at(30));
+  add("first", at(10));
+  add("later", at(1000));
+  add("second", at(20));
+
+  EXPECT_TRUE(manager.pollDue(at(5)).empty());
+  EXPECT_EQ((std::vector<std::string>{"first", "second", "third"}),
+            messages(manager.pollDue(at(40))));
+  // Fired notifications stay registered but are not polled again.
+  EXPECT_TRUE(manager.pollDue(at(40)).empty());
+  EXPECT_EQ(scheduled + 1, manager.scheduledCount());
+  EXPECT_NE(nullptr, manager.find(added[0]));
+}
+
+TEST_F(NotificationQueueTest, CancelAndRescheduleByHandle) {
+  auto task = LabFactory().createTask("Lab", at(100));
+  NotificationId a = add("a", at(10), task);
+  NotificationId b = add("b", at(20), task);
+  NotificationId c = add("c", at(30));
+
+  EXPECT_TRUE(manager.cancel(b));
+  EXPECT_FALSE(manager.cancel(b));
+  EXPECT_EQ(nullptr, manager.find(b));
+  ASSERT_EQ(1u, task->getNotifications().size());
+  EXPECT_EQ("a", task->getNotifications().front()->getMessage());
+
+  EXPECT_TRUE(manager.reschedule(c, at(5)));
+  EXPECT_TRUE(manager.reschedule(a, at(50)));
+  EXPECT_EQ((std::vector<std::string>{"c"}),
+            messages(manager.pollDue(at(40))));
+
+  // A fired notification is armed again by reschedule().
+  EXPECT_TRUE(manager.reschedule(c, at(45)));
+  EXPECT_EQ((std::vector<std::string>{"c", "a"}),
+            messages(manager.pollDue(at(60))));
+}
+
+TEST_F(NotificationQueueTest, TriggerTimesMovedLaterAreNoticed) {
+  NotificationId id = add("moved", at(10));
+  manager.find(id)->setTriggerTime(at(50));
+
+  EXPECT_TRUE(manager.pollDue(at(20)).empty());
+  EXPECT_EQ((std::vector<std::string>{"moved"}),
+            messages(manager.pollDue(at(50))));
+}
+
+TEST_F(NotificationQueueTest, DeadlineRemindersFollowTheTask) {
+  auto task = LabFactory().createTask("Lab", at(24 * 10));
+  added.push_back(manager.addNotification(
+      std::make_shared<DeadlineNotification>("Due", task, 2)));
+
+  task->setDeadline(at(24 * 20));
+  EXPECT_EQ(at(24 * 18), manager.find(added[0])->getTriggerTime());
+  EXPECT_TRUE(manager.pollDue(at(24 * 8 + 1)).empty());
+  EXPECT_EQ((std::vector<std::string>{"Due"}),
+            messages(manager.pollDue(at(24 * 18 + 1))));
+
+  // Past its one-day window a reminder is dropped without firing.
+  task->setDeadline(at(24 * 30));
+  EXPECT_TRUE(manager.pollDue(at(24 * 29 + 1)).empty());
+}
+
+TEST_F(NotificationQueueTest, RemindersCarryACopyOfTheirTask) {
+  auto task = ExamFactory().createTask("Final", at(24 * 10));
+  added.push_back(manager.addNotification(
+      std::make_shared<DeadlineNotification>("Due", task, 2)));
+  auto reminder = manager.find(added[0]);
+  std::size_t scheduled = manager.scheduledCount();
+
+  task->setTitle("Final exam");
+  auto details = reminder->getTaskDetails();
+  ASSERT_NE(nullptr, details);
+  EXPECT_EQ("Final exam", details->title);
+  EXPECT_EQ(at(24 * 10), details->deadline);
+
+  // Once the task is gone the reminder is disarmed rather than left to
+  // look for it when polled.
+  task.reset();
+  EXPECT_EQ(nullptr, reminder->getTaskDetails());
+  EXPECT_EQ(scheduled - 1, manager.scheduledCount());
+  EXPECT_TRUE(manager.pollDue(at(24 * 8 + 1)).empty());
+}
+
+TEST_F(NotificationQueueTest, IndexBasedRemovalSkipsCancelledEntries) {
+  std::size_t before = manager.getNotifications().size();
+  NotificationId first = add("first", at(10));
+  add("second", at(20));
+  add("third", at(30));
+
+  manager.cancel(first);
+  manager.removeNotification(before);
+  auto remaining = manager.getNotifications();
+  ASSERT_EQ(before + 1, remaining.size());
+  EXPECT_EQ("third", remaining.back()->getMessage());
+}
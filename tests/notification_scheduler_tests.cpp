@@ -0,0 +1,151 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Clock.h"
+#include "../include/Notification.h"
+#include "../include/NotificationScheduler.h"
+
+namespace {
+
+// Virtual time in 1970, like the queue tests, so the reminders other tests
+// leave in the shared manager are never due.
+DateTime at(int minutes) { return DateTime() + std::chrono::minutes(minutes); }
+
+class NotificationSchedulerTest : public ::testing::Test {
+protected:
+  NotificationManager &manager = NotificationManager::getInstance();
+  std::vector<NotificationId> added;
+
+  std::mutex mutex;
+  std::vector<NotificationFiring> fired;
+
+  NotificationScheduler::Sink recorder() {
+    return [this](const NotificationFiring &firing) {
+      std::lock_guard<std::mutex> lock(mutex);
+      fired.push_back(firing);
+    };
+  }
+
+  NotificationId add(const std::string &message, DateTime time) {
+    added.push_back(manager.addNotification(
+        std::make_shared<Notification>(message, time, nullptr)));
+    return added.back();
+  }
+
+  std::vector<std::string> messages() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> result;
+    for (const auto &firing : fired) {
+      result.push_back(firing.notification->getMessage());
+    }
+    return result;
+  }
+
+  bool firedMessage(const std::string &message) {
+    for (const std::string &seen : messages()) {
+      if (seen == message) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void TearDown() override {
+    for (NotificationId id : added) {
+      manager.cancel(id);
+    }
+  }
+};
+
+} // namespace
+
+TEST_F(NotificationSchedulerTest, FiresInVirtualTimeWithLatency) {
+  VirtualClock clock(at(0));
+  add("third", at(180));
+  add("first", at(60));
+  add("second", at(120));
+  NotificationScheduler scheduler({recorder()}, clock);
+
+  scheduler.sync();
+  EXPECT_TRUE(messages().empty());
+
+  clock.advance(std::chrono::minutes(90));
+  scheduler.sync();
+  ASSERT_EQ(std::vector<std::string>{"first"}, messages());
+  EXPECT_EQ(at(60), fired[0].due);
+  EXPECT_EQ(at(90), fired[0].fired);
+
+  clock.set(at(180));
+  scheduler.sync();
+  EXPECT_EQ((std::vector<std::string>{"first", "second", "third"}),
+            messages());
+  EXPECT_EQ(3u, scheduler.delivered());
+}
+
+TEST_F(NotificationSchedulerTest, EarlierNotificationWakesTheThread) {
+  VirtualClock clock(at(0));
+  add("later", at(600));
+  NotificationScheduler scheduler({recorder()}, clock);
+  scheduler.sync();
+
+  add("sooner", at(10));
+  clock.advance(std::chrono::minutes(10));
+  scheduler.sync();
+  EXPECT_EQ(std::vector<std::string>{"sooner"}, messages());
+}
+
+TEST_F(NotificationSchedulerTest, SleepsOnTheSystemClock) {
+  add("hourly", std::chrono::system_clock::now() + std::chrono::hours(1));
+  NotificationScheduler scheduler({recorder()});
+
+  // Inserted while the thread sleeps towards the hour.
+  auto due = std::chrono::system_clock::now() + std::chrono::milliseconds(20);
+  add("soon", due);
+  auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!firedMessage("soon") && std::chrono::steady_clock::now() < giveUp) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(firedMessage("soon"));
+  EXPECT_FALSE(firedMessage("hourly"));
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &firing : fired) {
+    if (firing.notification->getMessage() == "soon") {
+      EXPECT_EQ(due, firing.due);
+      EXPECT_FALSE(firing.fired < due);
+    }
+  }
+}
+
+TEST_F(NotificationSchedulerTest, EverySinkSeesEachFiringAndCancelledDoNot) {
+  VirtualClock clock(at(0));
+  int second = 0;
+  add("kept", at(5));
+  NotificationId dropped = add("dropped", at(5));
+  NotificationScheduler scheduler(
+      {recorder(), [&second](const NotificationFiring &) { ++second; }},
+      clock);
+
+  manager.cancel(dropped);
+  clock.advance(std::chrono::minutes(5));
+  scheduler.sync();
+  EXPECT_EQ(std::vector<std::string>{"kept"}, messages());
+  EXPECT_EQ(1, second);
+}
+
+TEST_F(NotificationSchedulerTest, OneSchedulerPerManager) {
+  VirtualClock clock(at(0));
+  {
+    NotificationScheduler scheduler({recorder()}, clock);
+    EXPECT_THROW(NotificationScheduler({recorder()}, clock), std::logic_error);
+  }
+  // Free again once the first is gone.
+  NotificationScheduler again({recorder()}, clock);
+  again.sync();
+}
@@ -0,0 +1,50 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "../include/ObjectPool.h"
+#include "../include/Task.h"
+#include "../include/TaskBuilder.h"
+
+TEST(ObjectPoolTest, RecyclesFreedBlocks) {
+  ObjectPool pool(40);
+  EXPECT_EQ(48u, pool.blockSize());
+
+  void *first = pool.allocate();
+  void *second = pool.allocate();
+  EXPECT_EQ(static_cast<char *>(first) + 48, second);
+  EXPECT_EQ(2u, pool.live());
+
+  pool.deallocate(first);
+  EXPECT_EQ(first, pool.allocate());
+  pool.deallocate(first);
+  pool.deallocate(second);
+  EXPECT_EQ(0u, pool.live());
+  EXPECT_EQ(ObjectPool::kSlabBytes - ObjectPool::kSlabBytes % 48,
+            pool.reservedBytes());
+}
+
+TEST(ObjectPoolTest, FactoryTasksReuseTheirBlocks) {
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory factory;
+  auto task = factory.createTask("Pooled lab", deadline);
+  const Task *address = task.get();
+  task.reset();
+
+  task = factory.createTask("Pooled lab", deadline);
+  EXPECT_EQ(address, task.get());
+  auto copy = task->clone();
+  EXPECT_EQ("Pooled lab", copy->getTitle());
+  EXPECT_EQ("Lab", copy->getType());
+}
+
+TEST(ObjectPoolTest, BuilderSharesFactories) {
+  TaskBuilder builder;
+  auto lab = builder.setTitle("Built lab").asLab().build();
+  auto exam = builder.asExam().build();
+  auto again = builder.asLab().build();
+  EXPECT_EQ("Lab", lab->getType());
+  EXPECT_EQ("Exam", exam->getType());
+  EXPECT_EQ("Lab", again->getType());
+}
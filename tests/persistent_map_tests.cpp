@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/PersistentMap.h"
+#include "../include/SymbolTable.h"
+
+namespace {
+
+using Map = PersistentMap<int>;
+
+std::shared_ptr<const int> boxed(int value) {
+  return std::make_shared<const int>(value);
+}
+
+std::map<std::string, int> contents(const Map &map) {
+  std::map<std::string, int> result;
+  for (const auto &[key, value] : map) {
+    result.emplace(key, *value);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(PersistentMapTest, CopiesAreUnaffectedByLaterChanges) {
+  Map first;
+  first.set("CS101", boxed(1));
+  first.set("MATH101", boxed(2));
+
+  Map second = first;
+  EXPECT_TRUE(second.shares(first));
+  second.set("CS101", boxed(10));
+  second.set("PHYS101", boxed(3));
+  EXPECT_EQ(1u, second.erase("MATH101"));
+  EXPECT_EQ(0u, second.erase("MATH101"));
+
+  EXPECT_EQ((std::map<std::string, int>{{"CS101", 1}, {"MATH101", 2}}),
+            contents(first));
+  EXPECT_EQ((std::map<std::string, int>{{"CS101", 10}, {"PHYS101", 3}}),
+            contents(second));
+  EXPECT_EQ(2u, second.size());
+  EXPECT_EQ(nullptr, second.find("MATH101"));
+  EXPECT_FALSE(second.shares(first));
+}
+
+TEST(PersistentMapTest, MatchesAStdMapUnderRandomEdits) {
+  std::mt19937 rng(7);
+  std::map<std::string, int> model;
+  Map map;
+  std::vector<Map> versions;
+  std::vector<std::map<std::string, int>> models;
+
+  for (int step = 0; step < 20000; ++step) {
+    std::string key = "key_" + std::to_string(rng() % 3000);
+    if (rng() % 3 == 0) {
+      EXPECT_EQ(model.erase(key), map.erase(key));
+    } else {
+      int value = static_cast<int>(rng() % 1000);
+      model[key] = value;
+      map.set(key, boxed(value));
+    }
+    if (step % 2000 == 0) {
+      versions.push_back(map);
+      models.push_back(model);
+    }
+  }
+
+  EXPECT_EQ(model.size(), map.size());
+  EXPECT_EQ(model, contents(map));
+  for (const auto &[key, value] : model) {
+    ASSERT_NE(nullptr, map.find(key));
+    EXPECT_EQ(value, *map.find(key));
+  }
+  for (std::size_t i = 0; i < versions.size(); ++i) {
+    EXPECT_EQ(models[i], contents(versions[i]));
+  }
+}
+
+TEST(PersistentMapTest, DiffReportsOnlyChangedKeys) {
+  Map before;
+  for (int i = 0; i < 5000; ++i) {
+    before.set("subject_" + std::to_string(i), boxed(i));
+  }
+  Map after = before;
+  after.set("subject_7", boxed(-7));
+  after.erase("subject_42");
+  after.set("subject_new", boxed(1));
+
+  std::map<std::string, std::pair<int, int>> changes;
+  Map::diff(before, after,
+            [&](const std::string &key, const std::shared_ptr<const int> &old,
+                const std::shared_ptr<const int> &now) {
+              changes[key] = {old ? *old : -1000, now ? *now : -1000};
+            });
+
+  EXPECT_EQ((std::map<std::string, std::pair<int, int>>{
+                {"subject_42", {42, -1000}},
+                {"subject_7", {7, -7}},
+                {"subject_new", {-1000, 1}}}),
+            changes);
+}
+
+TEST(PersistentMapTest, KeysWithCollidingHashesStayDistinct) {
+  std::unordered_map<std::uint32_t, std::string> seen;
+  std::string a, b;
+  for (int i = 0; a.empty(); ++i) {
+    std::string key = "k" + std::to_string(i);
+    auto [it, inserted] = seen.emplace(SymbolTable::hash(key), key);
+    if (!inserted) {
+      a = it->second;
+      b = key;
+    }
+  }
+
+  Map map;
+  map.set(a, boxed(1));
+  map.set(b, boxed(2));
+  map.set("other", boxed(3));
+  EXPECT_EQ(1, *map.find(a));
+  EXPECT_EQ(2, *map.find(b));
+
+  Map before = map;
+  EXPECT_EQ(1u, map.erase(a));
+  EXPECT_EQ(nullptr, map.find(a));
+  EXPECT_EQ(2, *map.find(b));
+  EXPECT_EQ(2u, map.size());
+
+  int reported = 0;
+  Map::diff(before, map,
+            [&](const std::string &key, const std::shared_ptr<const int> &,
+                const std::shared_ptr<const int> &now) {
+              EXPECT_EQ(a, key);
+              EXPECT_EQ(nullptr, now);
+              ++reported;
+            });
+  EXPECT_EQ(1, reported);
+}
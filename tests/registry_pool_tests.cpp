@@ -0,0 +1,92 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/RegistryPool.h"
+#include "../include/Subject.h"
+
+class RegistryPoolTest : public ::testing::Test {
+protected:
+  void TearDown() override {
+    Registry::instance().subjects.clear();
+    Registry::instance().publish();
+    CommandManager::instance().clearHistory();
+  }
+};
+
+TEST_F(RegistryPoolTest, StudentsHaveIndependentRegistries) {
+  RegistryPool pool(3);
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(1);
+
+  for (const std::string student : {"alice", "bob"}) {
+    pool.run(student, [&](Registry &registry) {
+      registry.createSubject("Mathematics", "MATH101", "");
+      registry.createTask("MATH101", "Homework " + student, "", deadline, 1);
+    });
+  }
+  pool.run("alice", [](Registry &registry) {
+    registry.changeTaskState("MATH101", 0, 2);
+  });
+
+  auto aliceTitle = pool.run("alice", [](Registry &registry) {
+    return registry.subjects.at("MATH101")->getTasks().front()->getTitle();
+  });
+  EXPECT_EQ("Homework alice", aliceTitle);
+  EXPECT_FALSE(pool.run("bob", [](Registry &registry) {
+    return registry.countTasks({TaskStateKind::Completed}) != 0;
+  }));
+  // Each shard steps back through its own versions only.
+  EXPECT_TRUE(pool.run("alice", [](Registry &registry) {
+    return registry.undo() &&
+           registry.countTasks({TaskStateKind::Completed}) == 0;
+  }));
+  EXPECT_FALSE(pool.run("bob", [](Registry &registry) {
+    return registry.canRedo() || registry.commands().canUndo();
+  }));
+  EXPECT_FALSE(CommandManager::instance().canUndo());
+  EXPECT_EQ(0u, Registry::instance().subjects.size());
+}
+
+TEST_F(RegistryPoolTest, DefaultStudentIsTheSingleton) {
+  RegistryPool pool(2);
+  Registry *shard = pool.run(RegistryPool::kDefaultStudent,
+                             [](Registry &registry) { return &registry; });
+  EXPECT_EQ(&Registry::instance(), shard);
+  EXPECT_EQ(&CommandManager::instance(), &shard->commands());
+  EXPECT_NE(shard, pool.run("carol", [](Registry &r) { return &r; }));
+}
+
+TEST_F(RegistryPoolTest, OneThreadPerStudentInSubmissionOrder) {
+  RegistryPool pool(4);
+  std::vector<std::future<std::thread::id>> threads;
+  std::vector<int> order;
+  for (int i = 0; i < 100; ++i) {
+    threads.push_back(pool.submit("dave", [&order, i](Registry &) {
+      order.push_back(i);
+      return std::this_thread::get_id();
+    }));
+  }
+
+  std::thread::id first = threads.front().get();
+  for (std::size_t i = 1; i < threads.size(); ++i) {
+    EXPECT_EQ(first, threads[i].get());
+  }
+  EXPECT_NE(std::this_thread::get_id(), first);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
+
+TEST_F(RegistryPoolTest, ExceptionsReachTheCaller) {
+  RegistryPool pool(1);
+  auto failed = pool.submit("erin", [](Registry &) -> int {
+    throw std::runtime_error("boom");
+  });
+  EXPECT_THROW(failed.get(), std::runtime_error);
+  EXPECT_EQ(7, pool.run("erin", [](Registry &) { return 7; }));
+}
@@ -0,0 +1,254 @@
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "../include/CommandManager.h"
+#include "../include/Notification.h"
+#include "../include/Registry.h"
+#include "../include/RegistryVersion.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/WriteAheadLog.h"
+
+class RegistryUndoTest : public ::testing::Test {
+protected:
+  DateTime deadline =
+      std::chrono::system_clock::now() + std::chrono::hours(24);
+
+  void SetUp() override {
+    std::cout.setstate(std::ios::failbit);
+    clearRegistry();
+  }
+
+  void TearDown() override {
+    Registry::instance().attachLog(nullptr);
+    Registry::instance().setHistoryDepth(Registry::kDefaultHistoryDepth);
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+    std::cout.clear();
+  }
+
+  static void clearRegistry() {
+    auto &registry = Registry::instance();
+    registry.subjects.clear();
+    registry.internships.clear();
+    registry.resumes.clear();
+    registry.publish();
+  }
+};
+
+TEST_F(RegistryUndoTest, UndoesAndRedoesWholeMutations) {
+  auto &registry = Registry::instance();
+  EXPECT_FALSE(registry.canUndo());
+  registry.createSubject("Computer Science", "CS101", "");
+  registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  std::string resumeId = registry.createResume("CV", "<p></p>");
+
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ(0u, registry.resumes.count(resumeId));
+  EXPECT_EQ(nullptr, registry.snapshot()->findResume(resumeId));
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ(0u, registry.subjects.at("CS101")->getTaskCount());
+  EXPECT_TRUE(
+      registry.snapshot()->findSubject("CS101")->getTasks().empty());
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ(0u, registry.subjects.count("CS101"));
+  EXPECT_FALSE(registry.undo());
+
+  ASSERT_TRUE(registry.redo());
+  ASSERT_TRUE(registry.redo());
+  ASSERT_NE(nullptr, registry.subjects.at("CS101")->findTask("Lab 1"));
+  ASSERT_NE(nullptr, registry.snapshot()->findSubject("CS101"));
+  EXPECT_TRUE(registry.canRedo());
+
+  // A new mutation drops what could be redone.
+  registry.createTask("CS101", "Lab 2", "", deadline, 1);
+  EXPECT_FALSE(registry.canRedo());
+  EXPECT_EQ(0u, registry.resumes.count(resumeId));
+}
+
+TEST_F(RegistryUndoTest, RestoredSubjectsAreLiveAndIndexed) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  registry.changeTaskState("CS101", 0, 2);
+
+  ASSERT_TRUE(registry.undo());
+  auto lab = registry.subjects.at("CS101")->findTask("Lab 1");
+  ASSERT_NE(nullptr, lab);
+  EXPECT_EQ("Pending", lab->getStateName());
+  EXPECT_EQ(1u, registry.overdue(deadline + std::chrono::hours(1)).size());
+
+  // The restored task takes further mutations like any other.
+  EXPECT_TRUE(registry.changeTaskState(lab->getHandle(), 1));
+  EXPECT_EQ("In Progress", registry.snapshot()
+                               ->findSubject("CS101")
+                               ->findTask("Lab 1")
+                               ->getStateName());
+}
+
+TEST_F(RegistryUndoTest, UndoAndRedoChangeTasksInPlace) {
+  auto &registry = Registry::instance();
+  auto &manager = NotificationManager::getInstance();
+  registry.createSubject("Computer Science", "CS101", "");
+  auto lab = registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  auto exam = registry.createTask("CS101", "Final", "", deadline, 3);
+  NotificationId reminder = manager.addNotification(
+      std::make_shared<DeadlineNotification>("Due", lab, 1));
+  TaskId examId = exam->getHandle();
+
+  ASSERT_TRUE(registry.changeTaskState(examId, 2));
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ("Pending", exam->getStateName());
+  ASSERT_TRUE(registry.redo());
+  EXPECT_EQ("Completed", exam->getStateName());
+
+  // Neither task was replaced, and the untouched one kept its reminder.
+  auto cs = registry.subjects.at("CS101");
+  EXPECT_EQ(lab, cs->findTask("Lab 1"));
+  EXPECT_EQ(exam.get(), Task::resolve(examId));
+  ASSERT_EQ(1u, lab->getNotifications().size());
+  ASSERT_NE(nullptr, manager.find(reminder)->getTaskDetails());
+  EXPECT_EQ("Lab 1", manager.find(reminder)->getTaskDetails()->title);
+  manager.cancel(reminder);
+}
+
+TEST_F(RegistryUndoTest, SnapshotsNameTheLiveTasksAcrossUndo) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  auto lab = registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  ASSERT_TRUE(registry.changeTaskState(lab->getHandle(), 2));
+
+  auto liveTask = [&registry] {
+    TaskId id = registry.snapshot()->findSubject("CS101")->findLiveId("Lab 1");
+    return Task::resolve(id);
+  };
+  EXPECT_EQ(lab.get(), liveTask());
+
+  // Redo creates the task again, and the version after it still holds the
+  // first task's id; both are made to name the new one.
+  ASSERT_TRUE(registry.undo());
+  ASSERT_TRUE(registry.undo());
+  ASSERT_TRUE(registry.redo());
+  auto again = registry.subjects.at("CS101")->findTask("Lab 1");
+  ASSERT_NE(lab, again);
+  EXPECT_EQ(again.get(), liveTask());
+  ASSERT_TRUE(registry.redo());
+  EXPECT_EQ(again.get(), liveTask());
+  EXPECT_EQ("Completed", again->getStateName());
+
+  // The same holds for a subject that is thawed whole.
+  ASSERT_TRUE(registry.undo());
+  ASSERT_TRUE(registry.undo());
+  ASSERT_TRUE(registry.undo());
+  ASSERT_TRUE(registry.redo());
+  ASSERT_TRUE(registry.redo());
+  ASSERT_TRUE(registry.redo());
+  EXPECT_EQ(registry.subjects.at("CS101")->findTask("Lab 1").get(),
+            liveTask());
+  EXPECT_TRUE(registry.changeTaskState(
+      registry.snapshot()->findSubject("CS101")->findLiveId("Lab 1"), 0));
+}
+
+TEST_F(RegistryUndoTest, OlderVersionsShareUnchangedEntries) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Mathematics", "MATH101", "");
+  registry.createSubject("Physics", "PHYS101", "");
+  auto before = registry.snapshot();
+  registry.createTask("PHYS101", "Kinematics", "", deadline, 1);
+
+  ASSERT_TRUE(registry.undo());
+  auto after = registry.snapshot();
+  EXPECT_LT(before->version, after->version);
+  EXPECT_TRUE(after->subjects.shares(before->subjects));
+  EXPECT_EQ(before->findSubject("MATH101"), after->findSubject("MATH101"));
+}
+
+TEST_F(RegistryUndoTest, KeepsOnlyTheConfiguredDepth) {
+  auto &registry = Registry::instance();
+  registry.setHistoryDepth(2);
+  registry.createSubject("A", "A1", "");
+  registry.createSubject("B", "B1", "");
+  registry.createSubject("C", "C1", "");
+
+  EXPECT_TRUE(registry.undo());
+  EXPECT_TRUE(registry.undo());
+  EXPECT_FALSE(registry.undo());
+  EXPECT_EQ(1u, registry.subjects.size());
+  EXPECT_THROW(registry.setHistoryDepth(0), std::invalid_argument);
+}
+
+TEST_F(RegistryUndoTest, StateChangesAreNotRecordedAsCommands) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  auto lab = registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  registry.changeTaskState("CS101", 0, 2);
+  registry.changeTaskStates({{lab->getHandle(), 1}});
+
+  // Only the registry's versions can undo them, so there is one history.
+  EXPECT_FALSE(registry.commands().canUndo());
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ("Completed",
+            registry.subjects.at("CS101")->findTask("Lab 1")->getStateName());
+  ASSERT_TRUE(registry.undo());
+  EXPECT_EQ("Pending",
+            registry.subjects.at("CS101")->findTask("Lab 1")->getStateName());
+}
+
+TEST_F(RegistryUndoTest, HistoryDepthIsReplayedFromTheLog) {
+  std::string logPath = ::testing::TempDir() + "registry_depth_test.log";
+  std::string snapshotPath = ::testing::TempDir() + "registry_depth_test.snap";
+  auto &registry = Registry::instance();
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    registry.createSubject("A", "A1", "");
+    registry.setHistoryDepth(1);
+    // The checkpoint empties the log and logs the depth again.
+    registry.checkpoint(snapshotPath);
+    registry.createSubject("B", "B1", "");
+    registry.createSubject("C", "C1", "");
+    registry.attachLog(nullptr);
+  }
+
+  clearRegistry();
+  registry.setHistoryDepth(Registry::kDefaultHistoryDepth);
+  EXPECT_EQ(3u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  EXPECT_EQ(1u, registry.historyDepth());
+  EXPECT_TRUE(registry.undo());
+  EXPECT_FALSE(registry.undo());
+  EXPECT_EQ(2u, registry.subjects.size());
+  std::remove(logPath.c_str());
+  std::remove(snapshotPath.c_str());
+}
+
+TEST_F(RegistryUndoTest, UndoIsReplayedFromTheLog) {
+  std::string logPath = ::testing::TempDir() + "registry_undo_test.log";
+  std::string snapshotPath = ::testing::TempDir() + "registry_undo_test.snap";
+  auto &registry = Registry::instance();
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    registry.createSubject("Computer Science", "CS101", "");
+    registry.checkpoint(snapshotPath);
+    EXPECT_FALSE(registry.canUndo());
+
+    registry.createTask("CS101", "Lab 1", "", deadline, 1);
+    registry.createTask("CS101", "Lab 2", "", deadline, 1);
+    ASSERT_TRUE(registry.undo());
+    ASSERT_TRUE(registry.undo());
+    ASSERT_TRUE(registry.redo());
+    registry.attachLog(nullptr);
+  }
+
+  clearRegistry();
+  EXPECT_EQ(5u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  auto cs = registry.subjects.at("CS101");
+  EXPECT_EQ(1u, cs->getTaskCount());
+  EXPECT_NE(nullptr, cs->findTask("Lab 1"));
+  EXPECT_TRUE(registry.canRedo());
+  std::remove(logPath.c_str());
+  std::remove(snapshotPath.c_str());
+}
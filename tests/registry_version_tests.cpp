@@ -0,0 +1,191 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/Notification.h"
+#include "../include/PerformanceStrategy.h"
+#include "../include/ProfilePerformanceCalculator.h"
+#include "../include/Registry.h"
+#include "../include/RegistryVersion.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+class RegistryVersionTest : public ::testing::Test {
+protected:
+  DateTime deadline;
+
+  void SetUp() override {
+    deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+    clearRegistry();
+  }
+
+  void TearDown() override {
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+  }
+
+  static void clearRegistry() {
+    auto &registry = Registry::instance();
+    registry.subjects.clear();
+    registry.internships.clear();
+    registry.resumes.clear();
+    registry.publish();
+  }
+};
+
+TEST_F(RegistryVersionTest, FrozenTasksAreReadOnlyAndLeaveNotificationsAlone) {
+  auto &registry = Registry::instance();
+  auto &manager = NotificationManager::getInstance();
+  registry.createSubject("Computer Science", "CS101", "Intro");
+  auto live = registry.createTask("CS101", "Lab 1", "Python", deadline, 1);
+  NotificationId reminder = manager.addNotification(
+      std::make_shared<DeadlineNotification>("Due", live, 1));
+
+  auto frozen = registry.snapshot()->findSubject("CS101")->findTask("Lab 1");
+  static_assert(std::is_same<decltype(frozen),
+                             std::shared_ptr<const Task>>::value,
+                "published tasks must not be changed through a snapshot");
+  EXPECT_TRUE(frozen->isFrozen());
+  EXPECT_FALSE(live->isFrozen());
+  EXPECT_NE(live->getHandle(), frozen->getHandle());
+  EXPECT_TRUE(frozen->getNotifications().empty());
+
+  // Dropping the versions holding the frozen copy leaves the live task's
+  // reminder as it was.
+  registry.changeTaskState("CS101", 0, 1);
+  frozen.reset();
+  registry.publish();
+  ASSERT_EQ(1u, live->getNotifications().size());
+  EXPECT_EQ("Lab 1", manager.find(reminder)->getTaskDetails()->title);
+  manager.cancel(reminder);
+}
+
+TEST_F(RegistryVersionTest, ReadersKeepTheVersionTheyTook) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "Intro");
+  registry.createTask("CS101", "Lab 1", "Python", deadline, 1);
+
+  auto before = registry.snapshot();
+  registry.createTask("CS101", "Lab 2", "Lists", deadline, 1);
+  registry.changeTaskState("CS101", 0, 2);
+  auto after = registry.snapshot();
+
+  EXPECT_LT(before->version, after->version);
+  ASSERT_NE(nullptr, before->findSubject("CS101"));
+  EXPECT_EQ(1u, before->findSubject("CS101")->getTasks().size());
+  EXPECT_EQ("Pending",
+            before->findSubject("CS101")->findTask("Lab 1")->getStateName());
+
+  EXPECT_EQ(2u, after->findSubject("CS101")->getTasks().size());
+  EXPECT_EQ("Completed",
+            after->findSubject("CS101")->findTask("Lab 1")->getStateName());
+}
+
+TEST_F(RegistryVersionTest, UnchangedEntriesAreSharedBetweenVersions) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Mathematics", "MATH101", "");
+  registry.createSubject("Physics", "PHYS101", "");
+  std::string resumeId = registry.createResume("CV", "<p></p>");
+
+  auto before = registry.snapshot();
+  registry.createTask("PHYS101", "Kinematics", "", deadline, 1);
+  auto after = registry.snapshot();
+
+  EXPECT_EQ(before->findSubject("MATH101"), after->findSubject("MATH101"));
+  EXPECT_EQ(before->findResume(resumeId), after->findResume(resumeId));
+  EXPECT_NE(before->findSubject("PHYS101"), after->findSubject("PHYS101"));
+}
+
+TEST_F(RegistryVersionTest, DirectEditsAppearAfterPublish) {
+  auto &registry = Registry::instance();
+  registry.subjects["CS101"] = std::make_shared<Subject>("CS", "CS101");
+  EXPECT_EQ(nullptr, registry.snapshot()->findSubject("CS101"));
+
+  registry.publish();
+  auto subject = registry.snapshot()->findSubject("CS101");
+  ASSERT_NE(nullptr, subject);
+  // A frozen copy: later direct edits stay out of it.
+  registry.subjects.at("CS101")->addTask(
+      LabFactory().createTask("Lab 1", deadline));
+  EXPECT_EQ(0u, subject->getTaskCount());
+}
+
+TEST_F(RegistryVersionTest, ChangingATaskCopiesOnlyThatTask) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  for (int i = 0; i < 100; ++i) {
+    registry.createTask("CS101", "Lab " + std::to_string(i), "", deadline, 1);
+  }
+  auto before = registry.snapshot()->findSubject("CS101");
+  registry.changeTaskState("CS101", 42, 2);
+  auto after = registry.snapshot()->findSubject("CS101");
+
+  EXPECT_EQ(before->findTask("Lab 41"), after->findTask("Lab 41"));
+  EXPECT_NE(before->findTask("Lab 42"), after->findTask("Lab 42"));
+  EXPECT_EQ("Pending", before->findTask("Lab 42")->getStateName());
+  EXPECT_EQ("Completed", after->findTask("Lab 42")->getStateName());
+  // Frozen tasks belong to no subject and keep the live order.
+  EXPECT_EQ(nullptr, after->findTask("Lab 42")->getSubject());
+  ASSERT_EQ(100u, after->taskView().size());
+  EXPECT_EQ("Lab 0", after->taskView()[0]->getTitle());
+  EXPECT_EQ("Lab 42", after->taskView()[42]->getTitle());
+  EXPECT_EQ("Lab 99", after->taskView()[99]->getTitle());
+}
+
+TEST_F(RegistryVersionTest, PerformanceIsComputedOnAVersion) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  registry.createTask("CS101", "Lab 1", "", deadline, 1);
+  registry.createTask("CS101", "Lab 2", "", deadline, 1);
+  registry.changeTaskState("CS101", 0, 2);
+
+  auto version = registry.snapshot();
+  registry.changeTaskState("CS101", 1, 2);
+
+  ProfilePerformanceCalculator calculator(
+      std::make_unique<CompletionRateStrategy>());
+  EXPECT_DOUBLE_EQ(50.0, version->accept(calculator));
+  EXPECT_DOUBLE_EQ(100.0, registry.accept(calculator));
+}
+
+TEST_F(RegistryVersionTest, ConcurrentReadersSeeMonotonicConsistentVersions) {
+  auto &registry = Registry::instance();
+  registry.createSubject("Computer Science", "CS101", "");
+  const std::uint64_t base = registry.snapshot()->version;
+
+  std::atomic<bool> done{false};
+  std::atomic<int> violations{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r) {
+    readers.emplace_back([&] {
+      std::uint64_t last = 0;
+      while (!done.load()) {
+        auto version = registry.snapshot();
+        auto subject = version->findSubject("CS101");
+        // Every version after base adds exactly one task.
+        if (version->version < last || !subject ||
+            subject->getTasks().size() != version->version - base) {
+          ++violations;
+        }
+        last = version->version;
+      }
+    });
+  }
+
+  for (int i = 0; i < 200; ++i) {
+    registry.createTask("CS101", "Task " + std::to_string(i), "", deadline, 1);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(0, violations.load());
+  EXPECT_EQ(200u, registry.snapshot()->findSubject("CS101")->getTasks().size());
+}
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/Notification.h"
+#include "../include/Registry.h"
+#include "../include/ReminderRule.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+namespace {
+
+// "<task title> <days before>" for each reminder the rule handed out.
+std::vector<std::string>
+describe(const std::vector<DueNotification> &due,
+         const std::string &message = "Exam soon") {
+  std::vector<std::string> result;
+  for (const auto &entry : due) {
+    auto reminder =
+        std::dynamic_pointer_cast<DeadlineNotification>(entry.notification);
+    if (!reminder || reminder->getMessage() != message) {
+      continue;
+    }
+    EXPECT_EQ(reminder->getTriggerTime(), entry.due);
+    result.push_back(reminder->getTaskDetails()->title + " " +
+                     std::to_string(reminder->getDaysBeforeDeadline()));
+  }
+  return result;
+}
+
+} // namespace
+
+class ReminderRuleTest : public ::testing::Test {
+protected:
+  DateTime now;
+  std::vector<NotificationId> added;
+
+  DateTime days(double count) const {
+    return now + std::chrono::duration_cast<DateTime::duration>(
+                     std::chrono::duration<double>(count * 86400));
+  }
+
+  TaskFilter exams() const {
+    TaskFilter filter;
+    filter.type = TaskType::Exam;
+    return filter;
+  }
+
+  void SetUp() override {
+    now = std::chrono::floor<std::chrono::seconds>(
+        std::chrono::system_clock::now());
+    clearRegistry();
+
+    auto &registry = Registry::instance();
+    registry.createSubject("Mathematics", "MATH101", "");
+    registry.createSubject("Physics", "PHYS101", "");
+    registry.createTask("MATH101", "Algebra", "", days(5), 1);
+    registry.createTask("MATH101", "Midterm", "", days(10), 3);
+    registry.createTask("PHYS101", "Kinematics", "", days(2), 1);
+    registry.createTask("PHYS101", "Final", "", days(8), 3);
+  }
+
+  void TearDown() override {
+    for (NotificationId id : added) {
+      NotificationManager::getInstance().cancel(id);
+    }
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().internships.clear();
+    Registry::instance().resumes.clear();
+    Registry::instance().publish();
+  }
+};
+
+TEST_F(ReminderRuleTest, OccurrencesAreComputedFromTheDeadlineIndex) {
+  ReminderRule rule("Exam soon", Registry::instance(), exams(), {7, 3, 1},
+                    now);
+
+  EXPECT_EQ(days(1), rule.nextOccurrence(now));
+  // Wakes within the hour regardless, to see tasks added meanwhile.
+  EXPECT_EQ(now + std::chrono::hours(1), rule.getTriggerTime());
+  EXPECT_EQ((std::vector<std::string>{"Final 7", "Midterm 7", "Final 3"}),
+            describe(rule.takeOccurrences(days(5))));
+  // Handed out once.
+  EXPECT_TRUE(rule.takeOccurrences(days(5)).empty());
+  EXPECT_EQ(days(7), rule.nextOccurrence(days(5)));
+  // Ties on day 7 come in the order of the offsets.
+  EXPECT_EQ((std::vector<std::string>{"Midterm 3", "Final 1", "Midterm 1"}),
+            describe(rule.takeOccurrences(days(20))));
+  EXPECT_FALSE(rule.nextOccurrence(days(20)));
+}
+
+TEST_F(ReminderRuleTest, FilterBySubjectSkipsCompletedTasks) {
+  auto &registry = Registry::instance();
+  TaskFilter physics;
+  physics.subject = registry.subjects.at("PHYS101").get();
+  ReminderRule rule("Physics due", registry, physics, {1}, now);
+
+  registry.changeTaskState("PHYS101", 0, 2);
+  EXPECT_EQ(std::vector<std::string>{"Final 1"},
+            describe(rule.takeOccurrences(days(10)), "Physics due"));
+}
+
+TEST_F(ReminderRuleTest, FilterBySubjectFollowsTheSubjectAcrossUndo) {
+  auto &registry = Registry::instance();
+  TaskFilter physics;
+  physics.subject = registry.subjects.at("PHYS101").get();
+  ReminderRule rule("Physics due", registry, physics, {1}, now);
+  EXPECT_EQ("PHYS101", rule.getSubjectCode());
+
+  // Back to before PHYS101 was created and forward again: the subject the
+  // filter named is freed and PHYS101 is a new object.
+  for (int step = 0; step < 5; ++step) {
+    ASSERT_TRUE(registry.undo());
+  }
+  EXPECT_EQ(0u, registry.subjects.count("PHYS101"));
+  for (int step = 0; step < 5; ++step) {
+    ASSERT_TRUE(registry.redo());
+  }
+  EXPECT_EQ((std::vector<std::string>{"Kinematics 1", "Final 1"}),
+            describe(rule.takeOccurrences(days(10)), "Physics due"));
+}
+
+TEST_F(ReminderRuleTest, ManagerArmsTheRuleOnceAndExpandsItWhenDue) {
+  auto &manager = NotificationManager::getInstance();
+  std::size_t scheduled = manager.scheduledCount();
+  added.push_back(manager.addNotification(std::make_shared<ReminderRule>(
+      "Exam soon", Registry::instance(), exams(), std::vector<int>{7, 3, 1},
+      now)));
+  // One entry however many tasks and offsets it covers.
+  EXPECT_EQ(scheduled + 1, manager.scheduledCount());
+
+  EXPECT_EQ((std::vector<std::string>{"Final 7", "Midterm 7"}),
+            describe(manager.takeDue(days(4))));
+  // Armed again at the next check: within the hour, before the next
+  // occurrence on day 5.
+  auto rule = manager.find(added[0]);
+  EXPECT_EQ(days(4) + std::chrono::hours(1), rule->getTriggerTime());
+  EXPECT_EQ(scheduled + 1, manager.scheduledCount());
+
+  // Added after the rule was armed; seen at its next wakeup.
+  Registry::instance().createTask("MATH101", "Quiz", "",
+                                  days(5) + std::chrono::minutes(30), 3);
+  EXPECT_EQ(std::vector<std::string>{"Quiz 1"},
+            describe(manager.takeDue(days(4) + std::chrono::hours(1))));
+}
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../include/Internship.h"
+#include "../include/Registry.h"
+#include "../include/RegistrySnapshot.h"
+#include "../include/Resume.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+class RegistrySnapshotTest : public ::testing::Test {
+protected:
+  std::string path;
+  DateTime deadline;
+
+  void SetUp() override {
+    path = ::testing::TempDir() + "registry_snapshot_test.bin";
+    deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+
+    auto &registry = Registry::instance();
+    auto cs = std::make_shared<Subject>("Computer Science", "CS101",
+                                        "Programming basics");
+
+    auto lab = LabFactory().createTask("Lab 1", deadline, "Python");
+    lab->completeTask();
+    lab->setMarks(95);
+    cs->addTask(lab);
+
+    auto exam = ExamFactory().createTask("Final", deadline);
+    exam->startTask();
+    cs->addTask(exam);
+
+    cs->addTask(ProjectFactory().createTask("Web App", deadline, "React"));
+
+    registry.subjects[cs->getCode()] = cs;
+    registry.subjects["MATH101"] =
+        std::make_shared<Subject>("Mathematics", "MATH101");
+    registry.internships["internship_1"] = std::make_shared<Internship>(
+        "internship_1", "Google", "SWE Intern", InternshipStatus::STARTED,
+        "2024-06-01", "2024-08-31");
+    registry.resumes["resume_1"] =
+        std::make_shared<Resume>("resume_1", "My CV", "<h1>Me</h1>");
+  }
+
+  void TearDown() override {
+    Registry::instance().subjects.clear();
+    Registry::instance().internships.clear();
+    Registry::instance().resumes.clear();
+    std::remove(path.c_str());
+  }
+};
+
+TEST_F(RegistrySnapshotTest, MappedViewExposesRecordsWithoutRestoring) {
+  RegistrySnapshot::write(Registry::instance(), path);
+  RegistrySnapshot snapshot = RegistrySnapshot::open(path);
+
+  EXPECT_EQ(1u, snapshot.version());
+  EXPECT_EQ(2u, snapshot.subjectCount());
+  EXPECT_EQ(3u, snapshot.taskCount());
+  EXPECT_EQ(1u, snapshot.internshipCount());
+  EXPECT_EQ(1u, snapshot.resumeCount());
+
+  SnapshotSubject cs = snapshot.subject(0);
+  EXPECT_EQ("CS101", cs.getCode());
+  ASSERT_EQ(3u, cs.taskCount());
+
+  SnapshotTask lab = cs.task(0);
+  EXPECT_EQ("Lab 1", lab.getTitle());
+  EXPECT_EQ("Lab", lab.getType());
+  EXPECT_TRUE(lab.isCompleted());
+  EXPECT_EQ(95, lab.getMarks());
+  EXPECT_EQ(deadline, lab.getDeadline());
+
+  EXPECT_EQ("In Progress", cs.task(1).getStateName());
+  EXPECT_EQ("Project", cs.task(2).getType());
+  EXPECT_EQ(0u, snapshot.subject(1).taskCount());
+}
+
+TEST_F(RegistrySnapshotTest, RestoreRebuildsTheRegistry) {
+  RegistrySnapshot::write(Registry::instance(), path);
+  Registry::instance().subjects.clear();
+  Registry::instance().internships.clear();
+  Registry::instance().resumes.clear();
+
+  RegistrySnapshot::open(path).restore(Registry::instance());
+  auto &registry = Registry::instance();
+
+  ASSERT_EQ(2u, registry.subjects.size());
+  auto cs = registry.subjects.at("CS101");
+  EXPECT_EQ("Programming basics", cs->getDescription());
+
+  auto lab = cs->findTask("Lab 1");
+  ASSERT_NE(nullptr, lab);
+  EXPECT_EQ("Completed", lab->getStateName());
+  EXPECT_EQ(95, lab->getMarks());
+  EXPECT_EQ(cs, registry.subjects.at("CS101"));
+  EXPECT_EQ(cs.get(), lab->getSubject());
+
+  auto exam = cs->findTask("Final");
+  ASSERT_NE(nullptr, exam);
+  EXPECT_EQ("Exam", exam->getType());
+  EXPECT_EQ("In Progress", exam->getStateName());
+  EXPECT_EQ(deadline, exam->getDeadline());
+
+  EXPECT_EQ("Google", registry.internships.at("internship_1")->company);
+  EXPECT_EQ(InternshipStatus::STARTED,
+            registry.internships.at("internship_1")->status);
+  EXPECT_EQ("<h1>Me</h1>", registry.resumes.at("resume_1")->getHtmlBody());
+}
+
+TEST_F(RegistrySnapshotTest, RejectsFilesThatAreNotSnapshots) {
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(256, 'x');
+  }
+  EXPECT_THROW(RegistrySnapshot::open(path), std::runtime_error);
+  EXPECT_THROW(RegistrySnapshot::open(path + ".missing"), std::runtime_error);
+}
+
+TEST_F(RegistrySnapshotTest, RejectsTruncatedFiles) {
+  RegistrySnapshot::write(Registry::instance(), path);
+
+  std::string bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+  }
+
+  EXPECT_THROW(RegistrySnapshot::open(path), std::runtime_error);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../include/InternedMap.h"
+#include "../include/Internship.h"
+#include "../include/Registry.h"
+#include "../include/SymbolTable.h"
+
+TEST(SymbolTableTest, InternReturnsDenseStableIds) {
+  SymbolTable symbols;
+
+  SymbolId math = symbols.intern("MATH101");
+  SymbolId cs = symbols.intern("CS101");
+
+  EXPECT_EQ(0u, math);
+  EXPECT_EQ(1u, cs);
+  EXPECT_EQ(math, symbols.intern(std::string("MATH101")));
+  EXPECT_EQ(2u, symbols.size());
+  EXPECT_EQ("CS101", symbols.name(cs));
+}
+
+TEST(SymbolTableTest, FindDoesNotIntern) {
+  SymbolTable symbols;
+  symbols.intern("internship_1");
+
+  EXPECT_EQ(kInvalidSymbol, symbols.find("internship_2"));
+  EXPECT_EQ(1u, symbols.size());
+  EXPECT_EQ(0u, symbols.find("internship_1"));
+}
+
+TEST(SymbolTableTest, ViewsSurviveGrowth) {
+  SymbolTable symbols;
+  SymbolId first = symbols.intern("resume_0");
+  std::string_view view = symbols.name(first);
+
+  for (int i = 1; i < 10000; ++i) {
+    symbols.intern("resume_" + std::to_string(i));
+  }
+
+  EXPECT_EQ("resume_0", view);
+  EXPECT_EQ(view.data(), symbols.name(first).data());
+  EXPECT_EQ(9999u, symbols.find("resume_9999"));
+}
+
+TEST(InternedMapTest, BehavesLikeAStringKeyedMap) {
+  SymbolTable symbols;
+  InternedMap<int> map(symbols);
+
+  map["a"] = 1;
+  map["b"] = 2;
+  map["a"] = 3;
+
+  EXPECT_EQ(2u, map.size());
+  EXPECT_EQ(3, map.at("a"));
+  EXPECT_EQ(1u, map.count("b"));
+  EXPECT_EQ(0u, map.count("c"));
+  EXPECT_EQ(map.end(), map.find("c"));
+  EXPECT_THROW(map.at("c"), std::out_of_range);
+}
+
+TEST(InternedMapTest, EraseKeepsRemainingEntriesReachable) {
+  SymbolTable symbols;
+  InternedMap<int> map(symbols);
+
+  for (int i = 0; i < 5; ++i) {
+    map["key_" + std::to_string(i)] = i;
+  }
+
+  EXPECT_EQ(1u, map.erase("key_1"));
+  EXPECT_EQ(0u, map.erase("key_1"));
+  EXPECT_EQ(4u, map.size());
+
+  for (int i : {0, 2, 3, 4}) {
+    auto it = map.find("key_" + std::to_string(i));
+    ASSERT_NE(map.end(), it);
+    EXPECT_EQ(i, it->second);
+    EXPECT_EQ("key_" + std::to_string(i), it->first);
+  }
+}
+
+TEST(InternedMapTest, MapsSharingSymbolsStayIndependent) {
+  SymbolTable symbols;
+  InternedMap<int> left(symbols);
+  InternedMap<int> right(symbols);
+
+  left["shared"] = 1;
+  EXPECT_EQ(0u, right.count("shared"));
+
+  right["shared"] = 2;
+  EXPECT_EQ(1, left.at("shared"));
+  EXPECT_EQ(2, right.at("shared"));
+  EXPECT_EQ(1u, symbols.size());
+
+  left.clear();
+  EXPECT_TRUE(left.empty());
+  EXPECT_EQ(2, right.at("shared"));
+}
+
+TEST(InternedMapTest, RegistryLookupsUseStringViewProbes) {
+  auto &registry = Registry::instance();
+  registry.internships["internship_42"] = std::make_shared<Internship>(
+      "internship_42", "Acme", "Intern", InternshipStatus::PENDING,
+      "2025-01-01", "2025-02-01");
+
+  std::string_view key = "internship_42";
+  auto it = registry.internships.find(key);
+  ASSERT_NE(registry.internships.end(), it);
+  EXPECT_EQ("Acme", it->second->company);
+
+  registry.internships.clear();
+}
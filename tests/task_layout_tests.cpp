@@ -0,0 +1,93 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/Notification.h"
+#include "../include/Task.h"
+#include "../include/TaskStore.h"
+
+namespace {
+
+// Bytes a task costs outside the subject that lists it: its object plus
+// its share of a TaskStore segment.
+constexpr std::size_t kBytesPerTask =
+    sizeof(LabTask) + sizeof(TaskStore::Segment) / TaskStore::kSegmentRows;
+
+} // namespace
+
+TEST(TaskLayoutTest, TaskIsARowAndASubjectHandle) {
+  EXPECT_LE(sizeof(LabTask), 24u);
+  EXPECT_EQ(sizeof(LabTask), sizeof(ExamTask));
+  EXPECT_LE(sizeof(TaskStore::Segment) / TaskStore::kSegmentRows, 48u);
+  // Ten million tasks, e.g. every student's copy of every course task,
+  // fit in 720 MB before strings.
+  EXPECT_LE(10'000'000 * kBytesPerTask, 720'000'000u);
+}
+
+TEST(TaskLayoutTest, RepeatedStringsAreStoredOnce) {
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory factory;
+  std::vector<std::shared_ptr<Task>> tasks;
+  tasks.push_back(factory.createTask("Layout lab", deadline, "Shared brief"));
+  std::size_t strings = TaskStore::global().internedStrings();
+  for (int i = 0; i < 100; ++i) {
+    tasks.push_back(factory.createTask("Layout lab", deadline, "Shared brief"));
+  }
+  EXPECT_EQ(strings, TaskStore::global().internedStrings());
+  EXPECT_EQ(tasks.front()->getDescription().data(),
+            tasks.back()->getDescription().data());
+}
+
+TEST(TaskLayoutTest, StringsAreFreedWithTheirLastUse) {
+  auto &store = TaskStore::global();
+  auto deadline = std::chrono::system_clock::now();
+  std::size_t strings = store.internedStrings();
+
+  auto task = ProjectFactory().createTask("Layout draft", deadline,
+                                          "Layout brief");
+  auto copy = task->clone();
+  EXPECT_EQ(strings + 2, store.internedStrings());
+
+  // The copy still uses the old title, so it is kept until the copy goes.
+  task->setTitle("Layout final");
+  EXPECT_EQ("Layout draft", copy->getTitle());
+  EXPECT_EQ("Layout final", task->getTitle());
+  EXPECT_EQ(strings + 3, store.internedStrings());
+  copy.reset();
+  EXPECT_EQ(strings + 2, store.internedStrings());
+
+  // Setting the current string again must not free it on the way.
+  task->setTitle(std::string(task->getTitle()));
+  task->setDescription(std::string(task->getDescription()));
+  EXPECT_EQ("Layout final", task->getTitle());
+  EXPECT_EQ("Layout brief", task->getDescription());
+  EXPECT_EQ("Project", task->getType());
+
+  std::size_t bytes = store.arenaBytes();
+  for (int i = 0; i < 1000; ++i) {
+    task->setDescription("Layout revision " + std::to_string(i));
+  }
+  // Each revision frees the one before, so the pool does not grow.
+  EXPECT_EQ(strings + 2, store.internedStrings());
+  EXPECT_LE(store.arenaBytes(), bytes + 64);
+  task.reset();
+  EXPECT_EQ(strings, store.internedStrings());
+}
+
+TEST(TaskLayoutTest, NotificationsAreFoundByTaskHandle) {
+  auto &manager = NotificationManager::getInstance();
+  auto task = ExamFactory().createTask(
+      "Layout exam", std::chrono::system_clock::now() + std::chrono::hours(72));
+  auto copy = task->clone();
+  std::size_t before = manager.getNotifications().size();
+  manager.addNotification(
+      std::make_shared<DeadlineNotification>("Revise", task, 2));
+
+  ASSERT_EQ(1u, task->getNotifications().size());
+  EXPECT_EQ("Revise", task->getNotifications().front()->getMessage());
+  EXPECT_TRUE(copy->getNotifications().empty());
+  manager.removeNotification(before);
+  EXPECT_TRUE(task->getNotifications().empty());
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "../include/Task.h"
+#include "../include/TaskCommands.h"
+#include "../include/TaskState.h"
+
+namespace {
+
+// Pending work that cannot be started until it is unblocked.
+class BlockedState : public TaskState {
+public:
+  void start(Task &) override {}
+
+  std::string getName() const override { return "Blocked"; }
+  TaskStateKind getKind() const override { return TaskStateKind::Pending; }
+  float getConceptualProgress() const override { return 0.0f; }
+};
+
+static_assert(taskTransition(TaskStateKind::Completed, TaskEvent::Reopen).to ==
+                  TaskStateKind::InProgress,
+              "");
+static_assert(taskTransition(TaskStateKind::Completed, TaskEvent::Reopen)
+                      .hooks &
+                  kResetMarks,
+              "");
+
+} // namespace
+
+TEST(TaskStateTest, TableDrivesBuiltinTransitions) {
+  auto task = LabFactory().createTask("Lab", std::chrono::system_clock::now());
+  EXPECT_EQ("Pending", task->getStateName());
+  EXPECT_EQ(TaskState::flyweight(TaskStateKind::Pending), task->getState());
+
+  task->reopenTask();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+  task->startTask();
+  task->startTask();
+  EXPECT_EQ("In Progress", task->getStateName());
+  EXPECT_FLOAT_EQ(50.0f, task->getProgress());
+
+  task->completeTask();
+  task->setMarks(88);
+  EXPECT_EQ(88, task->getMarks());
+  // Shared instances: no state object is allocated per task or transition.
+  EXPECT_EQ(TaskState::flyweight(TaskStateKind::Completed), task->getState());
+  EXPECT_TRUE(task->getState()->isFinished());
+
+  task->reopenTask();
+  EXPECT_EQ(TaskStateKind::InProgress, task->getStateKind());
+  EXPECT_EQ(0, task->getMarks());
+  task->reopenTask();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+
+  task->setState(std::make_shared<CompletedState>());
+  EXPECT_TRUE(task->isCompleted());
+  EXPECT_EQ(TaskState::flyweight(TaskStateKind::Completed), task->getState());
+}
+
+TEST(TaskStateTest, CustomStatesExtendTheMachine) {
+  auto task = ExamFactory().createTask("Resit", std::chrono::system_clock::now());
+  auto blocked = std::make_shared<BlockedState>();
+  task->setState(blocked);
+  EXPECT_EQ("Blocked", task->getStateName());
+  EXPECT_EQ(blocked, task->getState());
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+
+  task->startTask();
+  EXPECT_EQ("Blocked", task->getStateName());
+
+  // Events the custom state does not override fall back to the table.
+  auto clone = task->clone();
+  task->completeTask();
+  EXPECT_EQ("Completed", task->getStateName());
+  EXPECT_EQ("Blocked", clone->getStateName());
+}
+
+TEST(TaskStateTest, CommandsTargetKindsAndUndo) {
+  auto task =
+      ProjectFactory().createTask("Thesis", std::chrono::system_clock::now());
+  std::cout.setstate(std::ios::failbit);
+
+  SetTaskStateCommand complete(*task, TaskStateKind::Completed);
+  complete.execute();
+  EXPECT_TRUE(task->isCompleted());
+
+  // Reopening a completed task lands in In Progress; the command then forces
+  // Pending.
+  SetTaskStateCommand reset(*task, std::make_shared<PendingState>());
+  reset.execute();
+  EXPECT_EQ(TaskStateKind::Pending, task->getStateKind());
+  reset.undo();
+  EXPECT_EQ(TaskStateKind::Completed, task->getStateKind());
+
+  SetTaskStateCommand block(*task, std::make_shared<BlockedState>());
+  block.execute();
+  EXPECT_EQ("Blocked", task->getStateName());
+  block.undo();
+  EXPECT_TRUE(task->isCompleted());
+  std::cout.clear();
+}
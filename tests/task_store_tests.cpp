@@ -0,0 +1,97 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/PerformanceStrategy.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/TaskState.h"
+#include "../include/TaskStore.h"
+
+TEST(TaskStoreTest, TasksAreHandlesOntoStoreRows) {
+  auto &store = TaskStore::global();
+  auto deadline = std::chrono::system_clock::now();
+  std::size_t before = store.size();
+
+  ExamFactory exams;
+  auto task = exams.createTask("Final", deadline, "Room 4");
+  TaskStore::Row row = task->getRow();
+  EXPECT_EQ("Final", store.title(row));
+  EXPECT_EQ("Room 4", store.description(row));
+  EXPECT_EQ(TaskType::Exam, store.type(row));
+  EXPECT_EQ(deadline.time_since_epoch().count(), store.deadline(row));
+
+  task->completeTask();
+  task->setMarks(91);
+  task->setTitle("Final exam, rescheduled to the main hall");
+  EXPECT_EQ(TaskStateKind::Completed, store.state(row));
+  EXPECT_EQ(91, store.marks(row));
+  EXPECT_EQ("Final exam, rescheduled to the main hall", task->getTitle());
+
+  auto copy = task->clone();
+  EXPECT_NE(row, copy->getRow());
+  EXPECT_EQ(task->getTitle(), copy->getTitle());
+  EXPECT_EQ(91, copy->getMarks());
+  EXPECT_TRUE(copy->isCompleted());
+  EXPECT_EQ(before + 2, store.size());
+
+  // Released rows are reused by the next task.
+  copy.reset();
+  EXPECT_EQ(before + 1, store.size());
+  auto next = exams.createTask("Resit", deadline);
+  EXPECT_EQ("Resit", next->getTitle());
+  EXPECT_EQ(TaskStateKind::Pending, next->getStateKind());
+  EXPECT_EQ(0, next->getMarks());
+}
+
+TEST(TaskStoreTest, ColumnStatsMatchPerTaskStrategies) {
+  auto subject = std::make_shared<Subject>("Physics", "PHYS101");
+  auto other = std::make_shared<Subject>("Chemistry", "CHEM101");
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory labs;
+  ProjectFactory projects;
+
+  for (int i = 0; i < 50; ++i) {
+    auto task = (i % 3 ? static_cast<TaskFactory &>(labs)
+                       : static_cast<TaskFactory &>(projects))
+                    .createTask("Task " + std::to_string(i), deadline);
+    if (i % 4 == 0) {
+      task->completeTask();
+      task->setMarks(i);
+    } else if (i % 4 == 1) {
+      task->startTask();
+    }
+    subject->addTask(task);
+  }
+  other->addTask(labs.createTask("Unrelated", deadline));
+  subject->removeTask("Task 1");
+
+  TaskStats stats = TaskStore::global().stats(subject->getId());
+  EXPECT_EQ(49u, stats.total);
+  EXPECT_EQ(13u,
+            stats.byState[static_cast<std::size_t>(TaskStateKind::Completed)]);
+  EXPECT_EQ(17u, stats.byType[static_cast<std::size_t>(TaskType::Project)]);
+
+  auto bySubject = TaskStore::global().statsBySubject();
+  EXPECT_EQ(49u, bySubject[subject->getId()].total);
+  EXPECT_EQ(1u, bySubject[other->getId()].total);
+
+  // The same from the subject's own rows only.
+  TaskStats own = TaskStore::global().stats(subject->taskView());
+  EXPECT_EQ(stats.total, own.total);
+  EXPECT_EQ(stats.completedMarks, own.completedMarks);
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(stats.byState[i], own.byState[i]);
+    EXPECT_EQ(stats.byType[i], own.byType[i]);
+  }
+
+  AverageMarksStrategy marks;
+  CompletionRateStrategy completion;
+  AverageProgressStrategy progress;
+  auto tasks = subject->getTasks();
+  EXPECT_DOUBLE_EQ(marks.calculate(tasks), marks.calculate(stats));
+  EXPECT_DOUBLE_EQ(completion.calculate(tasks), completion.calculate(stats));
+  EXPECT_DOUBLE_EQ(progress.calculate(tasks), progress.calculate(stats));
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../include/PerformanceStrategy.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+TEST(TaskViewTest, ViewAndForEachSeeTasksInInsertionOrder) {
+  Subject subject("Mathematics", "MATH101");
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory labs;
+  subject.addTask(labs.createTask("Algebra", deadline));
+  subject.addTask(labs.createTask("Geometry", deadline));
+  subject.addTask(labs.createTask("Calculus", deadline));
+  subject.removeTask("Geometry");
+
+  // Taken after the last change to the subject, as required.
+  TaskSpan view = subject.taskView();
+  ASSERT_EQ(2u, view.size());
+  EXPECT_EQ("Algebra", view[0]->getTitle());
+  EXPECT_EQ("Calculus", view[1]->getTitle());
+  // No reference is taken: the subject still holds the only one.
+  EXPECT_EQ(1, view[0].use_count());
+
+  std::vector<std::string> titles;
+  subject.forEachTask([&](Task &task) {
+    task.completeTask();
+    titles.emplace_back(task.getTitle());
+  });
+  EXPECT_EQ((std::vector<std::string>{"Algebra", "Calculus"}), titles);
+
+  CompletionRateStrategy completion;
+  EXPECT_DOUBLE_EQ(100.0, completion.calculate(subject.taskView()));
+  EXPECT_DOUBLE_EQ(completion.calculate(subject.getTasks()),
+                   completion.calculate(subject.taskView()));
+}
+
+TEST(TaskViewTest, EmptySubjectGivesEmptyView) {
+  Subject subject("Physics", "PHYS101");
+  TaskSpan view = subject.taskView();
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(view.begin(), view.end());
+
+  int calls = 0;
+  subject.forEachTask([&](Task &) { ++calls; });
+  EXPECT_EQ(0, calls);
+  EXPECT_DOUBLE_EQ(0.0, AverageMarksStrategy().calculate(TaskSpan()));
+}
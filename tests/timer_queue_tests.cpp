@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/Notification.h"
+#include "../include/TimerQueue.h"
+#include "../include/TimingWheel.h"
+
+namespace {
+
+DateTime at(std::int64_t minutes) {
+  return DateTime() + std::chrono::minutes(minutes);
+}
+
+NotificationId id(std::uint32_t index, std::uint32_t generation = 1) {
+  return NotificationId{index, generation};
+}
+
+template <typename Queue> std::unique_ptr<TimerQueue> makeQueue();
+template <> std::unique_ptr<TimerQueue> makeQueue<HeapTimerQueue>() {
+  return std::make_unique<HeapTimerQueue>();
+}
+template <> std::unique_ptr<TimerQueue> makeQueue<TimingWheel>() {
+  return std::make_unique<TimingWheel>(at(0));
+}
+
+std::vector<std::uint32_t> indexes(const std::vector<TimerQueue::Timer> &due) {
+  std::vector<std::uint32_t> result;
+  for (const auto &timer : due) {
+    result.push_back(timer.id.index);
+  }
+  return result;
+}
+
+template <typename Queue> class TimerQueueTest : public ::testing::Test {
+protected:
+  std::unique_ptr<TimerQueue> queue = makeQueue<Queue>();
+
+  std::vector<std::uint32_t> pop(DateTime now) {
+    std::vector<TimerQueue::Timer> due;
+    queue->popDue(now, due);
+    return indexes(due);
+  }
+};
+
+using Queues = ::testing::Types<HeapTimerQueue, TimingWheel>;
+TYPED_TEST_SUITE(TimerQueueTest, Queues);
+
+} // namespace
+
+TYPED_TEST(TimerQueueTest, PopsDueTimersEarliestFirst) {
+  // Same minute, next hour, another day and beyond the day wheel.
+  this->queue->schedule(id(0), at(3) + std::chrono::seconds(40));
+  this->queue->schedule(id(1), at(3) + std::chrono::seconds(10));
+  this->queue->schedule(id(2), at(90));
+  this->queue->schedule(id(3), at(3 * 24 * 60));
+  this->queue->schedule(id(4), at(400 * 24 * 60));
+  EXPECT_EQ(5u, this->queue->size());
+
+  EXPECT_TRUE(this->pop(at(3)).empty());
+  EXPECT_EQ(std::vector<std::uint32_t>{1},
+            this->pop(at(3) + std::chrono::seconds(20)));
+  EXPECT_EQ((std::vector<std::uint32_t>{0, 2}), this->pop(at(120)));
+  ASSERT_TRUE(this->queue->peek());
+  EXPECT_EQ(3u, this->queue->peek()->id.index);
+  EXPECT_EQ((std::vector<std::uint32_t>{3, 4}),
+            this->pop(at(500 * 24 * 60)));
+  EXPECT_EQ(0u, this->queue->size());
+  EXPECT_FALSE(this->queue->peek());
+}
+
+TYPED_TEST(TimerQueueTest, RescheduleAndUnschedule) {
+  this->queue->schedule(id(0), at(10));
+  this->queue->schedule(id(1), at(20));
+  this->queue->schedule(id(2), at(30));
+
+  EXPECT_TRUE(this->queue->schedule(id(2), at(5)));
+  this->queue->schedule(id(0), at(2000));
+  EXPECT_TRUE(this->queue->unschedule(id(1)));
+  EXPECT_FALSE(this->queue->unschedule(id(1)));
+  // A later occupant of the same slot is a different timer.
+  EXPECT_FALSE(this->queue->contains(id(2, 3)));
+  EXPECT_FALSE(this->queue->unschedule(id(2, 3)));
+
+  EXPECT_EQ(2u, this->queue->size());
+  EXPECT_EQ(at(5), this->queue->peek()->time);
+  EXPECT_EQ(std::vector<std::uint32_t>{2}, this->pop(at(100)));
+  EXPECT_TRUE(this->queue->contains(id(0)));
+  EXPECT_EQ(std::vector<std::uint32_t>{0}, this->pop(at(2000)));
+}
+
+TYPED_TEST(TimerQueueTest, OverdueTimersAreDueAtOnce) {
+  this->pop(at(500));
+  this->queue->schedule(id(0), at(100));
+  EXPECT_EQ(at(100), this->queue->peek()->time);
+  EXPECT_EQ(std::vector<std::uint32_t>{0}, this->pop(at(500)));
+}
+
+TEST(TimingWheelTest, MatchesTheHeapUnderRandomOperations) {
+  HeapTimerQueue heap;
+  TimingWheel wheel(at(0));
+  std::mt19937_64 random(7);
+  std::vector<std::uint32_t> generation(2000, 1);
+  std::int64_t now = 0;
+
+  for (int round = 0; round < 300; ++round) {
+    for (int op = 0; op < 50; ++op) {
+      std::uint32_t index = static_cast<std::uint32_t>(random() % 2000);
+      if (random() % 4 == 0) {
+        EXPECT_EQ(heap.unschedule(id(index, generation[index])),
+                  wheel.unschedule(id(index, generation[index])));
+        generation[index] += 2;
+        continue;
+      }
+      // Seconds from just past to about two years out.
+      std::int64_t ahead = static_cast<std::int64_t>(random() % 4) == 0
+                               ? static_cast<std::int64_t>(random() % 600)
+                               : static_cast<std::int64_t>(
+                                     random() % (2 * 366 * 24 * 3600));
+      DateTime time = at(now) + std::chrono::seconds(ahead - 60);
+      heap.schedule(id(index, generation[index]), time);
+      wheel.schedule(id(index, generation[index]), time);
+    }
+    now += static_cast<std::int64_t>(random() % (3 * 24 * 60));
+    std::vector<TimerQueue::Timer> fromHeap, fromWheel;
+    heap.popDue(at(now), fromHeap);
+    wheel.popDue(at(now), fromWheel);
+    ASSERT_EQ(fromHeap.size(), fromWheel.size());
+    for (std::size_t i = 0; i < fromHeap.size(); ++i) {
+      EXPECT_EQ(fromHeap[i].time, fromWheel[i].time);
+    }
+    ASSERT_EQ(heap.size(), wheel.size());
+    if (heap.size()) {
+      EXPECT_EQ(heap.peek()->time, wheel.peek()->time);
+    }
+  }
+}
+
+TEST(TimingWheelTest, PeekFollowsCancelledAndMovedEarliestTimers) {
+  HeapTimerQueue heap;
+  TimingWheel wheel(at(0));
+  std::mt19937_64 random(11);
+  for (std::uint32_t index = 0; index < 3000; ++index) {
+    DateTime time = at(0) + std::chrono::seconds(random() % (600 * 24 * 3600));
+    heap.schedule(id(index), time);
+    wheel.schedule(id(index), time);
+  }
+
+  while (heap.size()) {
+    ASSERT_EQ(heap.peek()->time, wheel.peek()->time);
+    NotificationId earliest = wheel.peek()->id;
+    if (random() % 3 == 0) {
+      // Later, but possibly still in the same slot.
+      DateTime time = wheel.peek()->time + std::chrono::minutes(random() % 90);
+      heap.schedule(earliest, time);
+      wheel.schedule(earliest, time);
+    } else {
+      EXPECT_TRUE(heap.unschedule(earliest));
+      EXPECT_TRUE(wheel.unschedule(earliest));
+    }
+  }
+  EXPECT_FALSE(wheel.peek());
+}
+
+TEST(TimingWheelTest, DrivesTheNotificationManager) {
+  auto &manager = NotificationManager::getInstance();
+  manager.setTimerQueue(std::make_unique<TimingWheel>(at(0)));
+  std::vector<NotificationId> added;
+  for (int hours : {30, 2, 500}) {
+    added.push_back(manager.addNotification(std::make_shared<Notification>(
+        "after " + std::to_string(hours), at(hours * 60), nullptr)));
+  }
+  manager.reschedule(added[2], at(10 * 60));
+
+  std::vector<std::string> fired;
+  for (const auto &notification : manager.pollDue(at(40 * 60))) {
+    fired.push_back(notification->getMessage());
+  }
+  EXPECT_EQ((std::vector<std::string>{"after 2", "after 500", "after 30"}),
+            fired);
+
+  manager.setTimerQueue(std::make_unique<HeapTimerQueue>());
+  for (NotificationId added : added) {
+    manager.cancel(added);
+  }
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/Subject.h"
+#include "../include/Task.h"
+
+namespace {
+
+std::vector<std::string> titles(const Subject &subject) {
+  std::vector<std::string> result;
+  subject.forEachTask([&](Task &task) { result.emplace_back(task.getTitle()); });
+  return result;
+}
+
+} // namespace
+
+TEST(TitleIndexTest, LookupsAndRemovalKeepTaskOrder) {
+  Subject subject("Mathematics", "MATH101");
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory labs;
+
+  std::vector<std::shared_ptr<Task>> batch;
+  for (int i = 0; i < 1000; ++i) {
+    batch.push_back(labs.createTask("Lab " + std::to_string(i), deadline));
+  }
+  batch.push_back(labs.createTask("Lab 7", deadline));
+  subject.addTasks(batch);
+  subject.addTask(labs.createTask("Lab 9", deadline));
+  EXPECT_EQ(1000u, subject.getTaskCount());
+
+  std::string_view probe = "Lab 500 and more";
+  EXPECT_EQ(batch[500], subject.findTask(probe.substr(0, 7)));
+  EXPECT_EQ(nullptr, subject.findTask("Lab 1000"));
+
+  for (int i = 0; i < 1000; i += 2) {
+    subject.removeTask("Lab " + std::to_string(i));
+  }
+  EXPECT_EQ(500u, subject.getTaskCount());
+  auto remaining = titles(subject);
+  EXPECT_EQ("Lab 1", remaining.front());
+  EXPECT_EQ("Lab 3", remaining[1]);
+  EXPECT_EQ("Lab 999", remaining.back());
+  for (int i = 0; i < 1000; ++i) {
+    auto task = subject.findTask("Lab " + std::to_string(i));
+    if (i % 2) {
+      ASSERT_NE(nullptr, task);
+      EXPECT_EQ("Lab " + std::to_string(i), task->getTitle());
+    } else {
+      EXPECT_EQ(nullptr, task);
+    }
+  }
+}
+
+TEST(TitleIndexTest, RemovedTasksLeavePositionsToTheNextView) {
+  Subject subject("Chemistry", "CHEM101");
+  auto deadline = std::chrono::system_clock::now();
+  LabFactory labs;
+  for (int i = 0; i < 10; ++i) {
+    subject.addTask(labs.createTask("Lab " + std::to_string(i), deadline));
+  }
+
+  // Fewer than half removed, from the front and middle: left as tombstones
+  // until a positional read.
+  subject.removeTask("Lab 0");
+  subject.removeTask("Lab 4");
+  EXPECT_EQ(8u, subject.getTaskCount());
+  EXPECT_EQ("Lab 5", subject.findTask("Lab 5")->getTitle());
+  subject.addTask(labs.createTask("Lab 10", deadline));
+
+  TaskSpan view = subject.taskView();
+  ASSERT_EQ(9u, view.size());
+  EXPECT_EQ("Lab 1", view[0]->getTitle());
+  EXPECT_EQ("Lab 5", view[3]->getTitle());
+  EXPECT_EQ("Lab 10", view[8]->getTitle());
+  // The index follows the compaction.
+  EXPECT_EQ(view[3], subject.findTask("Lab 5"));
+  EXPECT_EQ(view[8], subject.findTask("Lab 10"));
+
+  // Past half, removal compacts by itself.
+  for (int i = 1; i < 9; i += 2) {
+    subject.removeTask("Lab " + std::to_string(i));
+  }
+  subject.removeTask("Lab 6");
+  EXPECT_EQ(4u, subject.getTaskCount());
+  EXPECT_EQ((std::vector<std::string>{"Lab 2", "Lab 8", "Lab 9", "Lab 10"}),
+            titles(subject));
+  EXPECT_EQ(4u, subject.getTasks().size());
+  EXPECT_NE(nullptr, subject.findTask("Lab 8"));
+}
+
+TEST(TitleIndexTest, RenamesAreIndexedAndStayUnique) {
+  Subject subject("Physics", "PHYS101");
+  auto deadline = std::chrono::system_clock::now();
+  ExamFactory exams;
+  subject.addTask(exams.createTask("Midterm", deadline));
+  subject.addTask(exams.createTask("Final", deadline));
+
+  auto midterm = subject.findTask("Midterm");
+  midterm->setTitle("Midterm, moved to week 8");
+  EXPECT_EQ(nullptr, subject.findTask("Midterm"));
+  EXPECT_EQ(midterm, subject.findTask("Midterm, moved to week 8"));
+
+  // A rename onto another task's title is refused, as addTask would be.
+  midterm->setTitle("Final");
+  EXPECT_EQ("Midterm, moved to week 8", midterm->getTitle());
+  EXPECT_NE(midterm, subject.findTask("Final"));
+
+  subject.addTask(exams.createTask("Midterm", deadline));
+  EXPECT_EQ(3u, subject.getTaskCount());
+
+  auto copy = subject.clone();
+  EXPECT_NE(nullptr, copy->findTask("Midterm, moved to week 8"));
+  copy->removeTask("Final");
+  EXPECT_EQ((std::vector<std::string>{"Midterm, moved to week 8", "Midterm"}),
+            titles(*copy));
+  EXPECT_EQ(3u, subject.getTaskCount());
+}
@@ -0,0 +1,237 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/CommandManager.h"
+#include "../include/Registry.h"
+#include "../include/Subject.h"
+#include "../include/Task.h"
+#include "../include/WriteAheadLog.h"
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+  std::string logPath;
+  std::string snapshotPath;
+
+  void SetUp() override {
+    logPath = ::testing::TempDir() + "registry_wal_test.log";
+    snapshotPath = ::testing::TempDir() + "registry_wal_test.snap";
+    std::remove(logPath.c_str());
+    std::remove(snapshotPath.c_str());
+    clearRegistry();
+  }
+
+  void TearDown() override {
+    Registry::instance().attachLog(nullptr);
+    clearRegistry();
+    CommandManager::instance().clearHistory();
+    std::remove(logPath.c_str());
+    std::remove(snapshotPath.c_str());
+  }
+
+  static void clearRegistry() {
+    Registry::instance().subjects.clear();
+    Registry::instance().internships.clear();
+    Registry::instance().resumes.clear();
+  }
+
+  static std::size_t fileSize(const std::string &path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<std::size_t>(in.tellg()) : 0;
+  }
+};
+
+TEST_F(WriteAheadLogTest, RecordsRoundTripInOrder) {
+  {
+    WriteAheadLog log(logPath);
+    log.append({WalOp::CreateSubject, {"Mathematics", "MATH101", ""}, {}});
+    log.append({WalOp::CreateTask, {"MATH101", "Lab 1", "Algebra"}, {42, 1}});
+  }
+
+  std::vector<WalRecord> records;
+  EXPECT_EQ(2u, WriteAheadLog::read(logPath, [&](const WalRecord &record) {
+              records.push_back(record);
+            }));
+
+  ASSERT_EQ(2u, records.size());
+  EXPECT_EQ(WalOp::CreateSubject, records[0].op);
+  EXPECT_EQ("MATH101", records[0].fields[1]);
+  EXPECT_EQ("", records[0].fields[2]);
+  EXPECT_EQ(WalOp::CreateTask, records[1].op);
+  EXPECT_EQ((std::vector<std::int64_t>{42, 1}), records[1].values);
+}
+
+TEST_F(WriteAheadLogTest, ReadingStopsAtTornOrCorruptedTail) {
+  {
+    WriteAheadLog log(logPath);
+    log.append({WalOp::CreateResume, {"resume_1", "CV", "<p>1</p>"}, {}});
+    log.append({WalOp::CreateResume, {"resume_2", "CV", "<p>2</p>"}, {}});
+  }
+  std::size_t intact = fileSize(logPath);
+
+  {
+    std::ofstream out(logPath, std::ios::binary | std::ios::app);
+    out.write("\x20\x00\x00\x00garbage", 11);
+  }
+  EXPECT_EQ(2u, WriteAheadLog::read(logPath, [](const WalRecord &) {}));
+
+  {
+    std::fstream io(logPath, std::ios::binary | std::ios::in | std::ios::out);
+    io.seekp(static_cast<std::streamoff>(intact - 2));
+    io.put('X');
+  }
+  EXPECT_EQ(1u, WriteAheadLog::read(logPath, [](const WalRecord &) {}));
+}
+
+TEST_F(WriteAheadLogTest, RecoveryCutsTheTornTailBeforeAppending) {
+  auto &registry = Registry::instance();
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    ASSERT_TRUE(registry.createSubject("Mathematics", "MATH101", ""));
+    registry.attachLog(nullptr);
+  }
+  std::size_t intact = fileSize(logPath);
+  {
+    std::ofstream out(logPath, std::ios::binary | std::ios::app);
+    out.write("\x20\x00\x00\x00torn", 8);
+  }
+
+  clearRegistry();
+  EXPECT_EQ(1u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  EXPECT_EQ(intact, fileSize(logPath));
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    ASSERT_TRUE(registry.createSubject("Physics", "PHYS101", ""));
+    registry.attachLog(nullptr);
+  }
+
+  clearRegistry();
+  EXPECT_EQ(2u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  EXPECT_EQ(1u, registry.subjects.count("MATH101"));
+  EXPECT_EQ(1u, registry.subjects.count("PHYS101"));
+}
+
+TEST_F(WriteAheadLogTest, RecoverReplaysTheLogOntoTheSnapshot) {
+  auto &registry = Registry::instance();
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+
+    ASSERT_TRUE(registry.createSubject("Computer Science", "CS101", "Intro"));
+    ASSERT_NE(nullptr, registry.createTask("CS101", "Lab 1", "Python",
+                                           deadline, 1));
+    EXPECT_EQ(nullptr, registry.createTask("CS101", "Lab 1", "Again",
+                                           deadline, 1));
+    EXPECT_EQ(nullptr, registry.createTask("NOPE", "Lab 1", "", deadline, 1));
+
+    registry.checkpoint(snapshotPath);
+    EXPECT_EQ(0u, fileSize(logPath));
+
+    ASSERT_NE(nullptr, registry.createTask("CS101", "Final", "All topics",
+                                           deadline, 3));
+    ASSERT_TRUE(registry.changeTaskState("CS101", 0, 2));
+    std::string internshipId = registry.createInternship(
+        "Google", "SWE Intern", InternshipStatus::STARTED, "2024-06-01",
+        "2024-08-31");
+    std::string resumeId = registry.createResume("My CV", "<h1>Me</h1>");
+    EXPECT_FALSE(internshipId.empty());
+    EXPECT_FALSE(resumeId.empty());
+
+    registry.attachLog(nullptr);
+  }
+
+  clearRegistry();
+  EXPECT_EQ(4u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+
+  auto cs = registry.subjects.at("CS101");
+  ASSERT_EQ(2u, cs->getTasks().size());
+  EXPECT_EQ("Completed", cs->findTask("Lab 1")->getStateName());
+  auto exam = cs->findTask("Final");
+  ASSERT_NE(nullptr, exam);
+  EXPECT_EQ("Exam", exam->getType());
+  EXPECT_EQ(deadline, exam->getDeadline());
+  EXPECT_EQ("Google", registry.internships.at("internship_1")->company);
+  EXPECT_EQ(InternshipStatus::STARTED,
+            registry.internships.at("internship_1")->status);
+  EXPECT_EQ(1u, registry.resumes.size());
+}
+
+TEST_F(WriteAheadLogTest, InvalidMutationsAreNotLoggedAndBadRecordsSkipped) {
+  auto &registry = Registry::instance();
+  auto deadline = std::chrono::system_clock::now() + std::chrono::hours(24);
+
+  {
+    WriteAheadLog log(logPath);
+    registry.attachLog(&log);
+    EXPECT_FALSE(registry.createSubject("", "X1", ""));
+    ASSERT_TRUE(registry.createSubject("Physics", "PHYS101", ""));
+    EXPECT_EQ(nullptr, registry.createTask("PHYS101", "", "", deadline, 1));
+    registry.attachLog(nullptr);
+
+    // As an older build could have logged them.
+    log.append({WalOp::CreateSubject, {"", "X1", ""}, {}});
+    log.append({WalOp::CreateTask, {"PHYS101", "", ""}, {0, 1}});
+    log.append({WalOp::CreateSubject, {"Chemistry", "CHEM101", ""}, {}});
+  }
+
+  clearRegistry();
+  EXPECT_EQ(4u, WriteAheadLog::recover(registry, snapshotPath, logPath));
+  EXPECT_EQ(2u, registry.subjects.size());
+  EXPECT_EQ(0u, registry.subjects.count("X1"));
+  EXPECT_EQ(0u, registry.subjects.at("PHYS101")->getTaskCount());
+  EXPECT_EQ(1u, registry.subjects.count("CHEM101"));
+}
+
+TEST_F(WriteAheadLogTest, AFailedFlushFailsEveryLaterWait) {
+  // Writes to /dev/full fail with ENOSPC, but fsync on it succeeds: a
+  // later leader with nothing left to write must not report success.
+  if (!std::ifstream("/dev/full")) {
+    GTEST_SKIP() << "no /dev/full";
+  }
+  WriteAheadLog log("/dev/full", WriteAheadLog::SyncMode::GroupCommit);
+  std::uint64_t first =
+      log.enqueue({WalOp::CreateResume, {"resume_1", "CV", ""}, {}});
+  std::uint64_t second =
+      log.enqueue({WalOp::CreateResume, {"resume_2", "CV", ""}, {}});
+
+  EXPECT_THROW(log.waitDurable(first), std::runtime_error);
+  EXPECT_THROW(log.waitDurable(second), std::runtime_error);
+  EXPECT_THROW(log.enqueue({WalOp::CreateResume, {"resume_3", "CV", ""}, {}}),
+               std::runtime_error);
+  EXPECT_EQ(0u, log.syncCount());
+}
+
+TEST_F(WriteAheadLogTest, GroupCommitSharesSyncsBetweenWriters) {
+  constexpr int kThreads = 8;
+  constexpr int kPerThread = 50;
+
+  WriteAheadLog log(logPath, WriteAheadLog::SyncMode::GroupCommit);
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&log, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        log.append({WalOp::CreateResume,
+                    {"resume_" + std::to_string(t) + "_" + std::to_string(i),
+                     "CV", ""},
+                    {}});
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+
+  EXPECT_EQ(static_cast<std::size_t>(kThreads * kPerThread),
+            WriteAheadLog::read(logPath, [](const WalRecord &) {}));
+  EXPECT_LE(log.syncCount(), static_cast<std::uint64_t>(kThreads * kPerThread));
+  EXPECT_GT(log.syncCount(), 0u);
+}